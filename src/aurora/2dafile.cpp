@@ -48,91 +48,66 @@ static const uint32 k2DAIDTab  = MKTAG('2', 'D', 'A', '\t');
 static const uint32 kVersion2a = MKTAG('V', '2', '.', '0');
 static const uint32 kVersion2b = MKTAG('V', '2', '.', 'b');
 
+static const Common::UString kEmpty;
+
 namespace Aurora {
 
-TwoDARow::TwoDARow(TwoDAFile &parent) : _parent(&parent) {
+TwoDARow::TwoDARow(TwoDAFile &parent, size_t index) : _parent(&parent), _index(index) {
 }
 
 TwoDARow::~TwoDARow() {
 }
 
 const Common::UString &TwoDARow::getString(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
+	if (_parent->isEmpty(_index, column))
 		return _parent->_defaultString;
 
-	return cell;
+	return _parent->getCell(_index, column);
 }
 
 const Common::UString &TwoDARow::getString(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultString;
-
-	return cell;
+	return getString(_parent->headerToColumn(column));
 }
 
 int32 TwoDARow::getInt(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
+	if (!_parent->hasCell(_index, column))
 		return _parent->_defaultInt;
 
-	return _parent->parseInt(cell);
+	return _parent->_columns[column].ints[_index];
 }
 
 int32 TwoDARow::getInt(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultInt;
-
-	return _parent->parseInt(cell);
+	return getInt(_parent->headerToColumn(column));
 }
 
 float TwoDARow::getFloat(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
+	if (!_parent->hasCell(_index, column))
 		return _parent->_defaultFloat;
 
-	return _parent->parseFloat(cell);
+	return _parent->_columns[column].floats[_index];
 }
 
 float TwoDARow::getFloat(const Common::UString &column) const {
-	const Common::UString &cell = getCell(_parent->headerToColumn(column));
-	if (cell.empty() || (cell == "****"))
-		return _parent->_defaultFloat;
-
-	return _parent->parseFloat(cell);
+	return getFloat(_parent->headerToColumn(column));
 }
 
 bool TwoDARow::empty(size_t column) const {
-	const Common::UString &cell = getCell(column);
-	if (cell.empty() || (cell == "****"))
-		return true;
-
-	return false;
+	return _parent->isEmpty(_index, column);
 }
 
 bool TwoDARow::empty(const Common::UString &column) const {
 	return empty(_parent->headerToColumn(column));
 }
 
-static const Common::UString kEmpty;
-const Common::UString &TwoDARow::getCell(size_t n) const {
-	if (n >= _data.size())
-		return kEmpty;
-
-	return _data[n];
-}
-
 
 TwoDAFile::TwoDAFile(Common::SeekableReadStream &twoda) :
-	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
 
 	load(twoda);
 }
 
 TwoDAFile::TwoDAFile(const GDAFile &gda) :
-	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this) {
+	_defaultInt(0), _defaultFloat(0.0f), _emptyRow(*this, SIZE_MAX) {
 
 	load(gda);
 }
@@ -231,9 +206,12 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 
 	const size_t columnCount = _headers.size();
 
-	while (!twoda.eos()) {
-		Common::ScopedPtr<TwoDARow> row(new TwoDARow(*this));
+	createColumns(0);
+
+	CellStrings strings;
+	std::vector<Common::UString> cells;
 
+	while (!twoda.eos()) {
 		/* Skip the first token, which is the row index, possibly indented.
 		 * The row index is implicit in the data and its use in the 2DA
 		 * file is only meant as a guideline for people editing the file by
@@ -242,7 +220,7 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 		tokenize.skipToken(twoda);
 
 		// Read all the cells in the row
-		size_t count = tokenize.getTokens(twoda, row->_data, columnCount, columnCount, "****");
+		size_t count = tokenize.getTokens(twoda, cells, columnCount, columnCount, "****");
 
 		// And move to the next line
 		tokenize.nextChunk(twoda);
@@ -251,7 +229,8 @@ void TwoDAFile::readRows2a(Common::SeekableReadStream &twoda,
 		if (count == 0)
 			continue;
 
-		_rows.push_back(row.release());
+		_rows.push_back(new TwoDARow(*this, _rows.size()));
+		addRow(strings, cells);
 	}
 }
 
@@ -316,20 +295,35 @@ void TwoDAFile::readRows2b(Common::SeekableReadStream &twoda) {
 
 	const size_t dataOffset = twoda.pos();
 
-	for (size_t i = 0; i < rowCount; i++) {
-		_rows[i] = new TwoDARow(*this);
+	createColumns(rowCount);
+
+	CellStrings strings;
+	std::vector<Common::UString> cells(columnCount);
 
-		_rows[i]->_data.resize(columnCount);
+	// Cells sharing an offset share the string, so we only need to read each offset once
+	std::map<uint32, Common::UString> offsetStrings;
+
+	for (size_t i = 0; i < rowCount; i++) {
+		_rows[i] = new TwoDARow(*this, i);
 
 		for (size_t j = 0; j < columnCount; j++) {
-			const size_t offset = dataOffset + offsets[i * columnCount + j];
+			const uint32 offset = offsets[i * columnCount + j];
 
-			twoda.seek(offset);
+			std::map<uint32, Common::UString>::const_iterator cell = offsetStrings.find(offset);
+			if (cell == offsetStrings.end()) {
+				twoda.seek(dataOffset + offset);
 
-			_rows[i]->_data[j] = tokenize.getToken(twoda);
-			if (_rows[i]->_data[j].empty())
-				_rows[i]->_data[j] = "****";
+				Common::UString token = tokenize.getToken(twoda);
+				if (token.empty())
+					token = "****";
+
+				cell = offsetStrings.insert(std::make_pair(offset, token)).first;
+			}
+
+			cells[j] = cell->second;
 		}
+
+		addRow(strings, cells);
 	}
 }
 
@@ -338,6 +332,57 @@ void TwoDAFile::createHeaderMap() {
 		_headerMap.insert(std::make_pair(_headers[i], i));
 }
 
+void TwoDAFile::createColumns(size_t rowCount) {
+	_columns.resize(_headers.size());
+	_rowIndices.resize(_headers.size(), 0);
+
+	for (std::vector<Column>::iterator c = _columns.begin(); c != _columns.end(); ++c) {
+		c->strings.reserve(rowCount);
+		c->ints.reserve(rowCount);
+		c->floats.reserve(rowCount);
+		c->empty.reserve((rowCount + 31) / 32);
+	}
+}
+
+uint32 TwoDAFile::addString(CellStrings &strings, const Common::UString &str) {
+	CellStrings::Indices::const_iterator s = strings.indices.find(str);
+	if (s != strings.indices.end())
+		return s->second;
+
+	// A string we haven't seen yet. Parse it, once, into all types
+
+	const uint32 index = _strings.size();
+	const bool   empty = str.empty() || (str == "****");
+
+	_strings.push_back(str);
+	strings.indices.insert(std::make_pair(str, index));
+
+	strings.ints.push_back  (empty ? _defaultInt   : parseInt(str));
+	strings.floats.push_back(empty ? _defaultFloat : parseFloat(str));
+	strings.empty.push_back (empty);
+
+	return index;
+}
+
+void TwoDAFile::addRow(CellStrings &strings, const std::vector<Common::UString> &cells) {
+	for (size_t i = 0; i < _columns.size(); i++) {
+		Column &column = _columns[i];
+
+		const size_t row    = column.strings.size();
+		const uint32 string = addString(strings, (i < cells.size()) ? cells[i] : kEmpty);
+
+		column.strings.push_back(string);
+		column.ints.push_back(strings.ints[string]);
+		column.floats.push_back(strings.floats[string]);
+
+		if ((row % 32) == 0)
+			column.empty.push_back(0);
+
+		if (strings.empty[string])
+			column.empty.back() |= 1U << (row % 32);
+	}
+}
+
 void TwoDAFile::load(const GDAFile &gda) {
 	try {
 
@@ -351,31 +396,37 @@ void TwoDAFile::load(const GDAFile &gda) {
 			_headers[i] = headerString ? headerString : Common::UString::format("[%u]", headers[i].hash);
 		}
 
+		createColumns(gda.getRowCount());
+
+		CellStrings strings;
+		std::vector<Common::UString> cells(gda.getColumnCount());
+
 		_rows.resize(gda.getRowCount(), 0);
 		for (size_t i = 0; i < gda.getRowCount(); i++) {
 			const GFF4Struct *row = gda.getRow(i);
 
-			_rows[i] = new TwoDARow(*this);
-			_rows[i]->_data.resize(gda.getColumnCount());
+			_rows[i] = new TwoDARow(*this, i);
 
 			for (size_t j = 0; j < gda.getColumnCount(); j++) {
+				cells[j].clear();
+
 				if (row) {
 					switch (headers[j].type) {
 						case GDAFile::kTypeString:
 						case GDAFile::kTypeResource:
-							_rows[i]->_data[j] = row->getString(headers[j].field);
+							cells[j] = row->getString(headers[j].field);
 							break;
 
 						case GDAFile::kTypeInt:
-							_rows[i]->_data[j] = Common::UString::format("%d", (int) row->getSint(headers[j].field));
+							cells[j] = Common::UString::format("%d", (int) row->getSint(headers[j].field));
 							break;
 
 						case GDAFile::kTypeFloat:
-							_rows[i]->_data[j] = Common::UString::format("%f", row->getDouble(headers[j].field));
+							cells[j] = Common::UString::format("%f", row->getDouble(headers[j].field));
 							break;
 
 						case GDAFile::kTypeBool:
-							_rows[i]->_data[j] = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
+							cells[j] = Common::UString::format("%u", (uint) row->getUint(headers[j].field));
 							break;
 
 						default:
@@ -383,10 +434,12 @@ void TwoDAFile::load(const GDAFile &gda) {
 					}
 				}
 
-				if (_rows[i]->_data[j].empty())
-					_rows[i]->_data[j] = "****";
+				if (cells[j].empty())
+					cells[j] = "****";
 
 			}
+
+			addRow(strings, cells);
 		}
 
 	} catch (Common::Exception &e) {
@@ -426,18 +479,90 @@ const TwoDARow &TwoDAFile::getRow(size_t row) const {
 	return *_rows[row];
 }
 
+const std::vector<int32> &TwoDAFile::getIntColumn(size_t column) const {
+	static const std::vector<int32> kNoInts;
+	if (column >= _columns.size())
+		return kNoInts;
+
+	return _columns[column].ints;
+}
+
+const std::vector<float> &TwoDAFile::getFloatColumn(size_t column) const {
+	static const std::vector<float> kNoFloats;
+	if (column >= _columns.size())
+		return kNoFloats;
+
+	return _columns[column].floats;
+}
+
+size_t TwoDAFile::getMemorySize() const {
+	size_t size = sizeof(*this);
+
+	for (std::vector<Common::UString>::const_iterator h = _headers.begin(); h != _headers.end(); ++h)
+		size += sizeof(*h) + h->size();
+
+	for (std::vector<Common::UString>::const_iterator s = _strings.begin(); s != _strings.end(); ++s)
+		size += sizeof(*s) + s->size();
+
+	for (std::vector<Column>::const_iterator c = _columns.begin(); c != _columns.end(); ++c)
+		size += sizeof(*c) +
+		        c->strings.capacity() * sizeof(uint32) + c->ints .capacity() * sizeof(int32) +
+		        c->floats .capacity() * sizeof(float)  + c->empty.capacity() * sizeof(uint32);
+
+	size += _rows.size() * (sizeof(TwoDARow *) + sizeof(TwoDARow));
+
+	return size;
+}
+
+bool TwoDAFile::hasCell(size_t row, size_t column) const {
+	return (row < _rows.size()) && (column < _columns.size());
+}
+
+bool TwoDAFile::isEmpty(size_t row, size_t column) const {
+	if (!hasCell(row, column))
+		return true;
+
+	return (_columns[column].empty[row / 32] & (1U << (row % 32))) != 0;
+}
+
+const Common::UString &TwoDAFile::getCell(size_t row, size_t column) const {
+	if (!hasCell(row, column))
+		return kEmpty;
+
+	return _strings[_columns[column].strings[row]];
+}
+
 const TwoDARow &TwoDAFile::getRow(const Common::UString &header, const Common::UString &value) const {
 	size_t columnIndex = headerToColumn(header);
-	if (columnIndex == kFieldIDInvalid)
+	if ((columnIndex == kFieldIDInvalid) || (columnIndex >= _columns.size()))
 		return _emptyRow;
 
-	for (std::vector<TwoDARow *>::const_iterator row = _rows.begin(); row != _rows.end(); ++row) {
-		if ((*row)->getString(columnIndex).equalsIgnoreCase(value))
-			return **row;
+	const RowIndex &index = getRowIndex(columnIndex);
+
+	RowIndex::const_iterator row = index.find(value);
+	if (row == index.end())
+		// No such row
+		return _emptyRow;
+
+	return *_rows[row->second];
+}
+
+const TwoDAFile::RowIndex &TwoDAFile::getRowIndex(size_t column) const {
+	/* Once created, an index is never changed again. So after we let go
+	 * of the mutex, it's safe to keep using the index without it. */
+	std::lock_guard<std::mutex> lock(_rowIndexMutex);
+
+	if (!_rowIndices[column]) {
+		Common::ScopedPtr<RowIndex> index(new RowIndex);
+
+		// Don't overwrite existing entries, so that the first matching row wins
+		for (size_t i = 0; i < _rows.size(); i++)
+			index->insert(std::make_pair(_rows[i]->getString(column), i));
+
+		_rowIndices[column] = index.release();
 	}
 
-	// No such row
-	return _emptyRow;
+	return *_rowIndices[column];
 }
 
 void TwoDAFile::writeASCII(Common::WriteStream &out) const {
@@ -460,9 +585,9 @@ void TwoDAFile::writeASCII(Common::WriteStream &out) const {
 		colLength[i + 1] = _headers[i].size();
 
 	for (size_t i = 0; i < _rows.size(); i++) {
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool   needQuote = _rows[i]->_data[j].contains(' ');
-			const size_t length    = needQuote ? _rows[i]->_data[j].size() + 2 : _rows[i]->_data[j].size();
+		for (size_t j = 0; j < _headers.size(); j++) {
+			const bool   needQuote = getCell(i, j).contains(' ');
+			const size_t length    = needQuote ? getCell(i, j).size() + 2 : getCell(i, j).size();
 
 			colLength[j + 1] = MAX<size_t>(colLength[j + 1], length);
 		}
@@ -482,14 +607,14 @@ void TwoDAFile::writeASCII(Common::WriteStream &out) const {
 	for (size_t i = 0; i < _rows.size(); i++) {
 		out.writeString(Common::UString::format("%*u", (int)colLength[0], (uint)i));
 
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool needQuote = _rows[i]->_data[j].contains(' ');
+		for (size_t j = 0; j < _headers.size(); j++) {
+			const bool needQuote = getCell(i, j).contains(' ');
 
 			Common::UString cellString;
 			if (needQuote)
-				cellString = Common::UString::format("\"%s\"", _rows[i]->_data[j].c_str());
+				cellString = Common::UString::format("\"%s\"", getCell(i, j).c_str());
 			else
-				cellString = _rows[i]->_data[j];
+				cellString = getCell(i, j);
 
 			out.writeString(Common::UString::format(" %-*s", (int)colLength[j + 1], cellString.c_str()));
 
@@ -641,19 +766,19 @@ void TwoDAFile::writeCSV(Common::WriteStream &out) const {
 	// Write array
 
 	for (size_t i = 0; i < _rows.size(); i++) {
-		for (size_t j = 0; j < _rows[i]->_data.size(); j++) {
-			const bool needQuote = _rows[i]->_data[j].contains(',');
+		for (size_t j = 0; j < _headers.size(); j++) {
+			const bool needQuote = getCell(i, j).contains(',');
 
 			if (needQuote)
 				out.writeByte('"');
 
-			if (_rows[i]->_data[j] != "****")
-				out.writeString(_rows[i]->_data[j]);
+			if (getCell(i, j) != "****")
+				out.writeString(getCell(i, j));
 
 			if (needQuote)
 				out.writeByte('"');
 
-			if (j < (_rows[i]->_data.size() - 1))
+			if (j < (_headers.size() - 1))
 				out.writeByte(',');
 		}
 
@@ -679,11 +804,7 @@ int32 TwoDAFile::parseInt(const Common::UString &str) {
 		return 0;
 
 	int32 v = 0;
-
-	try {
-		Common::parseString(str, v);
-	} catch (...) {
-	}
+	Common::tryParseString(str, v);
 
 	return v;
 }
@@ -693,11 +814,7 @@ float TwoDAFile::parseFloat(const Common::UString &str) {
 		return 0;
 
 	float v = 0.0f;
-
-	try {
-		Common::parseString(str, v);
-	} catch (...) {
-	}
+	Common::tryParseString(str, v);
 
 	return v;
 }
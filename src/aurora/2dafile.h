@@ -27,12 +27,14 @@
 
 #include <vector>
 #include <map>
+#include <unordered_map>
 
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
 #include "src/common/ptrvector.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/aurorafile.h"
 
@@ -82,14 +84,11 @@ public:
 
 private:
 	TwoDAFile *_parent; ///< The parent 2DA.
+	size_t     _index;  ///< The index of this row within the parent 2DA.
 
-	std::vector<Common::UString> _data;
-
-	TwoDARow(TwoDAFile &parent);
+	TwoDARow(TwoDAFile &parent, size_t index);
 	~TwoDARow();
 
-	const Common::UString &getCell(size_t n) const;
-
 	friend class TwoDAFile;
 
 	template<typename T>
@@ -119,6 +118,12 @@ private:
  *  be read and modified with a simple text editor. The binary
  *  version cannot.
  *
+ *  Internally, the cells are stored column by column. Each distinct cell
+ *  string is stored only once, and every cell is parsed into an int and
+ *  a float exactly once, when loading. Reading a cell as an int or float
+ *  is then just an array access. getIntColumn() and getFloatColumn()
+ *  give direct access to these arrays, for going through a whole column.
+ *
  *  See also classes TwoDARow and TwoDARegistry.
  */
 class TwoDAFile : boost::noncopyable, public AuroraFile {
@@ -142,9 +147,30 @@ public:
 	/** Get a row. */
 	const TwoDARow &getRow(size_t row) const;
 
-	/** Get a row whose value in the column named header is the given string value. */
+	/** Get a row whose value in the column named header is the given string value.
+	 *
+	 *  The comparison ignores case. If several rows match, the first one is
+	 *  returned. The first lookup in a column creates an index of all values
+	 *  in that column, so any further lookup is a simple hash lookup.
+	 */
 	const TwoDARow &getRow(const Common::UString &header, const Common::UString &value) const;
 
+	/** Return the int values of all cells in a column, one per row.
+	 *
+	 *  Empty cells hold the default int. For a column that doesn't
+	 *  exist, the returned array is empty.
+	 */
+	const std::vector<int32> &getIntColumn(size_t column) const;
+	/** Return the float values of all cells in a column, one per row.
+	 *
+	 *  Empty cells hold the default float. For a column that doesn't
+	 *  exist, the returned array is empty.
+	 */
+	const std::vector<float> &getFloatColumn(size_t column) const;
+
+	/** Return roughly how many bytes this 2DA takes up in memory. */
+	size_t getMemorySize() const;
+
 	// .--- 2DA file writers
 	/** Write the 2DA data into an V2.0 ASCII 2DA. */
 	void writeASCII(Common::WriteStream &out) const;
@@ -165,6 +191,29 @@ public:
 private:
 	typedef std::map<Common::UString, size_t, Common::UString::iless> HeaderMap;
 
+	/** A column of cells, parsed into all types. */
+	struct Column {
+		std::vector<uint32> strings; ///< Indices into _strings, one per row.
+		std::vector<int32>  ints;    ///< The cells parsed as ints.
+		std::vector<float>  floats;  ///< The cells parsed as floats.
+		std::vector<uint32> empty;   ///< A bitmap of all empty cells.
+	};
+
+	/** The distinct cell strings found while loading, with their parsed values. */
+	struct CellStrings {
+		typedef std::unordered_map<Common::UString, uint32, Common::hashUStringCaseSensitive> Indices;
+
+		Indices indices;
+
+		std::vector<int32> ints;
+		std::vector<float> floats;
+		std::vector<bool>  empty;
+	};
+
+	/** The index of the first row with each value in a column. */
+	typedef std::unordered_map<Common::UString, size_t,
+	                           Common::hashUStringCaseInsensitive, Common::UString::iequal> RowIndex;
+
 	Common::UString _defaultString; ///< The default string to return should a cell not exist.
 	int32           _defaultInt;    ///< The default int to return should a cell not exist.
 	float           _defaultFloat;  ///< The default float to return should a cell not exist.
@@ -172,9 +221,18 @@ private:
 	std::vector<Common::UString> _headers;
 	HeaderMap _headerMap;
 
+	/** All distinct cell strings. */
+	std::vector<Common::UString> _strings;
+	/** All cells, column by column. */
+	std::vector<Column> _columns;
+
 	TwoDARow _emptyRow;
 	Common::PtrVector<TwoDARow> _rows;
 
+	/** Row indices for getRow() by value, one per column, created on first use. */
+	mutable Common::PtrVector<RowIndex> _rowIndices;
+	mutable std::mutex _rowIndexMutex;
+
 	// Loading helpers
 	void load(Common::SeekableReadStream &twoda);
 	void read2a(Common::SeekableReadStream &twoda);
@@ -195,6 +253,17 @@ private:
 
 	void createHeaderMap();
 
+	void createColumns(size_t rowCount);
+	void addRow(CellStrings &strings, const std::vector<Common::UString> &cells);
+	uint32 addString(CellStrings &strings, const Common::UString &str);
+
+	const RowIndex &getRowIndex(size_t column) const;
+
+	// Cell access helpers for TwoDARow
+	bool hasCell(size_t row, size_t column) const;
+	bool isEmpty(size_t row, size_t column) const;
+	const Common::UString &getCell(size_t row, size_t column) const;
+
 	static int32 parseInt(const Common::UString &str);
 	static float parseFloat(const Common::UString &str);
 
@@ -22,9 +22,13 @@
  *  The global 2DA registry.
  */
 
+#include <chrono>
+#include <algorithm>
+
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
 #include "src/common/readstream.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/2dareg.h"
 #include "src/aurora/types.h"
@@ -36,7 +40,20 @@ DECLARE_SINGLETON(Aurora::TwoDARegistry)
 
 namespace Aurora {
 
-TwoDARegistry::TwoDARegistry() {
+static double getMilliseconds(const std::chrono::steady_clock::time_point &start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+static bool contains(const std::vector<Common::UString> &list, const Common::UString &name) {
+	return std::find(list.begin(), list.end(), name) != list.end();
+}
+
+
+TwoDARegistry::TableStats::TableStats() : gda(false), time(0.0), memory(0) {
+}
+
+
+TwoDARegistry::TwoDARegistry() : _snapshot(0) {
 }
 
 TwoDARegistry::~TwoDARegistry() {
@@ -44,11 +61,104 @@ TwoDARegistry::~TwoDARegistry() {
 }
 
 void TwoDARegistry::clear() {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	_snapshot.store(0, std::memory_order_release);
+	_snapshots.clear();
+
+	_retiredTwoDAs.clear();
+	_retiredGDAs.clear();
+
 	_twodas.clear();
 	_gdas.clear();
+
+	_twodaStats.clear();
+	_gdaStats.clear();
+}
+
+void TwoDARegistry::preload(const Manifest &manifest) {
+	// Only load the tables we don't already have
+
+	std::vector<Common::UString> twodas, gdas, mgdas;
+
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (std::vector<Common::UString>::const_iterator t = manifest.twodas.begin(); t != manifest.twodas.end(); ++t)
+			if ((_twodas.find(*t) == _twodas.end()) && !contains(twodas, *t))
+				twodas.push_back(*t);
+
+		for (std::vector<Common::UString>::const_iterator g = manifest.gdas.begin(); g != manifest.gdas.end(); ++g)
+			if ((_gdas.find(*g) == _gdas.end()) && !contains(gdas, *g))
+				gdas.push_back(*g);
+
+		for (std::vector<Common::UString>::const_iterator g = manifest.mgdas.begin(); g != manifest.mgdas.end(); ++g)
+			if ((_gdas.find(*g) == _gdas.end()) && !contains(gdas, *g) && !contains(mgdas, *g))
+				mgdas.push_back(*g);
+	}
+
+	// Parse all tables in parallel, without holding the lock
+
+	const size_t count = twodas.size() + gdas.size() + mgdas.size();
+
+	Common::PtrVector<TwoDAFile> newTwoDAs;
+	Common::PtrVector<GDAFile>   newGDAs;
+
+	newTwoDAs.resize(twodas.size(), 0);
+	newGDAs.resize(gdas.size() + mgdas.size(), 0);
+
+	std::vector<TableStats> stats(count);
+
+	ResMan.getThreadPool().parallelFor(count, [&](size_t i) {
+		try {
+			if (i < twodas.size())
+				newTwoDAs[i] = load2DA(twodas[i], stats[i]);
+			else if ((i - twodas.size()) < gdas.size())
+				newGDAs[i - twodas.size()] = loadGDA(gdas[i - twodas.size()], stats[i]);
+			else
+				newGDAs[i - twodas.size()] = loadMGDA(mgdas[i - twodas.size() - gdas.size()], stats[i]);
+
+		} catch (Common::Exception &e) {
+			Common::printException(e, "WARNING: ");
+		}
+	});
+
+	// Add them all, unless another thread loaded the same table in the meantime
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	for (size_t i = 0; i < newTwoDAs.size(); i++) {
+		if (!newTwoDAs[i] || !_twodas.insert(std::make_pair(twodas[i], newTwoDAs[i])).second)
+			continue;
+
+		newTwoDAs[i] = 0;
+		_twodaStats[twodas[i]] = stats[i];
+	}
+
+	for (size_t i = 0; i < newGDAs.size(); i++) {
+		const Common::UString &name = (i < gdas.size()) ? gdas[i] : mgdas[i - gdas.size()];
+
+		if (!newGDAs[i] || !_gdas.insert(std::make_pair(name, newGDAs[i])).second)
+			continue;
+
+		newGDAs[i] = 0;
+		_gdaStats[name] = stats[twodas.size() + i];
+	}
+
+	publishSnapshot();
 }
 
 const TwoDAFile &TwoDARegistry::get2DA(const Common::UString &name) {
+	// Look into the snapshot first, which doesn't need the lock
+	const Snapshot *snapshot = _snapshot.load(std::memory_order_acquire);
+	if (snapshot) {
+		Snapshot::TwoDAs::const_iterator twoda = snapshot->twodas.find(name);
+		if (twoda != snapshot->twodas.end())
+			return *twoda->second;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	TwoDAMap::const_iterator twoda = _twodas.find(name);
 	if (twoda != _twodas.end())
 		// Entry exists => return
@@ -56,15 +166,27 @@ const TwoDAFile &TwoDARegistry::get2DA(const Common::UString &name) {
 
 	// Entry doesn't exist => load and add
 
-	TwoDAFile *newTwoDA = load2DA(name);
+	TableStats stats;
+	TwoDAFile *newTwoDA = load2DA(name, stats);
 
 	std::pair<TwoDAMap::iterator, bool> result;
 	result = _twodas.insert(std::make_pair(name, newTwoDA));
 
+	_twodaStats[name] = stats;
+
 	return *result.first->second;
 }
 
 const GDAFile &TwoDARegistry::getGDA(const Common::UString &name) {
+	const Snapshot *snapshot = _snapshot.load(std::memory_order_acquire);
+	if (snapshot) {
+		Snapshot::GDAs::const_iterator gda = snapshot->gdas.find(name);
+		if (gda != snapshot->gdas.end())
+			return *gda->second;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	GDAMap::const_iterator gda = _gdas.find(name);
 	if (gda != _gdas.end())
 		// Entry exists => return
@@ -72,15 +194,27 @@ const GDAFile &TwoDARegistry::getGDA(const Common::UString &name) {
 
 	// Entry doesn't exist => load and add
 
-	GDAFile *newGDA = loadGDA(name);
+	TableStats stats;
+	GDAFile *newGDA = loadGDA(name, stats);
 
 	std::pair<GDAMap::iterator, bool> result;
 	result = _gdas.insert(std::make_pair(name, newGDA));
 
+	_gdaStats[name] = stats;
+
 	return *result.first->second;
 }
 
 const GDAFile &TwoDARegistry::getMGDA(const Common::UString &prefix) {
+	const Snapshot *snapshot = _snapshot.load(std::memory_order_acquire);
+	if (snapshot) {
+		Snapshot::GDAs::const_iterator gda = snapshot->gdas.find(prefix);
+		if (gda != snapshot->gdas.end())
+			return *gda->second;
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	GDAMap::const_iterator gda = _gdas.find(prefix);
 	if (gda != _gdas.end())
 		// Entry exists => return
@@ -88,63 +222,163 @@ const GDAFile &TwoDARegistry::getMGDA(const Common::UString &prefix) {
 
 	// Entry doesn't exist => load and add
 
-	GDAFile *newGDA = loadMGDA(prefix);
+	TableStats stats;
+	GDAFile *newGDA = loadMGDA(prefix, stats);
 
 	std::pair<GDAMap::iterator, bool> result;
 	result = _gdas.insert(std::make_pair(prefix, newGDA));
 
+	_gdaStats[prefix] = stats;
+
 	return *result.first->second;
 }
 
 void TwoDARegistry::add2DA(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	TableStats stats;
+	TwoDAFile *newTwoDA = load2DA(name, stats);
+
 	TwoDAMap::iterator twoda = _twodas.find(name);
 	if (twoda != _twodas.end())
 		// Entry exists => remove first
-		_twodas.erase(twoda);
+		retire2DA(twoda);
 
-	// Load and add
-	_twodas[name] = load2DA(name);
+	// Add
+	_twodas[name] = newTwoDA;
+	_twodaStats[name] = stats;
+
+	// The snapshot might still point to the old 2DA
+	if (_snapshot.load(std::memory_order_relaxed))
+		publishSnapshot();
 }
 
 void TwoDARegistry::remove2DA(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	TwoDAMap::iterator twoda = _twodas.find(name);
 	if (twoda == _twodas.end())
 		// Doesn't exist, nothing to do
 		return;
 
-	_twodas.erase(twoda);
+	retire2DA(twoda);
+	_twodaStats.erase(name);
+
+	if (_snapshot.load(std::memory_order_relaxed))
+		publishSnapshot();
 }
 
 void TwoDARegistry::addGDA(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	TableStats stats;
+	GDAFile *newGDA = loadGDA(name, stats);
+
 	GDAMap::iterator gda = _gdas.find(name);
 	if (gda != _gdas.end())
 		// Entry exists => remove first
-		_gdas.erase(gda);
+		retireGDA(gda);
 
-	// Load and add
-	_gdas[name] = loadGDA(name);
+	// Add
+	_gdas[name] = newGDA;
+	_gdaStats[name] = stats;
+
+	if (_snapshot.load(std::memory_order_relaxed))
+		publishSnapshot();
 }
 
 void TwoDARegistry::addMGDA(const Common::UString &prefix) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	TableStats stats;
+	GDAFile *newGDA = loadMGDA(prefix, stats);
+
 	GDAMap::iterator gda = _gdas.find(prefix);
 	if (gda != _gdas.end())
 		// Entry exists => remove first
-		_gdas.erase(gda);
+		retireGDA(gda);
 
-	// Load and add
-	_gdas[prefix] = loadMGDA(prefix);
+	// Add
+	_gdas[prefix] = newGDA;
+	_gdaStats[prefix] = stats;
+
+	if (_snapshot.load(std::memory_order_relaxed))
+		publishSnapshot();
 }
 
 void TwoDARegistry::removeGDA(const Common::UString &name) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	GDAMap::iterator gda = _gdas.find(name);
 	if (gda == _gdas.end())
 		// Doesn't exist, nothing to do
 		return;
 
+	retireGDA(gda);
+	_gdaStats.erase(name);
+
+	if (_snapshot.load(std::memory_order_relaxed))
+		publishSnapshot();
+}
+
+TwoDARegistry::TableStatsList TwoDARegistry::getTableStats() const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	TableStatsList stats;
+	stats.reserve(_twodaStats.size() + _gdaStats.size());
+
+	for (TableStatsMap::const_iterator s = _twodaStats.begin(); s != _twodaStats.end(); ++s)
+		stats.push_back(s->second);
+	for (TableStatsMap::const_iterator s = _gdaStats.begin(); s != _gdaStats.end(); ++s)
+		stats.push_back(s->second);
+
+	std::stable_sort(stats.begin(), stats.end(), [](const TableStats &a, const TableStats &b) {
+		return a.name.less(b.name);
+	});
+
+	return stats;
+}
+
+void TwoDARegistry::publishSnapshot() {
+	/* Readers might still be looking at the current snapshot, so we can't
+	 * change or free it. Instead, we create a new one and keep the old one
+	 * around until clear(). The tables an old snapshot points to are kept
+	 * alive as well, by retire2DA() and retireGDA(). Since this only happens
+	 * for preloads and for explicit adds and removes, there won't be many. */
+
+	Common::ScopedPtr<Snapshot> snapshot(new Snapshot);
+
+	snapshot->twodas.reserve(_twodas.size());
+	for (TwoDAMap::const_iterator t = _twodas.begin(); t != _twodas.end(); ++t)
+		snapshot->twodas.insert(std::make_pair(t->first, t->second));
+
+	snapshot->gdas.reserve(_gdas.size());
+	for (GDAMap::const_iterator g = _gdas.begin(); g != _gdas.end(); ++g)
+		snapshot->gdas.insert(std::make_pair(g->first, g->second));
+
+	_snapshots.push_back(snapshot.get());
+	_snapshot.store(snapshot.release(), std::memory_order_release);
+}
+
+void TwoDARegistry::retire2DA(TwoDAMap::iterator twoda) {
+	if (!_snapshots.empty()) {
+		_retiredTwoDAs.push_back(twoda->second);
+		twoda->second = 0;
+	}
+
+	_twodas.erase(twoda);
+}
+
+void TwoDARegistry::retireGDA(GDAMap::iterator gda) {
+	if (!_snapshots.empty()) {
+		_retiredGDAs.push_back(gda->second);
+		gda->second = 0;
+	}
+
 	_gdas.erase(gda);
 }
 
-TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name) {
+TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name, TableStats &stats) {
 	Common::ScopedPtr<Common::SeekableReadStream> twodaFile;
 	Common::ScopedPtr<TwoDAFile> twoda;
 
@@ -153,8 +387,15 @@ TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name) {
 		if (!twodaFile)
 			throw Common::Exception("No such 2DA");
 
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
 		twoda.reset(new TwoDAFile(*twodaFile));
 
+		stats.name   = name;
+		stats.gda    = false;
+		stats.time   = getMilliseconds(start);
+		stats.memory = twoda->getMemorySize();
+
 	} catch (Common::Exception &e) {
 		e.add("Failed loading 2DA \"%s\"", name.c_str());
 		throw;
@@ -163,7 +404,7 @@ TwoDAFile *TwoDARegistry::load2DA(const Common::UString &name) {
 	return twoda.release();
 }
 
-GDAFile *TwoDARegistry::loadGDA(const Common::UString &name) {
+GDAFile *TwoDARegistry::loadGDA(const Common::UString &name, TableStats &stats) {
 	Common::ScopedPtr<Common::SeekableReadStream> gdaFile;
 	Common::ScopedPtr<GDAFile> gda;
 
@@ -172,8 +413,17 @@ GDAFile *TwoDARegistry::loadGDA(const Common::UString &name) {
 		if (!gdaFile)
 			throw Common::Exception("No such GDA");
 
+		const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+		// The GDA keeps the whole GFF4 data around, which makes up nearly all of its size
+		stats.memory = gdaFile->size();
+
 		gda.reset(new GDAFile(gdaFile.release()));
 
+		stats.name = name;
+		stats.gda  = true;
+		stats.time = getMilliseconds(start);
+
 	} catch (Common::Exception &e) {
 		e.add("Failed loading GDA \"%s\"", name.c_str());
 		throw;
@@ -182,12 +432,17 @@ GDAFile *TwoDARegistry::loadGDA(const Common::UString &name) {
 	return gda.release();
 }
 
-GDAFile *TwoDARegistry::loadMGDA(Common::UString prefix) {
+GDAFile *TwoDARegistry::loadMGDA(Common::UString prefix, TableStats &stats) {
 	/* Load multiple GDAs with the same prefix, and merge them together into a single GDA. */
 
 	if (prefix.empty())
 		throw Common::Exception("Trying to load MGDA \"\"");
 
+	stats.name   = prefix;
+	stats.gda    = true;
+	stats.time   = 0.0;
+	stats.memory = 0;
+
 	prefix.makeLower();
 
 	std::list<ResourceManager::ResourceID> gdas;
@@ -207,11 +462,17 @@ GDAFile *TwoDARegistry::loadMGDA(Common::UString prefix) {
 			if (!stream)
 				throw Common::Exception("No such GDA \"%s\"", g->name.c_str());
 
+			const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+			stats.memory += stream->size();
+
 			// If this is the first GDA, plain load it. Otherwise, merge it into the first one
 			if (!gda)
 				gda.reset(new GDAFile(stream.release()));
 			else
 				gda->add(stream.release());
+
+			stats.time += getMilliseconds(start);
 		}
 
 		if (!gda)
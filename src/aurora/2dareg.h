@@ -25,9 +25,16 @@
 #ifndef AURORA_2DAREG_H
 #define AURORA_2DAREG_H
 
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <atomic>
+
 #include "src/common/ptrmap.h"
+#include "src/common/ptrvector.h"
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 namespace Aurora {
 
@@ -54,14 +61,60 @@ class GDAFile;
  *
  *  All 2DA and GDA files are directly and automatically loaded from
  *  the ResourceManager.
+ *
+ *  The registry can be used from several threads at once. When a context
+ *  is entered, the engine should preload() the tables it knows it needs,
+ *  which parses them in parallel on the ResourceManager's worker threads.
+ *  Afterwards, looking up any table loaded so far doesn't lock at all, so
+ *  script threads and the game thread can freely query the tables. Only
+ *  looking up tables that are loaded on demand later on takes a lock.
+ *
+ *  Tables that are replaced or removed are kept alive until clear(), since
+ *  a thread might still be using them.
+ *
+ *  Reading values out of a TwoDAFile is safe from several threads at once,
+ *  and so are the value getters of GDAFile. The GFF4Structs returned by
+ *  GDAFile::getRow(), however, read strings through a stream shared by
+ *  the whole GDA, and must not be used by several threads at once.
  */
 class TwoDARegistry : public Common::Singleton<TwoDARegistry> {
 public:
+	/** A list of tables to load all at once. */
+	struct Manifest {
+		std::vector<Common::UString> twodas; ///< The names of 2DAs to load.
+		std::vector<Common::UString> gdas;   ///< The names of GDAs to load.
+		std::vector<Common::UString> mgdas;  ///< The prefixes of multiple GDAs to load.
+	};
+
+	/** Statistics about a loaded table. */
+	struct TableStats {
+		Common::UString name;
+
+		bool   gda;    ///< Is this a GDA (or multiple GDA) instead of a 2DA?
+		double time;   ///< Time spent parsing the table, in milliseconds.
+		size_t memory; ///< Rough size of the table in memory, in bytes.
+
+		TableStats();
+	};
+	typedef std::vector<TableStats> TableStatsList;
+
 	TwoDARegistry();
 	~TwoDARegistry();
 
+	/** Remove and free all tables.
+	 *
+	 *  This invalidates all references to tables handed out so far. It
+	 *  must not be called while other threads might still look up tables.
+	 */
 	void clear();
 
+	/** Load all tables in the manifest that aren't loaded yet, in parallel.
+	 *
+	 *  Tables that fail to load are skipped with a warning. They will fail
+	 *  again, with an error, when they are requested.
+	 */
+	void preload(const Manifest &manifest);
+
 	/** Get a certain 2DA, loading it if necessary. */
 	const TwoDAFile &get2DA(const Common::UString &name);
 
@@ -83,16 +136,53 @@ public:
 	/** Remove a certain GDA from the registry. */
 	void removeGDA(const Common::UString &name);
 
+	/** Return statistics about all currently loaded tables, sorted by name. */
+	TableStatsList getTableStats() const;
+
 private:
 	typedef Common::PtrMap<Common::UString, TwoDAFile> TwoDAMap;
 	typedef Common::PtrMap<Common::UString, GDAFile> GDAMap;
 
+	typedef std::map<Common::UString, TableStats> TableStatsMap;
+
+	/** An unchanging view of the loaded tables, for lookups without locking. */
+	struct Snapshot {
+		typedef std::unordered_map<Common::UString, const TwoDAFile *, Common::hashUStringCaseSensitive> TwoDAs;
+		typedef std::unordered_map<Common::UString, const GDAFile *, Common::hashUStringCaseSensitive> GDAs;
+
+		TwoDAs twodas;
+		GDAs   gdas;
+	};
+
 	TwoDAMap _twodas;
 	GDAMap   _gdas;
 
-	TwoDAFile *load2DA(const Common::UString &name);
-	GDAFile   *loadGDA(const Common::UString &name);
-	GDAFile   *loadMGDA(Common::UString prefix);
+	TableStatsMap _twodaStats;
+	TableStatsMap _gdaStats;
+
+	/** The current snapshot of all tables, if any. */
+	std::atomic<const Snapshot *> _snapshot;
+	/** All snapshots ever published. Old ones might still be read, so they're only freed by clear(). */
+	Common::PtrVector<Snapshot> _snapshots;
+
+	/** Replaced and removed 2DAs. Snapshots might still point to them, so they're only freed by clear(). */
+	Common::PtrVector<TwoDAFile> _retiredTwoDAs;
+	/** Replaced and removed GDAs. Snapshots might still point to them, so they're only freed by clear(). */
+	Common::PtrVector<GDAFile> _retiredGDAs;
+
+	/** Protects everything but the current snapshot. */
+	mutable std::mutex _mutex;
+
+	void publishSnapshot();
+
+	/** Remove a 2DA from the map, without freeing it while snapshots might still point to it. */
+	void retire2DA(TwoDAMap::iterator twoda);
+	/** Remove a GDA from the map, without freeing it while snapshots might still point to it. */
+	void retireGDA(GDAMap::iterator gda);
+
+	static TwoDAFile *load2DA(const Common::UString &name, TableStats &stats);
+	static GDAFile   *loadGDA(const Common::UString &name, TableStats &stats);
+	static GDAFile   *loadMGDA(Common::UString prefix, TableStats &stats);
 };
 
 } // End of namespace Aurora
@@ -65,7 +65,19 @@ public:
 	/** Return the size of a resource. */
 	virtual uint32 getResourceSize(uint32 index) const;
 
+	/** Does reading the resource need more than just copying its data?
+	 *
+	 *  This is true for resources that are compressed or encrypted within
+	 *  the archive, making them expensive to read again and again.
+	 */
+	virtual bool isResourceCompressed(uint32 index) const;
+
 	/** Return a stream of the resource's contents.
+	 *
+	 *  The archive's resources are read with positional reads, so this
+	 *  method can be called from several threads at once. The exception
+	 *  are streams returned with tryNoCopy, which directly reference the
+	 *  archive stream and must not be used concurrently.
 	 *
 	 *  @param  index The index of the resource we want.
 	 *  @param  tryNoCopy Try to return a SeekableSubReadStream of the archive instead of copying.
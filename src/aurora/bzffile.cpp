@@ -142,13 +142,19 @@ uint32 BZFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).size;
 }
 
+bool BZFFile::isResourceCompressed(uint32 index) const {
+	getIResource(index);
+
+	return true;
+}
+
 Common::SeekableReadStream *BZFFile::getResource(uint32 index, bool UNUSED(tryNoCopy)) const {
 	const IResource &res = getIResource(index);
 
-	_bzf->seek(res.offset);
-
 #ifdef ENABLE_LZMA
-	return Common::decompressLZMA1(*_bzf, res.packedSize, res.size, true);
+	Common::ScopedPtr<Common::MemoryReadStream> packed(_bzf->readStreamAt(res.offset, res.packedSize));
+
+	return Common::decompressLZMA1(*packed, res.packedSize, res.size, true);
 #else
 	throw Common::Exception("LZMA decompression disabled when building without liblzma");
 #endif
@@ -54,6 +54,9 @@ static const uint32 kVersion30 = MKTAG('V', '3', '.', '0');
 
 namespace Aurora {
 
+/** Compressed resources at least this large are decompressed on the fly, while they are read. */
+static const uint32 kStreamingSize = 1024 * 1024;
+
 static const size_t kNWNPremiumKeyLength = 56;
 
 static const byte kNWNPremiumKeys[][kNWNPremiumKeyLength] = {
@@ -147,8 +150,9 @@ bool ERFFile::ERFHeader::isSensible(size_t fileSize) {
 }
 
 
-ERFFile::ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &password) :
-	_erf(erf), _password(password) {
+ERFFile::ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &password,
+                 Common::ThreadPool *threadPool) :
+	_erf(erf), _password(password), _threadPool(threadPool) {
 
 	assert(_erf);
 
@@ -304,7 +308,7 @@ void ERFFile::decryptNWNPremium() {
 
 	_erf->seek(0);
 
-	_erf.reset(decrypt(*_erf, kEncryptionBlowfishNWN, _password));
+	_erf.reset(decrypt(*_erf, kEncryptionBlowfishNWN, _password, _threadPool));
 
 	_header.encryption = kEncryptionNone;
 }
@@ -709,32 +713,55 @@ uint32 ERFFile::getResourceSize(uint32 index) const {
 	return getIResource(index).unpackedSize;
 }
 
+bool ERFFile::isResourceCompressed(uint32 index) const {
+	getIResource(index);
+
+	return (_header.encryption != kEncryptionNone) || (_header.compression != kCompressionNone);
+}
+
 Common::SeekableReadStream *ERFFile::getResource(uint32 index, bool tryNoCopy) const {
 	const IResource &res = getIResource(index);
 
 	if (tryNoCopy && (_header.encryption == kEncryptionNone) && (_header.compression == kCompressionNone))
 		return new Common::SeekableSubReadStream(_erf.get(), res.offset, res.offset + res.packedSize);
 
-	_erf->seek(res.offset);
-
-	// Read
-	Common::MemoryReadStream *stream = _erf->readStream(res.packedSize);
-
-	// Decrypt
-	if (_header.encryption != kEncryptionNone)
-		stream = decrypt(stream, _header.encryption, _password);
+	// Read, decrypting if necessary
+	Common::MemoryReadStream *stream = (_header.encryption != kEncryptionNone) ?
+		readDecrypted(res) : _erf->readStreamAt(res.offset, res.packedSize);
 
 	// Decompress
 	return decompress(stream, res.unpackedSize);
 }
 
+Common::MemoryReadStream *ERFFile::readDecrypted(const IResource &res) const {
+	switch (_header.encryption) {
+		case kEncryptionBlowfishDAO:
+		case kEncryptionBlowfishDA2:
+		case kEncryptionBlowfishNWN:
+			break;
+
+		default:
+			throw Common::Exception("Invalid ERF encryption %u", (uint) _header.encryption);
+	}
+
+	// Read the encrypted data straight into the buffer we then decrypt in place
+	Common::ScopedArray<byte> data(new byte[res.packedSize]);
+	if (_erf->readAt(res.offset, data.get(), res.packedSize) != res.packedSize)
+		throw Common::Exception(Common::kReadError);
+
+	Common::decryptBlowfishEBC(data.get(), res.packedSize, _password, _threadPool);
+
+	return new Common::MemoryReadStream(data.release(), res.packedSize, true);
+}
+
 Common::MemoryReadStream *ERFFile::decrypt(Common::SeekableReadStream &cryptStream,
-                                           Encryption encryption, const std::vector<byte> &password) {
+                                           Encryption encryption, const std::vector<byte> &password,
+                                           Common::ThreadPool *threadPool) {
 	switch (encryption) {
 		case kEncryptionBlowfishDAO:
 		case kEncryptionBlowfishDA2:
 		case kEncryptionBlowfishNWN:
-			return Common::decryptBlowfishEBC(cryptStream, password);
+			return Common::decryptBlowfishEBC(cryptStream, password, threadPool);
 
 		default:
 			throw Common::Exception("Invalid ERF encryption %u", (uint) encryption);
@@ -799,11 +826,12 @@ Common::SeekableReadStream *ERFFile::decompressBiowareZlib(Common::MemoryReadStr
 	assert(packedStream);
 
 	Common::ScopedPtr<Common::MemoryReadStream> stream(packedStream);
+	if (stream->size() < 1)
+		throw Common::Exception(Common::kReadError);
 
-	const byte * const compressedData = stream->getData();
-	const uint32 packedSize = stream->size();
+	const int windowBits = *stream->getData() >> 4;
 
-	return decompressZlib(compressedData + 1, packedSize - 1, unpackedSize, *compressedData >> 4);
+	return decompressZlib(stream.release(), 1, unpackedSize, windowBits);
 }
 
 Common::SeekableReadStream *ERFFile::decompressHeaderlessZlib(Common::MemoryReadStream *packedStream,
@@ -811,14 +839,7 @@ Common::SeekableReadStream *ERFFile::decompressHeaderlessZlib(Common::MemoryRead
 
 	/* Decompress using raw inflate. Use the default maximum window size (15). */
 
-	assert(packedStream);
-
-	Common::ScopedPtr<Common::MemoryReadStream> stream(packedStream);
-
-	const byte * const compressedData = stream->getData();
-	const uint32 packedSize = stream->size();
-
-	return decompressZlib(compressedData, packedSize, unpackedSize, Common::kWindowBitsMax);
+	return decompressZlib(packedStream, 0, unpackedSize, Common::kWindowBitsMax);
 }
 
 Common::SeekableReadStream *ERFFile::decompressStandardZlib(Common::MemoryReadStream *packedStream,
@@ -826,18 +847,29 @@ Common::SeekableReadStream *ERFFile::decompressStandardZlib(Common::MemoryReadSt
 
 	/* Decompress using raw inflate. Use the default maximum window size (15), and with zlib header. */
 
+	return decompressZlib(packedStream, 0, unpackedSize, -Common::kWindowBitsMax);
+}
+
+Common::SeekableReadStream *ERFFile::decompressZlib(Common::MemoryReadStream *packedStream, uint32 headerSize,
+                                                    uint32 unpackedSize, int windowBits) const {
+
 	assert(packedStream);
 
 	Common::ScopedPtr<Common::MemoryReadStream> stream(packedStream);
 
-	const byte * const compressedData = stream->getData();
-	const uint32 packedSize = stream->size();
+	const byte * const compressedData = stream->getData() + headerSize;
+	const uint32 packedSize = stream->size() - headerSize;
 
-	return decompressZlib(compressedData, packedSize, unpackedSize, -Common::kWindowBitsMax);
-}
+	/* Large resources, like sound banks and movies, are decompressed on the
+	 * fly while they are read. This way, we never need to hold the whole
+	 * decompressed data in memory, and the first bytes are available at once. */
+	if (unpackedSize >= kStreamingSize) {
+		Common::SeekableSubReadStream *input =
+			new Common::SeekableSubReadStream(stream.release(), headerSize, headerSize + packedSize, true);
 
-Common::SeekableReadStream *ERFFile::decompressZlib(const byte *compressedData, uint32 packedSize,
-                                                    uint32 unpackedSize, int windowBits) const {
+		// Negative window size to signal not to look for a gzip header.
+		return new Common::InflateReadStream(input, unpackedSize, -windowBits);
+	}
 
 	// Decompress. Negative window size to signal not to look for a gzip header.
 	const byte *data = Common::decompressDeflate(compressedData, packedSize, unpackedSize, -windowBits);
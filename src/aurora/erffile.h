@@ -38,6 +38,7 @@
 
 namespace Common {
 	class SeekableReadStream;
+	class ThreadPool;
 }
 
 namespace Aurora {
@@ -116,8 +117,12 @@ public:
 	 *  .nwm file and an encrypted .hak file, both of which are ERF archives.
 	 *  In this case, the password is the MD5 of the .nwm file. It is then used
 	 *  to calculate the key to decrypt the .hak file.
+	 *
+	 *  If a thread pool is given, it is used to decrypt large encrypted
+	 *  resources (and whole encrypted premium modules) in parallel.
 	 */
-	ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &password = std::vector<byte>());
+	ERFFile(Common::SeekableReadStream *erf, const std::vector<byte> &password = std::vector<byte>(),
+	        Common::ThreadPool *threadPool = 0);
 	~ERFFile();
 
 	/** Return the list of resources. */
@@ -126,6 +131,9 @@ public:
 	/** Return the size of a resource. */
 	uint32 getResourceSize(uint32 index) const;
 
+	/** Is the resource compressed or encrypted? */
+	bool isResourceCompressed(uint32 index) const;
+
 	/** Return a stream of the resource's contents. */
 	Common::SeekableReadStream *getResource(uint32 index, bool tryNoCopy = false) const;
 
@@ -222,6 +230,9 @@ private:
 	/** The password we were given, if any. */
 	std::vector<byte> _password;
 
+	/** The thread pool to decrypt with, if any. */
+	Common::ThreadPool *_threadPool;
+
 	void load();
 
 	// .--- Header
@@ -270,7 +281,8 @@ private:
 	void verifyPasswordDigest();
 
 	static Common::MemoryReadStream *decrypt(Common::SeekableReadStream &cryptStream,
-	                                         Encryption encryption, const std::vector<byte> &password);
+	                                         Encryption encryption, const std::vector<byte> &password,
+	                                         Common::ThreadPool *threadPool = 0);
 	static Common::MemoryReadStream *decrypt(Common::SeekableReadStream *cryptStream,
 	                                         Encryption encryption, const std::vector<byte> &password);
 
@@ -287,6 +299,8 @@ private:
 	                                    std::vector<byte> &password);
 
 	void decryptNWNPremium();
+
+	Common::MemoryReadStream *readDecrypted(const IResource &res) const;
 	// '---
 
 	// .--- Compression
@@ -300,7 +314,7 @@ private:
 	Common::SeekableReadStream *decompressStandardZlib  (Common::MemoryReadStream *packedStream,
 	                                                     uint32 unpackedSize) const;
 
-	Common::SeekableReadStream *decompressZlib(const byte *compressedData, uint32 packedSize,
+	Common::SeekableReadStream *decompressZlib(Common::MemoryReadStream *packedStream, uint32 headerSize,
 	                                           uint32 unpackedSize, int windowBits) const;
 	// '---
 
@@ -93,11 +93,26 @@ const GFF4Struct *GDAFile::getRow(size_t row) const {
 }
 
 size_t GDAFile::findRow(uint32 id) const {
-	size_t idColumn = findColumn("ID");
-	if (idColumn == kInvalidColumn)
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	if (!_rowIDMap)
+		createRowIDMap();
+
+	RowIDMap::const_iterator r = _rowIDMap->find(id);
+	if (r == _rowIDMap->end())
 		return kInvalidRow;
 
-	// Go through all rows of all GFF4s, and look for the ID
+	return r->second;
+}
+
+void GDAFile::createRowIDMap() const {
+	_rowIDMap.reset(new RowIDMap);
+
+	const size_t idColumn = findColumn(Common::hashStringCRC32("id", Common::kEncodingUTF16LE));
+	if (idColumn == kInvalidColumn)
+		return;
+
+	// Go through all rows of all GFF4s, and map their IDs. The first row with an ID wins
 
 	size_t gff4 = 0;
 	for (size_t i = 0, j = 0; i < _rowCount; i++, j++) {
@@ -108,20 +123,20 @@ size_t GDAFile::findRow(uint32 id) const {
 			j = 0;
 		}
 
-		if ((*_rows[gff4])[j] && ((*_rows[gff4])[j]->getUint(idColumn) == id))
-			return i;
+		if ((*_rows[gff4])[j])
+			_rowIDMap->insert(std::make_pair((uint32) (*_rows[gff4])[j]->getUint(idColumn), i));
 	}
-
-	return kInvalidRow;
 }
 
 size_t GDAFile::findColumn(const Common::UString &name) const {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	ColumnNameMap::const_iterator c = _columnNameMap.find(name);
 	if (c != _columnNameMap.end())
 		return c->second;
 
 	size_t column = findColumn(Common::hashStringCRC32(name.toLower(), Common::kEncodingUTF16LE));
-	_columnNameMap[name] = column;
+	_columnNameMap.insert(std::make_pair(name, column));
 
 	return column;
 }
@@ -131,18 +146,6 @@ size_t GDAFile::findColumn(uint32 hash) const {
 	if (c != _columnHashMap.end())
 		return c->second;
 
-	for (size_t i = 0; i < _columns->size(); i++) {
-		if (!(*_columns)[i])
-			continue;
-
-		if ((*_columns)[i]->getUint(kGFF4G2DAColumnHash) == hash) {
-			_columnHashMap[hash] = kGFF4G2DAColumn1 + i;
-
-			return kGFF4G2DAColumn1 + i;
-		}
-	}
-
-	_columnHashMap[hash] = kInvalidColumn;
 	return kInvalidColumn;
 }
 
@@ -168,6 +171,9 @@ Common::UString GDAFile::getString(size_t row, uint32 columnHash, const Common::
 	if (!gdaRow)
 		return def;
 
+	// Strings are read through the GFF4's stream, which can't be used by several threads at once
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	return gdaRow->getString(gdaColumn, def);
 }
 
@@ -178,6 +184,9 @@ Common::UString GDAFile::getString(size_t row, const Common::UString &columnName
 	if (!gdaRow)
 		return def;
 
+	// Strings are read through the GFF4's stream, which can't be used by several threads at once
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	return gdaRow->getString(gdaColumn, def);
 }
 
@@ -295,6 +304,9 @@ void GDAFile::load(Common::SeekableReadStream *gda) {
 			_headers[i].hash  = (uint32) (*_columns)[i]->getUint(kGFF4G2DAColumnHash);
 			_headers[i].type  =          identifyType(_columns, _rows.back(), i);
 			_headers[i].field = (uint32) kGFF4G2DAColumn1 + i;
+
+			// Should several columns have the same hash, the first one wins
+			_columnHashMap.insert(std::make_pair(_headers[i].hash, (size_t) _headers[i].field));
 		}
 
 	} catch (Common::Exception &e) {
@@ -335,6 +347,10 @@ void GDAFile::add(Common::SeekableReadStream *gda) {
 				                        hash1, (int)type1, hash2, (int)type2);
 		}
 
+		// The new rows need to be found by their IDs too
+		std::lock_guard<std::mutex> lock(_mutex);
+		_rowIDMap.reset();
+
 	} catch (Common::Exception &e) {
 		e.add("Failed adding GDA file");
 		throw;
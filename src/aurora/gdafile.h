@@ -26,12 +26,14 @@
 #define AURORA_GDAFILE_H
 
 #include <vector>
-#include <map>
+#include <unordered_map>
 
 #include <boost/noncopyable.hpp>
 
 #include "src/common/ustring.h"
 #include "src/common/ptrvector.h"
+#include "src/common/scopedptr.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 
@@ -58,6 +60,10 @@ namespace Aurora {
  *  by the Dragon Age games. Within these MGDAs, rows are not anymore
  *  identified by raw row index (since this index is now meaningless),
  *  but by an "ID" column.
+ *
+ *  Columns are found through a map from column hash, and rows through
+ *  a map from ID value, created when the first row is looked up by its
+ *  ID. Both can be used from several threads at once.
  */
 class GDAFile : boost::noncopyable {
 public:
@@ -113,7 +119,7 @@ public:
 	/** Get a row as a GFF4 struct. */
 	const GFF4Struct *getRow(size_t row) const;
 
-	/** Find a row by its ID value. */
+	/** Find a row by its ID value. If several rows have this ID, return the first one. */
 	size_t findRow(uint32 id) const;
 
 	/** Find a column by its name. */
@@ -139,8 +145,10 @@ private:
 	typedef std::vector<Row> Rows;
 	typedef std::vector<size_t> RowStarts;
 
-	typedef std::map<uint32, size_t> ColumnHashMap;
-	typedef std::map<Common::UString, size_t> ColumnNameMap;
+	typedef std::unordered_map<uint32, size_t> ColumnHashMap;
+	typedef std::unordered_map<Common::UString, size_t,
+	                           Common::hashUStringCaseInsensitive, Common::UString::iequal> ColumnNameMap;
+	typedef std::unordered_map<uint32, size_t> RowIDMap;
 
 
 	GFF4s _gff4s;
@@ -154,12 +162,22 @@ private:
 
 	RowStarts _rowStarts;
 
-	mutable ColumnHashMap _columnHashMap;
+	/** Column hash -> column field, for all columns. */
+	ColumnHashMap _columnHashMap;
+
+	/** Column name -> column field, for all names looked up so far. */
 	mutable ColumnNameMap _columnNameMap;
+	/** ID value -> row index, created on the first findRow(). */
+	mutable Common::ScopedPtr<RowIDMap> _rowIDMap;
+
+	/** Protects the lazily filled maps, and reading strings out of the GFF4s. */
+	mutable std::mutex _mutex;
 
 
 	void load(Common::SeekableReadStream *gda);
 
+	void createRowIDMap() const;
+
 	Type identifyType(const Columns &columns, const Row &rows, size_t column) const;
 
 	const GFF4Struct *getRowColumn(size_t row, uint32 hash, size_t &column) const;
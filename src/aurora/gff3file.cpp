@@ -27,12 +27,14 @@
  */
 
 #include <cassert>
+#include <algorithm>
 
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
 #include "src/common/ustring.h"
 #include "src/common/strutil.h"
+#include "src/common/hash.h"
 
 #include "src/aurora/gff3file.h"
 #include "src/aurora/util.h"
@@ -42,8 +44,29 @@
 static const uint32 kVersion32 = MKTAG('V', '3', '.', '2');
 static const uint32 kVersion33 = MKTAG('V', '3', '.', '3'); // Found in The Witcher, different language table
 
+static const uint32 kStructSize = 12;
+
 namespace Aurora {
 
+GFF3Label::GFF3Label(const char *name) : _name(name), _hash(hash(_name)) {
+}
+
+GFF3Label::GFF3Label(const Common::UString &name) : _name(name), _hash(hash(_name)) {
+}
+
+const Common::UString &GFF3Label::getName() const {
+	return _name;
+}
+
+uint32 GFF3Label::getHash() const {
+	return _hash;
+}
+
+uint32 GFF3Label::hash(const Common::UString &name) {
+	return Common::hashStringFNV32(name);
+}
+
+
 GFF3File::Header::Header() {
 }
 
@@ -64,7 +87,7 @@ void GFF3File::Header::read(Common::SeekableReadStream &gff3) {
 
 
 GFF3File::GFF3File(Common::SeekableReadStream *gff3, uint32 id, bool repairNWNPremium) :
-	_stream(gff3), _repairNWNPremium(repairNWNPremium), _offsetCorrection(0) {
+	_stream(gff3), _repairNWNPremium(repairNWNPremium), _offsetCorrection(0), _loadedStructCount(0) {
 
 	assert(_stream);
 
@@ -72,8 +95,11 @@ GFF3File::GFF3File(Common::SeekableReadStream *gff3, uint32 id, bool repairNWNPr
 }
 
 GFF3File::GFF3File(const Common::UString &gff3, FileType type, uint32 id, bool repairNWNPremium) :
-	_repairNWNPremium(repairNWNPremium), _offsetCorrection(0) {
+	_repairNWNPremium(repairNWNPremium), _offsetCorrection(0), _loadedStructCount(0) {
 
+	/* We keep reading from the stream for as long as we live, so we need a stream
+	 * of our own. A view into an archive would share the archive's file position,
+	 * and it would dangle once the archive is deindexed. */
 	_stream.reset(ResMan.getResource(gff3, type));
 	if (!_stream)
 		throw Common::Exception("No such GFF3 \"%s\"", TypeMan.setFileType(gff3, type).c_str());
@@ -92,6 +118,14 @@ const GFF3Struct &GFF3File::getTopLevel() const {
 	return getStruct(0);
 }
 
+size_t GFF3File::getStructCount() const {
+	return _structs.size();
+}
+
+size_t GFF3File::getLoadedStructCount() const {
+	return _loadedStructCount;
+}
+
 // --- Loader ---
 
 void GFF3File::load(uint32 id) {
@@ -99,7 +133,6 @@ void GFF3File::load(uint32 id) {
 
 		loadHeader(id);
 		loadStructs();
-		loadLists();
 
 	} catch (Common::Exception &e) {
 		e.add("Failed reading GFF3 file");
@@ -180,15 +213,36 @@ void GFF3File::loadHeader(uint32 id) {
 		throw Common::Exception("GFF3 header broken: section offset points outside stream");
 }
 
+void GFF3File::loadLabels() const {
+	/* Read all labels once, so that the structs can just refer to them
+	 * by their IDs, instead of each having their own copies. */
+
+	static const uint32 kLabelSize = 16;
+
+	if (_header.labelCount > ((_stream->size() - _header.labelOffset) / kLabelSize))
+		throw Common::Exception("GFF3: Label section points outside stream");
+
+	_stream->seek(_header.labelOffset);
+
+	LabelArray labels(_header.labelCount);
+	for (LabelArray::iterator l = labels.begin(); l != labels.end(); ++l) {
+		l->name = Common::readStringFixed(*_stream, Common::kEncodingASCII, kLabelSize);
+		l->hash = GFF3Label::hash(l->name);
+	}
+
+	_labels.swap(labels);
+}
+
 void GFF3File::loadStructs() {
-	static const uint32 kStructSize = 12;
+	// The structs themselves are only read when they're needed
+
+	if (_header.structCount > ((_stream->size() - _header.structOffset) / kStructSize))
+		throw Common::Exception("GFF3: Struct section points outside stream");
 
-	_structs.reserve(_header.structCount);
-	for (uint32 i = 0; i < _header.structCount; i++)
-		_structs.push_back(new GFF3Struct(*this, _header.structOffset + i * kStructSize));
+	_structs.resize(_header.structCount, 0);
 }
 
-void GFF3File::loadLists() {
+void GFF3File::loadLists() const {
 	/* Read in the lists section of the GFF3.
 	 *
 	 * GFF3s store lists in a linear fashion, with the indices prefixes by
@@ -199,9 +253,9 @@ void GFF3File::loadLists() {
 	 * The first list contains struct indices 0 to 2, the second 3 to 7, the
 	 * third 8 and the fourth 9 and 10.
 	 *
-	 * For easy handling, we convert this list into an array of struct
-	 * pointer arrays, and a small array to convert from an index into this
-	 * list of lists into a list index.
+	 * For easy handling, we keep the raw list array, and a small array to
+	 * convert from an index into this list of lists into a list index. The
+	 * lists themselves are filled with struct pointers when they're needed.
 	 */
 
 	_stream->seek(_header.listIndicesOffset);
@@ -212,40 +266,28 @@ void GFF3File::loadLists() {
 	for (std::vector<uint32>::iterator it = rawLists.begin(); it != rawLists.end(); ++it)
 		*it = _stream->readUint32LE();
 
-	// Counting the actual amount of lists
+	// Counting the actual amount of lists, and checking the struct indices
 	uint32 listCount = 0;
-	for (size_t i = 0; i < rawLists.size(); i++) {
-		uint32 n = rawLists[i];
+	std::vector<uint32> listOffsetToIndex(rawLists.size(), 0xFFFFFFFF);
+
+	for (size_t i = 0; i < rawLists.size(); listCount++) {
+		listOffsetToIndex[i] = listCount;
 
+		const uint32 n = rawLists[i++];
 		if ((i + n) > rawLists.size())
 			throw Common::Exception("GFF3: List indices broken during counting");
 
-		i += n;
-		listCount++;
+		for (uint32 j = 0; j < n; j++, i++)
+			if (rawLists[i] >= _structs.size())
+				throw Common::Exception("GFF3: List struct index out of range (%u >= %u)",
+				                        (uint) rawLists[i], (uint) _structs.size());
 	}
 
 	_lists.resize(listCount);
-	_listOffsetToIndex.resize(rawLists.size(), 0xFFFFFFFF);
-
-	// Converting the raw list array into real, usable lists
-	uint32 listIndex = 0;
-	for (size_t i = 0; i < rawLists.size(); listIndex++) {
-		_listOffsetToIndex[i] = listIndex;
+	_listsLoaded.resize(listCount, false);
 
-		const uint32 n = rawLists[i++];
-		if ((i + n) > rawLists.size())
-			throw Common::Exception("GFF3: List indices broken during conversion");
-
-		_lists[listIndex].resize(n);
-		for (uint32 j = 0; j < n; j++, i++) {
-			const size_t structIndex = rawLists[i];
-			if (structIndex >= _structs.size())
-				throw Common::Exception("GFF3: List struct index out of range (%u >= %u)",
-				                        (uint) structIndex, (uint) _structs.size());
-
-			_lists[listIndex][j] = _structs[structIndex];
-		}
-	}
+	_listIndices.swap(rawLists);
+	_listOffsetToIndex.swap(listOffsetToIndex);
 }
 
 // --- Helpers for GFF3Struct ---
@@ -254,10 +296,18 @@ const GFF3Struct &GFF3File::getStruct(uint32 i) const {
 	if (i >= _structs.size())
 		throw Common::Exception("GFF3: Struct index out of range (%u >= %u)", i, (uint) _structs.size());
 
+	if (!_structs[i]) {
+		_structs[i] = new GFF3Struct(*this, _header.structOffset + i * kStructSize);
+		_loadedStructCount++;
+	}
+
 	return *_structs[i];
 }
 
 const GFF3List &GFF3File::getList(uint32 i) const {
+	if (_listOffsetToIndex.empty() && (_header.listIndicesCount >= 4))
+		loadLists();
+
 	if (i >= _listOffsetToIndex.size())
 		throw Common::Exception("GFF3: List offset index out of range (%u >= %u)",
 		                        i, (uint) _listOffsetToIndex.size());
@@ -269,7 +319,29 @@ const GFF3List &GFF3File::getList(uint32 i) const {
 
 	assert(listIndex < _lists.size());
 
-	return _lists[listIndex];
+	GFF3List &list = _lists[listIndex];
+	if (!_listsLoaded[listIndex]) {
+		const uint32 n = _listIndices[i];
+
+		GFF3List structs(n);
+		for (uint32 j = 0; j < n; j++)
+			structs[j] = &getStruct(_listIndices[i + 1 + j]);
+
+		list.swap(structs);
+		_listsLoaded[listIndex] = true;
+	}
+
+	return list;
+}
+
+const GFF3File::Label &GFF3File::getLabel(uint32 i) const {
+	if (_labels.empty() && (_header.labelCount > 0))
+		loadLabels();
+
+	if (i >= _labels.size())
+		throw Common::Exception("GFF3: Label index out of range (%u >= %u)", i, (uint) _labels.size());
+
+	return _labels[i];
 }
 
 Common::SeekableReadStream &GFF3File::getStream(uint32 offset) const {
@@ -283,10 +355,10 @@ Common::SeekableReadStream &GFF3File::getFieldData() const {
 }
 
 
-GFF3Struct::Field::Field() : type(kFieldTypeNone), data(0), extended(false) {
+GFF3Struct::Field::Field() : label(0xFFFFFFFF), hash(0), type(kFieldTypeNone), data(0), extended(false) {
 }
 
-GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
+GFF3Struct::Field::Field(uint32 l, uint32 h, FieldType t, uint32 d) : label(l), hash(h), type(t), data(d) {
 	// These field types need extended field data
 	extended = (type == kFieldTypeUint64     ) ||
 	           (type == kFieldTypeSint64     ) ||
@@ -301,7 +373,7 @@ GFF3Struct::Field::Field(FieldType t, uint32 d) : type(t), data(d) {
 }
 
 
-GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent) {
+GFF3Struct::GFF3Struct(const GFF3File &parent, uint32 offset) : _parent(&parent), _fieldsLoaded(false) {
 	load(offset);
 }
 
@@ -321,14 +393,36 @@ void GFF3Struct::load(uint32 offset) {
 	_fieldIndex = data.readUint32LE();
 	_fieldCount = data.readUint32LE();
 
-	// Read the field(s)
-	if      (_fieldCount == 1)
-		readField (data, _fieldIndex);
-	else if (_fieldCount > 1)
-		readFields(data, _fieldIndex, _fieldCount);
+	// Sanity checks. The fields themselves are only read when they're needed
+	if ((_fieldCount == 1) && (_fieldIndex > _parent->_header.fieldCount))
+		throw Common::Exception("GFF3: Field index out of range (%d/%d)",
+				_fieldIndex, _parent->_header.fieldCount);
+
+	if ((_fieldCount > 1) && (_fieldIndex > _parent->_header.fieldIndicesCount))
+		throw Common::Exception("GFF3: Field indices index out of range (%d/%d)",
+		                        _fieldIndex , _parent->_header.fieldIndicesCount);
+}
+
+void GFF3Struct::readFields(FieldArray &fields) const {
+	fields.reserve(_fieldCount);
+
+	if (_fieldCount == 1) {
+		readField(_parent->getStream(_parent->_header.fieldOffset), _fieldIndex, fields);
+		return;
+	}
+
+	Common::SeekableReadStream &data = _parent->getStream(_parent->_header.fieldIndicesOffset + _fieldIndex);
+
+	// Read the field indices
+	std::vector<uint32> indices;
+	readIndices(data, indices, _fieldCount);
+
+	// Read the fields
+	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
+		readField(data, *i, fields);
 }
 
-void GFF3Struct::readField(Common::SeekableReadStream &data, uint32 index) {
+void GFF3Struct::readField(Common::SeekableReadStream &data, uint32 index, FieldArray &fields) const {
 	// Sanity check
 	if (index > _parent->_header.fieldCount)
 		throw Common::Exception("GFF3: Field index out of range (%d/%d)",
@@ -342,31 +436,10 @@ void GFF3Struct::readField(Common::SeekableReadStream &data, uint32 index) {
 	const uint32 fieldLabel = data.readUint32LE();
 	const uint32 fieldData  = data.readUint32LE();
 
-	// Read the name
-	Common::UString fieldName = readLabel(data, fieldLabel);
-
-	// And add the field to the map and name list
-	_fields[fieldName] = Field((FieldType) fieldType, fieldData);
+	// Look up the interned label
+	const GFF3File::Label &label = _parent->getLabel(fieldLabel);
 
-	_fieldNames.push_back(fieldName);
-}
-
-void GFF3Struct::readFields(Common::SeekableReadStream &data, uint32 index, uint32 count) {
-	// Sanity check
-	if (index > _parent->_header.fieldIndicesCount)
-		throw Common::Exception("GFF3: Field indices index out of range (%d/%d)",
-		                        index , _parent->_header.fieldIndicesCount);
-
-	// Seek
-	data.seek(_parent->_header.fieldIndicesOffset + index);
-
-	// Read the field indices
-	std::vector<uint32> indices;
-	readIndices(data, indices, count);
-
-	// Read the fields
-	for (std::vector<uint32>::const_iterator i = indices.begin(); i != indices.end(); ++i)
-		readField(data, *i);
+	fields.push_back(Field(fieldLabel, label.hash, (FieldType) fieldType, fieldData));
 }
 
 void GFF3Struct::readIndices(Common::SeekableReadStream &data,
@@ -376,10 +449,40 @@ void GFF3Struct::readIndices(Common::SeekableReadStream &data,
 		indices.push_back(data.readUint32LE());
 }
 
-Common::UString GFF3Struct::readLabel(Common::SeekableReadStream &data, uint32 index) const {
-	data.seek(_parent->_header.labelOffset + index * 16);
+void GFF3Struct::loadFields() const {
+	if (_fieldsLoaded)
+		return;
+
+	FieldArray fields;
+	if (_fieldCount > 0)
+		readFields(fields);
+
+	/* Sort the fields by their label hashes, for a binary search. Fields with
+	 * the same hash are additionally sorted by name, and a stable sort keeps
+	 * fields with the same name in their original order. */
+
+	const GFF3File &parent = *_parent;
+	std::stable_sort(fields.begin(), fields.end(), [&parent](const Field &a, const Field &b) {
+		if (a.hash != b.hash)
+			return a.hash < b.hash;
 
-	return Common::readStringFixed(data, Common::kEncodingASCII, 16);
+		return parent.getLabel(a.label).name < parent.getLabel(b.label).name;
+	});
+
+	// If a label appears several times within a struct, the last field wins
+	_fields.reserve(fields.size());
+	for (FieldArray::const_iterator f = fields.begin(); f != fields.end(); ++f) {
+		if (!_fields.empty() && (_fields.back().hash == f->hash) &&
+		    (parent.getLabel(_fields.back().label).name == parent.getLabel(f->label).name)) {
+
+			_fields.back() = *f;
+			continue;
+		}
+
+		_fields.push_back(*f);
+	}
+
+	_fieldsLoaded = true;
 }
 
 Common::SeekableReadStream &GFF3Struct::getData(const Field &field) const {
@@ -394,18 +497,29 @@ Common::SeekableReadStream &GFF3Struct::getData(const Field &field) const {
 // --- Field properties ---
 
 size_t GFF3Struct::getFieldCount() const {
+	loadFields();
+
 	return _fields.size();
 }
 
-bool GFF3Struct::hasField(const Common::UString &field) const {
+bool GFF3Struct::hasField(const GFF3Label &field) const {
 	return getField(field) != 0;
 }
 
 const std::vector<Common::UString> &GFF3Struct::getFieldNames() const {
+	if (_fieldNames.empty() && (_fieldCount > 0)) {
+		FieldArray fields;
+		readFields(fields);
+
+		_fieldNames.reserve(fields.size());
+		for (FieldArray::const_iterator f = fields.begin(); f != fields.end(); ++f)
+			_fieldNames.push_back(_parent->getLabel(f->label).name);
+	}
+
 	return _fieldNames;
 }
 
-GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) const {
+GFF3Struct::FieldType GFF3Struct::getFieldType(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		return kFieldTypeNone;
@@ -415,15 +529,22 @@ GFF3Struct::FieldType GFF3Struct::getFieldType(const Common::UString &field) con
 
 // --- Field value reader helpers ---
 
-const GFF3Struct::Field *GFF3Struct::getField(const Common::UString &name) const {
-	FieldMap::const_iterator field = _fields.find(name);
-	if (field == _fields.end())
-		return 0;
+const GFF3Struct::Field *GFF3Struct::getField(const GFF3Label &label) const {
+	loadFields();
+
+	const uint32 hash = label.getHash();
+
+	FieldArray::const_iterator f = std::lower_bound(_fields.begin(), _fields.end(), hash,
+			[](const Field &field, uint32 h) { return field.hash < h; });
+
+	for (; (f != _fields.end()) && (f->hash == hash); ++f)
+		if (_parent->getLabel(f->label).name == label.getName())
+			return &*f;
 
-	return &field->second;
+	return 0;
 }
 
-char GFF3Struct::getChar(const Common::UString &field, char def) const {
+char GFF3Struct::getChar(const GFF3Label &field, char def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -433,7 +554,7 @@ char GFF3Struct::getChar(const Common::UString &field, char def) const {
 	return (char) f->data;
 }
 
-uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
+uint64 GFF3Struct::getUint(const GFF3Label &field, uint64 def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -470,7 +591,7 @@ uint64 GFF3Struct::getUint(const Common::UString &field, uint64 def) const {
 	throw Common::Exception("GFF3: Field is not an int type");
 }
 
-int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
+int64 GFF3Struct::getSint(const GFF3Label &field, int64 def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -507,11 +628,11 @@ int64 GFF3Struct::getSint(const Common::UString &field, int64 def) const {
 	throw Common::Exception("GFF3: Field is not an int type");
 }
 
-bool GFF3Struct::getBool(const Common::UString &field, bool def) const {
+bool GFF3Struct::getBool(const GFF3Label &field, bool def) const {
 	return getUint(field, def) != 0;
 }
 
-double GFF3Struct::getDouble(const Common::UString &field, double def) const {
+double GFF3Struct::getDouble(const GFF3Label &field, double def) const {
 	const Field *f = getField(field);
 	if (!f)
 		return def;
@@ -524,7 +645,7 @@ double GFF3Struct::getDouble(const Common::UString &field, double def) const {
 	throw Common::Exception("GFF3: Field is not a double type");
 }
 
-Common::UString GFF3Struct::getString(const Common::UString &field,
+Common::UString GFF3Struct::getString(const GFF3Label &field,
                                       const Common::UString &def) const {
 
 	const Field *f = getField(field);
@@ -611,7 +732,7 @@ Common::UString GFF3Struct::getString(const Common::UString &field,
 	throw Common::Exception("GFF3: Field is not a string(able) type");
 }
 
-bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) const {
+bool GFF3Struct::getLocString(const GFF3Label &field, LocString &str) const {
 	const Field *f = getField(field);
 	if (!f || (f->type != kFieldTypeLocString))
 		return false;
@@ -635,7 +756,7 @@ bool GFF3Struct::getLocString(const Common::UString &field, LocString &str) cons
 	return true;
 }
 
-Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) const {
+Common::SeekableReadStream *GFF3Struct::getData(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		return 0;
@@ -657,7 +778,7 @@ Common::SeekableReadStream *GFF3Struct::getData(const Common::UString &field) co
 	return data.readStream(size);
 }
 
-void GFF3Struct::getVector(const Common::UString &field,
+void GFF3Struct::getVector(const GFF3Label &field,
                            float &x, float &y, float &z) const {
 
 	const Field *f = getField(field);
@@ -673,7 +794,7 @@ void GFF3Struct::getVector(const Common::UString &field,
 	z = data.readIEEEFloatLE();
 }
 
-void GFF3Struct::getOrientation(const Common::UString &field,
+void GFF3Struct::getOrientation(const GFF3Label &field,
                                 float &a, float &b, float &c, float &d) const {
 
 	const Field *f = getField(field);
@@ -690,7 +811,7 @@ void GFF3Struct::getOrientation(const Common::UString &field,
 	d = data.readIEEEFloatLE();
 }
 
-void GFF3Struct::getVector(const Common::UString &field,
+void GFF3Struct::getVector(const GFF3Label &field,
                            double &x, double &y, double &z) const {
 
 	const Field *f = getField(field);
@@ -706,7 +827,7 @@ void GFF3Struct::getVector(const Common::UString &field,
 	z = data.readIEEEFloatLE();
 }
 
-void GFF3Struct::getOrientation(const Common::UString &field,
+void GFF3Struct::getOrientation(const GFF3Label &field,
                                 double &a, double &b, double &c, double &d) const {
 
 	const Field *f = getField(field);
@@ -725,7 +846,7 @@ void GFF3Struct::getOrientation(const Common::UString &field,
 
 // --- Struct reader ---
 
-const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
+const GFF3Struct &GFF3Struct::getStruct(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		throw Common::Exception("GFF3: No such field");
@@ -738,7 +859,7 @@ const GFF3Struct &GFF3Struct::getStruct(const Common::UString &field) const {
 
 // --- Struct list reader ---
 
-const GFF3List &GFF3Struct::getList(const Common::UString &field) const {
+const GFF3List &GFF3Struct::getList(const GFF3Label &field) const {
 	const Field *f = getField(field);
 	if (!f)
 		throw Common::Exception("GFF3: No such field");
@@ -47,6 +47,29 @@ namespace Aurora {
 class LocString;
 class GFF3Struct;
 
+/** The label of a field in a GFF3 struct, together with its hash.
+ *
+ *  All field accessors of GFF3Struct take a GFF3Label, which is implicitly
+ *  created from a string. Looking up a field then only needs to compare
+ *  hashes. Labels used over and over again, for example in a loop over a
+ *  long list, can be created once up front, so they're only hashed once.
+ */
+class GFF3Label {
+public:
+	GFF3Label(const char *name);
+	GFF3Label(const Common::UString &name);
+
+	const Common::UString &getName() const;
+	uint32 getHash() const;
+
+	/** Return the hash of this label name. */
+	static uint32 hash(const Common::UString &name);
+
+private:
+	Common::UString _name;
+	uint32 _hash;
+};
+
 /** A GFF (generic file format) V3.2/V3.3 file, found in all Aurora games
  *  except Sonic Chronicles: The Dark Brotherhood. Even games that have
  *  V4.0/V4.1 GFFs additionally use V3.2/V3.3 files as well.
@@ -79,6 +102,18 @@ class GFF3Struct;
  *  LocStrings is different. Since xoreos has more flexible handling of
  *  language IDs anyway, this doesn't concern us.
  *
+ *  Only the header is read when a GFF3 is opened. Structs are created once
+ *  they're first reached through getTopLevel(), GFF3Struct::getStruct() or
+ *  GFF3Struct::getList(), and a struct's fields are only read when one of
+ *  them is accessed. Callers that only look at a few fields don't pay for
+ *  the rest of the file. Broken data in the parts of the file that are
+ *  never accessed goes unnoticed.
+ *
+ *  Since these structs, lists and field labels are filled in lazily by
+ *  const methods, and since they all read from the same stream, a GFF3File
+ *  and its GFF3Structs must not be accessed from several threads at once,
+ *  not even through const references.
+ *
  *  See also: GFF4File in gff4file.h for the later V4.0/V4.1 versions of
  *  the GFF format.
  */
@@ -96,6 +131,11 @@ public:
 	/** Returns the top-level struct. */
 	const GFF3Struct &getTopLevel() const;
 
+	/** Return the number of structs in the GFF3. */
+	size_t getStructCount() const;
+	/** Return the number of structs that have been accessed, and so created, so far. */
+	size_t getLoadedStructCount() const;
+
 
 private:
 	/** A GFF3 header. */
@@ -118,8 +158,15 @@ private:
 		void read(Common::SeekableReadStream &gff3);
 	};
 
+	/** A field label, read once for the whole GFF3. */
+	struct Label {
+		Common::UString name; ///< The label's name.
+		uint32          hash; ///< The label's hash.
+	};
+
 	typedef Common::PtrVector<GFF3Struct> StructArray;
 	typedef std::vector<GFF3List> ListArray;
+	typedef std::vector<Label> LabelArray;
 
 
 	Common::ScopedPtr<Common::SeekableReadStream> _stream;
@@ -131,18 +178,30 @@ private:
 	/** The correctional value for offsets to repair Neverwinter Nights premium modules. */
 	uint32 _offsetCorrection;
 
-	StructArray _structs; ///< Our structs.
-	ListArray   _lists;   ///< Our lists.
-
+	/** Our structs, 0 until they're accessed for the first time. */
+	mutable StructArray _structs;
+	/** The number of structs that have been created. */
+	mutable size_t _loadedStructCount;
+
+	/** Our lists. Each list is only filled when it's accessed for the first time. */
+	mutable ListArray _lists;
+	/** Has the list been filled? */
+	mutable std::vector<bool> _listsLoaded;
+	/** The raw list indices, as found in the GFF3. */
+	mutable std::vector<uint32> _listIndices;
 	/** To convert list offsets found in GFF3 to real indices. */
-	std::vector<uint32> _listOffsetToIndex;
+	mutable std::vector<uint32> _listOffsetToIndex;
+
+	/** All field labels, indexed by the label IDs the fields use. Read when first needed. */
+	mutable LabelArray _labels;
 
 
 	// .--- Loading helpers
 	void load(uint32 id);
 	void loadHeader(uint32 id);
+	void loadLabels() const;
 	void loadStructs();
-	void loadLists();
+	void loadLists() const;
 	// '---
 
 	// .--- Helper methods called by GFF3Struct
@@ -155,6 +214,8 @@ private:
 	const GFF3Struct &getStruct(uint32 i) const;
 	/** Return a list within the GFF3. */
 	const GFF3List   &getList  (uint32 i) const;
+	/** Return a field label within the GFF3. */
+	const Label      &getLabel (uint32 i) const;
 	// '---
 
 	friend class GFF3Struct;
@@ -201,58 +262,61 @@ public:
 	/** Return the number of fields in this struct. */
 	size_t getFieldCount() const;
 	/** Does this specific field exist? */
-	bool hasField(const Common::UString &field) const;
+	bool hasField(const GFF3Label &field) const;
 
-	/** Return a list of all field names in this struct. */
+	/** Return a list of all field names in this struct, in the order they appear in the GFF3. */
 	const std::vector<Common::UString> &getFieldNames() const;
 
 	/** Return the type of this field, or kFieldTypeNone if such a field doesn't exist. */
-	FieldType getFieldType(const Common::UString &field) const;
+	FieldType getFieldType(const GFF3Label &field) const;
 
 
 	// .--- Read field values
-	char   getChar(const Common::UString &field, char   def = '\0' ) const;
-	uint64 getUint(const Common::UString &field, uint64 def = 0    ) const;
-	 int64 getSint(const Common::UString &field,  int64 def = 0    ) const;
-	bool   getBool(const Common::UString &field, bool   def = false) const;
+	char   getChar(const GFF3Label &field, char   def = '\0' ) const;
+	uint64 getUint(const GFF3Label &field, uint64 def = 0    ) const;
+	 int64 getSint(const GFF3Label &field,  int64 def = 0    ) const;
+	bool   getBool(const GFF3Label &field, bool   def = false) const;
 
-	double getDouble(const Common::UString &field, double def = 0.0) const;
+	double getDouble(const GFF3Label &field, double def = 0.0) const;
 
-	Common::UString getString(const Common::UString &field,
+	Common::UString getString(const GFF3Label &field,
 	                          const Common::UString &def = "") const;
 
-	bool getLocString(const Common::UString &field, LocString &str) const;
+	bool getLocString(const GFF3Label &field, LocString &str) const;
 
-	void getVector     (const Common::UString &field,
+	void getVector     (const GFF3Label &field,
 	                    float &x, float &y, float &z          ) const;
-	void getOrientation(const Common::UString &field,
+	void getOrientation(const GFF3Label &field,
 	                    float &a, float &b, float &c, float &d) const;
 
-	void getVector     (const Common::UString &field,
+	void getVector     (const GFF3Label &field,
 	                    double &x, double &y, double &z           ) const;
-	void getOrientation(const Common::UString &field,
+	void getOrientation(const GFF3Label &field,
 	                    double &a, double &b, double &c, double &d) const;
 
-	Common::SeekableReadStream *getData(const Common::UString &field) const;
+	Common::SeekableReadStream *getData(const GFF3Label &field) const;
 	// '---
 
 	// .--- Structs and lists of structs
-	const GFF3Struct &getStruct(const Common::UString &field) const;
-	const GFF3List   &getList  (const Common::UString &field) const;
+	const GFF3Struct &getStruct(const GFF3Label &field) const;
+	const GFF3List   &getList  (const GFF3Label &field) const;
 	// '---
 
 private:
 	/** A field in the GFF3 struct. */
 	struct Field {
+		uint32    label;    ///< ID of the field's label within the GFF3.
+		uint32    hash;     ///< Hash of the field's label.
 		FieldType type;     ///< Type of the field.
 		uint32    data;     ///< Data of the field.
 		bool      extended; ///< Does this field need extended data?
 
 		Field();
-		Field(FieldType t, uint32 d);
+		Field(uint32 l, uint32 h, FieldType t, uint32 d);
 	};
 
-	typedef std::map<Common::UString, Field> FieldMap;
+	/** The fields of a struct, sorted by the hashes of their labels. */
+	typedef std::vector<Field> FieldArray;
 
 
 	const GFF3File *_parent; ///< The parent GFF3.
@@ -261,10 +325,13 @@ private:
 	uint32 _fieldIndex; ///< Field / Field indices index.
 	uint32 _fieldCount; ///< Field count.
 
-	FieldMap _fields; ///< The fields, indexed by their label.
+	/** The fields, only read when one is accessed for the first time. */
+	mutable FieldArray _fields;
+	/** Have the fields been read? */
+	mutable bool _fieldsLoaded;
 
-	/** The names of all fields in this struct. */
-	std::vector<Common::UString> _fieldNames;
+	/** The names of all fields in this struct, only created when requested. */
+	mutable std::vector<Common::UString> _fieldNames;
 
 
 	// .--- Loader
@@ -273,17 +340,19 @@ private:
 
 	void load(uint32 offset);
 
-	void readField  (Common::SeekableReadStream &data, uint32 index);
-	void readFields (Common::SeekableReadStream &data, uint32 index, uint32 count);
+	/** Read the fields, in the order they appear in the GFF3. */
+	void readFields (FieldArray &fields) const;
+	void readField  (Common::SeekableReadStream &data, uint32 index, FieldArray &fields) const;
 	void readIndices(Common::SeekableReadStream &data,
 	                 std::vector<uint32> &indices, uint32 count) const;
 
-	Common::UString readLabel(Common::SeekableReadStream &data, uint32 index) const;
+	/** Read and sort the fields, if that hasn't happened yet. */
+	void loadFields() const;
 	// '---
 
 	// .--- Field and field data accessors
-	/** Returns the field with this tag. */
-	const Field *getField(const Common::UString &name) const;
+	/** Returns the field with this label. */
+	const Field *getField(const GFF3Label &label) const;
 	/** Returns the extended field data for this field. */
 	Common::SeekableReadStream &getData(const Field &field) const;
 	// '---
@@ -27,13 +27,17 @@
  */
 
 #include <cassert>
+#include <cstring>
+#include <algorithm>
 
 #include "external/glm/gtc/type_ptr.hpp"
 
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/memreadstream.h"
 #include "src/common/encoding.h"
 #include "src/common/strutil.h"
+#include "src/common/util.h"
 
 #include "src/aurora/gff4file.h"
 #include "src/aurora/util.h"
@@ -75,9 +79,67 @@ bool GFF4File::Header::isBigEndian() const {
 	return (platformID == kPlatformPS3) || (platformID == kPlatformXbox360);
 }
 
+const uint32 GFF4File::StructTemplate::kNoField;
+
+void GFF4File::StructTemplate::createLabelTable() {
+	labelTable.clear();
+	sortedLabels.clear();
+
+	minLabel = 0;
+	if (fields.empty())
+		return;
+
+	uint32 maxLabel = fields[0].label;
+
+	minLabel = fields[0].label;
+	for (std::vector<Field>::const_iterator f = fields.begin(); f != fields.end(); ++f) {
+		minLabel = MIN(minLabel, f->label);
+		maxLabel = MAX(maxLabel, f->label);
+	}
+
+	/* Field labels within one struct are usually close together, so a direct
+	 * table indexed by the label is small. Otherwise, fall back to a binary
+	 * search. For duplicate labels, the last field wins either way. */
+
+	const uint64 range = (uint64) maxLabel - minLabel + 1;
+	if (range <= (4 * fields.size() + 64)) {
+		labelTable.resize(range, kNoField);
+
+		for (size_t i = 0; i < fields.size(); i++)
+			labelTable[fields[i].label - minLabel] = i;
+
+		return;
+	}
+
+	sortedLabels.reserve(fields.size());
+	for (size_t i = 0; i < fields.size(); i++)
+		sortedLabels.push_back(std::make_pair(fields[i].label, (uint32) i));
+
+	std::sort(sortedLabels.begin(), sortedLabels.end());
+}
+
+uint32 GFF4File::StructTemplate::findField(uint32 fieldLabel) const {
+	if (!labelTable.empty()) {
+		if ((fieldLabel < minLabel) || ((fieldLabel - minLabel) >= labelTable.size()))
+			return kNoField;
+
+		return labelTable[fieldLabel - minLabel];
+	}
+
+	// Find the last entry with this label
+	std::vector< std::pair<uint32, uint32> >::const_iterator l =
+		std::upper_bound(sortedLabels.begin(), sortedLabels.end(), fieldLabel,
+		                 [](uint32 x, const std::pair<uint32, uint32> &y) { return x < y.first; });
+
+	if ((l == sortedLabels.begin()) || ((--l)->first != fieldLabel))
+		return kNoField;
+
+	return l->second;
+}
+
 
 GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type) :
-	_origStream(gff4), _topLevelStruct(0) {
+	_origStream(gff4), _data(0), _dataSize(0), _topLevelStruct(0) {
 
 	assert(_origStream);
 
@@ -85,7 +147,7 @@ GFF4File::GFF4File(Common::SeekableReadStream *gff4, uint32 type) :
 }
 
 GFF4File::GFF4File(const Common::UString &gff4, FileType fileType, uint32 type) :
-	_topLevelStruct(0) {
+	_data(0), _dataSize(0), _topLevelStruct(0) {
 
 	_origStream.reset(ResMan.getResource(gff4, fileType));
 	if (!_origStream)
@@ -102,6 +164,9 @@ void GFF4File::clear() {
 	_origStream.reset();
 	_stream.reset();
 
+	_data     = 0;
+	_dataSize = 0;
+
 	for (StructMap::iterator s = _structs.begin(); s != _structs.end(); ++s)
 		delete s->second;
 
@@ -143,6 +208,7 @@ const GFF4Struct &GFF4File::getTopLevel() const {
 void GFF4File::load(uint32 type) {
 	try {
 
+		loadData();
 		loadHeader(type);
 		loadStructs();
 		loadStrings();
@@ -155,6 +221,26 @@ void GFF4File::load(uint32 type) {
 	}
 }
 
+void GFF4File::loadData() {
+	/* Field values are decoded straight out of memory, so we need the
+	 * whole file in one contiguous block. Resources usually come as a
+	 * MemoryReadStream already. If not, read the file into one. */
+
+	Common::MemoryReadStream *memStream = dynamic_cast<Common::MemoryReadStream *>(_origStream.get());
+	if (!memStream) {
+		const size_t pos = _origStream->pos();
+
+		_origStream->seek(0);
+		memStream = _origStream->readStream(_origStream->size());
+
+		_origStream.reset(memStream);
+		_origStream->seek(pos);
+	}
+
+	_data     = memStream->getData();
+	_dataSize = memStream->size();
+}
+
 void GFF4File::loadHeader(uint32 type) {
 	readHeader(*_origStream);
 
@@ -234,6 +320,8 @@ void GFF4File::loadStructs() {
 
 			field.offset = _stream->readUint32();
 		}
+
+		strct.createLabelTable();
 	}
 
 	/* And load the top level struct, which itself recurses into field structs.
@@ -297,6 +385,14 @@ Common::SeekableSubReadStreamEndian &GFF4File::getStream(uint32 offset) const {
 	return *_stream;
 }
 
+const byte *GFF4File::getData(uint32 offset, uint64 size) const {
+	if ((offset > _dataSize) || (size > (_dataSize - offset)))
+		throw Common::Exception("GFF4: Data out of range (%u, %u, %u)",
+		                        offset, (uint) size, (uint) _dataSize);
+
+	return _data + offset;
+}
+
 uint32 GFF4File::getDataOffset() const {
 	return _header.dataOffset;
 }
@@ -364,7 +460,7 @@ GFF4Struct::Field::Field(uint32 l, uint16 t, uint16 f, uint32 o, bool g) :
 
 
 GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTemplate &tmplt) :
-	_parent(&parent), _label(tmplt.label), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _template(&tmplt), _label(tmplt.label), _refCount(0), _fieldCount(0) {
 
 	// Constructor for a real struct, from a template
 
@@ -380,7 +476,7 @@ GFF4Struct::GFF4Struct(GFF4File &parent, uint32 offset, const GFF4File::StructTe
 }
 
 GFF4Struct::GFF4Struct(GFF4File &parent, const Field &genericParent) :
-	_parent(&parent), _label(0), _refCount(0), _fieldCount(0) {
+	_parent(&parent), _template(0), _label(0), _refCount(0), _fieldCount(0) {
 
 	// Constructor for a generic, converted into a struct
 
@@ -420,6 +516,9 @@ void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTem
 	 * a struct, recursively create a new struct instance for it. If
 	 * the field is a generic, create a struct for it as well. */
 
+	_fields.resize(tmplt.fields.size());
+	_fieldLabels.reserve(tmplt.fields.size());
+
 	for (size_t i = 0; i < tmplt.fields.size(); i++) {
 		const GFF4File::StructTemplate::Field &field = tmplt.fields[i];
 
@@ -431,7 +530,7 @@ void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTem
 			fieldOffset = 0xFFFFFFFF;
 
 		// Load the field and its struct(s), if any
-		Field &f = _fields[field.label] = Field(field.label, field.type, field.flags, fieldOffset);
+		Field &f = _fields[i] = Field(field.label, field.type, field.flags, fieldOffset);
 		if (f.type == kFieldTypeStruct)
 			loadStructs(parent, f);
 		if (f.type == kFieldTypeGeneric)
@@ -441,7 +540,11 @@ void GFF4Struct::load(GFF4File &parent, uint32 offset, const GFF4File::StructTem
 			throw Common::Exception("GFF4: TODO: ASCII string field in a file with shared strings");
 	}
 
-	_fieldCount = _fields.size();
+	// Duplicate labels count only once
+	_fieldCount = 0;
+	for (size_t i = 0; i < tmplt.fields.size(); i++)
+		if (tmplt.findField(tmplt.fields[i].label) == i)
+			_fieldCount++;
 }
 
 void GFF4Struct::loadStructs(GFF4File &parent, Field &field) {
@@ -517,6 +620,10 @@ void GFF4Struct::load(GFF4File &parent, const Field &genericParent) {
 	const uint32 genericCount = genericParent.isList ? data.readUint32() : 1;
 	const uint32 genericStart = data.pos();
 
+	// Make sure the count is sane before we make room for all the fields
+	parent.getData(genericStart, (uint64) genericCount * kGenericSize);
+	_fields.resize(genericCount);
+
 	for (uint32 i = 0; i < genericCount; i++) {
 		data.seek(genericStart + i * kGenericSize);
 
@@ -600,20 +707,27 @@ bool GFF4Struct::getFieldProperties(uint32 field, FieldType &type, uint32 &label
 // --- Field value reader helpers ---
 
 const GFF4Struct::Field *GFF4Struct::getField(uint32 field) const {
-	FieldMap::const_iterator f = _fields.find(field);
-	if (f == _fields.end())
+	// Fields of a real struct are found through the template's label table
+	if (_template) {
+		const uint32 index = _template->findField(field);
+		if (index == GFF4File::StructTemplate::kNoField)
+			return 0;
+
+		return &_fields[index];
+	}
+
+	// Fields of a generic are labeled by their index, but might be missing
+	if ((field >= _fields.size()) || (_fields[field].type == kFieldTypeNone))
 		return 0;
 
-	return &f->second;
+	return &_fields[field];
 }
 
 uint32 GFF4Struct::getDataOffset(bool isReference, uint32 offset) const {
 	if (!isReference || (offset == 0xFFFFFFFF))
 		return offset;
 
-	Common::SeekableSubReadStreamEndian &data = _parent->getStream(offset);
-
-	offset = data.readUint32();
+	offset = readUint32(_parent->getData(offset, 4));
 	if (offset == 0xFFFFFFFF)
 		return offset;
 
@@ -642,6 +756,33 @@ Common::SeekableSubReadStreamEndian *GFF4Struct::getField(uint32 fieldID, const
 	return getData(*field);
 }
 
+const byte *GFF4Struct::getFieldData(uint32 fieldID, const Field *&field, uint32 &count) const {
+	if (!(field = getField(fieldID)))
+		return 0;
+
+	uint32 offset = getDataOffset(*field);
+	if (offset == 0xFFFFFFFF)
+		return 0;
+
+	count = 1;
+	if (field->isList) {
+		const byte *listPointer = _parent->getData(offset, 4);
+
+		const uint32 listOffset = readUint32(listPointer);
+		if (listOffset == 0xFFFFFFFF) {
+			count = 0;
+			return listPointer;
+		}
+
+		offset = _parent->getDataOffset() + listOffset;
+
+		count   = readUint32(_parent->getData(offset, 4));
+		offset += 4;
+	}
+
+	return _parent->getData(offset, (uint64) count * getFieldSize(field->type));
+}
+
 uint32 GFF4Struct::getVectorMatrixLength(const Field &field, uint32 minLength, uint32 maxLength) const {
 	uint32 length;
 	if       (field.type == kFieldTypeVector3f)
@@ -689,6 +830,7 @@ uint32 GFF4Struct::getFieldSize(FieldType type) const {
 		case kFieldTypeUint32:
 		case kFieldTypeSint32:
 		case kFieldTypeFloat32:
+		case kFieldTypeNDSFixed:
 			return 4;
 
 		case kFieldTypeUint64:
@@ -727,64 +869,43 @@ uint32 GFF4Struct::getFieldSize(FieldType type) const {
 
 // --- Low-level value readers ---
 
-uint64 GFF4Struct::getUint(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
-	switch (type) {
-		case kFieldTypeUint8:
-			return (uint64) data.readByte();
-
-		case kFieldTypeSint8:
-			return (uint64) ((int64) data.readSByte());
-
-		case kFieldTypeUint16:
-			return (uint64) data.readUint16();
-
-		case kFieldTypeSint16:
-			return (uint64) ((int64) data.readSint16());
-
-		case kFieldTypeUint32:
-			return (uint64) data.readUint32();
-
-		case kFieldTypeSint32:
-			return (uint64) ((int64) data.readSint32());
-
-		case kFieldTypeUint64:
-			return (uint64) data.readUint64();
-
-		case kFieldTypeSint64:
-			return (uint64) ((int64) data.readSint64());
-
-		default:
-			break;
-	}
+bool GFF4Struct::isNativeEndian() const {
+#if defined(XOREOS_LITTLE_ENDIAN)
+	return !_parent->isBigEndian();
+#else
+	return  _parent->isBigEndian();
+#endif
+}
 
-	throw Common::Exception("GFF4: Field is not an int type");
+uint32 GFF4Struct::readUint32(const byte *data) const {
+	return _parent->isBigEndian() ? READ_BE_UINT32(data) : READ_LE_UINT32(data);
 }
 
-int64 GFF4Struct::getSint(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
+uint64 GFF4Struct::getUint(const byte *data, FieldType type) const {
+	const bool bigEndian = _parent->isBigEndian();
+
 	switch (type) {
 		case kFieldTypeUint8:
-			return (int64) ((uint64) data.readByte());
+			return (uint64) *data;
 
 		case kFieldTypeSint8:
-			return (int64) data.readSByte();
+			return (uint64) ((int64) ((int8) *data));
 
 		case kFieldTypeUint16:
-			return (int64) ((uint64) data.readUint16());
+			return (uint64) (bigEndian ? READ_BE_UINT16(data) : READ_LE_UINT16(data));
 
 		case kFieldTypeSint16:
-			return (int64) data.readSint16();
+			return (uint64) ((int64) ((int16) (bigEndian ? READ_BE_UINT16(data) : READ_LE_UINT16(data))));
 
 		case kFieldTypeUint32:
-			return (int64) ((uint64) data.readUint32());
+			return (uint64) readUint32(data);
 
 		case kFieldTypeSint32:
-			return (int64) data.readSint32();
+			return (uint64) ((int64) ((int32) readUint32(data)));
 
 		case kFieldTypeUint64:
-			return (int64) ((uint64) data.readUint64());
-
 		case kFieldTypeSint64:
-			return (int64) data.readSint64();
+			return bigEndian ? READ_BE_UINT64(data) : READ_LE_UINT64(data);
 
 		default:
 			break;
@@ -793,16 +914,21 @@ int64 GFF4Struct::getSint(Common::SeekableSubReadStreamEndian &data, FieldType t
 	throw Common::Exception("GFF4: Field is not an int type");
 }
 
-double GFF4Struct::getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
+int64 GFF4Struct::getSint(const byte *data, FieldType type) const {
+	// getUint() already sign-extends the signed types
+	return (int64) getUint(data, type);
+}
+
+double GFF4Struct::getDouble(const byte *data, FieldType type) const {
 	switch (type) {
 		case kFieldTypeFloat32:
-			return (double) data.readIEEEFloat();
+			return (double) convertIEEEFloat(readUint32(data));
 
 		case kFieldTypeFloat64:
-			return (double) data.readIEEEDouble();
+			return convertIEEEDouble(_parent->isBigEndian() ? READ_BE_UINT64(data) : READ_LE_UINT64(data));
 
 		case kFieldTypeNDSFixed:
-			return readNintendoFixedPoint(data.readUint32(), true, 19, 12);
+			return readNintendoFixedPoint(readUint32(data), true, 19, 12);
 
 		default:
 			break;
@@ -811,22 +937,11 @@ double GFF4Struct::getDouble(Common::SeekableSubReadStreamEndian &data, FieldTyp
 	throw Common::Exception("GFF4: Field is not a float type");
 }
 
-float GFF4Struct::getFloat(Common::SeekableSubReadStreamEndian &data, FieldType type) const {
-	switch (type) {
-		case kFieldTypeFloat32:
-			return (float) data.readIEEEFloat();
+float GFF4Struct::getFloat(const byte *data, FieldType type) const {
+	if (type == kFieldTypeFloat32)
+		return convertIEEEFloat(readUint32(data));
 
-		case kFieldTypeFloat64:
-			return (float) data.readIEEEDouble();
-
-		case kFieldTypeNDSFixed:
-			return (float) readNintendoFixedPoint(data.readUint32(), true, 19, 12);
-
-		default:
-			break;
-	}
-
-	throw Common::Exception("GFF4: Field is not a float type");
+	return (float) getDouble(data, type);
 }
 
 Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding) const {
@@ -888,26 +1003,28 @@ Common::UString GFF4Struct::getString(Common::SeekableSubReadStreamEndian &data,
 
 uint64 GFF4Struct::getUint(uint32 field, uint64 def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getUint(*data, f->type);
+	return getUint(data, f->type);
 }
 
 int64 GFF4Struct::getSint(uint32 field, int64 def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getSint(*data, f->type);
+	return getSint(data, f->type);
 }
 
 bool GFF4Struct::getBool(uint32 field, bool def) const {
@@ -916,26 +1033,28 @@ bool GFF4Struct::getBool(uint32 field, bool def) const {
 
 double GFF4Struct::getDouble(uint32 field, double def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getDouble(*data, f->type);
+	return getDouble(data, f->type);
 }
 
 float GFF4Struct::getFloat(uint32 field, float def) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return def;
 
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	return getFloat(*data, f->type);
+	return getFloat(data, f->type);
 }
 
 Common::UString GFF4Struct::getString(uint32 field, Common::Encoding encoding,
@@ -969,9 +1088,9 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 	if (f->isList)
 		throw Common::Exception("GFF4: Tried reading list as singular value");
 
-	strRef = getUint(*data, kFieldTypeUint32);
+	strRef = data->readUint32();
 
-	const uint32 offset = getUint(*data, kFieldTypeUint32);
+	const uint32 offset = data->readUint32();
 
 	str.clear();
 	if (offset != 0xFFFFFFFF) {
@@ -990,7 +1109,8 @@ bool GFF4Struct::getTalkString(uint32 field, uint32 &strRef, Common::UString &st
 
 bool GFF4Struct::getVector3(uint32 field, double &v1, double &v2, double &v3) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -999,16 +1119,17 @@ bool GFF4Struct::getVector3(uint32 field, double &v1, double &v2, double &v3) co
 
 	getVectorMatrixLength(*f, 3, 3);
 
-	v1 = getDouble(*data, kFieldTypeFloat32);
-	v2 = getDouble(*data, kFieldTypeFloat32);
-	v3 = getDouble(*data, kFieldTypeFloat32);
+	v1 = getDouble(data +  0, kFieldTypeFloat32);
+	v2 = getDouble(data +  4, kFieldTypeFloat32);
+	v3 = getDouble(data +  8, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector3(uint32 field, float &v1, float &v2, float &v3) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1017,16 +1138,17 @@ bool GFF4Struct::getVector3(uint32 field, float &v1, float &v2, float &v3) const
 
 	getVectorMatrixLength(*f, 3, 3);
 
-	v1 = getFloat(*data, kFieldTypeFloat32);
-	v2 = getFloat(*data, kFieldTypeFloat32);
-	v3 = getFloat(*data, kFieldTypeFloat32);
+	v1 = getFloat(data +  0, kFieldTypeFloat32);
+	v2 = getFloat(data +  4, kFieldTypeFloat32);
+	v3 = getFloat(data +  8, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector4(uint32 field, double &v1, double &v2, double &v3, double &v4) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1035,17 +1157,18 @@ bool GFF4Struct::getVector4(uint32 field, double &v1, double &v2, double &v3, do
 
 	getVectorMatrixLength(*f, 4, 4);
 
-	v1 = getDouble(*data, kFieldTypeFloat32);
-	v2 = getDouble(*data, kFieldTypeFloat32);
-	v3 = getDouble(*data, kFieldTypeFloat32);
-	v4 = getDouble(*data, kFieldTypeFloat32);
+	v1 = getDouble(data +  0, kFieldTypeFloat32);
+	v2 = getDouble(data +  4, kFieldTypeFloat32);
+	v3 = getDouble(data +  8, kFieldTypeFloat32);
+	v4 = getDouble(data + 12, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVector4(uint32 field, float &v1, float &v2, float &v3, float &v4) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1054,17 +1177,18 @@ bool GFF4Struct::getVector4(uint32 field, float &v1, float &v2, float &v3, float
 
 	getVectorMatrixLength(*f, 4, 4);
 
-	v1 = getFloat(*data, kFieldTypeFloat32);
-	v2 = getFloat(*data, kFieldTypeFloat32);
-	v3 = getFloat(*data, kFieldTypeFloat32);
-	v4 = getFloat(*data, kFieldTypeFloat32);
+	v1 = getFloat(data +  0, kFieldTypeFloat32);
+	v2 = getFloat(data +  4, kFieldTypeFloat32);
+	v3 = getFloat(data +  8, kFieldTypeFloat32);
+	v4 = getFloat(data + 12, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getMatrix4x4(uint32 field, double (&m)[16]) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1073,14 +1197,15 @@ bool GFF4Struct::getMatrix4x4(uint32 field, double (&m)[16]) const {
 
 	const uint32 length = getVectorMatrixLength(*f, 16, 16);
 	for (uint32 i = 0; i < length; i++)
-		m[i] = getDouble(*data, kFieldTypeFloat32);
+		m[i] = getDouble(data + i * 4, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getMatrix4x4(uint32 field, float (&m)[16]) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1089,7 +1214,7 @@ bool GFF4Struct::getMatrix4x4(uint32 field, float (&m)[16]) const {
 
 	const uint32 length = getVectorMatrixLength(*f, 16, 16);
 	for (uint32 i = 0; i < length; i++)
-		m[i] = getFloat(*data, kFieldTypeFloat32);
+		m[i] = getFloat(data + i * 4, kFieldTypeFloat32);
 
 	return true;
 }
@@ -1105,7 +1230,8 @@ bool GFF4Struct::getMatrix4x4(uint32 field, glm::mat4 &m) const {
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1116,14 +1242,15 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<double> &vectorMatrix
 
 	vectorMatrix.resize(length);
 	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getDouble(*data, kFieldTypeFloat32);
+		vectorMatrix[i] = getDouble(data + i * 4, kFieldTypeFloat32);
 
 	return true;
 }
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
@@ -1134,7 +1261,7 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix)
 
 	vectorMatrix.resize(length);
 	for (uint32 i = 0; i < length; i++)
-		vectorMatrix[i] = getFloat(*data, kFieldTypeFloat32);
+		vectorMatrix[i] = getFloat(data + i * 4, kFieldTypeFloat32);
 
 	return true;
 }
@@ -1143,75 +1270,80 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector<float> &vectorMatrix)
 
 bool GFF4Struct::getUint(uint32 field, std::vector<uint64> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size = getFieldSize(f->type);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type);
+		list[i] = getUint(data + i * size, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getSint(uint32 field, std::vector<int64> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size = getFieldSize(f->type);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getSint(*data, f->type);
+		list[i] = getSint(data + i * size, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getBool(uint32 field, std::vector<bool> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size = getFieldSize(f->type);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getUint(*data, f->type) != 0;
+		list[i] = getUint(data + i * size, f->type) != 0;
 
 	return true;
 }
 
 bool GFF4Struct::getDouble(uint32 field, std::vector<double> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size = getFieldSize(f->type);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getDouble(*data, f->type);
+		list[i] = getDouble(data + i * size, f->type);
 
 	return true;
 }
 
 bool GFF4Struct::getFloat(uint32 field, std::vector<float> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
-	const uint32 count = getListCount(*data, *f);
+	const uint32 size = getFieldSize(f->type);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++)
-		list[i] = getFloat(*data, f->type);
+		list[i] = getFloat(data + i * size, f->type);
 
 	return true;
 }
@@ -1264,9 +1396,9 @@ bool GFF4Struct::getTalkString(uint32 field, Common::Encoding encoding,
 	offsets.resize(count);
 
 	for (uint32 i = 0; i < count; i++) {
-		strRefs[i] = getUint(*data, kFieldTypeUint32);
+		strRefs[i] = data->readUint32();
 
-		const uint32 offset = getUint(*data, kFieldTypeUint32);
+		const uint32 offset = data->readUint32();
 
 		if (offset != 0xFFFFFFFF) {
 			if (_parent->hasSharedStrings())
@@ -1287,19 +1419,20 @@ bool GFF4Struct::getTalkString(uint32 field,
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<double> > &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
+		const byte *element = data + i * length * 4;
 
 		list[i].resize(length);
 		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getDouble(*data, kFieldTypeFloat32);
+			list[i][j] = getDouble(element + j * 4, kFieldTypeFloat32);
 	}
 
 	return true;
@@ -1307,19 +1440,20 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<double>
 
 bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<float> > &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
+		const byte *element = data + i * length * 4;
 
 		list[i].resize(length);
 		for (uint32 j = 0; j < length; j++)
-			list[i][j] = getFloat(*data, kFieldTypeFloat32);
+			list[i][j] = getFloat(element + j * 4, kFieldTypeFloat32);
 	}
 
 	return true;
@@ -1327,19 +1461,19 @@ bool GFF4Struct::getVectorMatrix(uint32 field, std::vector< std::vector<float> >
 
 bool GFF4Struct::getMatrix4x4(uint32 field, std::vector<glm::mat4> &list) const {
 	const Field *f;
-	Common::SeekableSubReadStreamEndian *data = getField(field, f);
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
 	if (!data)
 		return false;
 
 	const uint32 length = getVectorMatrixLength(*f, 0, 16);
-	const uint32 count  = getListCount(*data, *f);
 
 	list.resize(count);
 	for (uint32 i = 0; i < count; i++) {
-		float m[16];
+		float m[16] = { 0.0f };
 
 		for (uint32 j = 0; j < length; j++)
-			m[j] = getFloat(*data, kFieldTypeFloat32);
+			m[j] = getFloat(data + (i * length + j) * 4, kFieldTypeFloat32);
 
 		list[i] = glm::make_mat4(m);
 	}
@@ -1347,6 +1481,105 @@ bool GFF4Struct::getMatrix4x4(uint32 field, std::vector<glm::mat4> &list) const
 	return true;
 }
 
+// --- Bulk value readers ---
+
+uint32 GFF4Struct::getValueLength(const Field &field) const {
+	switch (field.type) {
+		case kFieldTypeVector3f:
+			return 3;
+
+		case kFieldTypeVector4f:
+		case kFieldTypeQuaternionf:
+		case kFieldTypeColor4f:
+			return 4;
+
+		case kFieldTypeMatrix4x4f:
+			return 16;
+
+		default:
+			break;
+	}
+
+	return 1;
+}
+
+size_t GFF4Struct::getValueCount(uint32 field) const {
+	const Field *f;
+	uint32 count;
+	if (!getFieldData(field, f, count))
+		return 0;
+
+	return (size_t) count * getValueLength(*f);
+}
+
+size_t GFF4Struct::getFloat(uint32 field, float *values, size_t maxCount) const {
+	const Field *f;
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
+	if (!data)
+		return 0;
+
+	// Vectors and matrices consist of 32-bit floats
+	const uint32    length = getValueLength(*f);
+	const FieldType type   = (length > 1) ? kFieldTypeFloat32 : f->type;
+	const uint32    size   = (length > 1) ? 4 : getFieldSize(type);
+
+	if ((type != kFieldTypeFloat32) && (type != kFieldTypeFloat64) && (type != kFieldTypeNDSFixed))
+		throw Common::Exception("GFF4: Field is not a float type");
+
+	const size_t total = MIN<size_t>((size_t) count * length, maxCount);
+
+	if (type == kFieldTypeFloat32) {
+		// With matching endianness, we can take the floats as they are
+		if (isNativeEndian()) {
+			std::memcpy(values, data, total * 4);
+			return total;
+		}
+
+		for (size_t i = 0; i < total; i++, data += 4)
+			values[i] = convertIEEEFloat(readUint32(data));
+
+		return total;
+	}
+
+	for (size_t i = 0; i < total; i++, data += size)
+		values[i] = getFloat(data, type);
+
+	return total;
+}
+
+size_t GFF4Struct::getUint(uint32 field, uint32 *values, size_t maxCount) const {
+	const Field *f;
+	uint32 count;
+	const byte *data = getFieldData(field, f, count);
+	if (!data)
+		return 0;
+
+	// Don't silently cut off the upper half of 64-bit values
+	if ((f->type == kFieldTypeUint64) || (f->type == kFieldTypeSint64))
+		throw Common::Exception("GFF4: Field is a 64-bit int type");
+
+	const uint32 size  = getFieldSize(f->type);
+	const size_t total = MIN<size_t>(count, maxCount);
+
+	if ((f->type == kFieldTypeUint32) || (f->type == kFieldTypeSint32)) {
+		if (isNativeEndian()) {
+			std::memcpy(values, data, total * 4);
+			return total;
+		}
+
+		for (size_t i = 0; i < total; i++, data += 4)
+			values[i] = readUint32(data);
+
+		return total;
+	}
+
+	for (size_t i = 0; i < total; i++, data += size)
+		values[i] = (uint32) getUint(data, f->type);
+
+	return total;
+}
+
 // --- Struct reader ---
 
 const GFF4Struct *GFF4Struct::getStruct(uint32 field) const {
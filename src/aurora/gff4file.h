@@ -77,6 +77,13 @@ class GFF4Struct;
  *  reference a string within this table, so that duplicated strings don't
  *  need to be stored multiple times.
  *
+ *  The whole file is kept in memory, and field values are decoded straight
+ *  out of it. Each struct template carries a table mapping field labels to
+ *  fields, built once when the file is loaded, so that finding a field in a
+ *  struct doesn't need a search. For large amounts of float or integer data,
+ *  like vertices or animation keys, GFF4Struct can read whole lists at once
+ *  into a caller-provided array.
+ *
  *  Notes:
  *  - Generics and lists of generics are mapped to structs, with the field ID
  *    being the list element indices (or just 0 on non-list generics).
@@ -151,6 +158,25 @@ private:
 		uint32 size;
 
 		std::vector<Field> fields;
+
+		/** Field indices, by label, when the labels are close enough together.
+		 *
+		 *  labelTable[label - minLabel] is the index of the field with that
+		 *  label, or kNoField if there is none.
+		 */
+		std::vector<uint32> labelTable;
+		uint32 minLabel;
+
+		/** The labels together with their field indices, sorted by label.
+		 *  Used when the labels are too far apart for a labelTable. */
+		std::vector< std::pair<uint32, uint32> > sortedLabels;
+
+		static const uint32 kNoField = 0xFFFFFFFF;
+
+		/** Build the label lookup tables. */
+		void createLabelTable();
+		/** Return the index of the field with this label, or kNoField. */
+		uint32 findField(uint32 fieldLabel) const;
 	};
 
 	typedef std::vector<StructTemplate> StructTemplates;
@@ -162,6 +188,10 @@ private:
 	Common::ScopedPtr<Common::SeekableReadStream> _origStream;
 	Common::ScopedPtr<Common::SeekableSubReadStreamEndian> _stream;
 
+	/** The whole GFF4 file, as one block of memory, owned by _origStream. */
+	const byte *_data;
+	size_t      _dataSize;
+
 	/** This GFF4's header. */
 	Header          _header;
 	/** All struct templates in this GFF4. */
@@ -178,6 +208,7 @@ private:
 
 	// .--- Loading helpers
 	void load(uint32 type);
+	void loadData();
 	void loadHeader(uint32 type);
 	void loadStructs();
 	void loadStrings();
@@ -191,6 +222,7 @@ private:
 	GFF4Struct *findStruct(uint64 id);
 
 	Common::SeekableSubReadStreamEndian &getStream(uint32 offset) const;
+	const byte *getData(uint32 offset, uint64 size) const;
 	const StructTemplate &getStructTemplate(uint32 i) const;
 	uint32 getDataOffset() const;
 
@@ -337,6 +369,41 @@ public:
 	bool getMatrix4x4(uint32 field, std::vector<glm::mat4> &list) const;
 	// '---
 
+	// .--- Bulk values
+	/** Return the number of values in a field, or 0 if it has no data.
+	 *
+	 *  For vector and matrix types, this counts every single float. For
+	 *  lists, the values of all elements are added together.
+	 */
+	size_t getValueCount(uint32 field) const;
+
+	/** Read the values of a float, vector or matrix field into an array of floats.
+	 *
+	 *  Lists are read as well, with the elements one after the other, and
+	 *  vectors and matrices are flattened. This is considerably faster than
+	 *  reading each element on its own, which makes it the way to read large
+	 *  amounts of vertex data, animation keys and the like.
+	 *
+	 *  @param  field    The field to read.
+	 *  @param  values   The array to read the values into.
+	 *  @param  maxCount The number of values that fit into the array.
+	 *  @return The number of values read, at most maxCount.
+	 */
+	size_t getFloat(uint32 field, float *values, size_t maxCount) const;
+
+	/** Read the values of an integer field or list into an array of uint32s.
+	 *
+	 *  Signed values are converted like a cast from int32 to uint32 would.
+	 *  64-bit fields don't fit into the array and throw an exception.
+	 *
+	 *  @param  field    The field to read.
+	 *  @param  values   The array to read the values into.
+	 *  @param  maxCount The number of values that fit into the array.
+	 *  @return The number of values read, at most maxCount.
+	 */
+	size_t getUint(uint32 field, uint32 *values, size_t maxCount) const;
+	// '---
+
 	// .--- Structs and lists of structs
 	const GFF4Struct *getStruct (uint32 field) const;
 	const GFF4Struct *getGeneric(uint32 field) const;
@@ -367,11 +434,15 @@ private:
 		~Field() = default;
 	};
 
-	typedef std::map<uint32, Field> FieldMap;
+	/** The fields, in the order of the template, or by index for a generic. */
+	typedef std::vector<Field> FieldArray;
 
 
 	const GFF4File *_parent;
 
+	/** The template this struct was created from, or 0 for a generic. */
+	const GFF4File::StructTemplate *_template;
+
 	uint32 _label;
 
 	uint64 _id;
@@ -379,7 +450,7 @@ private:
 
 	size_t _fieldCount;
 
-	FieldMap _fields;
+	FieldArray _fields;
 
 	/** The labels of all fields in this struct. */
 	std::vector<uint32> _fieldLabels;
@@ -409,17 +480,27 @@ private:
 
 	Common::SeekableSubReadStreamEndian *getData(const Field &field) const;
 	Common::SeekableSubReadStreamEndian *getField(uint32 fieldID, const Field *&field) const;
+
+	/** Return a pointer to the values of a field, together with their number. */
+	const byte *getFieldData(uint32 fieldID, const Field *&field, uint32 &count) const;
 	// '---
 
 	// .--- Field reader helpers
 	uint32 getListCount(Common::SeekableSubReadStreamEndian &data, const Field &field) const;
 	uint32 getFieldSize(FieldType type) const;
 
-	uint64 getUint(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
-	 int64 getSint(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
+	/** Does the GFF4 have the same endianness as we do? */
+	bool isNativeEndian() const;
+
+	uint32 readUint32(const byte *data) const;
+
+	uint64 getUint(const byte *data, FieldType type) const;
+	 int64 getSint(const byte *data, FieldType type) const;
+
+	double getDouble(const byte *data, FieldType type) const;
+	float  getFloat (const byte *data, FieldType type) const;
 
-	double getDouble(Common::SeekableSubReadStreamEndian &data, FieldType type) const;
-	float  getFloat (Common::SeekableSubReadStreamEndian &data, FieldType type) const;
+	uint32 getValueLength(const Field &field) const;
 
 	Common::UString getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding) const;
 	Common::UString getString(Common::SeekableSubReadStreamEndian &data, Common::Encoding encoding,
@@ -0,0 +1,236 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of resource index information.
+ */
+
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+
+#include "src/common/util.h"
+#include "src/common/strutil.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/readfile.h"
+#include "src/common/writefile.h"
+#include "src/common/filepath.h"
+
+#include "src/aurora/resindexcache.h"
+
+static const uint32 kCacheID   = MKTAG('X', 'R', 'I', 'C');
+static const uint32 kVersion1  = MKTAG('V', '1', '.', '0');
+
+namespace Aurora {
+
+ResourceIndexCache::Dependency::Dependency() : size(0), time(0) {
+}
+
+
+ResourceIndexCache::ResourceIndexCache() {
+}
+
+ResourceIndexCache::~ResourceIndexCache() {
+}
+
+void ResourceIndexCache::clear() {
+	_loaded.clear();
+	_used.clear();
+}
+
+bool ResourceIndexCache::load(const Common::UString &fileName) {
+	clear();
+
+	Common::ReadFile file;
+	if (!file.open(fileName))
+		return false;
+
+	try {
+		// Read the whole cache in one go
+		Common::ScopedPtr<Common::MemoryReadStream> stream(file.readStream(file.size()));
+
+		load(*stream);
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to load resource index cache \"%s\"", fileName.c_str());
+		Common::printException(e, "WARNING: ");
+
+		clear();
+		return false;
+	}
+
+	return true;
+}
+
+void ResourceIndexCache::load(Common::MemoryReadStream &stream) {
+	const uint32 id      = stream.readUint32BE();
+	const uint32 version = stream.readUint32BE();
+
+	if (id != kCacheID)
+		throw Common::Exception("Not a resource index cache (%s)", Common::debugTag(id).c_str());
+
+	if (version != kVersion1)
+		throw Common::Exception("Unsupported resource index cache version %s", Common::debugTag(version).c_str());
+
+	const uint32 entryCount = stream.readUint32LE();
+	for (uint32 i = 0; i < entryCount; i++) {
+		const Common::UString key = readString(stream);
+
+		Entry &entry = _loaded[key];
+
+		entry.dependencies.resize(stream.readUint32LE());
+		for (Dependencies::iterator d = entry.dependencies.begin(); d != entry.dependencies.end(); ++d) {
+			d->path = readString(stream);
+			d->size = stream.readUint64LE();
+			d->time = stream.readUint64LE();
+		}
+
+		const uint32 size = stream.readUint32LE();
+		if (size > (stream.size() - stream.pos()))
+			throw Common::Exception(Common::kReadError);
+
+		entry.data.resize(size);
+		if (size > 0)
+			stream.read(&entry.data[0], size);
+	}
+}
+
+void ResourceIndexCache::save(const Common::UString &fileName) const {
+	Common::FilePath::createDirectories(Common::FilePath::getDirectory(fileName));
+
+	Common::WriteFile file;
+	if (!file.open(fileName))
+		throw Common::Exception(Common::kOpenError);
+
+	file.writeUint32BE(kCacheID);
+	file.writeUint32BE(kVersion1);
+
+	file.writeUint32LE(_used.size());
+	for (EntryMap::const_iterator e = _used.begin(); e != _used.end(); ++e) {
+		writeString(file, e->first);
+
+		file.writeUint32LE(e->second.dependencies.size());
+		for (Dependencies::const_iterator d = e->second.dependencies.begin(); d != e->second.dependencies.end(); ++d) {
+			writeString(file, d->path);
+			file.writeUint64LE(d->size);
+			file.writeUint64LE(d->time);
+		}
+
+		file.writeUint32LE(e->second.data.size());
+		if (!e->second.data.empty())
+			file.write(&e->second.data[0], e->second.data.size());
+	}
+
+	file.flush();
+	file.close();
+}
+
+Common::MemoryReadStream *ResourceIndexCache::find(const Common::UString &key) {
+	EntryMap::iterator used = _used.find(key);
+	if (used == _used.end()) {
+		EntryMap::iterator loaded = _loaded.find(key);
+		if ((loaded == _loaded.end()) || !isValid(loaded->second.dependencies))
+			return 0;
+
+		// Move the entry over into the used entries, so it will be saved again
+		used = _used.insert(std::make_pair(key, Entry())).first;
+
+		used->second.dependencies.swap(loaded->second.dependencies);
+		used->second.data.swap(loaded->second.data);
+
+		_loaded.erase(loaded);
+
+	} else if (!isValid(used->second.dependencies))
+		return 0;
+
+	if (used->second.data.empty())
+		return new Common::MemoryReadStream(static_cast<const byte *>(0), 0);
+
+	return new Common::MemoryReadStream(&used->second.data[0], used->second.data.size());
+}
+
+void ResourceIndexCache::add(const Common::UString &key, const Dependencies &dependencies,
+                             const byte *data, size_t size) {
+
+	_loaded.erase(key);
+
+	Entry &entry = _used[key];
+
+	entry.dependencies = dependencies;
+	entry.data.assign(data, data + size);
+}
+
+bool ResourceIndexCache::isValid(const Dependencies &dependencies) {
+	for (Dependencies::const_iterator d = dependencies.begin(); d != dependencies.end(); ++d) {
+		Dependency current;
+		if (!getDependency(d->path, current))
+			return false;
+
+		if ((current.size != d->size) || (current.time != d->time))
+			return false;
+	}
+
+	return true;
+}
+
+bool ResourceIndexCache::getDependency(const Common::UString &path, Dependency &dependency) {
+	const boost::filesystem::path p(path.c_str());
+
+	boost::system::error_code error;
+
+	const std::time_t time = boost::filesystem::last_write_time(p, error);
+	if (error)
+		return false;
+
+	uintmax_t size = 0;
+	if (!boost::filesystem::is_directory(p, error)) {
+		size = boost::filesystem::file_size(p, error);
+		if (error)
+			return false;
+	}
+
+	dependency.path = path;
+	dependency.size = size;
+	dependency.time = (uint64) time;
+
+	return true;
+}
+
+void ResourceIndexCache::writeString(Common::WriteStream &stream, const Common::UString &str) {
+	const size_t length = std::strlen(str.c_str());
+
+	stream.writeUint32LE(length);
+	stream.write(str.c_str(), length);
+}
+
+Common::UString ResourceIndexCache::readString(Common::MemoryReadStream &stream) {
+	const size_t length = stream.readUint32LE();
+	if (length > (stream.size() - stream.pos()))
+		throw Common::Exception(Common::kReadError);
+
+	const char *data = reinterpret_cast<const char *>(stream.getData() + stream.pos());
+	stream.skip(length);
+
+	return Common::UString(data, length);
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,125 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A persistent cache of resource index information.
+ */
+
+#ifndef AURORA_RESINDEXCACHE_H
+#define AURORA_RESINDEXCACHE_H
+
+#include <vector>
+#include <map>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+	class SeekableReadStream;
+	class WriteStream;
+	class MemoryReadStream;
+}
+
+namespace Aurora {
+
+/** A persistent cache of resource index information.
+ *
+ *  Each entry in the cache is a blob of data (for example, the resource
+ *  list of an archive) stored under a string key. Every entry depends on
+ *  a set of files and directories. If any of them changed in size or
+ *  modification time, the entry is considered stale and is ignored.
+ *
+ *  The whole cache file is read in one go. Only the entries that were
+ *  looked up successfully or added since then are written back, so
+ *  entries for files that are no longer used drop out of the cache.
+ */
+class ResourceIndexCache : boost::noncopyable {
+public:
+	/** A file or directory an entry depends on. */
+	struct Dependency {
+		Common::UString path; ///< The path of the file or directory.
+		uint64 size;          ///< The size of the file, 0 for directories.
+		uint64 time;          ///< The time of the last modification.
+
+		Dependency();
+	};
+
+	typedef std::vector<Dependency> Dependencies;
+
+	ResourceIndexCache();
+	~ResourceIndexCache();
+
+	/** Remove all entries. */
+	void clear();
+
+	/** Load the cache from this file.
+	 *
+	 *  @return true if the cache was loaded, false if the file doesn't
+	 *          exist or is not a valid cache file.
+	 */
+	bool load(const Common::UString &fileName);
+
+	/** Write all used entries into this file. */
+	void save(const Common::UString &fileName) const;
+
+	/** Look up an entry, and check that its dependencies haven't changed.
+	 *
+	 *  @return A stream over the entry's data, or 0 if there's no valid entry
+	 *          with this key. The stream stays valid as long as the entry exists.
+	 */
+	Common::MemoryReadStream *find(const Common::UString &key);
+
+	/** Add an entry, replacing any existing entry with the same key. */
+	void add(const Common::UString &key, const Dependencies &dependencies, const byte *data, size_t size);
+
+	/** Fill a dependency with the current state of this file or directory.
+	 *
+	 *  @return true if the file or directory exists, false otherwise.
+	 */
+	static bool getDependency(const Common::UString &path, Dependency &dependency);
+
+	/** Write a string in the format used by the cache. */
+	static void writeString(Common::WriteStream &stream, const Common::UString &str);
+	/** Read a string in the format used by the cache. */
+	static Common::UString readString(Common::MemoryReadStream &stream);
+
+private:
+	struct Entry {
+		Dependencies dependencies;
+		std::vector<byte> data;
+	};
+
+	typedef std::map<Common::UString, Entry> EntryMap;
+
+	/** Entries loaded from the cache file, not yet validated. */
+	EntryMap _loaded;
+	/** Entries validated or added, to be saved. */
+	EntryMap _used;
+
+	void load(Common::MemoryReadStream &stream);
+
+	static bool isValid(const Dependencies &dependencies);
+};
+
+} // End of namespace Aurora
+
+#endif // AURORA_RESINDEXCACHE_H
@@ -23,6 +23,8 @@
  */
 
 #include <cassert>
+#include <chrono>
+#include <atomic>
 
 #include <boost/scope_exit.hpp>
 
@@ -32,9 +34,15 @@
 #include "src/common/readstream.h"
 #include "src/common/filepath.h"
 #include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
 #include "src/common/writefile.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/md5.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/resman.h"
+#include "src/aurora/resindexcache.h"
 #include "src/aurora/util.h"
 
 #include "src/aurora/keyfile.h"
@@ -57,6 +65,56 @@ DECLARE_SINGLETON(Aurora::ResourceManager)
 
 namespace Aurora {
 
+/** Order resource IDs by their hash, the order getAvailableResources() lists them in. */
+static bool compareResourceIDHash(const ResourceManager::ResourceID &a, const ResourceManager::ResourceID &b) {
+	return a.hash < b.hash;
+}
+
+/** A stream over a resource in the resource cache.
+ *
+ *  Every stream holds a reference to the cached data, so the data stays
+ *  valid even when it's evicted from the cache while the stream is in use.
+ */
+class CachedResourceStream : public Common::MemoryReadStream {
+public:
+	CachedResourceStream(const std::shared_ptr<Common::MemoryReadStream> &data) :
+		Common::MemoryReadStream(data->getData(), data->size()), _data(data) {
+	}
+
+private:
+	std::shared_ptr<Common::MemoryReadStream> _data;
+};
+
+static double getMilliseconds(const std::chrono::steady_clock::time_point &start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+ResourceManager::IndexStats::IndexStats() : fromCache(0), fromDisk(0), cacheTime(0.0), diskTime(0.0) {
+}
+
+
+ResourceManager::ArchiveIndexRequest::ArchiveIndexRequest(const Common::UString &f, uint32 p, bool o,
+                                                          Common::ChangeID *c) :
+	file(f), priority(p), optional(o), changeID(c) {
+
+}
+
+
+ResourceManager::PendingArchive::PendingArchive() : known(0), fromCache(false), time(0.0) {
+}
+
+void ResourceManager::PendingArchive::clear() {
+	known     = 0;
+	fromCache = false;
+	time      = 0.0;
+
+	names.clear();
+	archives.clear();
+	data.clear();
+	hashAlgos.clear();
+	resources.clear();
+}
+
 ResourceManager::KnownArchive::KnownArchive() :
 	type(kArchiveMAX), resource(0), opened(0) {
 
@@ -68,11 +126,11 @@ ResourceManager::KnownArchive::KnownArchive(ArchiveType t, const Common::UString
 }
 
 
-ResourceManager::OpenedArchive::OpenedArchive() : archive(0), known(0), parent(0) {
+ResourceManager::OpenedArchive::OpenedArchive() : archive(0), known(0), id(0), parent(0) {
 }
 
-void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive &a) {
-	archive = &a;
+void ResourceManager::OpenedArchive::set(KnownArchive &kA, Archive *a) {
+	archive = a;
 	known   = &kA;
 
 	if (known->opened)
@@ -107,7 +165,7 @@ bool ResourceManager::Resource::operator<(const Resource &right) const {
 
 
 ResourceManager::ResourceManager() : _hasSmall(false),
-	_hashAlgo(Common::kHashFNV64) {
+	_hashAlgo(Common::kHashFNV64), _nextArchiveID(0) {
 
 	// These file types are archives
 
@@ -182,9 +240,16 @@ void ResourceManager::clear() {
 
 	setRIMsAreERFs(false);
 	clearResources();
+
+	_indexCache.reset();
+	_indexCacheFile.clear();
+
+	_indexStats = IndexStats();
 }
 
 void ResourceManager::clearResources() {
+	waitForPrefetches();
+
 	_cursorRemap.clear();
 
 	_baseDir.clear();
@@ -197,6 +262,8 @@ void ResourceManager::clearResources() {
 		delete a->archive;
 	_openedArchives.clear();
 
+	_resourceCache.clear();
+
 	_resources.clear();
 
 	_changes.clear();
@@ -228,6 +295,9 @@ void ResourceManager::setHashAlgo(Common::HashAlgo algo) {
 		throw Common::Exception("ResourceManager::setHashAlgo(): We already have resources!");
 
 	_hashAlgo = algo;
+
+	std::lock_guard<std::mutex> lock(_resRefHashMutex);
+	_resRefHashes.clear();
 }
 
 void ResourceManager::setCursorRemap(const std::vector<Common::UString> &remap) {
@@ -264,6 +334,42 @@ const Common::UString &ResourceManager::getDataBase() const {
 	return _baseDir;
 }
 
+void ResourceManager::openIndexCache(const Common::UString &fileName) {
+	closeIndexCache();
+
+	_indexCache.reset(new ResourceIndexCache);
+	_indexCache->load(fileName);
+
+	_indexCacheFile = fileName;
+}
+
+void ResourceManager::closeIndexCache() {
+	if (!_indexCache)
+		return;
+
+	try {
+		_indexCache->save(_indexCacheFile);
+	} catch (Common::Exception &e) {
+		e.add("Failed to save resource index cache \"%s\"", _indexCacheFile.c_str());
+		Common::printException(e, "WARNING: ");
+	}
+
+	_indexCache.reset();
+	_indexCacheFile.clear();
+}
+
+const ResourceManager::IndexStats &ResourceManager::getIndexStats() const {
+	return _indexStats;
+}
+
+void ResourceManager::setResourceCacheSize(size_t size) {
+	_resourceCache.setBudget(size);
+}
+
+ResourceManager::ResourceCacheStats ResourceManager::getResourceCacheStats() const {
+	return _resourceCache.getStats();
+}
+
 ResourceManager::KnownArchive *ResourceManager::findArchive(const Common::UString &file) {
 	ArchiveType archiveType = getArchiveType(file);
 	if (((size_t) archiveType) >= kArchiveMAX)
@@ -300,62 +406,70 @@ Common::SeekableReadStream *ResourceManager::openArchiveStream(const KnownArchiv
 	return getResource(*archive.resource, true);
 }
 
-void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
-                                   const std::vector<byte> &password, Common::ChangeID *changeID) {
-
-	KnownArchive *knownArchive = findArchive(file);
-	if (!knownArchive)
-		throw Common::Exception("No such archive file \"%s\"", file.c_str());
+Archive *ResourceManager::openArchive(const KnownArchive &knownArchive, const std::vector<byte> &password) const {
+	Common::SeekableReadStream *archiveStream = openArchiveStream(knownArchive);
 
-	if (knownArchive->type == kArchiveBIF)
-		throw Common::Exception("Attempted to index a lone BIF");
+	switch (knownArchive.type) {
+		case kArchiveBIF:
+			// BZF archives are still indexed as BIF
+			if (Common::FilePath::getExtension(knownArchive.name).equalsIgnoreCase(".bzf"))
+				return new BZFFile(archiveStream);
 
-	Change *change = 0;
-	if (changeID)
-		change = newChangeSet(*changeID);
-
-	Common::SeekableReadStream *archiveStream = openArchiveStream(*knownArchive);
-
-	Common::ScopedPtr<Archive> archive;
-	switch (knownArchive->type) {
-		case kArchiveKEY:
-			indexKEY(archiveStream, priority, change);
-			break;
+			return new BIFFile(archiveStream);
 
 		case kArchiveNDS:
-			archive.reset(new NDSFile(archiveStream));
-			break;
+			return new NDSFile(archiveStream);
 
 		case kArchiveHERF:
-			archive.reset(new HERFFile(archiveStream));
-			break;
+			return new HERFFile(archiveStream);
 
 		case kArchiveERF:
-			archive.reset(new ERFFile(archiveStream, password));
-			break;
+			return new ERFFile(archiveStream, password, &getThreadPool());
 
 		case kArchiveRIM:
-			archive.reset(new RIMFile(archiveStream));
-			break;
+			return new RIMFile(archiveStream);
 
 		case kArchiveZIP:
-			archive.reset(new ZIPFile(archiveStream));
-			break;
+			return new ZIPFile(archiveStream);
 
 		case kArchiveEXE:
-			archive.reset(new PEFile(archiveStream, _cursorRemap));
-			break;
+			return new PEFile(archiveStream, _cursorRemap);
 
 		case kArchiveNSBTX:
-			archive.reset(new NSBTXFile(archiveStream));
-			break;
+			return new NSBTXFile(archiveStream);
 
 		default:
-			throw Common::Exception("Invalid archive type %d", knownArchive->type);
+			break;
+	}
+
+	delete archiveStream;
+	throw Common::Exception("Invalid archive type %d", knownArchive.type);
+}
+
+Archive *ResourceManager::getArchive(OpenedArchive &archive) const {
+	/* Archives indexed from the cache are only opened when a resource within
+	 * them is needed for the first time. This can happen from several threads
+	 * at once, so this is done under a lock. */
+
+	std::lock_guard<std::mutex> lock(_archiveMutex);
+
+	if (!archive.archive) {
+		assert(archive.known);
+
+		archive.archive = openArchive(*archive.known, archive.password);
 	}
 
-	if (archive)
-		indexArchive(*knownArchive, archive.release(), priority, change);
+	return archive.archive;
+}
+
+void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
+                                   const std::vector<byte> &password, Common::ChangeID *changeID) {
+
+	ArchiveIndexRequest request(file, priority, false, changeID);
+	request.password = password;
+
+	PendingArchive pending;
+	indexArchive(request, pending);
 }
 
 void ResourceManager::indexArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID) {
@@ -364,18 +478,163 @@ void ResourceManager::indexArchive(const Common::UString &file, uint32 priority,
 	indexArchive(file, priority, password, changeID);
 }
 
+void ResourceManager::indexArchives(const std::vector<ArchiveIndexRequest> &archives,
+		const IndexAbortFunc &abort) {
+
+	Common::PtrVector<PendingArchive> pending;
+	pending.reserve(archives.size());
+
+	std::vector<KnownArchive *> toRead(archives.size(), 0);
+
+	// Look up all archives, and whether we have them in the index cache
+	for (size_t i = 0; i < archives.size(); i++) {
+		pending.push_back(new PendingArchive);
+
+		KnownArchive *knownArchive = findArchive(archives[i].file);
+		if (!knownArchive || (knownArchive->type == kArchiveBIF))
+			continue;
+
+		if (!readCachedArchive(*knownArchive, archives[i].password, *pending[i]))
+			toRead[i] = knownArchive;
+	}
+
+	/* Read all the other archives in parallel. If reading one fails, we just
+	 * try again once we get to it below, so that errors are thrown in order. */
+	if (archives.size() > 1) {
+		getThreadPool().parallelFor(archives.size(), [&](size_t i) {
+			if (!toRead[i] || (abort && abort()))
+				return;
+
+			try {
+				readArchive(*toRead[i], archives[i].password, *pending[i]);
+			} catch (...) {
+				pending[i]->clear();
+			}
+		});
+	}
+
+	// Add the resources of all archives, in order
+	for (size_t i = 0; i < archives.size(); i++) {
+		if (abort && abort())
+			return;
+
+		try {
+			indexArchive(archives[i], *pending[i]);
+		} catch (Common::Exception &e) {
+			e.add("Failed to index archive \"%s\"", archives[i].file.c_str());
+			throw;
+		}
+
+		pending[i]->clear();
+	}
+}
+
+bool ResourceManager::indexArchive(const ArchiveIndexRequest &request, PendingArchive &pending) {
+	KnownArchive *knownArchive = findArchive(request.file);
+	if (!knownArchive) {
+		if (request.optional)
+			return false;
+
+		throw Common::Exception("No such archive file \"%s\"", request.file.c_str());
+	}
+
+	if (knownArchive->type == kArchiveBIF)
+		throw Common::Exception("Attempted to index a lone BIF");
+
+	Change *change = 0;
+	if (request.changeID)
+		change = newChangeSet(*request.changeID);
+
+	/* If this archive wasn't read yet, or indexing the archives before it changed
+	 * what we would read now, read it here. This keeps the result identical to
+	 * indexing all archives one after the other. */
+	bool stale = pending.known != knownArchive;
+	if (pending.fromCache)
+		for (std::vector<KnownArchive *>::const_iterator a = pending.archives.begin(); a != pending.archives.end(); ++a)
+			stale = stale || ((*a)->opened != 0);
+
+	if (stale && !readCachedArchive(*knownArchive, request.password, pending))
+		readArchive(*knownArchive, request.password, pending);
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (pending.fromCache) {
+		for (size_t i = 0; i < pending.archives.size(); i++)
+			indexArchive(*pending.archives[i], 0, pending.resources[i], pending.hashAlgos[i],
+			             request.password, request.priority, change);
+
+		_indexStats.fromCache++;
+		_indexStats.cacheTime += pending.time + getMilliseconds(start);
+		return true;
+	}
+
+	const std::vector<Archive *> data(pending.data.begin(), pending.data.end());
+
+	for (size_t i = 0; i < data.size(); i++) {
+		// The index takes over the archive
+		pending.data[i] = 0;
+
+		indexArchive(*pending.archives[i], data[i], data[i]->getResources(), data[i]->getNameHashAlgo(),
+		             request.password, request.priority, change);
+	}
+
+	addCachedArchive(*knownArchive, request.password, pending.names, pending.archives, data);
+
+	_indexStats.fromDisk++;
+	_indexStats.diskTime += pending.time + getMilliseconds(start);
+	return true;
+}
+
+void ResourceManager::readArchive(KnownArchive &knownArchive, const std::vector<byte> &password,
+                                  PendingArchive &pending) {
+
+	pending.clear();
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	if (knownArchive.type == kArchiveKEY) {
+		std::vector<KEYDataFile *> keyData;
+		openKEYBIFs(openArchiveStream(knownArchive), pending.names, pending.archives, keyData);
+
+		pending.data.reserve(keyData.size());
+		pending.data.insert(pending.data.end(), keyData.begin(), keyData.end());
+
+	} else {
+		pending.data.reserve(1);
+		pending.data.push_back(openArchive(knownArchive, password));
+
+		pending.names.push_back("");
+		pending.archives.push_back(&knownArchive);
+	}
+
+	pending.known = &knownArchive;
+	pending.time  = getMilliseconds(start);
+}
+
+Common::ThreadPool &ResourceManager::getThreadPool() const {
+	// Archives are opened, and need the thread pool, from several threads
+	std::lock_guard<std::mutex> lock(_threadPoolMutex);
+
+	if (!_threadPool)
+		_threadPool.reset(new Common::ThreadPool);
+
+	return *_threadPool;
+}
+
 uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
+                                    std::vector<Common::UString> &names,
                                     std::vector<KnownArchive *> &archives,
                                     std::vector<KEYDataFile *> &keyData) {
 
 	bool success = false;
-	BOOST_SCOPE_EXIT( (&success) (&archives) (&keyData) ) {
+	BOOST_SCOPE_EXIT( (&success) (&names) (&archives) (&keyData) ) {
 		if (!success) {
 			for (std::vector<KEYDataFile *>::iterator b = keyData.begin(); b != keyData.end(); ++b)
 				delete *b;
 
 			keyData.clear();
 			archives.clear();
+			names.clear();
 		}
 	} BOOST_SCOPE_EXIT_END
 
@@ -383,6 +642,7 @@ uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
 	KEYFile key(*keyStream);
 
 	const KEYFile::BIFList &keyBIFs = key.getBIFs();
+	names.assign(keyBIFs.begin(), keyBIFs.end());
 	archives.resize(keyBIFs.size(), 0);
 	keyData.resize(keyBIFs.size(), 0);
 
@@ -403,23 +663,17 @@ uint32 ResourceManager::openKEYBIFs(Common::SeekableReadStream *keyStream,
 	return archives.size();
 }
 
-void ResourceManager::indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change) {
-	std::vector<KnownArchive *> archives;
-	std::vector<KEYDataFile *> keyData;
-
-	const uint32 count = openKEYBIFs(stream, archives, keyData);
-
-	for (uint32 i = 0; i < count; i++)
-		indexArchive(*archives[i], keyData[i], priority, change);
-}
-
 void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
-                                   uint32 priority, Change *change) {
+                                   const Archive::ResourceList &resources, Common::HashAlgo hashAlgo,
+                                   const std::vector<byte> &password, uint32 priority, Change *change) {
+
+	if ((hashAlgo != Common::kHashNone) && (hashAlgo != _hashAlgo)) {
+		// We own the archive now, so we need to get rid of it
+		delete archive;
 
-	const Common::HashAlgo hashAlgo = archive->getNameHashAlgo();
-	if ((hashAlgo != Common::kHashNone) && (hashAlgo != _hashAlgo))
 		throw Common::Exception("ResourceManager::indexArchive(): Archive uses a different name hashing "
 		                        "algorithm than we do (%d vs. %d)", (int) hashAlgo, (int) _hashAlgo);
+	}
 
 	bool couldSet = false;
 	_openedArchives.push_back(OpenedArchive());
@@ -431,14 +685,15 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 		}
 	} BOOST_SCOPE_EXIT_END
 
-	_openedArchives.back().set(knownArchive, *archive);
+	_openedArchives.back().set(knownArchive, archive);
+	_openedArchives.back().password = password;
+	_openedArchives.back().id       = _nextArchiveID++;
 	couldSet = true;
 
 	// Add the information of the new archive to the change set
 	if (change)
 		change->_change->openedArchives.push_back(--_openedArchives.end());
 
-	const Archive::ResourceList &resources = archive->getResources();
 	for (Archive::ResourceList::const_iterator resource = resources.begin(); resource != resources.end(); ++resource) {
 		// Build the resource record
 		Resource res;
@@ -470,6 +725,149 @@ void ResourceManager::indexArchive(KnownArchive &knownArchive, Archive *archive,
 	}
 }
 
+bool ResourceManager::canCacheArchive(const KnownArchive &knownArchive) const {
+	// The names of the resources in EXE files depend on the cursor remap
+	if (knownArchive.type == kArchiveEXE)
+		return false;
+
+	// Only archives that are files themselves can be validated against the file system
+	return knownArchive.resource && (knownArchive.resource->source == kSourceFile);
+}
+
+Common::UString ResourceManager::getIndexCacheKey(const KnownArchive &knownArchive,
+                                                  const std::vector<byte> &password) const {
+
+	Common::UString key = Common::UString::format("archive:%d:", (int) knownArchive.type);
+
+	// The cache is stored on disk, so only its digest identifies the password
+	if (!password.empty()) {
+		std::vector<byte> digest;
+		Common::hashMD5(password, digest);
+
+		for (std::vector<byte>::const_iterator d = digest.begin(); d != digest.end(); ++d)
+			key += Common::UString::format("%02X", *d);
+	}
+
+	return key + ":" + knownArchive.resource->path;
+}
+
+bool ResourceManager::readCachedArchive(KnownArchive &knownArchive, const std::vector<byte> &password,
+                                        PendingArchive &pending) {
+
+	pending.clear();
+
+	if (!_indexCache || !canCacheArchive(knownArchive))
+		return false;
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	Common::ScopedPtr<Common::MemoryReadStream> cache(_indexCache->find(getIndexCacheKey(knownArchive, password)));
+	if (!cache)
+		return false;
+
+	try {
+		const uint32 count = cache->readUint32LE();
+
+		pending.names.resize(count);
+		pending.archives.resize(count, 0);
+		pending.hashAlgos.resize(count, Common::kHashNone);
+		pending.resources.resize(count);
+
+		for (uint32 i = 0; i < count; i++) {
+			pending.names[i] = ResourceIndexCache::readString(*cache);
+
+			const Common::UString path = ResourceIndexCache::readString(*cache);
+
+			// Find the archive the same way as when indexing the archive itself
+			pending.archives[i] = (knownArchive.type == kArchiveKEY) ?
+				findArchive(pending.names[i], _knownArchives[kArchiveBIF]) : &knownArchive;
+
+			// If it's not the same file anymore, or already in use, index it the long way
+			if (!pending.archives[i] || !canCacheArchive(*pending.archives[i]) ||
+			    (pending.archives[i]->resource->path != path) || pending.archives[i]->opened) {
+
+				pending.clear();
+				return false;
+			}
+
+			pending.hashAlgos[i] = (Common::HashAlgo) cache->readUint32LE();
+
+			Archive::ResourceList &resources = pending.resources[i];
+
+			const uint32 resourceCount = cache->readUint32LE();
+			for (uint32 j = 0; j < resourceCount; j++) {
+				resources.push_back(Archive::Resource());
+
+				resources.back().name  = ResourceIndexCache::readString(*cache);
+				resources.back().hash  = cache->readUint64LE();
+				resources.back().type  = (FileType) cache->readUint32LE();
+				resources.back().index = cache->readUint32LE();
+			}
+		}
+
+	} catch (Common::Exception &e) {
+		e.add("Failed to read cached index of archive \"%s\"", knownArchive.name.c_str());
+		Common::printException(e, "WARNING: ");
+
+		pending.clear();
+		return false;
+	}
+
+	pending.known     = &knownArchive;
+	pending.fromCache = true;
+	pending.time      = getMilliseconds(start);
+
+	return true;
+}
+
+void ResourceManager::addCachedArchive(const KnownArchive &knownArchive, const std::vector<byte> &password,
+                                       const std::vector<Common::UString> &names,
+                                       const std::vector<KnownArchive *> &archives,
+                                       const std::vector<Archive *> &data) {
+
+	if (!_indexCache || !canCacheArchive(knownArchive))
+		return;
+
+	assert((names.size() == archives.size()) && (archives.size() == data.size()));
+
+	ResourceIndexCache::Dependencies dependencies(1);
+	if (!ResourceIndexCache::getDependency(knownArchive.resource->path, dependencies[0]))
+		return;
+
+	Common::MemoryWriteStreamDynamic cache(true);
+
+	cache.writeUint32LE(archives.size());
+	for (size_t i = 0; i < archives.size(); i++) {
+		// The BIFs of a KEY need to be files we can validate too
+		if (archives[i] != &knownArchive) {
+			if (!canCacheArchive(*archives[i]))
+				return;
+
+			dependencies.push_back(ResourceIndexCache::Dependency());
+			if (!ResourceIndexCache::getDependency(archives[i]->resource->path, dependencies.back()))
+				return;
+		}
+
+		ResourceIndexCache::writeString(cache, names[i]);
+		ResourceIndexCache::writeString(cache, archives[i]->resource->path);
+
+		cache.writeUint32LE((uint32) data[i]->getNameHashAlgo());
+
+		const Archive::ResourceList &resources = data[i]->getResources();
+
+		cache.writeUint32LE(resources.size());
+		for (Archive::ResourceList::const_iterator r = resources.begin(); r != resources.end(); ++r) {
+			ResourceIndexCache::writeString(cache, r->name);
+
+			cache.writeUint64LE(r->hash);
+			cache.writeUint32LE((uint32) r->type);
+			cache.writeUint32LE(r->index);
+		}
+	}
+
+	_indexCache->add(getIndexCacheKey(knownArchive, password), dependencies, cache.getData(), cache.size());
+}
+
 bool ResourceManager::hasResourceDir(const Common::UString &dir) {
 	if (_baseDir.empty())
 		return false;
@@ -504,26 +902,88 @@ void ResourceManager::indexResourceDir(const Common::UString &dir, const char *g
 	if (directory.empty())
 		throw Common::Exception("No such directory \"%s\"", dir.c_str());
 
-	// Find files
-	Common::FileList files;
-	files.addDirectory(directory, depth);
-
 	Change *change = 0;
 	if (changeID)
 		change = newChangeSet(*changeID);
 
-	if (!glob) {
-		// Add the files
-		addResources(files, change, priority);
-		return;
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	// Find files
+	std::list<Common::UString> files;
+	const bool fromCache = findResourceFiles(directory, glob, depth, files);
+
+	// Add the files
+	addResources(files, change, priority);
+
+	if (fromCache) {
+		_indexStats.fromCache++;
+		_indexStats.cacheTime += getMilliseconds(start);
+	} else {
+		_indexStats.fromDisk++;
+		_indexStats.diskTime += getMilliseconds(start);
+	}
+}
+
+bool ResourceManager::findResourceFiles(const Common::UString &directory, const char *glob, int depth,
+                                        std::list<Common::UString> &files) {
+
+	const Common::UString key =
+		Common::UString::format("directory:%d:%s:%s", depth, glob ? glob : "", directory.c_str());
+
+	if (_indexCache) {
+		Common::ScopedPtr<Common::MemoryReadStream> cache(_indexCache->find(key));
+		if (cache) {
+			try {
+				std::list<Common::UString> cachedFiles;
+
+				const uint32 count = cache->readUint32LE();
+				for (uint32 i = 0; i < count; i++)
+					cachedFiles.push_back(ResourceIndexCache::readString(*cache));
+
+				files.swap(cachedFiles);
+				return true;
+
+			} catch (Common::Exception &e) {
+				e.add("Failed to read cached contents of directory \"%s\"", directory.c_str());
+				Common::printException(e, "WARNING: ");
+			}
+		}
 	}
 
+	Common::FileList dirFiles;
+	std::list<Common::UString> directories;
+	dirFiles.addDirectory(directory, depth, directories);
+
 	// Find files matching the glob pattern
 	Common::FileList globFiles;
-	files.getSubListGlob(glob, true, globFiles);
+	if (glob)
+		dirFiles.getSubListGlob(glob, true, globFiles);
 
-	// Add the files
-	addResources(globFiles, change, priority);
+	const Common::FileList &found = glob ? globFiles : dirFiles;
+	files.assign(found.begin(), found.end());
+
+	if (!_indexCache)
+		return false;
+
+	/* A directory's modification time changes whenever files are added to or
+	 * removed from it. So the file list is still valid as long as none of the
+	 * directories we looked into changed. */
+
+	ResourceIndexCache::Dependencies dependencies(directories.size());
+
+	std::list<Common::UString>::const_iterator dir = directories.begin();
+	for (size_t i = 0; i < dependencies.size(); i++, ++dir)
+		if (!ResourceIndexCache::getDependency(*dir, dependencies[i]))
+			return false;
+
+	Common::MemoryWriteStreamDynamic cache(true);
+
+	cache.writeUint32LE(files.size());
+	for (std::list<Common::UString>::const_iterator f = files.begin(); f != files.end(); ++f)
+		ResourceIndexCache::writeString(cache, *f);
+
+	_indexCache->add(key, dependencies, cache.getData(), cache.size());
+	return false;
 }
 
 void ResourceManager::undo(Common::ChangeID &changeID) {
@@ -531,6 +991,8 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 	if (!change || (change->_change == _changes.end()))
 		return;
 
+	waitForPrefetches();
+
 	// Removing all changes in the opened archives list
 	for (OpenedArchiveChanges::iterator oaChange = change->_change->openedArchives.begin();
 	     oaChange != change->_change->openedArchives.end(); ++oaChange) {
@@ -560,6 +1022,10 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 				throw Common::Exception("Couldn't find archive in the parent's children list");
 		}
 
+		// Drop all its resources from the resource cache
+		const uint32 id = (*oaChange)->id;
+		_resourceCache.eraseIf([id](uint64 key) { return (key >> 32) == id; });
+
 		delete (*oaChange)->archive;
 		_openedArchives.erase(*oaChange);
 	}
@@ -582,20 +1048,19 @@ void ResourceManager::undo(Common::ChangeID &changeID) {
 	for (ResourceChanges::iterator resChange = change->_change->resources.begin();
 	     resChange != change->_change->resources.end(); ++resChange) {
 
+		Resource &res = _resources.get(*resChange);
+
 		// If the resource still has an archive attached, it was added by a
 		// declareResources() call and needs to be removed manually
-		if (resChange->resIt->selfArchive.first) {
-			if (resChange->resIt->selfArchive.second->opened)
+		if (res.selfArchive.first) {
+			if (res.selfArchive.second->opened)
 				throw Common::Exception("Attempted to deindex an archive resource that's still opened");
 
-			resChange->resIt->selfArchive.first->erase(resChange->resIt->selfArchive.second);
+			res.selfArchive.first->erase(res.selfArchive.second);
 		}
 
-		// Remove the resource, and the name list too if it's empty
-		resChange->hashIt->second.erase(resChange->resIt);
-
-		if (resChange->hashIt->second.empty())
-			_resources.erase(resChange->hashIt);
+		// Remove the resource, and the hash too if it has no resources left
+		_resources.erase(*resChange);
 	}
 
 	// Now we can remove the change set from our list of change sets
@@ -610,19 +1075,16 @@ void ResourceManager::addTypeAlias(FileType alias, FileType realType) {
 }
 
 void ResourceManager::blacklist(const Common::UString &name, FileType type) {
-	ResourceMap::iterator resList = _resources.find(getHash(name, type));
-	if (resList == _resources.end())
-		return;
-
-	for (ResourceList::iterator res = resList->second.begin(); res != resList->second.end(); ++res)
-		res->priority = 0;
+	for (ResourceMap::Handle res = _resources.find(getHash(name, type));
+	     res != ResourceMap::kInvalidHandle; res = _resources.getNext(res))
+		_resources.get(res).priority = 0;
 }
 
 void ResourceManager::declareResource(const Common::UString &name, FileType type) {
 	bool isSmall = false;
 
-	ResourceMap::iterator resList = _resources.find(getHash(name, type));
-	if (resList == _resources.end()) {
+	ResourceMap::Handle resList = _resources.find(getHash(name, type));
+	if (resList == ResourceMap::kInvalidHandle) {
 		if (_hasSmall) {
 			Common::UString smallName = TypeMan.addFileType(TypeMan.setFileType(name, type), kFileTypeSMALL);
 
@@ -630,16 +1092,18 @@ void ResourceManager::declareResource(const Common::UString &name, FileType type
 			isSmall = true;
 		}
 
-		if (resList == _resources.end())
+		if (resList == ResourceMap::kInvalidHandle)
 			return;
 	}
 
-	for (ResourceList::iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		r->name    = name;
-		r->type    = type;
-		r->isSmall = isSmall;
+	for (ResourceMap::Handle r = resList; r != ResourceMap::kInvalidHandle; r = _resources.getNext(r)) {
+		Resource &res = _resources.get(r);
+
+		res.name    = name;
+		res.type    = type;
+		res.isSmall = isSmall;
 
-		checkResourceIsArchive(*r, 0);
+		checkResourceIsArchive(res, 0);
 	}
 }
 
@@ -669,6 +1133,10 @@ bool ResourceManager::hasResource(const Common::UString &name, const std::vector
 	return getRes(name, types) != 0;
 }
 
+bool ResourceManager::hasResource(ResRefID name, FileType type) const {
+	return getRes(name, std::vector<FileType>(1, type)) != 0;
+}
+
 bool ResourceManager::hasResource(uint64 hash) const {
 	return getRes(hash) != 0;
 }
@@ -702,10 +1170,10 @@ Common::UString ResourceManager::findResourceFile(const Common::UString &name,
 
 uint32 ResourceManager::getResourceSize(const Resource &res) const {
 	if (res.source == kSourceArchive) {
-		if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
+		if ((res.archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
 			return 0xFFFFFFFF;
 
-		return res.archive->archive->getResourceSize(res.archiveIndex);
+		return getArchive(*res.archive)->getResourceSize(res.archiveIndex);
 	}
 
 	if (res.source == kSourceFile)
@@ -715,10 +1183,129 @@ uint32 ResourceManager::getResourceSize(const Resource &res) const {
 }
 
 Common::SeekableReadStream *ResourceManager::getArchiveResource(const Resource &res, bool tryNoCopy) const {
-	if ((res.archive == 0) || (res.archive->archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
+	if ((res.archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
 		throw Common::Exception("Archive resource has no archive");
 
-	return res.archive->archive->getResource(res.archiveIndex, tryNoCopy);
+	return getArchive(*res.archive)->getResource(res.archiveIndex, tryNoCopy);
+}
+
+bool ResourceManager::canCacheResource(const Resource &res) const {
+	if (_resourceCache.getBudget() == 0)
+		return false;
+
+	// Only cache resources that are expensive to read again
+	if (res.isSmall)
+		return true;
+
+	if ((res.archive == 0) || (res.archiveIndex == 0xFFFFFFFF))
+		return false;
+
+	Archive *archive = getArchive(*res.archive);
+	if (!archive->isResourceCompressed(res.archiveIndex))
+		return false;
+
+	/* Don't let a single huge resource push out lots of smaller ones.
+	 * Archives might decompress such resources on the fly anyway. */
+	return archive->getResourceSize(res.archiveIndex) <= (_resourceCache.getBudget() / 8);
+}
+
+static uint64 getResourceCacheKey(uint32 archiveID, uint32 archiveIndex) {
+	return (((uint64) archiveID) << 32) | archiveIndex;
+}
+
+std::shared_ptr<Common::MemoryReadStream> ResourceManager::readCachedResource(const Resource &res) const {
+	Common::ScopedPtr<Common::SeekableReadStream> stream(getArchiveResource(res));
+
+	if (res.isSmall)
+		stream.reset(Small::decompress(stream.release()));
+
+	// Decompressing usually already gives us the whole resource in memory
+	Common::MemoryReadStream *memStream = dynamic_cast<Common::MemoryReadStream *>(stream.get());
+	if (memStream && (memStream->pos() == 0)) {
+		stream.release();
+		return std::shared_ptr<Common::MemoryReadStream>(memStream);
+	}
+
+	return std::shared_ptr<Common::MemoryReadStream>(stream->readStream(stream->size() - stream->pos()));
+}
+
+Common::SeekableReadStream *ResourceManager::getCachedResource(const Resource &res) const {
+	const uint64 key = getResourceCacheKey(res.archive->id, res.archiveIndex);
+
+	std::shared_ptr<Common::MemoryReadStream> data;
+	if (!_resourceCache.get(key, data)) {
+		data = readCachedResource(res);
+
+		_resourceCache.put(key, data, data->size());
+	}
+
+	return new CachedResourceStream(data);
+}
+
+bool ResourceManager::prefetchResource(const Resource &res) const {
+	if (!canCacheResource(res))
+		return false;
+
+	const uint64 key = getResourceCacheKey(res.archive->id, res.archiveIndex);
+	if (_resourceCache.contains(key))
+		return true;
+
+	std::shared_ptr<Common::MemoryReadStream> data = readCachedResource(res);
+
+	return _resourceCache.put(key, data, data->size());
+}
+
+std::shared_future<size_t> ResourceManager::prefetch(const std::vector<Common::UString> &names,
+                                                     const std::vector<FileType> &types) {
+
+	/* Look up the resources now. The workers only get copies of them, so
+	 * indexing more resources in the meantime doesn't disturb them. */
+	std::vector<Resource> resources;
+	if (_resourceCache.getBudget() > 0) {
+		resources.reserve(names.size());
+
+		for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n) {
+			const Resource *res = getRes(*n, types);
+			if (res && (res->source == kSourceArchive))
+				resources.push_back(*res);
+		}
+	}
+
+	// Forget about prefetches that are already done
+	for (std::list< std::shared_future<size_t> >::iterator p = _prefetches.begin(); p != _prefetches.end(); ) {
+		if (p->wait_for(std::chrono::seconds(0)) == std::future_status::ready)
+			p = _prefetches.erase(p);
+		else
+			++p;
+	}
+
+	Common::ThreadPool &threadPool = getThreadPool();
+
+	std::shared_future<size_t> prefetch = threadPool.enqueue([this, &threadPool, resources]() {
+		std::atomic<size_t> count(0);
+
+		threadPool.parallelFor(resources.size(), [this, &resources, &count](size_t i) {
+			try {
+				if (prefetchResource(resources[i]))
+					count++;
+			} catch (...) {
+				// Ignored, getResource() will complain once the resource is needed
+			}
+		});
+
+		return count.load();
+	}).share();
+
+	_prefetches.push_back(prefetch);
+
+	return prefetch;
+}
+
+void ResourceManager::waitForPrefetches() {
+	for (std::list< std::shared_future<size_t> >::iterator p = _prefetches.begin(); p != _prefetches.end(); ++p)
+		p->wait();
+
+	_prefetches.clear();
 }
 
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name, FileType type) const {
@@ -729,6 +1316,18 @@ Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &
 	return getResource(name, types);
 }
 
+Common::SeekableReadStream *ResourceManager::getResource(ResRefID name, FileType type) const {
+	return getResource(name, std::vector<FileType>(1, type));
+}
+
+Common::SeekableReadStream *ResourceManager::getResourceMapped(const Common::UString &name, FileType type) const {
+	const Resource *res = getRes(name, type);
+	if (!res)
+		return 0;
+
+	return getResource(*res, true);
+}
+
 Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &name) const {
 	return getResource(TypeMan.setFileType(name, kFileTypeNone), TypeMan.getFileType(name));
 }
@@ -747,6 +1346,53 @@ Common::SeekableReadStream *ResourceManager::getResource(const Common::UString &
 	return getResource(*res);
 }
 
+Common::SeekableReadStream *ResourceManager::getResource(ResRefID name,
+		const std::vector<FileType> &types, FileType *foundType) const {
+
+	const Resource *res = getRes(name, types);
+	if (!res)
+		return 0;
+
+	if (foundType)
+		*foundType = res->type;
+
+	return getResource(*res);
+}
+
+void ResourceManager::getResources(const std::vector<Common::UString> &names, const std::vector<FileType> &types,
+                                   Common::PtrVector<Common::SeekableReadStream> &streams,
+                                   std::vector<FileType> *foundTypes) const {
+
+	std::vector<const Resource *> resources;
+	resources.reserve(names.size());
+
+	for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n)
+		resources.push_back(getRes(*n, types));
+
+	if (foundTypes) {
+		foundTypes->clear();
+		for (std::vector<const Resource *>::const_iterator r = resources.begin(); r != resources.end(); ++r)
+			foundTypes->push_back(*r ? (*r)->type : kFileTypeNone);
+	}
+
+	streams.clear();
+	streams.resize(names.size(), 0);
+
+	getThreadPool().parallelFor(resources.size(), [this, &resources, &streams](size_t i) {
+		if (resources[i])
+			streams[i] = getResource(*resources[i]);
+	});
+}
+
+void ResourceManager::getResources(ResourceType resType, const std::vector<Common::UString> &names,
+                                   Common::PtrVector<Common::SeekableReadStream> &streams,
+                                   std::vector<FileType> *foundTypes) const {
+
+	assert((resType >= 0) && (resType < kResourceMAX));
+
+	getResources(names, _resourceTypeTypes[resType], streams, foundTypes);
+}
+
 Common::SeekableReadStream *ResourceManager::getResource(uint64 hash, FileType *type) const {
 	const Resource *res = getRes(hash);
 	if (!res)
@@ -764,10 +1410,21 @@ Common::SeekableReadStream *ResourceManager::getResource(const Resource &res, bo
 
 	switch (res.source) {
 		case kSourceFile:
-			stream = new Common::ReadFile(res.path);
+			/* If we were asked not to copy, try to map the file into memory.
+			 * Archives opened this way can then return their resources as
+			 * views into the mapping. If the file can't be mapped, fall back
+			 * to reading it normally. */
+			if (tryNoCopy)
+				stream = Common::MappedFileReadStream::open(res.path);
+
+			if (!stream)
+				stream = new Common::ReadFile(res.path);
 			break;
 
 		case kSourceArchive:
+			if (!tryNoCopy && canCacheResource(res))
+				return getCachedResource(res);
+
 			stream = getArchiveResource(res, tryNoCopy);
 			break;
 
@@ -800,32 +1457,54 @@ Common::SeekableReadStream *ResourceManager::getResource(ResourceType resType,
 void ResourceManager::getAvailableResources(FileType type,
 		std::list<ResourceID> &list) const {
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (!r->second.empty() && (r->second.front().type == type)) {
-			list.push_back(ResourceID());
+	// The hash table is unordered, so collect first and sort by hash
+	std::list<ResourceID> found;
+
+	for (size_t i = 0; i < _resources.getBucketCount(); i++) {
+		const ResourceMap::Handle r = _resources.getBucket(i);
+		if (r == ResourceMap::kInvalidHandle)
+			continue;
+
+		const Resource &res = _resources.get(_resources.getLast(r));
+		if (res.type == type) {
+			found.push_back(ResourceID());
 
-			list.back().name = r->second.front().name;
-			list.back().type = r->second.front().type;
-			list.back().hash = r->first;
+			found.back().name = res.name;
+			found.back().type = res.type;
+			found.back().hash = _resources.getHash(r);
 		}
 	}
+
+	found.sort(compareResourceIDHash);
+	list.splice(list.end(), found);
 }
 
 void ResourceManager::getAvailableResources(const std::vector<FileType> &types,
 		std::list<ResourceID> &list) const {
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
+	// The hash table is unordered, so collect first and sort by hash
+	std::list<ResourceID> found;
+
+	for (size_t i = 0; i < _resources.getBucketCount(); i++) {
+		const ResourceMap::Handle r = _resources.getBucket(i);
+		if (r == ResourceMap::kInvalidHandle)
+			continue;
+
+		const Resource &res = _resources.get(_resources.getLast(r));
 		for (std::vector<FileType>::const_iterator t = types.begin(); t != types.end(); ++t) {
-			if (!r->second.empty() && (r->second.front().type == *t)) {
-				list.push_back(ResourceID());
+			if (res.type == *t) {
+				found.push_back(ResourceID());
 
-				list.back().name = r->second.front().name;
-				list.back().type = r->second.front().type;
-				list.back().hash = r->first;
+				found.back().name = res.name;
+				found.back().type = res.type;
+				found.back().hash = _resources.getHash(r);
 			}
 		}
 
 	}
+
+	found.sort(compareResourceIDHash);
+	list.splice(list.end(), found);
 }
 
 void ResourceManager::getAvailableResources(ResourceType type,
@@ -900,17 +1579,33 @@ inline uint64 ResourceManager::getHash(const Common::UString &name) const {
 	return Common::hashString(name.toLower(), _hashAlgo);
 }
 
-void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList) {
-	if (resource.name.empty() || resList->second.empty())
+uint64 ResourceManager::getHash(ResRefID name, FileType type) const {
+	const uint64 key = (((uint64) name) << 32) | ((uint32) type);
+
+	std::lock_guard<std::mutex> lock(_resRefHashMutex);
+
+	std::unordered_map<uint64, uint64>::const_iterator h = _resRefHashes.find(key);
+	if (h != _resRefHashes.end())
+		return h->second;
+
+	const uint64 hash = getHash(ResRefMan.getName(name), type);
+	_resRefHashes.insert(std::make_pair(key, hash));
+
+	return hash;
+}
+
+void ResourceManager::checkHashCollision(const Resource &resource, ResourceMap::Handle resList) {
+	if (resource.name.empty() || (resList == ResourceMap::kInvalidHandle))
 		return;
 
 	Common::UString newName = TypeMan.setFileType(resource.name, resource.type).toLower();
 
-	for (ResourceList::const_iterator r = resList->second.begin(); r != resList->second.end(); ++r) {
-		if (r->name.empty())
+	for (ResourceMap::Handle r = resList; r != ResourceMap::kInvalidHandle; r = _resources.getNext(r)) {
+		const Resource &res = _resources.get(r);
+		if (res.name.empty())
 			continue;
 
-		Common::UString oldName = TypeMan.setFileType(r->name, r->type).toLower();
+		Common::UString oldName = TypeMan.setFileType(res.name, res.type).toLower();
 		if (oldName != newName) {
 			warning("ResourceManager: Found hash collision: %s (\"%s\" and \"%s\")",
 					Common::formatHash(getHash(oldName)).c_str(), oldName.c_str(), newName.c_str());
@@ -951,36 +1646,18 @@ bool ResourceManager::checkResourceIsArchive(Resource &resource, Change *change)
 }
 
 void ResourceManager::addResource(Resource &resource, uint64 hash, Change *change) {
-	ResourceMap::iterator resList = _resources.find(hash);
-	if (resList == _resources.end()) {
-		// We don't have a resource with this name yet, create a new resource list for it
-
-		std::pair<ResourceMap::iterator, bool> result;
-
-		result = _resources.insert(std::make_pair(hash, ResourceList()));
-
-		resList = result.first;
-	}
-
 #ifdef CHECK_HASH_COLLISION
-	checkHashCollision(resource, resList);
+	checkHashCollision(resource, _resources.find(hash));
 #endif
 
-	// Add the resource to the list
-	resList->second.push_back(resource);
-	Resource *res = &resList->second.back();
+	// Add the resource, sorted by priority into the ones with the same hash
+	const ResourceMap::Handle res = _resources.insert(hash, resource);
 
-	checkResourceIsArchive(*res, change);
+	checkResourceIsArchive(_resources.get(res), change);
 
 	// Remember the resource in the change set
-	if (change) {
-		change->_change->resources.push_back(ResourceChange());
-		change->_change->resources.back().hashIt = resList;
-		change->_change->resources.back().resIt  = --resList->second.end();
-	}
-
-	// Resort the list by priority
-	resList->second.sort();
+	if (change)
+		change->_change->resources.push_back(res);
 }
 
 void ResourceManager::addResource(const Common::UString &path, Change *change, uint32 priority) {
@@ -1008,17 +1685,17 @@ void ResourceManager::addResource(const Common::UString &path, Change *change, u
 	addResource(res, hash, change);
 }
 
-void ResourceManager::addResources(const Common::FileList &files, Change *change, uint32 priority) {
-	for (Common::FileList::const_iterator file = files.begin(); file != files.end(); ++file)
+void ResourceManager::addResources(const std::list<Common::UString> &files, Change *change, uint32 priority) {
+	for (std::list<Common::UString>::const_iterator file = files.begin(); file != files.end(); ++file)
 		addResource(*file, change, priority);
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(uint64 hash) const {
-	ResourceMap::const_iterator r = _resources.find(hash);
-	if ((r == _resources.end()) || r->second.empty() || (r->second.back().priority == 0))
+	const ResourceMap::Handle r = _resources.find(hash);
+	if ((r == ResourceMap::kInvalidHandle) || (_resources.get(r).priority == 0))
 		return 0;
 
-	return &r->second.back();
+	return &_resources.get(r);
 }
 
 const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &name,
@@ -1049,6 +1726,21 @@ const ResourceManager::Resource *ResourceManager::getRes(const Common::UString &
 	return getRes(name, types);
 }
 
+const ResourceManager::Resource *ResourceManager::getRes(ResRefID name, const std::vector<FileType> &types) const {
+	const Resource *result = 0;
+	for (std::vector<FileType>::const_iterator type = types.begin(); type != types.end(); ++type) {
+		const Resource *res = getRes(getHash(name, *type));
+		if (res && (!result || *result < *res))
+			result = res;
+	}
+
+	// "Small" files are rare enough to just look them up by name
+	if (!result && _hasSmall)
+		return getRes(ResRefMan.getName(name), types);
+
+	return result;
+}
+
 void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	Common::WriteFile file;
 
@@ -1058,15 +1750,16 @@ void ResourceManager::dumpResourcesList(const Common::UString &fileName) const {
 	file.writeString("                Name                 |        Hash        |     Size    \n");
 	file.writeString("-------------------------------------|--------------------|-------------\n");
 
-	for (ResourceMap::const_iterator r = _resources.begin(); r != _resources.end(); ++r) {
-		if (r->second.empty())
+	for (size_t i = 0; i < _resources.getBucketCount(); i++) {
+		const ResourceMap::Handle r = _resources.getBucket(i);
+		if (r == ResourceMap::kInvalidHandle)
 			continue;
 
-		const Resource &res = r->second.back();
+		const Resource &res = _resources.get(r);
 
 		const Common::UString &name = res.name;
 		const Common::UString   ext = TypeMan.setFileType("", res.type);
-		const uint64           hash = r->first;
+		const uint64           hash = _resources.getHash(r);
 		const uint32           size = getResourceSize(res);
 
 		const Common::UString line =
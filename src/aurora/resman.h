@@ -29,25 +29,44 @@
 #include <vector>
 #include <map>
 #include <set>
+#include <unordered_map>
+#include <memory>
+
+#include <boost/function.hpp>
+
+#if defined(__MINGW32__ ) && !defined(_GLIBCXX_HAS_GTHREADS)
+	#include "external/mingw-std-threads/mingw.future.h"
+#else
+	#include <future>
+#endif
 
 #include "src/common/types.h"
 #include "src/common/ustring.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/mutex.h"
 #include "src/common/singleton.h"
 #include "src/common/filelist.h"
 #include "src/common/hash.h"
 #include "src/common/changeid.h"
+#include "src/common/priorityhashmap.h"
+#include "src/common/lrucache.h"
 
 #include "src/aurora/types.h"
+#include "src/aurora/archive.h"
+#include "src/aurora/resref.h"
 
 namespace Common {
 	class SeekableReadStream;
+	class MemoryReadStream;
+	class ThreadPool;
 }
 
 namespace Aurora {
 
-class Archive;
 class KEYFile;
 class KEYDataFile;
+class ResourceIndexCache;
 
 /** A resource manager holding information about and handling all request for all
  *  resources usable by the game.
@@ -60,6 +79,36 @@ public:
 		uint64 hash;
 	};
 
+	/** Statistics about indexing archives and directories. */
+	struct IndexStats {
+		uint32 fromCache; ///< Number of archives and directories indexed from the index cache.
+		uint32 fromDisk;  ///< Number of archives and directories indexed by reading them.
+
+		double cacheTime; ///< Time spent indexing from the index cache, in milliseconds.
+		double diskTime;  ///< Time spent indexing by reading archives and directories, in milliseconds.
+
+		IndexStats();
+	};
+
+	/** The cache of decompressed archive resources, keyed by archive and resource index. */
+	typedef Common::LRUCache<uint64, std::shared_ptr<Common::MemoryReadStream> > ResourceCache;
+	/** Statistics about the cache of decompressed archive resources. */
+	typedef ResourceCache::Stats ResourceCacheStats;
+
+	/** An archive to be indexed by indexArchives(). */
+	struct ArchiveIndexRequest {
+		Common::UString file;       ///< The name of the archive file, as for indexArchive().
+		uint32 priority;            ///< The priority of the archive's resources.
+		std::vector<byte> password; ///< The password to decrypt the archive file, if necessary.
+		bool optional;              ///< Silently skip the archive if it does not exist?
+		Common::ChangeID *changeID; ///< If given, record the changes done for this archive.
+
+		ArchiveIndexRequest(const Common::UString &f, uint32 p, bool o = false, Common::ChangeID *c = 0);
+	};
+
+	/** A function deciding whether indexArchives() should stop early. */
+	typedef boost::function<bool ()> IndexAbortFunc;
+
 	ResourceManager();
 	~ResourceManager();
 
@@ -107,6 +156,66 @@ public:
 	const Common::UString &getDataBase() const;
 	// '---
 
+	// .--- Index cache
+	/** Use a persistent cache for the index of archives and directories.
+	 *
+	 *  Information about archives and directories is looked up in this cache
+	 *  file before reading them. Cached archives are only opened once a
+	 *  resource within them is actually requested. The cache entries are
+	 *  invalidated when the size or modification time of any of the files
+	 *  they were built from changes.
+	 *
+	 *  Only archives found directly in the file system are cached.
+	 *
+	 *  @param fileName The file to read the cache from and write it to.
+	 */
+	void openIndexCache(const Common::UString &fileName);
+
+	/** Write the index cache back into its file and stop using it. */
+	void closeIndexCache();
+
+	/** Return statistics about indexing archives and directories so far. */
+	const IndexStats &getIndexStats() const;
+	// '---
+
+	// .--- Resource cache
+	/** Set the size of the cache for decompressed resources, in bytes.
+	 *
+	 *  Resources that are compressed or encrypted within their archive are
+	 *  kept in this cache after they have been decompressed, so that they
+	 *  don't have to be decompressed again when they're requested again.
+	 *  The least recently used resources are evicted when the cache grows
+	 *  larger than this size. A size of 0 disables the cache.
+	 */
+	void setResourceCacheSize(size_t size);
+
+	/** Return statistics about the cache for decompressed resources. */
+	ResourceCacheStats getResourceCacheStats() const;
+
+	/** Decompress these resources in the background, putting them into the resource cache.
+	 *
+	 *  The resources are looked up right away, and then read and decompressed
+	 *  on worker threads, while the calling thread can continue. Only resources
+	 *  that would be cached anyway are prefetched, and nothing is done at all
+	 *  when the resource cache is disabled.
+	 *
+	 *  Resources that fail to load are silently skipped. They will fail again,
+	 *  with an error, when they are requested with getResource().
+	 *
+	 *  Deindexing resources or clearing the resource manager waits for all
+	 *  running prefetches to finish first.
+	 *
+	 *  @param  names The names (ResRefs) of the resources.
+	 *  @param  types The types of the resources, in order of preference.
+	 *  @return A future for the number of resources now in the resource cache.
+	 */
+	std::shared_future<size_t> prefetch(const std::vector<Common::UString> &names,
+	                                    const std::vector<FileType> &types);
+
+	/** Wait for all running prefetches to finish. */
+	void waitForPrefetches();
+	// '---
+
 	// .--- Archives
 	/** Does a specific archive exist?
 	 *
@@ -139,6 +248,24 @@ public:
 	 */
 	void indexArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
 	                  Common::ChangeID *changeID = 0);
+
+	/** Add all the resources of several archives to the resource manager.
+	 *
+	 *  The archive files are opened and read on several threads at once.
+	 *  Their resources are then added in the order of the list, so the
+	 *  result is the same as calling indexArchive() on each of them, one
+	 *  after the other. If an archive fails to index, the archives before
+	 *  it stay indexed and the ones after it are not indexed.
+	 *
+	 *  If an abort function is given, it is called before each archive is
+	 *  read and before each archive's resources are added. Once it returns
+	 *  true, the remaining archives are silently left unindexed.
+	 *
+	 *  @param archives The archives to index.
+	 *  @param abort    If given, stop indexing once this returns true.
+	 */
+	void indexArchives(const std::vector<ArchiveIndexRequest> &archives,
+	                   const IndexAbortFunc &abort = IndexAbortFunc());
 	// '---
 
 	// .--- Directories and files
@@ -205,9 +332,20 @@ public:
 	 *  @param name The name (with extension) of the resource.
 	 */
 	void declareResource(const Common::UString &name);
+
+	/** Return the worker threads for reading archives in parallel.
+	 *
+	 *  Other subsystems that need worker threads should use these
+	 *  as well, instead of creating a pool of their own.
+	 */
+	Common::ThreadPool &getThreadPool() const;
 	// '---
 
 	// .--- Resources
+	/* NOTE: The methods querying and returning resources can safely be called
+	 *       from several threads at once, as long as no other thread modifies
+	 *       the resource index (by indexing or undoing) at the same time. */
+
 	/** Does a specific resource exist?
 	 *
 	 *  @param  hash The hash of the name and extension of the resource.
@@ -246,6 +384,14 @@ public:
 	 */
 	bool hasResource(const Common::UString &name, const std::vector<FileType> &types) const;
 
+	/** Does a specific resource exist?
+	 *
+	 *  @param  name The interned name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return true if the resource exists, false otherwise.
+	 */
+	bool hasResource(ResRefID name, FileType type) const;
+
 	/** Find and return the absolute filesystem file behind a resource.
 	 *
 	 *  If this resources does not exist, or the resource is not a direct file
@@ -301,6 +447,25 @@ public:
 	 */
 	Common::SeekableReadStream *getResource(const Common::UString &name, FileType type) const;
 
+	/** Return a resource.
+	 *
+	 *  @param  name The interned name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return The resource stream or 0 if the resource doesn't exist.
+	 */
+	Common::SeekableReadStream *getResource(ResRefID name, FileType type) const;
+
+	/** Return a resource, mapping it into memory instead of reading it, if possible.
+	 *
+	 *  This is meant for large resources that stay open for a long time,
+	 *  but of which only small parts are ever read, like talk tables.
+	 *
+	 *  @param  name The name (ResRef) of the resource.
+	 *  @param  type The resource's type.
+	 *  @return The resource stream or 0 if the resource doesn't exist.
+	 */
+	Common::SeekableReadStream *getResourceMapped(const Common::UString &name, FileType type) const;
+
 	/** Return a resource.
 	 *
 	 *  @param  name The name (with extension) of the resource.
@@ -321,6 +486,50 @@ public:
 	Common::SeekableReadStream *getResource(const Common::UString &name,
 			const std::vector<FileType> &types, FileType *foundType = 0) const;
 
+	/** Return a resource.
+	 *
+	 *  This only returns one stream, even if more than one of the specified file types exist
+	 *  for the given name.
+	 *
+	 *  @param  name The interned name (ResRef) of the resource.
+	 *  @param  types A list of file types to look for.
+	 *  @param  foundType If != 0, that's where the actually found type is stored.
+	 *  @return The resource stream or 0 if the resource doesn't exist.
+	 */
+	Common::SeekableReadStream *getResource(ResRefID name,
+			const std::vector<FileType> &types, FileType *foundType = 0) const;
+
+	/** Return several resources at once.
+	 *
+	 *  The resources are read, and decompressed if necessary, in parallel.
+	 *  This pays off for a set of compressed resources needed together,
+	 *  like all the textures of a model.
+	 *
+	 *  If reading any of the resources fails, the exception is rethrown
+	 *  after all other resources were read.
+	 *
+	 *  @param names      The names (ResRefs) of the resources.
+	 *  @param types      A list of file types to look for.
+	 *  @param streams    The resource streams, in the order of the names. 0 for
+	 *                    resources that don't exist.
+	 *  @param foundTypes If != 0, that's where the actually found types are stored.
+	 */
+	void getResources(const std::vector<Common::UString> &names, const std::vector<FileType> &types,
+	                  Common::PtrVector<Common::SeekableReadStream> &streams,
+	                  std::vector<FileType> *foundTypes = 0) const;
+
+	/** Return several resources of a specific type at once.
+	 *
+	 *  @param resType    The type of the resources.
+	 *  @param names      The names (ResRefs) of the resources.
+	 *  @param streams    The resource streams, in the order of the names. 0 for
+	 *                    resources that don't exist.
+	 *  @param foundTypes If != 0, that's where the actually found types are stored.
+	 */
+	void getResources(ResourceType resType, const std::vector<Common::UString> &names,
+	                  Common::PtrVector<Common::SeekableReadStream> &streams,
+	                  std::vector<FileType> *foundTypes = 0) const;
+
 	/** Return a resource of a specific type.
 	 *
 	 *  @param  resType The type of the resource.
@@ -366,12 +575,18 @@ private:
 	};
 
 	struct OpenedArchive {
-		/** The actual archive. */
+		/** The actual archive, or 0 if it was indexed from the cache and not yet opened. */
 		Archive *archive;
 
+		/** The password needed to open the archive, if any. */
+		std::vector<byte> password;
+
 		/** The information we know about this archive. */
 		KnownArchive *known;
 
+		/** A number unique to this opened archive, identifying its resources in the resource cache. */
+		uint32 id;
+
 		/** Is this archive is found in another archive, this is the "parent" archive. */
 		OpenedArchive *parent;
 		/** If this archive contains other archives, these are the opened "children" archives. */
@@ -379,13 +594,34 @@ private:
 
 		OpenedArchive();
 
-		void set(KnownArchive &kA, Archive &a);
+		void set(KnownArchive &kA, Archive *a);
 	};
 
 	/** List of all known archive files. */
 	typedef std::list<KnownArchive> KnownArchives;
 	/** List of all opened archive files. */
 	typedef std::list<OpenedArchive> OpenedArchives;
+
+	/** An archive read in preparation of adding its resources to the index. */
+	struct PendingArchive {
+		KnownArchive *known; ///< The archive that was read, or 0 if none was.
+		bool fromCache;      ///< Was it read from the index cache?
+
+		std::vector<Common::UString> names;    ///< For a KEY, the names of its BIFs.
+		std::vector<KnownArchive *>  archives; ///< The archives holding the resources.
+
+		/** When read from disk, the opened archives. */
+		Common::PtrVector<Archive> data;
+
+		std::vector<Common::HashAlgo>      hashAlgos; ///< When read from the cache, the name hashing algorithms.
+		std::vector<Archive::ResourceList> resources; ///< When read from the cache, the resource lists.
+
+		double time; ///< Time spent reading, in milliseconds.
+
+		PendingArchive();
+
+		void clear();
+	};
 	// '---
 
 	// .--- Resources
@@ -425,10 +661,8 @@ private:
 		bool operator<(const Resource &right) const;
 	};
 
-	/** List of resources, sorted by priority. */
-	typedef std::list<Resource> ResourceList;
-	/** Map over resources, indexed by their hashed name. */
-	typedef std::map<uint64, ResourceList> ResourceMap;
+	/** Map over resources, indexed by their hashed name and sorted by priority. */
+	typedef Common::PriorityHashMap<Resource> ResourceMap;
 	// '---
 
 	// .--- Changes
@@ -437,10 +671,7 @@ private:
 	/** A change produced by indexing/opening an archive. */
 	typedef OpenedArchives::iterator OpenedArchiveChange;
 	/** A change produced by indexing archive resources. */
-	struct ResourceChange {
-		ResourceMap::iterator  hashIt;
-		ResourceList::iterator resIt;
-	};
+	typedef ResourceMap::Handle ResourceChange;
 
 	typedef std::list<KnownArchiveChange>  KnownArchiveChanges;
 	typedef std::list<OpenedArchiveChange> OpenedArchiveChanges;
@@ -494,6 +725,32 @@ private:
 	ResourceMap   _resources; ///< All currently known resources.
 	ChangeSetList _changes;   ///< Changes produced by indexing the currently known resources.
 
+	Common::ScopedPtr<ResourceIndexCache> _indexCache; ///< The persistent index cache, if used.
+	Common::UString _indexCacheFile;                   ///< The file the index cache is saved to.
+
+	IndexStats _indexStats;
+
+	/** Decompressed archive resources. */
+	mutable ResourceCache _resourceCache;
+	/** The ID the next opened archive gets. */
+	uint32 _nextArchiveID;
+
+	/** Prefetches that might still be running. */
+	std::list< std::shared_future<size_t> > _prefetches;
+
+	/** Protects opening archives that were indexed from the cache. */
+	mutable std::mutex _archiveMutex;
+
+	/** Worker threads for reading archives in parallel, shared with other subsystems. */
+	mutable Common::ScopedPtr<Common::ThreadPool> _threadPool;
+	/** Protects creating the worker threads. */
+	mutable std::mutex _threadPoolMutex;
+
+	/** The lookup hashes of interned ResRefs, by ResRefID (upper 32 bits) and file type (lower 32 bits). */
+	mutable std::unordered_map<uint64, uint64> _resRefHashes;
+	/** Protects the ResRef lookup hashes. */
+	mutable std::mutex _resRefHashMutex;
+
 	FileTypeSet  _archiveTypeTypes [kArchiveMAX];  ///< All valid archive types file types.
 	FileTypeList _resourceTypeTypes[kResourceMAX]; ///< All valid resource type file types.
 
@@ -506,14 +763,34 @@ private:
 	// '---
 
 	// .--- Indexing archives
-	void indexKEY(Common::SeekableReadStream *stream, uint32 priority, Change *change);
-	uint32 openKEYBIFs(Common::SeekableReadStream *keyStream,
+	uint32 openKEYBIFs(Common::SeekableReadStream *keyStream, std::vector<Common::UString> &names,
 	                   std::vector<KnownArchive *> &archives, std::vector<KEYDataFile *> &keyData);
 
-	void indexArchive(KnownArchive &knownArchive, Archive *archive,
+	void readArchive(KnownArchive &knownArchive, const std::vector<byte> &password, PendingArchive &pending);
+
+	bool indexArchive(const ArchiveIndexRequest &request, PendingArchive &pending);
+	void indexArchive(KnownArchive &knownArchive, Archive *archive, const Archive::ResourceList &resources,
+	                  Common::HashAlgo hashAlgo, const std::vector<byte> &password,
 	                  uint32 priority, Change *change);
 
 	Common::SeekableReadStream *openArchiveStream(const KnownArchive &archive) const;
+
+	Archive *openArchive(const KnownArchive &knownArchive, const std::vector<byte> &password) const;
+	Archive *getArchive(OpenedArchive &archive) const;
+	// '---
+
+	// .--- Index cache
+	bool canCacheArchive(const KnownArchive &knownArchive) const;
+	Common::UString getIndexCacheKey(const KnownArchive &knownArchive, const std::vector<byte> &password) const;
+
+	bool readCachedArchive(KnownArchive &knownArchive, const std::vector<byte> &password,
+	                       PendingArchive &pending);
+	void addCachedArchive(const KnownArchive &knownArchive, const std::vector<byte> &password,
+	                      const std::vector<Common::UString> &names, const std::vector<KnownArchive *> &archives,
+	                      const std::vector<Archive *> &data);
+
+	bool findResourceFiles(const Common::UString &directory, const char *glob, int depth,
+	                       std::list<Common::UString> &files);
 	// '---
 
 	// .--- Adding resources
@@ -523,17 +800,23 @@ private:
 	void addResource(Resource &resource, uint64 hash, Change *change);
 	void addResource(const Common::UString &path, Change *change, uint32 priority);
 
-	void addResources(const Common::FileList &files, Change *change, uint32 priority);
+	void addResources(const std::list<Common::UString> &files, Change *change, uint32 priority);
 	// '---
 
 	// .--- Finding and getting resources
 	const Resource *getRes(uint64 hash) const;
 	const Resource *getRes(const Common::UString &name, const std::vector<FileType> &types) const;
 	const Resource *getRes(const Common::UString &name, FileType type) const;
+	const Resource *getRes(ResRefID name, const std::vector<FileType> &types) const;
 
 	Common::SeekableReadStream *getResource(const Resource &res, bool tryNoCopy = false) const;
 
 	Common::SeekableReadStream *getArchiveResource(const Resource &res, bool tryNoCopy = false) const;
+	Common::SeekableReadStream *getCachedResource(const Resource &res) const;
+	std::shared_ptr<Common::MemoryReadStream> readCachedResource(const Resource &res) const;
+
+	bool canCacheResource(const Resource &res) const;
+	bool prefetchResource(const Resource &res) const;
 
 	uint32 getResourceSize(const Resource &res) const;
 	// '---
@@ -547,8 +830,9 @@ private:
 
 	inline uint64 getHash(const Common::UString &name, FileType type) const;
 	inline uint64 getHash(const Common::UString &name) const;
+	uint64 getHash(ResRefID name, FileType type) const;
 
-	void checkHashCollision(const Resource &resource, ResourceMap::const_iterator resList);
+	void checkHashCollision(const Resource &resource, ResourceMap::Handle resList);
 
 	Change *newChangeSet(Common::ChangeID &changeID);
 	// '---
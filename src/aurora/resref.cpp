@@ -0,0 +1,161 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The global ResRef manager, interning resource names.
+ */
+
+#include "src/common/error.h"
+
+#include "src/aurora/resref.h"
+
+DECLARE_SINGLETON(Aurora::ResRefManager)
+
+namespace Aurora {
+
+ResRefManager::Entry::Entry() : hash(0) {
+}
+
+ResRefManager::IDTable::IDTable(size_t size) : mask(size - 1), slots(new std::atomic<uint32>[size]) {
+	for (size_t i = 0; i < size; i++)
+		slots[i].store(0, std::memory_order_relaxed);
+}
+
+ResRefManager::IDTable::~IDTable() {
+	delete[] slots;
+}
+
+
+ResRefManager::ResRefManager() : _count(0), _table(new IDTable(kTableSizeMin)) {
+	for (size_t i = 0; i < kChunkCount; i++)
+		_chunks[i].store(0, std::memory_order_relaxed);
+
+	// ID 0 is always the empty ResRef
+	intern("");
+}
+
+ResRefManager::~ResRefManager() {
+	delete _table.load(std::memory_order_relaxed);
+
+	for (size_t i = 0; i < kChunkCount; i++)
+		delete[] _chunks[i].load(std::memory_order_relaxed);
+}
+
+ResRefID ResRefManager::intern(const Common::UString &name) {
+	const size_t hash = name.hashIgnoreCase();
+
+	ResRefID found;
+	if (findID(*_table.load(std::memory_order_acquire), name, hash, found))
+		return found;
+
+	std::lock_guard<std::mutex> lock(_mutex);
+
+	// Another thread might have interned the name while we waited for the lock
+	IDTable *table = _table.load(std::memory_order_relaxed);
+	if (findID(*table, name, hash, found))
+		return found;
+
+	const size_t id = _count.load(std::memory_order_relaxed);
+	if (id >= (kChunkSize * kChunkCount))
+		throw Common::Exception("Too many ResRefs interned");
+
+	Entry *chunk = _chunks[id / kChunkSize].load(std::memory_order_relaxed);
+	if (!chunk) {
+		chunk = new Entry[kChunkSize];
+		_chunks[id / kChunkSize].store(chunk, std::memory_order_release);
+	}
+
+	Entry &entry = chunk[id % kChunkSize];
+
+	entry.name = name.toLower();
+	entry.hash = hash;
+
+	// Only publish the ID once the entry is complete
+	_count.store(id + 1, std::memory_order_release);
+
+	if (((id + 1) * 2) > (table->mask + 1)) {
+		// The table is getting too full. Replace it by a bigger one, with all IDs
+		IDTable *bigger = new IDTable((table->mask + 1) * 2);
+		for (size_t i = 0; i <= id; i++)
+			addID(*bigger, (ResRefID) i, getEntry(i).hash);
+
+		_table.store(bigger, std::memory_order_release);
+		_oldTables.push_back(table);
+
+	} else
+		addID(*table, (ResRefID) id, hash);
+
+	return (ResRefID) id;
+}
+
+ResRefID ResRefManager::find(const Common::UString &name) const {
+	ResRefID id;
+	if (findID(*_table.load(std::memory_order_acquire), name, name.hashIgnoreCase(), id))
+		return id;
+
+	return kResRefIDNone;
+}
+
+bool ResRefManager::findID(const IDTable &table, const Common::UString &name, size_t hash,
+                           ResRefID &id) const {
+
+	// The table is never more than half full, so there's always an empty slot to stop at
+	for (size_t i = hash & table.mask; ; i = (i + 1) & table.mask) {
+		const uint32 slot = table.slots[i].load(std::memory_order_acquire);
+		if (slot == 0)
+			return false;
+
+		const Entry &entry = getEntry(slot - 1);
+		if ((entry.hash == hash) && entry.name.equalsIgnoreCase(name)) {
+			id = slot - 1;
+			return true;
+		}
+	}
+}
+
+void ResRefManager::addID(IDTable &table, ResRefID id, size_t hash) {
+	size_t i = hash & table.mask;
+	while (table.slots[i].load(std::memory_order_relaxed) != 0)
+		i = (i + 1) & table.mask;
+
+	// The entry was published before, so readers finding the ID also find a complete entry
+	table.slots[i].store(id + 1, std::memory_order_release);
+}
+
+const ResRefManager::Entry &ResRefManager::getEntry(ResRefID id) const {
+	if (id >= _count.load(std::memory_order_acquire))
+		throw Common::Exception("Invalid ResRef ID %u", (uint)id);
+
+	return _chunks[id / kChunkSize].load(std::memory_order_acquire)[id % kChunkSize];
+}
+
+const Common::UString &ResRefManager::getName(ResRefID id) const {
+	return getEntry(id).name;
+}
+
+size_t ResRefManager::getHash(ResRefID id) const {
+	return getEntry(id).hash;
+}
+
+size_t ResRefManager::getCount() const {
+	return _count.load(std::memory_order_acquire);
+}
+
+} // End of namespace Aurora
@@ -0,0 +1,131 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  The global ResRef manager, interning resource names.
+ */
+
+#ifndef AURORA_RESREF_H
+#define AURORA_RESREF_H
+
+#include <atomic>
+
+#include "src/common/types.h"
+#include "src/common/ustring.h"
+#include "src/common/mutex.h"
+#include "src/common/singleton.h"
+#include "src/common/ptrvector.h"
+
+namespace Aurora {
+
+/** The ID of an interned ResRef. */
+typedef uint32 ResRefID;
+
+/** The ID of the empty ResRef, which is always interned. */
+static const ResRefID kResRefIDNone = 0;
+
+/** The global ResRef manager, handing out IDs for resource names.
+ *
+ *  The same resource names turn up in lots of places, and as ResRefs are
+ *  case-insensitive, comparing and hashing them isn't free. Interning a
+ *  ResRef returns a 32-bit ID, which is the same for all ResRefs that only
+ *  differ in case. These IDs can be compared directly, and they're valid
+ *  for the whole lifetime of the process: interned names are never removed.
+ *
+ *  Each interned name is stored once, in lowercase, together with its
+ *  precomputed case-insensitive hash, the same as hashUStringCaseInsensitive
+ *  returns for it. Names are found through a hash table of IDs, which
+ *  refers back to these entries instead of holding copies of the names.
+ *
+ *  Only adding a new name takes a lock. Finding the ID of a name, and
+ *  getting the name and hash of an ID, don't, so these can be done freely
+ *  from any thread.
+ */
+class ResRefManager : public Common::Singleton<ResRefManager> {
+public:
+	ResRefManager();
+	~ResRefManager();
+
+	/** Return the ID of this ResRef, interning it first if necessary. */
+	ResRefID intern(const Common::UString &name);
+
+	/** Return the ID of this ResRef if it was interned already, kResRefIDNone otherwise. */
+	ResRefID find(const Common::UString &name) const;
+
+	/** Return the (lowercase) name of an interned ResRef. */
+	const Common::UString &getName(ResRefID id) const;
+	/** Return the case-insensitive hash of an interned ResRef's name. */
+	size_t getHash(ResRefID id) const;
+
+	/** Return the number of ResRefs interned so far, including the empty one. */
+	size_t getCount() const;
+
+private:
+	static const size_t kChunkSize  = 4096;
+	static const size_t kChunkCount = 4096;
+
+	static const size_t kTableSizeMin = 4096;
+
+	struct Entry {
+		Common::UString name;
+		size_t hash;
+
+		Entry();
+	};
+
+	/** A hash table of IDs, keyed by the names of their entries, with linear probing.
+	 *
+	 *  Slots only ever go from empty to filled. Once a table gets half full,
+	 *  a bigger one replaces it, so readers never see a table being changed
+	 *  in any other way.
+	 */
+	struct IDTable {
+		size_t mask;                 ///< The number of slots, minus 1.
+		std::atomic<uint32> *slots;  ///< ID + 1 of the entry in each slot, 0 for empty slots.
+
+		IDTable(size_t size);
+		~IDTable();
+	};
+
+	/** The entries, by ID, in chunks that never move once allocated. */
+	std::atomic<Entry *> _chunks[kChunkCount];
+
+	std::atomic<size_t> _count;
+
+	/** The current table for finding IDs by name. */
+	std::atomic<IDTable *> _table;
+	/** Tables that were replaced, kept alive for readers that might still use them. */
+	Common::PtrVector<IDTable> _oldTables;
+
+	/** Protects interning. */
+	std::mutex _mutex;
+
+	const Entry &getEntry(ResRefID id) const;
+
+	bool findID(const IDTable &table, const Common::UString &name, size_t hash, ResRefID &id) const;
+	void addID(IDTable &table, ResRefID id, size_t hash);
+};
+
+} // End of namespace Aurora
+
+/** Shortcut for accessing the ResRef manager. */
+#define ResRefMan ::Aurora::ResRefManager::instance()
+
+#endif // AURORA_RESREF_H
@@ -37,7 +37,7 @@ DECLARE_SINGLETON(Aurora::TalkManager)
 
 namespace Aurora {
 
-TalkManager::TalkManager() {
+TalkManager::TalkManager() : _cacheSize(TalkTable::kDefaultCacheSize) {
 }
 
 TalkManager::~TalkManager() {
@@ -58,7 +58,7 @@ static TalkTable *loadTable(const Common::UString &name, Common::Encoding encodi
 	if (name.empty())
 		return 0;
 
-	Common::SeekableReadStream *tlk = ResMan.getResource(name, kFileTypeTLK);
+	Common::SeekableReadStream *tlk = ResMan.getResourceMapped(name, kFileTypeTLK);
 	if (!tlk)
 		return 0;
 
@@ -84,6 +84,11 @@ void TalkManager::addTable(const Common::UString &nameMale, const Common::UStrin
 	if (!tableMale && !tableFemale)
 		throw Common::Exception("No such talk table \"%s\"/\"%s\"", nameMale.c_str(), nameFemale.c_str());
 
+	if (tableMale)
+		tableMale->setCacheSize(_cacheSize);
+	if (tableFemale)
+		tableFemale->setCacheSize(_cacheSize);
+
 	Tables *tables = &_tablesMain;
 	if (isAlt)
 		tables = &_tablesAlt;
@@ -126,35 +131,52 @@ void TalkManager::removeTable(Common::ChangeID &changeID) {
 	changeID.clear();
 }
 
-static const Common::UString kEmptyString = "";
-const Common::UString &TalkManager::getString(uint32 strRef, LanguageGender gender) {
+Common::UString TalkManager::getString(uint32 strRef, LanguageGender gender) {
 	if (gender == kLanguageGenderCurrent)
 		gender = LangMan.getCurrentGender();
 
 	if (strRef == kStrRefInvalid)
-		return kEmptyString;
+		return "";
 
 	const TalkTable *table = find(strRef, gender);
 	if (!table)
-		return kEmptyString;
+		return "";
 
 	return table->getString(strRef);
 }
 
-const Common::UString &TalkManager::getSoundResRef(uint32 strRef, LanguageGender gender) {
+Common::UString TalkManager::getSoundResRef(uint32 strRef, LanguageGender gender) {
 	if (gender == kLanguageGenderCurrent)
 		gender = LangMan.getCurrentGender();
 
 	if (strRef == kStrRefInvalid)
-		return kEmptyString;
+		return "";
 
 	const TalkTable *table = find(strRef, gender);
 	if (!table)
-		return kEmptyString;
+		return "";
 
 	return table->getSoundResRef(strRef);
 }
 
+void TalkManager::setCacheSize(size_t size) {
+	_cacheSize = size;
+
+	for (Tables::iterator t = _tablesMain.begin(); t != _tablesMain.end(); ++t) {
+		if (t->tableMale)
+			t->tableMale->setCacheSize(size);
+		if (t->tableFemale)
+			t->tableFemale->setCacheSize(size);
+	}
+
+	for (Tables::iterator t = _tablesAlt.begin(); t != _tablesAlt.end(); ++t) {
+		if (t->tableMale)
+			t->tableMale->setCacheSize(size);
+		if (t->tableFemale)
+			t->tableFemale->setCacheSize(size);
+	}
+}
+
 const TalkTable *TalkManager::find(const Tables &tables, uint32 strRef, LanguageGender gender) const {
 	/* Look for the strRef in decreasing priority.
 	 *
@@ -60,8 +60,11 @@ public:
 	/** Remove a talk table from the talk manager again. */
 	void removeTable(Common::ChangeID &changeID);
 
-	const Common::UString &getString     (uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
-	const Common::UString &getSoundResRef(uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
+	Common::UString getString     (uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
+	Common::UString getSoundResRef(uint32 strRef, LanguageGender gender = kLanguageGenderCurrent);
+
+	/** Set the size of the cache of decoded strings each talk table keeps, in bytes. */
+	void setCacheSize(size_t size);
 
 private:
 	struct Table {
@@ -98,6 +101,8 @@ private:
 	Tables _tablesMain;
 	Tables _tablesAlt;
 
+	size_t _cacheSize;
+
 
 	void deleteTable(Table &table);
 
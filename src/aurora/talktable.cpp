@@ -22,6 +22,8 @@
  *  Base class for BioWare's talk tables.
  */
 
+#include <cstring>
+
 #include "src/common/util.h"
 #include "src/common/scopedptr.h"
 #include "src/common/readstream.h"
@@ -36,12 +38,31 @@ static const uint32 kGFFID = MKTAG('G', 'F', 'F', ' ');
 
 namespace Aurora {
 
-TalkTable::TalkTable(Common::Encoding encoding) : _encoding(encoding) {
+const size_t TalkTable::kDefaultCacheSize;
+
+TalkTable::TalkTable(Common::Encoding encoding) : _encoding(encoding), _cache(kDefaultCacheSize) {
 }
 
 TalkTable::~TalkTable() {
 }
 
+void TalkTable::setCacheSize(size_t size) {
+	_cache.setBudget(size);
+}
+
+TalkTable::CacheStats TalkTable::getCacheStats() const {
+	return _cache.getStats();
+}
+
+bool TalkTable::getCachedString(uint32 strRef, Common::UString &str) const {
+	return _cache.get(strRef, str);
+}
+
+void TalkTable::putCachedString(uint32 strRef, const Common::UString &str) const {
+	// Count the string data and roughly the bookkeeping around it
+	_cache.put(strRef, str, strlen(str.c_str()) + sizeof(Common::UString) + 32);
+}
+
 TalkTable *TalkTable::load(Common::SeekableReadStream *tlk, Common::Encoding encoding) {
 	Common::ScopedPtr<Common::SeekableReadStream> tlkStream(tlk);
 	if (!tlkStream)
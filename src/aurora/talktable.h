@@ -28,10 +28,11 @@
 #include <boost/noncopyable.hpp>
 
 #include "src/common/types.h"
+#include "src/common/ustring.h"
 #include "src/common/encoding.h"
+#include "src/common/lrucache.h"
 
 namespace Common {
-	class UString;
 	class SeekableReadStream;
 }
 
@@ -48,18 +49,34 @@ namespace Aurora {
  *
  *  See classes TalkTable_TLK and TalkTable_GFF for the two main
  *  formats a talk table can be found in.
+ *
+ *  Strings are decoded when they're requested. Decoded strings are kept
+ *  in a cache of limited size, evicting the least recently used ones.
+ *  Since a string might be evicted at any time, they're returned by value.
+ *  All methods can be called from several threads at once.
  */
 class TalkTable : boost::noncopyable {
 public:
+	/** Statistics about the cache of decoded strings. */
+	typedef Common::LRUCache<uint32, Common::UString>::Stats CacheStats;
+
+	/** The default size of the cache of decoded strings, in bytes. */
+	static const size_t kDefaultCacheSize = 1024 * 1024;
+
 	virtual ~TalkTable();
 
 	virtual bool hasEntry(uint32 strRef) const = 0;
 
-	virtual const Common::UString &getString     (uint32 strRef) const = 0;
-	virtual const Common::UString &getSoundResRef(uint32 strRef) const = 0;
+	virtual Common::UString getString     (uint32 strRef) const = 0;
+	virtual Common::UString getSoundResRef(uint32 strRef) const = 0;
 
 	virtual uint32 getSoundID(uint32 strRef) const = 0;
 
+	/** Set the size of the cache of decoded strings, in bytes. 0 disables the cache. */
+	void setCacheSize(size_t size);
+	/** Return statistics about the cache of decoded strings. */
+	CacheStats getCacheStats() const;
+
 	/** Take over this stream and read a talk table (of either format) out of it. */
 	static TalkTable *load(Common::SeekableReadStream *tlk, Common::Encoding encoding);
 
@@ -68,6 +85,14 @@ protected:
 	TalkTable(Common::Encoding encoding);
 
 	Common::Encoding _encoding;
+
+	/** Look up a decoded string in the cache. */
+	bool getCachedString(uint32 strRef, Common::UString &str) const;
+	/** Put a decoded string into the cache. */
+	void putCachedString(uint32 strRef, const Common::UString &str) const;
+
+private:
+	mutable Common::LRUCache<uint32, Common::UString> _cache;
 };
 
 } // End of namespace Aurora
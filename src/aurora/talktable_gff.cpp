@@ -31,6 +31,7 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/readstream.h"
+#include "src/common/encoding.h"
 
 #include "src/aurora/talktable_gff.h"
 #include "src/aurora/gff4file.h"
@@ -55,19 +56,23 @@ bool TalkTable_GFF::hasEntry(uint32 strRef) const {
 	return _entries.find(strRef) != _entries.end();
 }
 
-static const Common::UString kEmptyString = "";
-const Common::UString &TalkTable_GFF::getString(uint32 strRef) const {
-	Entries::iterator e = _entries.find(strRef);
+Common::UString TalkTable_GFF::getString(uint32 strRef) const {
+	Entries::const_iterator e = _entries.find(strRef);
 	if (e == _entries.end())
-		return kEmptyString;
+		return "";
 
-	readString(*e->second);
+	Common::UString str;
+	if (getCachedString(strRef, str))
+		return str;
 
-	return e->second->text;
+	str = readString(*e->second);
+
+	putCachedString(strRef, str);
+	return str;
 }
 
-const Common::UString &TalkTable_GFF::getSoundResRef(uint32 UNUSED(strRef)) const {
-	return kEmptyString;
+Common::UString TalkTable_GFF::getSoundResRef(uint32 UNUSED(strRef)) const {
+	return "";
 }
 
 uint32 TalkTable_GFF::getSoundID(uint32 UNUSED(strRef)) const {
@@ -101,22 +106,7 @@ void TalkTable_GFF::load02(const GFF4Struct &top) {
 	if (!top.hasField(kGFF4TalkStringList))
 		return;
 
-	const GFF4List &strings = top.getList(kGFF4TalkStringList);
-
-	for (GFF4List::const_iterator s = strings.begin(); s != strings.end(); ++s) {
-		if (!*s)
-			continue;
-
-		uint32 strRef = (*s)->getUint(kGFF4TalkStringID, 0xFFFFFFFF);
-		if (strRef == 0xFFFFFFFF)
-			continue;
-
-		Common::ScopedPtr<Entry> entry(new Entry(*s));
-
-		std::pair<Entries::iterator, bool> result = _entries.insert(std::make_pair(strRef, entry.get()));
-		if (result.second)
-			entry.release();
-	}
+	addEntries(top.getList(kGFF4TalkStringList), kGFF4TalkStringID);
 }
 
 void TalkTable_GFF::load05(const GFF4Struct &top) {
@@ -125,62 +115,64 @@ void TalkTable_GFF::load05(const GFF4Struct &top) {
 	    !top.hasField(kGFF4HuffTalkStringBitStream))
 		return;
 
-	const GFF4List &strings = top.getList(kGFF4HuffTalkStringList);
+	const bool bigEndian = _gff->isBigEndian();
+
+	/* Both data streams share the GFF4's stream, so each one has to be
+	 * read completely before the next one is created. */
+
+	Common::ScopedPtr<Common::SeekableReadStream> huffTree(top.getData(kGFF4HuffTalkStringHuffTree));
+	if (!huffTree)
+		return;
+
+	_huffTree.resize(huffTree->size() / 4);
+	for (std::vector<int32>::iterator n = _huffTree.begin(); n != _huffTree.end(); ++n)
+		*n = bigEndian ? huffTree->readSint32BE() : huffTree->readSint32LE();
+
+	Common::ScopedPtr<Common::SeekableReadStream> bitStream(top.getData(kGFF4HuffTalkStringBitStream));
+	if (!bitStream) {
+		_huffTree.clear();
+		return;
+	}
 
+	_bitStream.resize(bitStream->size() / 4);
+	for (std::vector<uint32>::iterator b = _bitStream.begin(); b != _bitStream.end(); ++b)
+		*b = bigEndian ? bitStream->readUint32BE() : bitStream->readUint32LE();
+
+	addEntries(top.getList(kGFF4HuffTalkStringList), kGFF4HuffTalkStringID);
+}
+
+void TalkTable_GFF::addEntries(const GFF4List &strings, uint32 idField) {
 	for (GFF4List::const_iterator s = strings.begin(); s != strings.end(); ++s) {
 		if (!*s)
 			continue;
 
-		uint32 strRef = (*s)->getUint(kGFF4HuffTalkStringID, 0xFFFFFFFF);
+		uint32 strRef = (*s)->getUint(idField, 0xFFFFFFFF);
 		if (strRef == 0xFFFFFFFF)
 			continue;
 
-		Common::ScopedPtr<Entry> entry(new Entry(*s));
-
-		std::pair<Entries::iterator, bool> result = _entries.insert(std::make_pair(strRef, entry.get()));
-		if (result.second)
-			entry.release();
+		// The first string with a StrRef wins
+		_entries.insert(std::make_pair(strRef, *s));
 	}
 }
 
-void TalkTable_GFF::readString(Entry &entry) const {
-	if (!entry.strct)
-		return;
+Common::UString TalkTable_GFF::readString(const GFF4Struct &strct) const {
+	if (_gff->getTypeVersion() == kVersion02)
+		return readString02(strct);
 
-	if      (_gff->getTypeVersion() == kVersion02)
-		readString02(entry);
-	else if (_gff->getTypeVersion() == kVersion04)
-		readString05(entry, _gff->isBigEndian());
-	else if (_gff->getTypeVersion() == kVersion05)
-		readString05(entry, _gff->isBigEndian());
-
-	entry.strct = 0;
-}
-
-void TalkTable_GFF::readString02(Entry &entry) const {
-	if (_encoding != Common::kEncodingInvalid)
-		entry.text = entry.strct->getString(kGFF4TalkString, _encoding);
-	else
-		entry.text = "[???]";
+	return readString05(strct);
 }
 
-void TalkTable_GFF::readString05(Entry &entry, bool bigEndian) const {
-	Common::ScopedPtr<Common::SeekableReadStream>
-		huffTree (_gff->getTopLevel().getData(kGFF4HuffTalkStringHuffTree)),
-		bitStream(_gff->getTopLevel().getData(kGFF4HuffTalkStringBitStream));
+Common::UString TalkTable_GFF::readString02(const GFF4Struct &strct) const {
+	if (_encoding == Common::kEncodingInvalid)
+		return "[???]";
 
-	if (!huffTree || !bitStream)
-		return;
+	// Strings are read through the GFF4's stream, which can't be shared between threads
+	std::lock_guard<std::mutex> lock(_mutex);
 
-	Common::SeekableSubReadStreamEndian huffTreeEndian(huffTree.get(), 0, huffTree->size(), bigEndian);
-	Common::SeekableSubReadStreamEndian bitStreamEndian(bitStream.get(), 0, bitStream->size(), bigEndian);
-
-	readString05(huffTreeEndian, bitStreamEndian, entry);
+	return strct.getString(kGFF4TalkString, _encoding);
 }
 
-void TalkTable_GFF::readString05(Common::SeekableSubReadStreamEndian &huffTree,
-                                 Common::SeekableSubReadStreamEndian &bitStream, Entry &entry) const {
-
+Common::UString TalkTable_GFF::readString05(const GFF4Struct &strct) const {
 	/* Read a string encoded in a Huffman'd bitstream.
 	 *
 	 * The Huffman tree itself is made up of signed 32bit nodes:
@@ -190,22 +182,31 @@ void TalkTable_GFF::readString05(Common::SeekableSubReadStreamEndian &huffTree,
 	 * Kudos to Rick (gibbed) (<http://gib.me/>).
 	 */
 
+	if (_huffTree.empty() || _bitStream.empty())
+		return "";
+
 	std::vector<uint16> utf16Str;
+	bool isASCII = true;
 
-	const uint32 startOffset = entry.strct->getUint(kGFF4HuffTalkStringBitOffset);
+	const uint32 startOffset = strct.getUint(kGFF4HuffTalkStringBitOffset);
 
 	uint32 index = startOffset >> 5;
 	uint32 shift = startOffset & 0x1F;
 
 	do {
-		ptrdiff_t e = (huffTree.size() / 8) - 1;
+		ptrdiff_t e = (_huffTree.size() / 2) - 1;
 
 		while (e >= 0) {
-			bitStream.seek(index * 4);
-			const ptrdiff_t offset = (bitStream.readUint32() >> shift) & 1;
+			if (index >= _bitStream.size())
+				throw Common::Exception("Huffman-encoded string out of range");
+
+			const ptrdiff_t offset = (_bitStream[index] >> shift) & 1;
 
-			huffTree.seek(((e * 2) + offset) * 4);
-			e = huffTree.readSint32();
+			const size_t node = (e * 2) + offset;
+			if (node >= _huffTree.size())
+				throw Common::Exception("Invalid Huffman tree node");
+
+			e = _huffTree[node];
 
 			shift++;
 			index += (shift >> 5);
@@ -213,14 +214,23 @@ void TalkTable_GFF::readString05(Common::SeekableSubReadStreamEndian &huffTree,
 			shift %= 32;
 		}
 
-		utf16Str.push_back(TO_LE_16(0xFFFF - e));
+		utf16Str.push_back(0xFFFF - e);
+
+		isASCII = isASCII && (utf16Str.back() < 0x80);
 
 	} while (utf16Str.back() != 0);
 
+	// Plain ASCII strings don't need to be converted
+	if (isASCII)
+		return Common::UString(std::string(utf16Str.begin(), utf16Str.end() - 1));
+
+	for (std::vector<uint16>::iterator c = utf16Str.begin(); c != utf16Str.end(); ++c)
+		*c = TO_LE_16(*c);
+
 	const byte  *data = reinterpret_cast<const byte *>(&utf16Str[0]);
 	const size_t size = utf16Str.size() * 2;
 
-	entry.text = Common::readString(data, size, Common::kEncodingUTF16LE);
+	return Common::readString(data, size, Common::kEncodingUTF16LE);
 }
 
 } // End of namespace Aurora
@@ -25,19 +25,19 @@
 #ifndef AURORA_TALKTABLE_GFF_H
 #define AURORA_TALKTABLE_GFF_H
 
-#include <map>
+#include <vector>
+#include <unordered_map>
 
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
-#include "src/common/ptrmap.h"
 #include "src/common/ustring.h"
+#include "src/common/mutex.h"
 
 #include "src/aurora/types.h"
 #include "src/aurora/talktable.h"
 
 namespace Common {
 	class SeekableReadStream;
-	class SeekableSubReadStreamEndian;
 }
 
 namespace Aurora {
@@ -56,6 +56,10 @@ namespace Aurora {
  *  - V0.2, used by Sonic Chronicles and Dragon Age: Origins (PC)
  *  - V0.4, used by Dragon Age: Origins (Xbox 360)
  *  - V0.5, used by Dragon Age II
+ *
+ *  The Huffman tree and bit stream of V0.4 and V0.5 talk tables are read
+ *  into memory when loading, and strings are decoded out of them when
+ *  they're needed. Decoded strings are put into the cache.
  */
 class TalkTable_GFF : public TalkTable {
 public:
@@ -65,38 +69,38 @@ public:
 
 	bool hasEntry(uint32 strRef) const;
 
-	const Common::UString &getString     (uint32 strRef) const;
-	const Common::UString &getSoundResRef(uint32 strRef) const;
+	Common::UString getString     (uint32 strRef) const;
+	Common::UString getSoundResRef(uint32 strRef) const;
 
 	uint32 getSoundID(uint32 strRef) const;
 
 
 private:
-	struct Entry {
-		Common::UString text;
-
-		const GFF4Struct *strct;
+	/** StrRef -> the struct holding the string. */
+	typedef std::unordered_map<uint32, const GFF4Struct *> Entries;
 
-		Entry(const GFF4Struct *s = 0) : strct(s) { }
-	};
 
-	typedef Common::PtrMap<uint32, Entry> Entries;
+	Common::ScopedPtr<GFF4File> _gff;
 
+	Entries _entries;
 
-	Common::ScopedPtr<GFF4File> _gff;
+	/** The nodes of the Huffman tree (V0.4 and V0.5). */
+	std::vector<int32>  _huffTree;
+	/** The Huffman-encoded strings (V0.4 and V0.5). */
+	std::vector<uint32> _bitStream;
 
-	mutable Entries _entries;
+	/** Protects reading V0.2 strings out of the GFF4. */
+	mutable std::mutex _mutex;
 
 	void load(Common::SeekableReadStream *tlk);
 	void load02(const GFF4Struct &top);
 	void load05(const GFF4Struct &top);
 
-	void readString(Entry &entry) const;
-	void readString02(Entry &entry) const;
-	void readString05(Entry &entry, bool bigEndian) const;
+	void addEntries(const GFF4List &strings, uint32 idField);
 
-	void readString05(Common::SeekableSubReadStreamEndian &huffTree,
-	                  Common::SeekableSubReadStreamEndian &bitStream, Entry &entry) const;
+	Common::UString readString(const GFF4Struct &strct) const;
+	Common::UString readString02(const GFF4Struct &strct) const;
+	Common::UString readString05(const GFF4Struct &strct) const;
 };
 
 } // End of namespace Aurora
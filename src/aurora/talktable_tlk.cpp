@@ -27,12 +27,14 @@
  */
 
 #include <cassert>
+#include <algorithm>
 
 #include "src/common/util.h"
 #include "src/common/strutil.h"
 #include "src/common/memreadstream.h"
 #include "src/common/readfile.h"
 #include "src/common/error.h"
+#include "src/common/encoding.h"
 
 #include "src/aurora/talktable_tlk.h"
 #include "src/aurora/language.h"
@@ -41,10 +43,16 @@ static const uint32 kTLKID    = MKTAG('T', 'L', 'K', ' ');
 static const uint32 kVersion3 = MKTAG('V', '3', '.', '0');
 static const uint32 kVersion4 = MKTAG('V', '4', '.', '0');
 
+static const size_t kEntrySizeV3 = 40;
+static const size_t kEntrySizeV4 = 10;
+
+static const size_t kSoundResRefLength = 16;
+
 namespace Aurora {
 
 TalkTable_TLK::TalkTable_TLK(Common::SeekableReadStream *tlk, Common::Encoding encoding) :
-	TalkTable(encoding), _tlk(tlk) {
+	TalkTable(encoding), _tlk(tlk), _data(0), _dataSize(0), _languageID(0),
+	_entryCount(0), _tableOffset(0), _stringsOffset(0) {
 
 	assert(_tlk);
 
@@ -65,25 +73,20 @@ void TalkTable_TLK::load() {
 			throw Common::Exception("Unsupported TLK file version %s", Common::debugTag(_version).c_str());
 
 		_languageID = _tlk->readUint32LE();
-
-		uint32 stringCount = _tlk->readUint32LE();
-		_entries.resize(stringCount);
+		_entryCount = _tlk->readUint32LE();
 
 		// V4 added this field; it's right after the header in V3
-		uint32 tableOffset = 20;
+		_tableOffset = 20;
 		if (_version == kVersion4)
-			tableOffset = _tlk->readUint32LE();
+			_tableOffset = _tlk->readUint32LE();
 
-		const uint32 stringsOffset = _tlk->readUint32LE();
+		_stringsOffset = _tlk->readUint32LE();
 
-		// Go to the table
-		_tlk->seek(tableOffset);
+		loadData();
 
-		// Read in all the table data
-		if (_version == kVersion3)
-			readEntryTableV3(stringsOffset);
-		else
-			readEntryTableV4();
+		const size_t entrySize = (_version == kVersion3) ? kEntrySizeV3 : kEntrySizeV4;
+		if ((_tableOffset > _dataSize) || (((_dataSize - _tableOffset) / entrySize) < _entryCount))
+			throw Common::Exception("Entry table out of range");
 
 	} catch (Common::Exception &e) {
 		e.add("Failed reading TLK file");
@@ -91,48 +94,111 @@ void TalkTable_TLK::load() {
 	}
 }
 
-void TalkTable_TLK::readEntryTableV3(uint32 stringsOffset) {
-	for (Entries::iterator entry = _entries.begin(); entry != _entries.end(); ++entry) {
-		entry->flags          = _tlk->readUint32LE();
-		entry->soundResRef    = Common::readStringFixed(*_tlk, Common::kEncodingASCII, 16);
-		entry->volumeVariance = _tlk->readUint32LE();
-		entry->pitchVariance  = _tlk->readUint32LE();
-		entry->offset         = _tlk->readUint32LE() + stringsOffset;
-		entry->length         = _tlk->readUint32LE();
-		entry->soundLength    = _tlk->readIEEEFloatLE();
-		entry->soundID        = kFieldIDInvalid;
+void TalkTable_TLK::loadData() {
+	/* We read the entries straight out of memory, so we need the whole
+	 * file in one contiguous block. TLKs are usually memory-mapped, and
+	 * then we already have that. If not, read the file into memory. */
+
+	Common::MemoryReadStream *memStream = dynamic_cast<Common::MemoryReadStream *>(_tlk.get());
+	if (!memStream) {
+		_tlk->seek(0);
+		memStream = _tlk->readStream(_tlk->size());
+
+		_tlk.reset(memStream);
 	}
+
+	_data     = memStream->getData();
+	_dataSize = memStream->size();
 }
 
-void TalkTable_TLK::readEntryTableV4() {
-	for (Entries::iterator entry = _entries.begin(); entry != _entries.end(); ++entry) {
-		entry->soundID = _tlk->readUint32LE();
-		entry->offset  = _tlk->readUint32LE();
-		entry->length  = _tlk->readUint16LE();
-		entry->flags   = kFlagTextPresent;
+bool TalkTable_TLK::getEntry(uint32 strRef, Entry &entry) const {
+	if (strRef >= _entryCount)
+		return false;
+
+	if (_version == kVersion3) {
+		const byte *data = _data + _tableOffset + strRef * kEntrySizeV3;
+
+		entry.flags       = READ_LE_UINT32(data);
+		entry.soundResRef = data + 4;
+		entry.offset      = READ_LE_UINT32(data + 28) + _stringsOffset;
+		entry.length      = READ_LE_UINT32(data + 32);
+		entry.soundID     = kFieldIDInvalid;
+
+	} else {
+		const byte *data = _data + _tableOffset + strRef * kEntrySizeV4;
+
+		entry.soundID     = READ_LE_UINT32(data);
+		entry.offset      = READ_LE_UINT32(data + 4);
+		entry.length      = READ_LE_UINT16(data + 8);
+		entry.flags       = kFlagTextPresent;
+		entry.soundResRef = 0;
 	}
+
+	return true;
 }
 
-void TalkTable_TLK::readString(Entry &entry) const {
-	if (!entry.text.empty() || (entry.length == 0) || !(entry.flags & kFlagTextPresent))
-		// We already have the string
-		return;
+/** Does this encoding encode all 7-bit ASCII characters as themselves? */
+static bool isASCIICompatible(Common::Encoding encoding) {
+	switch (encoding) {
+		case Common::kEncodingASCII:
+		case Common::kEncodingUTF8:
+		case Common::kEncodingLatin9:
+		case Common::kEncodingCP1250:
+		case Common::kEncodingCP1251:
+		case Common::kEncodingCP1252:
+		case Common::kEncodingCP932:
+		case Common::kEncodingCP936:
+		case Common::kEncodingCP949:
+		case Common::kEncodingCP950:
+			return true;
+
+		default:
+			break;
+	}
 
-	assert(_tlk);
+	return false;
+}
+
+/** Is this string plain 7-bit ASCII, without anything that might be a color code? */
+static bool isPlainASCII(const byte *data, size_t size) {
+	for (size_t i = 0; i < size; i++)
+		if ((data[i] >= 0x80) || (data[i] == '<'))
+			return false;
+
+	return true;
+}
+
+Common::UString TalkTable_TLK::readString(uint32 strRef, const Entry &entry) const {
+	if (entry.offset >= _dataSize)
+		return "";
+
+	const byte  *data   = _data + entry.offset;
+	const size_t length = MIN<size_t>(entry.length, _dataSize - entry.offset);
 
-	_tlk->seek(entry.offset);
+	/* Fast path: Plain ASCII strings are the same in all the encodings
+	 * TLKs use in practice. We don't need to convert them, and creating
+	 * them is just as fast as looking them up in the cache. */
+	if (isASCIICompatible(_encoding)) {
+		const size_t size = std::find(data, data + length, 0) - data;
 
-	uint32 length = MIN<size_t>(entry.length, _tlk->size() - _tlk->pos());
-	if (length == 0)
-		return;
+		if (isPlainASCII(data, size))
+			return Common::UString(reinterpret_cast<const char *>(data), size);
+	}
+
+	Common::UString str;
+	if (getCachedString(strRef, str))
+		return str;
 
-	Common::ScopedPtr<Common::MemoryReadStream> data(_tlk->readStream(length));
-	Common::ScopedPtr<Common::MemoryReadStream> parsed(LangMan.preParseColorCodes(*data));
+	Common::MemoryReadStream stream(data, length);
+	Common::ScopedPtr<Common::MemoryReadStream> parsed(LangMan.preParseColorCodes(stream));
 
 	if (_encoding != Common::kEncodingInvalid)
-		entry.text = Common::readString(*parsed, _encoding);
+		str = Common::readString(*parsed, _encoding);
 	else
-		entry.text = "[???]";
+		str = "[???]";
+
+	putCachedString(strRef, str);
+	return str;
 }
 
 uint32 TalkTable_TLK::getLanguageID() const {
@@ -140,31 +206,37 @@ uint32 TalkTable_TLK::getLanguageID() const {
 }
 
 bool TalkTable_TLK::hasEntry(uint32 strRef) const {
-	return strRef < _entries.size();
+	return strRef < _entryCount;
 }
 
-static const Common::UString kEmptyString = "";
-const Common::UString &TalkTable_TLK::getString(uint32 strRef) const {
-	if (strRef >= _entries.size())
-		return kEmptyString;
+Common::UString TalkTable_TLK::getString(uint32 strRef) const {
+	Entry entry;
+	if (!getEntry(strRef, entry) || (entry.length == 0) || !(entry.flags & kFlagTextPresent))
+		return "";
 
-	readString(_entries[strRef]);
-
-	return _entries[strRef].text;
+	return readString(strRef, entry);
 }
 
-const Common::UString &TalkTable_TLK::getSoundResRef(uint32 strRef) const {
-	if (strRef >= _entries.size())
-		return kEmptyString;
+Common::UString TalkTable_TLK::getSoundResRef(uint32 strRef) const {
+	Entry entry;
+	if (!getEntry(strRef, entry) || !entry.soundResRef)
+		return "";
+
+	const byte  *data = entry.soundResRef;
+	const size_t size = std::find(data, data + kSoundResRefLength, 0) - data;
+
+	if (isPlainASCII(data, size))
+		return Common::UString(reinterpret_cast<const char *>(data), size);
 
-	return _entries[strRef].soundResRef;
+	return Common::readString(data, size, Common::kEncodingASCII);
 }
 
 uint32 TalkTable_TLK::getSoundID(uint32 strRef) const {
-	if (strRef >= _entries.size())
+	Entry entry;
+	if (!getEntry(strRef, entry))
 		return kFieldIDInvalid;
 
-	return _entries[strRef].soundID;
+	return entry.soundID;
 }
 
 uint32 TalkTable_TLK::getLanguageID(Common::SeekableReadStream &tlk) {
@@ -25,8 +25,6 @@
 #ifndef AURORA_TALKTABLE_TLK_H
 #define AURORA_TALKTABLE_TLK_H
 
-#include <vector>
-
 #include "src/common/types.h"
 #include "src/common/scopedptr.h"
 #include "src/common/ustring.h"
@@ -49,6 +47,12 @@ namespace Aurora {
  *  - V3.0, used by Neverwinter Nights, Neverwinter Nights 2, Knight of
  *    the Old Republic, Knight of the Old Republic II and The Witcher
  *  - V4.0, used by Jade Empire
+ *
+ *  The whole TLK is kept in memory, preferably as a memory-mapped file,
+ *  and entries are read straight out of it when needed. Strings that are
+ *  plain ASCII are returned as they are, without going through the cache
+ *  or the encoding conversion. All other strings are converted and then
+ *  put into the cache of decoded strings.
  */
 class TalkTable_TLK : public AuroraFile, public TalkTable {
 public:
@@ -61,8 +65,8 @@ public:
 
 	bool hasEntry(uint32 strRef) const;
 
-	const Common::UString &getString     (uint32 strRef) const;
-	const Common::UString &getSoundResRef(uint32 strRef) const;
+	Common::UString getString     (uint32 strRef) const;
+	Common::UString getSoundResRef(uint32 strRef) const;
 
 	uint32 getSoundID(uint32 strRef) const;
 
@@ -78,38 +82,38 @@ private:
 		kFlagSoundLengthPresent = (1 << 2)
 	};
 
-	/** A talk resource entry. */
+	/** A talk resource entry, as far as we need it. */
 	struct Entry {
-		Common::UString text;
 		uint32 offset;
 		uint32 length;
+		uint32 flags;
 
 		// V3
-		uint32 flags;
-		Common::UString soundResRef;
-		uint32 volumeVariance; // Unused
-		uint32 pitchVariance; // Unused
-		float soundLength; // In seconds
+		const byte *soundResRef;
 
 		// V4
 		uint32 soundID;
 	};
 
-	typedef std::vector<Entry> Entries;
-
 
 	Common::ScopedPtr<Common::SeekableReadStream> _tlk;
 
+	/** The whole TLK file in memory. Usually, this is a memory-mapped file. */
+	const byte *_data;
+	size_t      _dataSize;
+
 	uint32 _languageID;
 
-	mutable Entries _entries;
+	uint32 _entryCount;
+	uint32 _tableOffset;
+	uint32 _stringsOffset;
 
 	void load();
+	void loadData();
 
-	void readEntryTableV3(uint32 stringsOffset);
-	void readEntryTableV4();
+	bool getEntry(uint32 strRef, Entry &entry) const;
 
-	void readString(Entry &entry) const;
+	Common::UString readString(uint32 strRef, const Entry &entry) const;
 };
 
 } // End of namespace Aurora
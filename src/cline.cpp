@@ -61,12 +61,19 @@ static void displayUsage(const Common::UString &name) {
 	std::printf("          --nologfile=BOOL    Don't write a log file.\n");
 	std::printf("          --consolelog=FILE   Write all debug console output into this file too.\n");
 	std::printf("          --noconsolelog=BOOL Don't write a debug console log file.\n");
+	std::printf("          --indexcache=BOOL   Cache the resource index between runs.\n");
+	std::printf("          --indextime=BOOL    Report the time spent indexing resources.\n");
+	std::printf("          --rescache=SIZE     Keep up to SIZE MB of decompressed resources.\n");
+	std::printf("          --talkcache=SIZE    Keep up to SIZE KB of decoded strings per talk table.\n");
+	std::printf("          --culling=BOOL      Don't render objects outside the camera's view.\n");
+	std::printf("          --culldistance=DIST Don't render objects further away than DIST.\n");
 	std::printf("\n");
 	std::printf("FILE: Absolute or relative path to a file.\n");
 	std::printf("DIR:  Absolute or relative path to a directory.\n");
 	std::printf("SIZE: A positive integer.\n");
 	std::printf("BOOL: \"true\", \"yes\", \"y\", \"on\" and \"1\" are true, everything else is false.\n");
 	std::printf("VOL:  A double ranging from 0.0 (min) - 1.0 (max).\n");
+	std::printf("DIST: A positive double, or 0.0 for no limit.\n");
 	std::printf("LANG: A language identifier. Full name, ISO 639-1 or ISO 639-2 language code;\n");
 	std::printf("      or IETF language tag with ISO 639-1 and ISO 3166-1 country code.\n");
 	std::printf("      Examples: en, de_de, hun, Czech, zh-tw, zh_cn, zh-cht, zh-chs.\n");
@@ -0,0 +1,426 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned boxes.
+ */
+
+#include <cassert>
+
+#include "src/common/aabbtree.h"
+#include "src/common/util.h"
+
+namespace Common {
+
+AABBTree::Segment::Segment(const float *s, const float *e) {
+	for (int i = 0; i < 3; i++) {
+		const float dir = e[i] - s[i];
+
+		start   [i] = s[i];
+		parallel[i] = dir == 0.0f;
+		invDir  [i] = parallel[i] ? 0.0f : (1.0f / dir);
+	}
+}
+
+
+AABBTree::AABBTree(float margin) : _margin(MAX(margin, 0.0f)), _root(kNodeNone), _freeList(kNodeNone), _count(0) {
+}
+
+AABBTree::~AABBTree() {
+}
+
+void AABBTree::clear() {
+	_nodes.clear();
+
+	_root     = kNodeNone;
+	_freeList = kNodeNone;
+	_count    = 0;
+}
+
+size_t AABBTree::getCount() const {
+	return _count;
+}
+
+int32 AABBTree::getHeight() const {
+	return (_root == kNodeNone) ? 0 : _nodes[_root].height;
+}
+
+AABBTree::EntryID AABBTree::add(const float *min, const float *max, void *data) {
+	const int32 leaf = allocateNode();
+
+	setBox(_nodes[leaf], min, max, _margin);
+	_nodes[leaf].data = data;
+
+	insertLeaf(leaf);
+
+	_count++;
+	return leaf;
+}
+
+void AABBTree::remove(EntryID id) {
+	assert((id >= 0) && (static_cast<size_t>(id) < _nodes.size()) && _nodes[id].isLeaf());
+
+	removeLeaf(id);
+	freeNode(id);
+
+	_count--;
+}
+
+bool AABBTree::update(EntryID id, const float *min, const float *max) {
+	assert((id >= 0) && (static_cast<size_t>(id) < _nodes.size()) && _nodes[id].isLeaf());
+
+	/* Keep the leaf where it is if it still contains the box, and if
+	 * it isn't needlessly large, which would slow down the searches. */
+
+	Node &leaf = _nodes[id];
+	if (contains(leaf, min, max)) {
+		Node outer;
+		setBox(outer, min, max, 2.0f * _margin);
+
+		if (contains(outer, leaf.min, leaf.max))
+			return false;
+	}
+
+	removeLeaf(id);
+
+	setBox(_nodes[id], min, max, _margin);
+
+	insertLeaf(id);
+	return true;
+}
+
+void *AABBTree::getData(EntryID id) const {
+	assert((id >= 0) && (static_cast<size_t>(id) < _nodes.size()) && _nodes[id].isLeaf());
+
+	return _nodes[id].data;
+}
+
+bool AABBTree::intersect(const float *min, const float *max, const float *start, const float *end, float &t) {
+	return intersect(min, max, Segment(start, end), 1.0f, t);
+}
+
+bool AABBTree::intersect(const float *min, const float *max, const Segment &segment, float maxT, float &t) {
+	float tMin = 0.0f, tMax = maxT;
+
+	for (int i = 0; i < 3; i++) {
+		if (segment.parallel[i]) {
+			if ((segment.start[i] < min[i]) || (segment.start[i] > max[i]))
+				return false;
+
+			continue;
+		}
+
+		float t1 = (min[i] - segment.start[i]) * segment.invDir[i];
+		float t2 = (max[i] - segment.start[i]) * segment.invDir[i];
+		if (t1 > t2)
+			SWAP(t1, t2);
+
+		tMin = MAX(tMin, t1);
+		tMax = MIN(tMax, t2);
+
+		if (tMin > tMax)
+			return false;
+	}
+
+	t = tMin;
+	return true;
+}
+
+int32 AABBTree::allocateNode() {
+	int32 index = _freeList;
+
+	if (index != kNodeNone) {
+		_freeList = _nodes[index].parent;
+	} else {
+		index = static_cast<int32>(_nodes.size());
+		_nodes.push_back(Node());
+	}
+
+	Node &node = _nodes[index];
+
+	node.data   = 0;
+	node.parent = kNodeNone;
+	node.child1 = kNodeNone;
+	node.child2 = kNodeNone;
+	node.height = 0;
+
+	return index;
+}
+
+void AABBTree::freeNode(int32 index) {
+	_nodes[index].parent = _freeList;
+	_nodes[index].height = -1;
+
+	_freeList = index;
+}
+
+void AABBTree::insertLeaf(int32 leaf) {
+	if (_root == kNodeNone) {
+		_root = leaf;
+		_nodes[leaf].parent = kNodeNone;
+		return;
+	}
+
+	// Walk down to the best sibling for the new leaf, by the surface area heuristic
+	int32 index = _root;
+	while (!_nodes[index].isLeaf()) {
+		const Node &node   = _nodes[index];
+		const Node &child1 = _nodes[node.child1];
+		const Node &child2 = _nodes[node.child2];
+
+		Node combined;
+		combine(combined, node, _nodes[leaf]);
+
+		const float area         = getArea(node.min, node.max);
+		const float combinedArea = getArea(combined.min, combined.max);
+
+		// Cost of making the leaf and this node siblings
+		const float cost = 2.0f * combinedArea;
+		// Minimum cost of pushing the leaf further down
+		const float inheritanceCost = 2.0f * (combinedArea - area);
+
+		Node combined1, combined2;
+		combine(combined1, child1, _nodes[leaf]);
+		combine(combined2, child2, _nodes[leaf]);
+
+		float cost1 = getArea(combined1.min, combined1.max) + inheritanceCost;
+		if (!child1.isLeaf())
+			cost1 -= getArea(child1.min, child1.max);
+
+		float cost2 = getArea(combined2.min, combined2.max) + inheritanceCost;
+		if (!child2.isLeaf())
+			cost2 -= getArea(child2.min, child2.max);
+
+		if ((cost < cost1) && (cost < cost2))
+			break;
+
+		index = (cost1 < cost2) ? node.child1 : node.child2;
+	}
+
+	const int32 sibling   = index;
+	const int32 oldParent = _nodes[sibling].parent;
+	const int32 newParent = allocateNode();
+
+	Node &parent = _nodes[newParent];
+
+	parent.parent = oldParent;
+	parent.child1 = sibling;
+	parent.child2 = leaf;
+	parent.height = _nodes[sibling].height + 1;
+	combine(parent, _nodes[sibling], _nodes[leaf]);
+
+	if (oldParent != kNodeNone) {
+		if (_nodes[oldParent].child1 == sibling)
+			_nodes[oldParent].child1 = newParent;
+		else
+			_nodes[oldParent].child2 = newParent;
+	} else
+		_root = newParent;
+
+	_nodes[sibling].parent = newParent;
+	_nodes[leaf].parent    = newParent;
+
+	refit(newParent);
+}
+
+void AABBTree::removeLeaf(int32 leaf) {
+	if (leaf == _root) {
+		_root = kNodeNone;
+		return;
+	}
+
+	const int32 parent      = _nodes[leaf].parent;
+	const int32 grandParent = _nodes[parent].parent;
+	const int32 sibling     = (_nodes[parent].child1 == leaf) ? _nodes[parent].child2 : _nodes[parent].child1;
+
+	_nodes[sibling].parent = grandParent;
+
+	if (grandParent != kNodeNone) {
+		if (_nodes[grandParent].child1 == parent)
+			_nodes[grandParent].child1 = sibling;
+		else
+			_nodes[grandParent].child2 = sibling;
+
+		freeNode(parent);
+		refit(grandParent);
+	} else {
+		_root = sibling;
+
+		freeNode(parent);
+	}
+
+	_nodes[leaf].parent = kNodeNone;
+}
+
+void AABBTree::refit(int32 index) {
+	while (index != kNodeNone) {
+		index = balance(index);
+
+		Node &node = _nodes[index];
+
+		const Node &child1 = _nodes[node.child1];
+		const Node &child2 = _nodes[node.child2];
+
+		node.height = 1 + MAX(child1.height, child2.height);
+		combine(node, child1, child2);
+
+		index = node.parent;
+	}
+}
+
+int32 AABBTree::balance(int32 iA) {
+	Node &a = _nodes[iA];
+	if (a.isLeaf() || (a.height < 2))
+		return iA;
+
+	const int32 iB = a.child1;
+	const int32 iC = a.child2;
+
+	Node &b = _nodes[iB];
+	Node &c = _nodes[iC];
+
+	const int32 difference = c.height - b.height;
+
+	if (difference > 1) {
+		// Rotate C up
+
+		const int32 iF = c.child1;
+		const int32 iG = c.child2;
+
+		Node &f = _nodes[iF];
+		Node &g = _nodes[iG];
+
+		c.child1 = iA;
+		c.parent = a.parent;
+		a.parent = iC;
+
+		if (c.parent != kNodeNone) {
+			if (_nodes[c.parent].child1 == iA)
+				_nodes[c.parent].child1 = iC;
+			else
+				_nodes[c.parent].child2 = iC;
+		} else
+			_root = iC;
+
+		if (f.height > g.height) {
+			c.child2 = iF;
+			a.child2 = iG;
+			g.parent = iA;
+
+			combine(a, b, g);
+			combine(c, a, f);
+
+			a.height = 1 + MAX(b.height, g.height);
+			c.height = 1 + MAX(a.height, f.height);
+		} else {
+			c.child2 = iG;
+			a.child2 = iF;
+			f.parent = iA;
+
+			combine(a, b, f);
+			combine(c, a, g);
+
+			a.height = 1 + MAX(b.height, f.height);
+			c.height = 1 + MAX(a.height, g.height);
+		}
+
+		return iC;
+	}
+
+	if (difference < -1) {
+		// Rotate B up
+
+		const int32 iD = b.child1;
+		const int32 iE = b.child2;
+
+		Node &d = _nodes[iD];
+		Node &e = _nodes[iE];
+
+		b.child1 = iA;
+		b.parent = a.parent;
+		a.parent = iB;
+
+		if (b.parent != kNodeNone) {
+			if (_nodes[b.parent].child1 == iA)
+				_nodes[b.parent].child1 = iB;
+			else
+				_nodes[b.parent].child2 = iB;
+		} else
+			_root = iB;
+
+		if (d.height > e.height) {
+			b.child2 = iD;
+			a.child1 = iE;
+			e.parent = iA;
+
+			combine(a, c, e);
+			combine(b, a, d);
+
+			a.height = 1 + MAX(c.height, e.height);
+			b.height = 1 + MAX(a.height, d.height);
+		} else {
+			b.child2 = iE;
+			a.child1 = iD;
+			d.parent = iA;
+
+			combine(a, c, d);
+			combine(b, a, e);
+
+			a.height = 1 + MAX(c.height, d.height);
+			b.height = 1 + MAX(a.height, e.height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void AABBTree::setBox(Node &node, const float *min, const float *max, float margin) {
+	for (int i = 0; i < 3; i++) {
+		node.min[i] = min[i] - margin;
+		node.max[i] = max[i] + margin;
+	}
+}
+
+void AABBTree::combine(Node &node, const Node &a, const Node &b) {
+	for (int i = 0; i < 3; i++) {
+		node.min[i] = MIN(a.min[i], b.min[i]);
+		node.max[i] = MAX(a.max[i], b.max[i]);
+	}
+}
+
+float AABBTree::getArea(const float *min, const float *max) {
+	const float x = max[0] - min[0];
+	const float y = max[1] - min[1];
+	const float z = max[2] - min[2];
+
+	return 2.0f * (x * y + y * z + z * x);
+}
+
+bool AABBTree::contains(const Node &node, const float *min, const float *max) {
+	for (int i = 0; i < 3; i++)
+		if ((min[i] < node.min[i]) || (max[i] > node.max[i]))
+			return false;
+
+	return true;
+}
+
+} // End of namespace Common
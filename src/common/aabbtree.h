@@ -0,0 +1,214 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A dynamic bounding volume hierarchy of axis-aligned boxes.
+ */
+
+#ifndef COMMON_AABBTREE_H
+#define COMMON_AABBTREE_H
+
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A dynamic bounding volume hierarchy over axis-aligned boxes.
+ *
+ *  Each entry is a leaf of a balanced binary tree, in which every inner
+ *  node encloses its two children. Entries can be added, removed and
+ *  moved at any time, and segments can be tested against the tree in
+ *  logarithmic time.
+ *
+ *  The leaves are enlarged by a margin, so that small movements of an
+ *  entry only need a check against its leaf, not a change of the tree.
+ *
+ *  The tree is not thread-safe.
+ */
+class AABBTree : boost::noncopyable {
+public:
+	/** The ID of an entry. */
+	typedef int32 EntryID;
+
+	/** The ID of no entry. */
+	static const EntryID kEntryNone = -1;
+
+	/** Create an empty tree.
+	 *
+	 *  @param margin How much to enlarge the leaves on every side.
+	 */
+	AABBTree(float margin = 0.0f);
+	~AABBTree();
+
+	/** Remove all entries. */
+	void clear();
+
+	/** Return the number of entries. */
+	size_t getCount() const;
+	/** Return the height of the tree, 0 for a single entry. */
+	int32 getHeight() const;
+
+	/** Add an entry with this box and user data, and return its ID. */
+	EntryID add(const float *min, const float *max, void *data);
+	/** Remove an entry. */
+	void remove(EntryID id);
+
+	/** Change the box of an entry.
+	 *
+	 *  @return true if the entry had to be moved within the tree.
+	 */
+	bool update(EntryID id, const float *min, const float *max);
+
+	/** Return the user data of an entry. */
+	void *getData(EntryID id) const;
+
+	/** Find the nearest entry hit by the segment from start to end.
+	 *
+	 *  The hit test is called for every entry whose (enlarged) box the segment
+	 *  crosses, nearest boxes first, as bool hitTest(void *data, float &t).
+	 *  It decides whether the segment actually hits the entry and, if so,
+	 *  sets t to where, as a fraction of the segment between 0.0f and 1.0f.
+	 *  Entries whose boxes start beyond the nearest hit so far are skipped.
+	 *
+	 *  @return The user data of the nearest hit entry, or 0 if none was hit.
+	 */
+	template<typename HitTest>
+	void *raycast(const float *start, const float *end, HitTest hitTest) const {
+		Segment segment(start, end);
+
+		void *hit = 0;
+		float hitT = 1.0f;
+
+		std::vector<int32> &stack = _stack;
+		stack.clear();
+
+		if (_root != kNodeNone)
+			stack.push_back(_root);
+
+		while (!stack.empty()) {
+			const int32 index = stack.back();
+			stack.pop_back();
+
+			float t;
+			const Node &node = _nodes[index];
+			if (!intersect(node.min, node.max, segment, hitT, t))
+				continue;
+
+			if (node.isLeaf()) {
+				float dataT = t;
+				if (hitTest(node.data, dataT) && (dataT <= hitT)) {
+					hit  = node.data;
+					hitT = dataT;
+				}
+
+				continue;
+			}
+
+			// Visit the nearer child first, so that the further one might be skipped
+			float t1, t2;
+			const bool hit1 = intersect(_nodes[node.child1].min, _nodes[node.child1].max, segment, hitT, t1);
+			const bool hit2 = intersect(_nodes[node.child2].min, _nodes[node.child2].max, segment, hitT, t2);
+
+			if (hit1 && hit2) {
+				stack.push_back((t1 <= t2) ? node.child2 : node.child1);
+				stack.push_back((t1 <= t2) ? node.child1 : node.child2);
+			} else if (hit1)
+				stack.push_back(node.child1);
+			else if (hit2)
+				stack.push_back(node.child2);
+		}
+
+		return hit;
+	}
+
+	/** Does the segment from start to end intersect the box?
+	 *
+	 *  @param t Set to where the segment enters the box, as a fraction
+	 *           of the segment between 0.0f and 1.0f.
+	 */
+	static bool intersect(const float *min, const float *max, const float *start, const float *end, float &t);
+
+private:
+	static const int32 kNodeNone = -1;
+
+	struct Node {
+		float min[3];
+		float max[3];
+
+		void *data;
+
+		int32 parent; ///< The parent node, or the next free node.
+		int32 child1;
+		int32 child2;
+
+		int32 height; ///< 0 for leaves, -1 for free nodes.
+
+		bool isLeaf() const {
+			return child1 == kNodeNone;
+		}
+	};
+
+	/** A segment, prepared for testing it against boxes. */
+	struct Segment {
+		float start[3];
+		float invDir[3];
+		bool  parallel[3];
+
+		Segment(const float *s, const float *e);
+	};
+
+	float _margin;
+
+	std::vector<Node> _nodes;
+
+	int32 _root;
+	int32 _freeList;
+
+	size_t _count;
+
+	/** Scratch stack for walking the tree. */
+	mutable std::vector<int32> _stack;
+
+	int32 allocateNode();
+	void freeNode(int32 index);
+
+	void insertLeaf(int32 leaf);
+	void removeLeaf(int32 leaf);
+
+	/** Fix the boxes and heights from this node up to the root, rebalancing on the way. */
+	void refit(int32 index);
+	/** Rotate the subtree at this node if it's unbalanced, and return its new root. */
+	int32 balance(int32 index);
+
+	static void setBox(Node &node, const float *min, const float *max, float margin);
+	static void combine(Node &node, const Node &a, const Node &b);
+
+	static float getArea(const float *min, const float *max);
+	static bool contains(const Node &node, const float *min, const float *max);
+
+	static bool intersect(const float *min, const float *max, const Segment &segment, float maxT, float &t);
+};
+
+} // End of namespace Common
+
+#endif // COMMON_AABBTREE_H
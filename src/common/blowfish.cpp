@@ -28,6 +28,7 @@
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
 #include "src/common/memreadstream.h"
+#include "src/common/threadpool.h"
 #include "src/common/blowfish.h"
 
 namespace Common {
@@ -72,6 +73,12 @@ static const size_t kMaxKeyLength = 56;
 static const size_t kRoundCount   = 16;
 static const size_t kBlockSize    =  8;
 
+/** Number of blocks run through the rounds together. */
+static const size_t kInterleave = 4;
+
+/** Data of at least this size is split into chunks for a thread pool. */
+static const size_t kChunkSize = 64 * 1024;
+
 struct BlowfishContext {
 	uint32 P[kRoundCount + 2]; ///< Blowfish round keys.
 	uint32 S[4][256];          ///< Key-dependant S-boxes.
@@ -244,7 +251,7 @@ static uint32 F(const BlowfishContext &ctx, uint32 x) {
 	return ((ctx.S[0][a] + ctx.S[1][b]) ^ ctx.S[2][c]) + ctx.S[3][d];
 }
 
-static void blowfishEnc(BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
+static void blowfishEnc(const BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
 	for (size_t i = 0; i < kRoundCount; i++) {
 		xl = xl ^ ctx.P[i];
 		xr = F(ctx, xl) ^ xr;
@@ -258,7 +265,7 @@ static void blowfishEnc(BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
 	xl = xl ^ ctx.P[kRoundCount + 1];
 }
 
-static void blowfishDec(BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
+static void blowfishDec(const BlowfishContext &ctx, uint32 &xl, uint32 &xr) {
 	for (size_t i = kRoundCount + 1; i > 1; i--) {
 		xl = xl ^ ctx.P[i];
 		xr = F(ctx, xl) ^ xr;
@@ -314,7 +321,7 @@ static void blowfishSetKey(BlowfishContext &ctx, const byte *key, size_t keyLeng
 	}
 }
 
-static void blowfishECB(BlowfishContext &ctx, Mode mode, const byte *input, byte *output) {
+static void blowfishECB(const BlowfishContext &ctx, Mode mode, const byte *input, byte *output) {
 	uint32 X0 = READ_BE_UINT32(input);
 	uint32 X1 = READ_BE_UINT32(input + 4);
 
@@ -335,47 +342,140 @@ static void blowfishECB(BlowfishContext &ctx, Mode mode, const byte *input, byte
 }
 // '--- Blowfish, based on the implementation from mbed TLS ---'
 
-MemoryReadStream *blowfishEBC(SeekableReadStream &input, const std::vector<byte> &key, Mode mode) {
+/** Run several independent blocks through the Blowfish rounds at once.
+ *
+ *  Each round of a single block depends on the S-box lookups of the one
+ *  before it. Interleaving the rounds of several blocks gives the CPU other
+ *  work to do while it waits for these lookups.
+ *
+ *  This is the same as blowfishEnc() / blowfishDec() for each block, but
+ *  with two rounds per step to get rid of the swaps.
+ */
+template<Mode mode>
+static void blowfishBlocks(const BlowfishContext &ctx, uint32 (&xl)[kInterleave], uint32 (&xr)[kInterleave]) {
+	for (size_t i = 0; i < kRoundCount; i += 2) {
+		const uint32 p0 = ctx.P[(mode == kModeEncrypt) ? (i    ) : (kRoundCount + 1 - i)];
+		const uint32 p1 = ctx.P[(mode == kModeEncrypt) ? (i + 1) : (kRoundCount     - i)];
+
+		for (size_t j = 0; j < kInterleave; j++) {
+			xl[j] ^= p0;
+			xr[j] ^= F(ctx, xl[j]);
+			xr[j] ^= p1;
+			xl[j] ^= F(ctx, xr[j]);
+		}
+	}
+
+	const uint32 pl = ctx.P[(mode == kModeEncrypt) ? (kRoundCount + 1) : 0];
+	const uint32 pr = ctx.P[(mode == kModeEncrypt) ? (kRoundCount    ) : 1];
+
+	for (size_t j = 0; j < kInterleave; j++) {
+		const uint32 l = xr[j] ^ pl;
+
+		xr[j] = xl[j] ^ pr;
+		xl[j] = l;
+	}
+}
+
+/** Encrypt or decrypt a number of 8-byte blocks in place. */
+template<Mode mode>
+static void blowfishECBBlocks(const BlowfishContext &ctx, byte *data, size_t blockCount) {
+	uint32 xl[kInterleave], xr[kInterleave];
+
+	for (; blockCount >= kInterleave; blockCount -= kInterleave, data += kInterleave * kBlockSize) {
+		for (size_t j = 0; j < kInterleave; j++) {
+			xl[j] = READ_BE_UINT32(data + j * kBlockSize);
+			xr[j] = READ_BE_UINT32(data + j * kBlockSize + 4);
+		}
+
+		blowfishBlocks<mode>(ctx, xl, xr);
+
+		for (size_t j = 0; j < kInterleave; j++) {
+			WRITE_BE_UINT32(data + j * kBlockSize    , xl[j]);
+			WRITE_BE_UINT32(data + j * kBlockSize + 4, xr[j]);
+		}
+	}
+
+	for (; blockCount > 0; blockCount--, data += kBlockSize)
+		blowfishECB(ctx, mode, data, data);
+}
+
+static void blowfishECBBlocks(const BlowfishContext &ctx, Mode mode, byte *data, size_t blockCount) {
+	switch (mode) {
+		case kModeDecrypt:
+			blowfishECBBlocks<kModeDecrypt>(ctx, data, blockCount);
+			break;
+		case kModeEncrypt:
+			blowfishECBBlocks<kModeEncrypt>(ctx, data, blockCount);
+			break;
+
+		default:
+			assert(false);
+	}
+}
+
+static void blowfishEBC(byte *data, size_t size, const std::vector<byte> &key, Mode mode, ThreadPool *threadPool) {
+	if ((size % kBlockSize) != 0)
+		throw Exception("Blowfish operates on blocks of 8 bytes (%u)", (uint) size);
+
 	BlowfishContext ctx;
 
 	blowfishSetKey(ctx, &key[0], key.size());
 
-	size_t inputSize = input.size() - input.pos();
+	const size_t chunkCount = (size + kChunkSize - 1) / kChunkSize;
+	if (!threadPool || (chunkCount < 2)) {
+		blowfishECBBlocks(ctx, mode, data, size / kBlockSize);
+		return;
+	}
+
+	// The blocks are independent of each other, so the chunks can be worked on in any order
+	threadPool->parallelFor(chunkCount, [&ctx, mode, data, size](size_t i) {
+		const size_t offset = i * kChunkSize;
+
+		blowfishECBBlocks(ctx, mode, data + offset, MIN(kChunkSize, size - offset) / kBlockSize);
+	});
+}
+
+static MemoryReadStream *blowfishEBC(SeekableReadStream &input, const std::vector<byte> &key, Mode mode,
+                                     ThreadPool *threadPool) {
+
+	const size_t inputSize = input.size() - input.pos();
 
 	// Round up to the next multiple of the block size
 	const size_t outputSize = ((inputSize + kBlockSize - 1) / kBlockSize) * kBlockSize;
 
 	ScopedArray<byte> output(new byte[outputSize]);
 
-	byte buffer[kBlockSize];
-	byte *data = output.get();
-	while (inputSize > 0) {
-		const size_t toRead = MIN<size_t>(inputSize, kBlockSize);
+	if (input.read(output.get(), inputSize) != inputSize)
+		throw Exception(kReadError);
 
-		if (input.read(buffer, toRead) != toRead)
-			throw Exception(kReadError);
+	std::memset(output.get() + inputSize, 0, outputSize - inputSize);
 
-		if (toRead < kBlockSize)
-			std::memset(buffer + toRead, 0, kBlockSize - toRead);
-
-		blowfishECB(ctx, mode, buffer, data);
-
-		data      += toRead;
-		inputSize -= toRead;
-	}
+	blowfishEBC(output.get(), outputSize, key, mode, threadPool);
 
 	return new MemoryReadStream(output.release(), outputSize, true);
 }
 
-MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key) {
-	return blowfishEBC(input, key, kModeEncrypt);
+MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key,
+                                     ThreadPool *threadPool) {
+
+	return blowfishEBC(input, key, kModeEncrypt, threadPool);
 }
 
-MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key) {
+MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key,
+                                     ThreadPool *threadPool) {
+
 	if ((input.size() % 8) != 0)
 		throw Exception("Blowfish operates on blocks of 8 bytes (%u)", (uint) input.size());
 
-	return blowfishEBC(input, key, kModeDecrypt);
+	return blowfishEBC(input, key, kModeDecrypt, threadPool);
+}
+
+void encryptBlowfishEBC(byte *data, size_t size, const std::vector<byte> &key, ThreadPool *threadPool) {
+	blowfishEBC(data, size, key, kModeEncrypt, threadPool);
+}
+
+void decryptBlowfishEBC(byte *data, size_t size, const std::vector<byte> &key, ThreadPool *threadPool) {
+	blowfishEBC(data, size, key, kModeDecrypt, threadPool);
 }
 
 } // End of namespace Common
@@ -33,11 +33,34 @@ namespace Common {
 
 class SeekableReadStream;
 class MemoryReadStream;
+class ThreadPool;
 
-/** Encrypt the stream with the Blowfish algorithm in EBC mode. */
-MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
+/** Encrypt the stream with the Blowfish algorithm in EBC mode.
+ *
+ *  The stream is padded with 0 to a multiple of 8 bytes.
+ */
+MemoryReadStream *encryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key,
+                                     ThreadPool *threadPool = 0);
 /** Decrypt the stream with the Blowfish algorithm in EBC mode. */
-MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key);
+MemoryReadStream *decryptBlowfishEBC(SeekableReadStream &input, const std::vector<byte> &key,
+                                     ThreadPool *threadPool = 0);
+
+/** Encrypt the data in place with the Blowfish algorithm in EBC mode.
+ *
+ *  The size of the data has to be a multiple of 8 bytes.
+ *
+ *  With a thread pool, large data is split into chunks that are
+ *  encrypted in parallel.
+ */
+void encryptBlowfishEBC(byte *data, size_t size, const std::vector<byte> &key, ThreadPool *threadPool = 0);
+/** Decrypt the data in place with the Blowfish algorithm in EBC mode.
+ *
+ *  The size of the data has to be a multiple of 8 bytes.
+ *
+ *  With a thread pool, large data is split into chunks that are
+ *  decrypted in parallel.
+ */
+void decryptBlowfishEBC(byte *data, size_t size, const std::vector<byte> &key, ThreadPool *threadPool = 0);
 
 } // End of namespace Common
 
@@ -22,6 +22,8 @@
  *  Compress (deflate) and decompress (inflate) using zlib's DEFLATE algorithm.
  */
 
+#include <cstring>
+
 #include <zlib.h>
 
 #include <boost/scope_exit.hpp>
@@ -197,4 +199,212 @@ size_t decompressDeflateChunk(SeekableReadStream &input, int windowBits,
 	return strm.total_out;
 }
 
+
+/** The state of the decompressor at one point within the stream. */
+struct InflateReadStream::State {
+	z_stream strm;
+	bool initialized;
+
+	size_t inputPos;  ///< The position within the input of the data in strm.next_in.
+	size_t outputPos; ///< The position within the output.
+
+	State() : initialized(false), inputPos(0), outputPos(0) {
+		std::memset(&strm, 0, sizeof(strm));
+	}
+
+	~State() {
+		if (initialized)
+			inflateEnd(&strm);
+	}
+
+	/** Return the position within the input up to which zlib has consumed the data. */
+	size_t getConsumedPos() const {
+		return inputPos - strm.avail_in;
+	}
+};
+
+static const size_t kInflateInputBufferSize = 16384;
+
+InflateReadStream::InflateReadStream(SeekableReadStream *input, size_t outputSize, int windowBits,
+                                     bool disposeInput, size_t restartInterval) :
+	_input(input, disposeInput), _size(outputSize), _pos(0), _eos(false), _windowBits(windowBits),
+	_restartInterval(restartInterval), _inputBuffer(new byte[kInflateInputBufferSize]) {
+
+	assert(_input);
+
+	if (_restartInterval == 0)
+		throw Exception("Invalid inflate restart interval");
+}
+
+InflateReadStream::~InflateReadStream() {
+	for (std::vector<State *>::iterator r = _restartPoints.begin(); r != _restartPoints.end(); ++r)
+		delete *r;
+}
+
+bool InflateReadStream::eos() const {
+	return _eos;
+}
+
+size_t InflateReadStream::pos() const {
+	return _pos;
+}
+
+size_t InflateReadStream::size() const {
+	return _size;
+}
+
+size_t InflateReadStream::getRestartPointCount() const {
+	return _restartPoints.size();
+}
+
+size_t InflateReadStream::seek(ptrdiff_t offset, Origin whence) {
+	const size_t oldPos = _pos;
+	const size_t newPos = evalSeek(offset, whence, _pos, 0, size());
+	if (newPos > _size)
+		throw Exception(kSeekError);
+
+	// We only actually move the decompressor once something is read from there
+	_pos = newPos;
+	_eos = false;
+
+	return oldPos;
+}
+
+size_t InflateReadStream::read(void *dataPtr, size_t dataSize) {
+	assert(dataPtr);
+
+	// Read at most as many bytes as are still available...
+	if (dataSize > (_size - _pos)) {
+		dataSize = _size - _pos;
+		_eos = true;
+	}
+
+	if (dataSize == 0)
+		return 0;
+
+	moveTo(_pos);
+
+	inflateInto(static_cast<byte *>(dataPtr), dataSize);
+
+	_pos += dataSize;
+	return dataSize;
+}
+
+void InflateReadStream::reset() {
+	_state.reset(new State);
+
+	initZStream(_state->strm, _windowBits, 0, 0);
+	_state->initialized = true;
+}
+
+void InflateReadStream::restart(const State &state) {
+	_state.reset(new State);
+
+	int zResult = inflateCopy(&_state->strm, const_cast<z_stream *>(&state.strm));
+	if (zResult != Z_OK)
+		throw Exception("Could not copy zlib inflate state: %s (%d)", zError(zResult), zResult);
+
+	_state->initialized = true;
+
+	_state->inputPos  = state.inputPos;
+	_state->outputPos = state.outputPos;
+}
+
+void InflateReadStream::moveTo(size_t position) {
+	if (_state && (_state->outputPos == position))
+		return;
+
+	// The closest restart point at or before the position (0 being the start of the stream)
+	const size_t restartPoint = MIN<size_t>(position / _restartInterval, _restartPoints.size());
+	const size_t restartPos   = restartPoint * _restartInterval;
+
+	/* Restart if we have to go backwards, or if we can skip over some data
+	 * that was already decompressed before. */
+	if (!_state || (position < _state->outputPos) || (restartPos > _state->outputPos)) {
+		if (restartPoint == 0)
+			reset();
+		else
+			restart(*_restartPoints[restartPoint - 1]);
+	}
+
+	inflateSkip(position - _state->outputPos);
+}
+
+void InflateReadStream::inflateSkip(size_t outputSize) {
+	byte buffer[4096];
+
+	while (outputSize > 0) {
+		const size_t skipSize = MIN<size_t>(outputSize, sizeof(buffer));
+
+		inflateInto(buffer, skipSize);
+		outputSize -= skipSize;
+	}
+}
+
+void InflateReadStream::inflateInto(byte *output, size_t outputSize) {
+	z_stream &strm = _state->strm;
+
+	while (outputSize > 0) {
+		// Don't decompress past the next restart point, so that we can save it there
+		const size_t nextRestart = (_restartPoints.size() + 1) * _restartInterval;
+
+		size_t chunkSize = outputSize;
+		if (_state->outputPos < nextRestart)
+			chunkSize = MIN<size_t>(chunkSize, nextRestart - _state->outputPos);
+
+		if (strm.avail_in == 0) {
+			const size_t inputSize = MIN<size_t>(_input->size() - _state->inputPos, kInflateInputBufferSize);
+			if (inputSize == 0)
+				throw Exception("Failed to inflate: input buffer empty, stream not ended");
+
+			if (_input->readAt(_state->inputPos, _inputBuffer.get(), inputSize) != inputSize)
+				throw Exception(kReadError);
+
+			setZStreamInput(strm, inputSize, _inputBuffer.get());
+			_state->inputPos += inputSize;
+		}
+
+		strm.avail_out = chunkSize;
+		strm.next_out  = output;
+
+		// Decompress. Z_SYNC_FLUSH, because we want to decompress partwise.
+		const int zResult = inflate(&strm, Z_SYNC_FLUSH);
+		if ((zResult != Z_STREAM_END) && (zResult != Z_OK))
+			throw Exception("Failed to inflate: %s (%d)", zError(zResult), zResult);
+
+		const size_t written = chunkSize - strm.avail_out;
+
+		output     += written;
+		outputSize -= written;
+
+		_state->outputPos += written;
+
+		if ((zResult == Z_STREAM_END) && (outputSize > 0))
+			throw Exception("Failed to inflate: premature end of stream");
+
+		if (_state->outputPos == nextRestart)
+			saveRestartPoint();
+	}
+}
+
+void InflateReadStream::saveRestartPoint() {
+	ScopedPtr<State> state(new State);
+
+	int zResult = inflateCopy(&state->strm, &_state->strm);
+	if (zResult != Z_OK)
+		throw Exception("Could not copy zlib inflate state: %s (%d)", zError(zResult), zResult);
+
+	state->initialized = true;
+
+	// The copy doesn't own our input buffer, so continue from where zlib stopped reading it
+	state->strm.avail_in = 0;
+	state->strm.next_in  = 0;
+
+	state->inputPos  = _state->getConsumedPos();
+	state->outputPos = _state->outputPos;
+
+	_restartPoints.push_back(state.get());
+	state.release();
+}
+
 } // End of namespace Common
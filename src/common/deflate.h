@@ -25,7 +25,14 @@
 #ifndef COMMON_DEFLATE_H
 #define COMMON_DEFLATE_H
 
+#include <vector>
+
+#include <boost/noncopyable.hpp>
+
 #include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/disposableptr.h"
+#include "src/common/readstream.h"
 
 namespace Common {
 
@@ -35,9 +42,6 @@ namespace Common {
  *   of the decompressed data beforehand
  */
 
-class ReadStream;
-class SeekableReadStream;
-
 static const int kWindowBitsMax    =  15;
 static const int kWindowBitsMaxRaw = -kWindowBitsMax;
 
@@ -117,6 +121,86 @@ SeekableReadStream *decompressDeflateWithoutOutputSize(ReadStream &input, size_t
 size_t decompressDeflateChunk(SeekableReadStream &input, int windowBits, byte *output, size_t outputSize,
                               unsigned int frameSize = 4096);
 
+/** A stream decompressing (inflating) DEFLATE data on the fly, while it is read.
+ *
+ *  Only the parts of the data that are actually read are decompressed, and
+ *  the decompressed data is not kept around. This makes the first bytes of
+ *  large compressed files available immediately, and avoids holding the
+ *  whole decompressed data in memory.
+ *
+ *  Every restartInterval bytes of output, a copy of the decompressor's state
+ *  is saved. Seeking backwards continues decompressing from the closest such
+ *  restart point before the target, instead of from the very beginning. The
+ *  same goes for seeking forwards into data that was decompressed before.
+ *
+ *  The input is read with positional reads only.
+ *
+ *  This doesn't build on decompressDeflateChunk(), since that always inflates
+ *  a whole chunk with a z_stream of its own. Stopping at any output position,
+ *  and copying the state for restart points, needs a z_stream that lives as
+ *  long as the stream does.
+ */
+class InflateReadStream : public SeekableReadStream, boost::noncopyable {
+public:
+	static const size_t kRestartInterval = 1024 * 1024;
+
+	/** Create an inflating stream.
+	 *
+	 *  @param input           The compressed input data.
+	 *  @param outputSize      The size of the decompressed data.
+	 *  @param windowBits      The base two logarithm of the window size (the size of
+	 *                         the history buffer). See the zlib documentation on
+	 *                         inflateInit2() for details.
+	 *  @param disposeInput    Should the input stream be deleted together with this stream?
+	 *  @param restartInterval Save a restart point every this many bytes of output.
+	 */
+	InflateReadStream(SeekableReadStream *input, size_t outputSize, int windowBits,
+	                  bool disposeInput = true, size_t restartInterval = kRestartInterval);
+	~InflateReadStream();
+
+	bool eos() const;
+
+	size_t pos() const;
+	size_t size() const;
+
+	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
+
+	size_t read(void *dataPtr, size_t dataSize);
+
+	/** Return the number of restart points saved so far. */
+	size_t getRestartPointCount() const;
+
+private:
+	struct State;
+
+	DisposablePtr<SeekableReadStream> _input;
+
+	size_t _size;
+	size_t _pos;
+	bool   _eos;
+
+	int _windowBits;
+
+	size_t _restartInterval;
+
+	/** The current state of the decompressor. */
+	ScopedPtr<State> _state;
+	/** Saved decompressor states, the n-th at output position (n + 1) * _restartInterval. */
+	std::vector<State *> _restartPoints;
+
+	ScopedArray<byte> _inputBuffer;
+
+
+	void reset();
+	void restart(const State &state);
+	void moveTo(size_t position);
+
+	void inflateInto(byte *output, size_t outputSize);
+	void inflateSkip(size_t outputSize);
+
+	void saveRestartPoint();
+};
+
 } // End of namespace Common
 
 #endif // COMMON_DEFLATE_H
@@ -27,12 +27,20 @@
 
 #include <iconv.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define XOREOS_ENCODING_SSE2 1
+	#include <emmintrin.h>
+#endif
+
 #include <vector>
+#include <string>
+#include <algorithm>
 
 #include "src/common/encoding.h"
 #include "src/common/error.h"
 #include "src/common/scopedptr.h"
 #include "src/common/singleton.h"
+#include "src/common/mutex.h"
 #include "src/common/ustring.h"
 #include "src/common/memreadstream.h"
 #include "src/common/writestream.h"
@@ -116,6 +124,9 @@ private:
 	iconv_t _contextFrom[kEncodingMAX];
 	iconv_t _contextTo  [kEncodingMAX];
 
+	/** The iconv contexts are stateful, so only one thread at a time may use them. */
+	std::mutex _mutex;
+
 	byte *doConvert(iconv_t &ctx, byte *data, size_t nIn, size_t nOut, size_t &size) {
 		size_t inBytes  = nIn;
 		size_t outBytes = nOut;
@@ -124,6 +135,8 @@ private:
 
 		byte *outBuf = convData.get();
 
+		std::lock_guard<std::mutex> lock(_mutex);
+
 		// Reset the converter's state
 		iconv(ctx, 0, 0, 0, 0);
 
@@ -183,6 +196,517 @@ DECLARE_SINGLETON(Common::ConversionManager)
 
 namespace Common {
 
+/* Fast paths for the encodings that make up nearly all game data.
+ *
+ * Going through iconv means taking the ConversionManager lock and resetting
+ * a context for every single string, which is a lot of overhead for the
+ * short strings we usually convert. Instead, we handle the single-byte
+ * encodings with lookup tables and UTF-16 directly, and copy runs of ASCII
+ * characters wholesale.
+ *
+ * Anything the fast paths can't convert (undefined bytes, broken surrogate
+ * pairs, unencodable characters) is left to iconv, so that errors are still
+ * reported the same way. The CJK code pages always go through iconv.
+ */
+
+/** The upper halves of the single-byte encodings, as Unicode codepoints. 0 means undefined. */
+static const uint16 kUpperLatin9[128] = {
+	0x0080, 0x0081, 0x0082, 0x0083, 0x0084, 0x0085, 0x0086, 0x0087,
+	0x0088, 0x0089, 0x008A, 0x008B, 0x008C, 0x008D, 0x008E, 0x008F,
+	0x0090, 0x0091, 0x0092, 0x0093, 0x0094, 0x0095, 0x0096, 0x0097,
+	0x0098, 0x0099, 0x009A, 0x009B, 0x009C, 0x009D, 0x009E, 0x009F,
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x20AC, 0x00A5, 0x0160, 0x00A7,
+	0x0161, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x017D, 0x00B5, 0x00B6, 0x00B7,
+	0x017E, 0x00B9, 0x00BA, 0x00BB, 0x0152, 0x0153, 0x0178, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+};
+
+static const uint16 kUpperCP1250[128] = {
+	0x20AC, 0x0000, 0x201A, 0x0000, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x0000, 0x2030, 0x0160, 0x2039, 0x015A, 0x0164, 0x017D, 0x0179,
+	0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x0000, 0x2122, 0x0161, 0x203A, 0x015B, 0x0165, 0x017E, 0x017A,
+	0x00A0, 0x02C7, 0x02D8, 0x0141, 0x00A4, 0x0104, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x015E, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x017B,
+	0x00B0, 0x00B1, 0x02DB, 0x0142, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x0105, 0x015F, 0x00BB, 0x013D, 0x02DD, 0x013E, 0x017C,
+	0x0154, 0x00C1, 0x00C2, 0x0102, 0x00C4, 0x0139, 0x0106, 0x00C7,
+	0x010C, 0x00C9, 0x0118, 0x00CB, 0x011A, 0x00CD, 0x00CE, 0x010E,
+	0x0110, 0x0143, 0x0147, 0x00D3, 0x00D4, 0x0150, 0x00D6, 0x00D7,
+	0x0158, 0x016E, 0x00DA, 0x0170, 0x00DC, 0x00DD, 0x0162, 0x00DF,
+	0x0155, 0x00E1, 0x00E2, 0x0103, 0x00E4, 0x013A, 0x0107, 0x00E7,
+	0x010D, 0x00E9, 0x0119, 0x00EB, 0x011B, 0x00ED, 0x00EE, 0x010F,
+	0x0111, 0x0144, 0x0148, 0x00F3, 0x00F4, 0x0151, 0x00F6, 0x00F7,
+	0x0159, 0x016F, 0x00FA, 0x0171, 0x00FC, 0x00FD, 0x0163, 0x02D9
+};
+
+static const uint16 kUpperCP1251[128] = {
+	0x0402, 0x0403, 0x201A, 0x0453, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x20AC, 0x2030, 0x0409, 0x2039, 0x040A, 0x040C, 0x040B, 0x040F,
+	0x0452, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x0000, 0x2122, 0x0459, 0x203A, 0x045A, 0x045C, 0x045B, 0x045F,
+	0x00A0, 0x040E, 0x045E, 0x0408, 0x00A4, 0x0490, 0x00A6, 0x00A7,
+	0x0401, 0x00A9, 0x0404, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x0407,
+	0x00B0, 0x00B1, 0x0406, 0x0456, 0x0491, 0x00B5, 0x00B6, 0x00B7,
+	0x0451, 0x2116, 0x0454, 0x00BB, 0x0458, 0x0405, 0x0455, 0x0457,
+	0x0410, 0x0411, 0x0412, 0x0413, 0x0414, 0x0415, 0x0416, 0x0417,
+	0x0418, 0x0419, 0x041A, 0x041B, 0x041C, 0x041D, 0x041E, 0x041F,
+	0x0420, 0x0421, 0x0422, 0x0423, 0x0424, 0x0425, 0x0426, 0x0427,
+	0x0428, 0x0429, 0x042A, 0x042B, 0x042C, 0x042D, 0x042E, 0x042F,
+	0x0430, 0x0431, 0x0432, 0x0433, 0x0434, 0x0435, 0x0436, 0x0437,
+	0x0438, 0x0439, 0x043A, 0x043B, 0x043C, 0x043D, 0x043E, 0x043F,
+	0x0440, 0x0441, 0x0442, 0x0443, 0x0444, 0x0445, 0x0446, 0x0447,
+	0x0448, 0x0449, 0x044A, 0x044B, 0x044C, 0x044D, 0x044E, 0x044F
+};
+
+static const uint16 kUpperCP1252[128] = {
+	0x20AC, 0x0000, 0x201A, 0x0192, 0x201E, 0x2026, 0x2020, 0x2021,
+	0x02C6, 0x2030, 0x0160, 0x2039, 0x0152, 0x0000, 0x017D, 0x0000,
+	0x0000, 0x2018, 0x2019, 0x201C, 0x201D, 0x2022, 0x2013, 0x2014,
+	0x02DC, 0x2122, 0x0161, 0x203A, 0x0153, 0x0000, 0x017E, 0x0178,
+	0x00A0, 0x00A1, 0x00A2, 0x00A3, 0x00A4, 0x00A5, 0x00A6, 0x00A7,
+	0x00A8, 0x00A9, 0x00AA, 0x00AB, 0x00AC, 0x00AD, 0x00AE, 0x00AF,
+	0x00B0, 0x00B1, 0x00B2, 0x00B3, 0x00B4, 0x00B5, 0x00B6, 0x00B7,
+	0x00B8, 0x00B9, 0x00BA, 0x00BB, 0x00BC, 0x00BD, 0x00BE, 0x00BF,
+	0x00C0, 0x00C1, 0x00C2, 0x00C3, 0x00C4, 0x00C5, 0x00C6, 0x00C7,
+	0x00C8, 0x00C9, 0x00CA, 0x00CB, 0x00CC, 0x00CD, 0x00CE, 0x00CF,
+	0x00D0, 0x00D1, 0x00D2, 0x00D3, 0x00D4, 0x00D5, 0x00D6, 0x00D7,
+	0x00D8, 0x00D9, 0x00DA, 0x00DB, 0x00DC, 0x00DD, 0x00DE, 0x00DF,
+	0x00E0, 0x00E1, 0x00E2, 0x00E3, 0x00E4, 0x00E5, 0x00E6, 0x00E7,
+	0x00E8, 0x00E9, 0x00EA, 0x00EB, 0x00EC, 0x00ED, 0x00EE, 0x00EF,
+	0x00F0, 0x00F1, 0x00F2, 0x00F3, 0x00F4, 0x00F5, 0x00F6, 0x00F7,
+	0x00F8, 0x00F9, 0x00FA, 0x00FB, 0x00FC, 0x00FD, 0x00FE, 0x00FF
+};
+
+static const uint16 *getUpperTable(Encoding encoding) {
+	switch (encoding) {
+		case kEncodingLatin9:
+			return kUpperLatin9;
+
+		case kEncodingCP1250:
+			return kUpperCP1250;
+
+		case kEncodingCP1251:
+			return kUpperCP1251;
+
+		case kEncodingCP1252:
+			return kUpperCP1252;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+/** The bytes encoding the codepoints of an upper half, in 256-codepoint pages. */
+struct ReverseTable {
+	/** For each page of codepoints, 1 + the index of the page in bytes, or 0. */
+	uint16 pages[256];
+	/** The byte encoding each codepoint, or 0. */
+	std::vector<byte> bytes;
+
+	ReverseTable(const uint16 *upper) {
+		std::memset(pages, 0, sizeof(pages));
+
+		for (size_t i = 0; i < 128; i++) {
+			if (upper[i] == 0)
+				continue;
+
+			uint16 &page = pages[upper[i] >> 8];
+			if (page == 0) {
+				bytes.resize(bytes.size() + 256, 0);
+				page = bytes.size() / 256;
+			}
+
+			bytes[(page - 1) * 256 + (upper[i] & 0xFF)] = 0x80 + i;
+		}
+	}
+
+	/** Find the byte encoding this codepoint. Return false if there is none. */
+	bool find(uint32 c, byte &b) const {
+		if (c > 0xFFFF)
+			return false;
+
+		const uint16 page = pages[c >> 8];
+		if (page == 0)
+			return false;
+
+		b = bytes[(page - 1) * 256 + (c & 0xFF)];
+		return b != 0;
+	}
+};
+
+static const ReverseTable kReverseLatin9(kUpperLatin9);
+static const ReverseTable kReverseCP1250(kUpperCP1250);
+static const ReverseTable kReverseCP1251(kUpperCP1251);
+static const ReverseTable kReverseCP1252(kUpperCP1252);
+
+static const ReverseTable *getReverseTable(Encoding encoding) {
+	switch (encoding) {
+		case kEncodingLatin9:
+			return &kReverseLatin9;
+
+		case kEncodingCP1250:
+			return &kReverseCP1250;
+
+		case kEncodingCP1251:
+			return &kReverseCP1251;
+
+		case kEncodingCP1252:
+			return &kReverseCP1252;
+
+		default:
+			break;
+	}
+
+	return 0;
+}
+
+/** Return the number of bytes at the start of data that are 7-bit ASCII. */
+static size_t findASCIIRun(const byte *data, size_t size) {
+	size_t n = 0;
+
+#ifdef XOREOS_ENCODING_SSE2
+	for (; (size - n) >= 16; n += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + n));
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+	}
+#else
+	for (; (size - n) >= 8; n += 8) {
+		uint64 word;
+		std::memcpy(&word, data + n, 8);
+
+		if ((word & 0x8080808080808080ULL) != 0)
+			break;
+	}
+#endif
+
+	while ((n < size) && (data[n] < 0x80))
+		n++;
+
+	return n;
+}
+
+/** Write a character as UTF-8, returning the position after it. */
+static char *writeUTF8Char(char *str, uint32 c) {
+	if        (c < 0x80) {
+		*str++ = c;
+	} else if (c < 0x800) {
+		*str++ = 0xC0 |  (c >>  6);
+		*str++ = 0x80 | ( c        & 0x3F);
+	} else if (c < 0x10000) {
+		*str++ = 0xE0 |  (c >> 12);
+		*str++ = 0x80 | ((c >>  6) & 0x3F);
+		*str++ = 0x80 | ( c        & 0x3F);
+	} else {
+		*str++ = 0xF0 |  (c >> 18);
+		*str++ = 0x80 | ((c >> 12) & 0x3F);
+		*str++ = 0x80 | ((c >>  6) & 0x3F);
+		*str++ = 0x80 | ( c        & 0x3F);
+	}
+
+	return str;
+}
+
+/** Read a character out of UTF-8 data we know to be valid, like an UString's. */
+static uint32 readUTF8Char(const byte *data, size_t &n) {
+	const uint32 c = data[n++];
+
+	if (c < 0x80)
+		return c;
+
+	if (c < 0xE0) {
+		n += 1;
+		return ((c & 0x1F) <<  6) |  (data[n - 1] & 0x3F);
+	}
+
+	if (c < 0xF0) {
+		n += 2;
+		return ((c & 0x0F) << 12) | ((data[n - 2] & 0x3F) <<  6) |  (data[n - 1] & 0x3F);
+	}
+
+	n += 3;
+	return ((c & 0x07) << 18) | ((data[n - 3] & 0x3F) << 12) | ((data[n - 2] & 0x3F) << 6) | (data[n - 1] & 0x3F);
+}
+
+static bool decodeSingleByte(const byte *data, size_t size, const uint16 *upper, UString &str) {
+	// Like iconv, fail on undefined bytes even after the end of the string
+	const byte  *end    = static_cast<const byte *>(std::memchr(data, 0, size));
+	const size_t length = end ? (end - data) : size;
+
+	for (size_t i = length; i < size; i++)
+		if ((data[i] >= 0x80) && (upper[data[i] - 0x80] == 0))
+			return false;
+
+	// None of the tables has characters above U+FFFF, so 3 bytes each are enough
+	std::string utf8(length * 3, '\0');
+	char *out = &utf8[0];
+
+	for (size_t n = 0; n < length; ) {
+		if (data[n] < 0x80) {
+			const size_t run = findASCIIRun(data + n, length - n);
+
+			std::memcpy(out, data + n, run);
+
+			out += run;
+			n   += run;
+			continue;
+		}
+
+		const uint16 c = upper[data[n++] - 0x80];
+		if (c == 0)
+			return false;
+
+		out = writeUTF8Char(out, c);
+	}
+
+	utf8.resize(out - &utf8[0]);
+
+	str = utf8;
+	return true;
+}
+
+static uint16 readUTF16Unit(const byte *data, size_t n, bool bigEndian) {
+	return bigEndian ? READ_BE_UINT16(data + n * 2) : READ_LE_UINT16(data + n * 2);
+}
+
+static void writeUTF16Unit(byte *data, size_t n, uint16 c, bool bigEndian) {
+	if (bigEndian)
+		WRITE_BE_UINT16(data + n * 2, c);
+	else
+		WRITE_LE_UINT16(data + n * 2, c);
+}
+
+/** Read one UTF-16 character, combining surrogate pairs. Return false if it's invalid. */
+static bool readUTF16Char(const byte *data, size_t count, size_t &n, bool bigEndian, uint32 &c) {
+	c = readUTF16Unit(data, n++, bigEndian);
+	if ((c < 0xD800) || (c > 0xDFFF))
+		return true;
+
+	if ((c >= 0xDC00) || (n >= count))
+		return false;
+
+	const uint32 low = readUTF16Unit(data, n, bigEndian);
+	if ((low < 0xDC00) || (low > 0xDFFF))
+		return false;
+
+	n++;
+
+	c = 0x10000 + ((c - 0xD800) << 10) + (low - 0xDC00);
+	return true;
+}
+
+/** Copy the run of non-0 ASCII characters at the start of UTF-16 data. Return its length. */
+static size_t copyUTF16ASCIIRun(const byte *data, size_t count, bool bigEndian, char *str) {
+	size_t n = 0;
+
+#ifdef XOREOS_ENCODING_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i high = _mm_set1_epi16((short) 0xFF80);
+
+	for (; (count - n) >= 8; n += 8) {
+		__m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + n * 2));
+		if (bigEndian)
+			units = _mm_or_si128(_mm_slli_epi16(units, 8), _mm_srli_epi16(units, 8));
+
+		if ((_mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(units, high), zero)) != 0xFFFF) ||
+		    (_mm_movemask_epi8(_mm_cmpeq_epi16(units, zero)) != 0))
+			break;
+
+		_mm_storel_epi64(reinterpret_cast<__m128i *>(str + n), _mm_packus_epi16(units, units));
+	}
+#endif
+
+	for (; n < count; n++) {
+		const uint16 c = readUTF16Unit(data, n, bigEndian);
+		if ((c == 0) || (c >= 0x80))
+			break;
+
+		str[n] = c;
+	}
+
+	return n;
+}
+
+static bool decodeUTF16(const byte *data, size_t size, bool bigEndian, UString &str) {
+	// iconv fails on incomplete characters
+	if ((size % 2) != 0)
+		return false;
+
+	const size_t count = size / 2;
+
+	// A unit is at most 3 bytes of UTF-8, a surrogate pair 4
+	std::string utf8(count * 3, '\0');
+	char *out = &utf8[0];
+
+	size_t n = 0;
+	while (n < count) {
+		const size_t run = copyUTF16ASCIIRun(data + n * 2, count - n, bigEndian, out);
+
+		out += run;
+		if ((n += run) >= count)
+			break;
+
+		uint32 c;
+		if (!readUTF16Char(data, count, n, bigEndian, c))
+			return false;
+
+		if (c == 0)
+			break;
+
+		out = writeUTF8Char(out, c);
+	}
+
+	// Like iconv, fail on invalid characters even after the end of the string
+	while (n < count) {
+		uint32 c;
+		if (!readUTF16Char(data, count, n, bigEndian, c))
+			return false;
+	}
+
+	utf8.resize(out - &utf8[0]);
+
+	str = utf8;
+	return true;
+}
+
+/** Convert data in this encoding to UTF-8 without iconv. Return false if we can't. */
+static bool decodeFast(const byte *data, size_t size, Encoding encoding, UString &str) {
+	const uint16 *upper = getUpperTable(encoding);
+	if (upper)
+		return decodeSingleByte(data, size, upper, str);
+
+	if (encoding == kEncodingUTF16LE)
+		return decodeUTF16(data, size, false, str);
+	if (encoding == kEncodingUTF16BE)
+		return decodeUTF16(data, size, true, str);
+
+	return false;
+}
+
+static MemoryReadStream *encodeSingleByte(const UString &str, const ReverseTable *reverse, bool terminate) {
+	const byte  *data = reinterpret_cast<const byte *>(str.c_str());
+	const size_t size = std::strlen(str.c_str());
+
+	ScopedArray<byte> output(new byte[size + 1]);
+	size_t n = 0, o = 0;
+
+	while (n < size) {
+		if (data[n] < 0x80) {
+			const size_t run = findASCIIRun(data + n, size - n);
+
+			std::memcpy(output.get() + o, data + n, run);
+
+			o += run;
+			n += run;
+			continue;
+		}
+
+		// Without a table, only ASCII itself is encodable
+		if (!reverse || !reverse->find(readUTF8Char(data, n), output[o++]))
+			return 0;
+	}
+
+	if (terminate)
+		output[o++] = 0;
+
+	return new MemoryReadStream(output.release(), o, true);
+}
+
+/** Widen the run of ASCII characters at the start of UTF-8 data into UTF-16. Return its length. */
+static size_t copyASCIIRunUTF16(const byte *data, size_t size, bool bigEndian, byte *utf16) {
+	size_t n = 0;
+
+#ifdef XOREOS_ENCODING_SSE2
+	const __m128i zero = _mm_setzero_si128();
+
+	for (; (size - n) >= 16; n += 16) {
+		const __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + n));
+		if (_mm_movemask_epi8(bytes) != 0)
+			break;
+
+		__m128i *out = reinterpret_cast<__m128i *>(utf16 + n * 2);
+
+		if (bigEndian) {
+			_mm_storeu_si128(out    , _mm_unpacklo_epi8(zero, bytes));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi8(zero, bytes));
+		} else {
+			_mm_storeu_si128(out    , _mm_unpacklo_epi8(bytes, zero));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi8(bytes, zero));
+		}
+	}
+#endif
+
+	for (; (n < size) && (data[n] < 0x80); n++)
+		writeUTF16Unit(utf16, n, data[n], bigEndian);
+
+	return n;
+}
+
+static MemoryReadStream *encodeUTF16(const UString &str, bool bigEndian, bool terminate) {
+	const byte  *data = reinterpret_cast<const byte *>(str.c_str());
+	const size_t size = std::strlen(str.c_str());
+
+	// Every UTF-8 byte turns into at most one UTF-16 unit
+	ScopedArray<byte> output(new byte[(size + 1) * 2]);
+	size_t n = 0, o = 0;
+
+	while (n < size) {
+		if (data[n] < 0x80) {
+			const size_t run = copyASCIIRunUTF16(data + n, size - n, bigEndian, output.get() + o * 2);
+
+			o += run;
+			n += run;
+			continue;
+		}
+
+		uint32 c = readUTF8Char(data, n);
+
+		// Let iconv decide what to do with those
+		if ((c >= 0xD800) && (c <= 0xDFFF))
+			return 0;
+
+		if (c >= 0x10000) {
+			c -= 0x10000;
+
+			writeUTF16Unit(output.get(), o++, 0xD800 + (c >> 10)  , bigEndian);
+			writeUTF16Unit(output.get(), o++, 0xDC00 + (c & 0x3FF), bigEndian);
+			continue;
+		}
+
+		writeUTF16Unit(output.get(), o++, c, bigEndian);
+	}
+
+	if (terminate)
+		writeUTF16Unit(output.get(), o++, 0, bigEndian);
+
+	return new MemoryReadStream(output.release(), o * 2, true);
+}
+
+/** Convert an UTF-8 string into this encoding without iconv. Return 0 if we can't. */
+static MemoryReadStream *encodeFast(const UString &str, Encoding encoding, bool terminate) {
+	const ReverseTable *reverse = getReverseTable(encoding);
+	if (reverse || (encoding == kEncodingASCII))
+		return encodeSingleByte(str, reverse, terminate);
+
+	if (encoding == kEncodingUTF16LE)
+		return encodeUTF16(str, false, terminate);
+	if (encoding == kEncodingUTF16BE)
+		return encodeUTF16(str, true, terminate);
+
+	return 0;
+}
+
 UString getEncodingName(Encoding encoding) {
 	if (((size_t) encoding) >= kEncodingMAX)
 		return "Invalid";
@@ -278,10 +802,14 @@ static UString createString(std::vector<byte> &output, Encoding encoding) {
 			return UString(reinterpret_cast<const char *>(&output[0]));
 
 		default:
-			return ConvMan.convert(encoding, &output[0], output.size());
+			break;
 	}
 
-	return "";
+	UString str;
+	if (decodeFast(&output[0], output.size(), encoding, str))
+		return str;
+
+	return ConvMan.convert(encoding, &output[0], output.size());
 }
 
 UString readString(SeekableReadStream &stream, Encoding encoding) {
@@ -360,6 +888,10 @@ MemoryReadStream *convertString(const UString &str, Encoding encoding, bool term
 		return new MemoryReadStream(reinterpret_cast<const byte *>(str.c_str()),
 		                            std::strlen(str.c_str()) + (terminateString ? 1 : 0));
 
+	MemoryReadStream *converted = encodeFast(str, encoding, terminateString);
+	if (converted)
+		return converted;
+
 	return ConvMan.convert(encoding, str, terminateString);
 }
 
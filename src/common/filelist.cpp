@@ -100,10 +100,18 @@ FileList::const_iterator FileList::end() const {
 }
 
 bool FileList::addDirectory(const UString &directory, int recurseDepth) {
+	std::list<UString> directories;
+
+	return addDirectory(directory, recurseDepth, directories);
+}
+
+bool FileList::addDirectory(const UString &directory, int recurseDepth, std::list<UString> &directories) {
 	// Not a directory? Fail.
 	if (!FilePath::isDirectory(directory))
 		return false;
 
+	directories.push_back(directory);
+
 	try {
 		// Iterator over the directory's contents
 		for (directory_iterator itEnd, itDir(directory.c_str()); itDir != itEnd; ++itDir) {
@@ -113,7 +121,7 @@ bool FileList::addDirectory(const UString &directory, int recurseDepth) {
 				// It's a directory. Recurse into it if the depth limit wasn't yet reached
 
 				if (recurseDepth != 0)
-					if (!addDirectory(path, (recurseDepth == -1) ? -1 : (recurseDepth - 1)))
+					if (!addDirectory(path, (recurseDepth == -1) ? -1 : (recurseDepth - 1), directories))
 						return false;
 
 			} else
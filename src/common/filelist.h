@@ -77,6 +77,17 @@ public:
 	 */
 	bool addDirectory(const UString &directory, int recurseDepth = 0);
 
+	/** Add a directory to the list, and record all directories that were scanned.
+	 *
+	 *  @param  directory The directory to add.
+	 *  @param  recurseDepth The number of levels to recurse into subdirectories. 0
+	 *          for ignoring subdirectories, -1 for a limitless recursion.
+	 *  @param  directories The list to add the paths of all scanned directories to.
+	 *  @return true if the directory was successfully added to the list,
+	 *          false otherwise.
+	 */
+	bool addDirectory(const UString &directory, int recurseDepth, std::list<UString> &directories);
+
 	/** Add subdirectories of a directory to the list.
 	 *
 	 *  @param  directory The directory to scan.
@@ -0,0 +1,128 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum, for culling.
+ */
+
+#include "external/glm/gtc/matrix_inverse.hpp"
+
+#include "src/common/frustum.h"
+#include "src/common/boundingbox.h"
+
+namespace Common {
+
+Frustum::Frustum() {
+	clear();
+}
+
+void Frustum::clear() {
+	for (int i = 0; i < 6; i++) {
+		_planes[i][0] = 0.0f;
+		_planes[i][1] = 0.0f;
+		_planes[i][2] = 0.0f;
+		_planes[i][3] = 1.0f;
+	}
+
+	_camera[0] = 0.0f;
+	_camera[1] = 0.0f;
+	_camera[2] = 0.0f;
+
+	_maxDistance = 0.0f;
+}
+
+void Frustum::set(const glm::mat4 &projection, const glm::mat4 &modelview) {
+	/* Extract the planes from the rows of the combined matrix, in world
+	 * coordinates: left, right, bottom, top, near and far. */
+
+	const glm::mat4 clip = projection * modelview;
+
+	for (int i = 0; i < 3; i++) {
+		for (int j = 0; j < 4; j++) {
+			_planes[2 * i    ][j] = clip[j][3] + clip[j][i];
+			_planes[2 * i + 1][j] = clip[j][3] - clip[j][i];
+		}
+	}
+
+	const glm::mat4 modelviewInv = glm::affineInverse(modelview);
+
+	_camera[0] = modelviewInv[3][0];
+	_camera[1] = modelviewInv[3][1];
+	_camera[2] = modelviewInv[3][2];
+}
+
+float Frustum::getMaxDistance() const {
+	return _maxDistance;
+}
+
+void Frustum::setMaxDistance(float distance) {
+	_maxDistance = distance;
+}
+
+bool Frustum::isIn(float x, float y, float z) const {
+	const float point[3] = { x, y, z };
+
+	return isIn(point, point);
+}
+
+bool Frustum::isIn(const BoundingBox &box) const {
+	if (box.empty())
+		return true;
+
+	float min[3], max[3];
+	box.getMin(min[0], min[1], min[2]);
+	box.getMax(max[0], max[1], max[2]);
+
+	return isIn(min, max);
+}
+
+bool Frustum::isIn(const float *min, const float *max) const {
+	for (int i = 0; i < 6; i++) {
+		const float *plane = _planes[i];
+
+		// The corner of the box furthest along the plane's normal
+		const float x = (plane[0] >= 0.0f) ? max[0] : min[0];
+		const float y = (plane[1] >= 0.0f) ? max[1] : min[1];
+		const float z = (plane[2] >= 0.0f) ? max[2] : min[2];
+
+		if ((plane[0] * x + plane[1] * y + plane[2] * z + plane[3]) < 0.0f)
+			return false;
+	}
+
+	if (_maxDistance <= 0.0f)
+		return true;
+
+	// The squared distance from the camera to the closest point of the box
+	float distance = 0.0f;
+	for (int i = 0; i < 3; i++) {
+		float d = 0.0f;
+
+		if      (_camera[i] < min[i])
+			d = min[i] - _camera[i];
+		else if (_camera[i] > max[i])
+			d = _camera[i] - max[i];
+
+		distance += d * d;
+	}
+
+	return distance <= (_maxDistance * _maxDistance);
+}
+
+} // End of namespace Common
@@ -0,0 +1,83 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A view frustum, for culling.
+ */
+
+#ifndef COMMON_FRUSTUM_H
+#define COMMON_FRUSTUM_H
+
+#include "external/glm/mat4x4.hpp"
+
+namespace Common {
+
+class BoundingBox;
+
+/** The volume visible through a camera, for culling objects that can't be seen.
+ *
+ *  The frustum is built from the projection and modelview matrices and
+ *  consists of six planes in world coordinates. Optionally, objects too far
+ *  away from the camera can be culled as well.
+ *
+ *  All tests are conservative: they might claim something is visible that
+ *  isn't, but never the other way round. A default constructed frustum
+ *  contains everything.
+ */
+class Frustum {
+public:
+	Frustum();
+
+	/** Contain everything again. */
+	void clear();
+
+	/** Build the frustum from a projection and a modelview (camera view) matrix. */
+	void set(const glm::mat4 &projection, const glm::mat4 &modelview);
+
+	/** Return the maximum distance from the camera, 0.0f for none. */
+	float getMaxDistance() const;
+	/** Set the maximum distance from the camera. Anything further away is outside. 0.0f for none. */
+	void setMaxDistance(float distance);
+
+	/** Is that point within the frustum? */
+	bool isIn(float x, float y, float z) const;
+
+	/** Is any part of the box within the frustum?
+	 *
+	 *  The box is taken as axis-aligned between its minimum and maximum,
+	 *  so it should be absolute. An empty box is always within the frustum.
+	 */
+	bool isIn(const BoundingBox &box) const;
+
+	/** Is any part of the axis-aligned box between min and max within the frustum? */
+	bool isIn(const float *min, const float *max) const;
+
+private:
+	/** The planes, as (a, b, c, d) with a * x + b * y + c * z + d >= 0 inside. */
+	float _planes[6][4];
+
+	float _camera[3]; ///< The position of the camera.
+
+	float _maxDistance;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_FRUSTUM_H
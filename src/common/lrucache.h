@@ -0,0 +1,238 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A size-bounded cache, evicting the least recently used values.
+ */
+
+#ifndef COMMON_LRUCACHE_H
+#define COMMON_LRUCACHE_H
+
+#include <list>
+#include <unordered_map>
+#include <functional>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+#include "src/common/mutex.h"
+
+namespace Common {
+
+/** A cache of values, evicting the least recently used ones once it grows too large.
+ *
+ *  Every value is added together with its size, in whatever unit the budget
+ *  is given in (usually bytes). When the sum of all sizes exceeds the budget,
+ *  the values that were least recently used are evicted until it fits again.
+ *  A value that is larger than the whole budget is not added at all, and a
+ *  budget of 0 disables the cache.
+ *
+ *  All methods lock an internal mutex, so the cache can be used from several
+ *  threads at once. Values are copied in and out, so they should be cheap to
+ *  copy, for example shared pointers.
+ */
+template<typename Key, typename Value, class Hash = std::hash<Key> >
+class LRUCache : boost::noncopyable {
+public:
+	/** Statistics about the use of a cache. */
+	struct Stats {
+		uint64 hits;      ///< Number of lookups that found a value.
+		uint64 misses;    ///< Number of lookups that found nothing.
+		uint64 evictions; ///< Number of values evicted to stay within the budget.
+
+		size_t count;  ///< Number of values currently in the cache.
+		size_t size;   ///< Sum of the sizes of all values currently in the cache.
+		size_t budget; ///< The maximum size of all values in the cache.
+
+		Stats() : hits(0), misses(0), evictions(0), count(0), size(0), budget(0) {
+		}
+	};
+
+	LRUCache(size_t budget = 0) : _size(0), _budget(budget) {
+	}
+
+	/** Change the budget, evicting values if the cache doesn't fit anymore. */
+	void setBudget(size_t budget) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_budget = budget;
+		evict(0);
+	}
+
+	size_t getBudget() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _budget;
+	}
+
+	/** Look up a value, and mark it as the most recently used one.
+	 *
+	 *  @return true if the value was found and copied into value.
+	 */
+	bool get(const Key &key, Value &value) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		typename EntryMap::iterator e = _map.find(key);
+		if (e == _map.end()) {
+			_stats.misses++;
+			return false;
+		}
+
+		_stats.hits++;
+
+		_entries.splice(_entries.begin(), _entries, e->second);
+
+		value = e->second->value;
+		return true;
+	}
+
+	/** Is there a value with this key? This doesn't count as a use of the value. */
+	bool contains(const Key &key) const {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		return _map.find(key) != _map.end();
+	}
+
+	/** Add a value as the most recently used one, replacing any value with the same key.
+	 *
+	 *  @return true if the value was added, false if it's larger than the budget.
+	 */
+	bool put(const Key &key, const Value &value, size_t size) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		remove(key);
+
+		if (size > _budget)
+			return false;
+
+		evict(size);
+
+		_entries.push_front(Entry(key, value, size));
+		_map.insert(std::make_pair(key, _entries.begin()));
+
+		_size += size;
+		return true;
+	}
+
+	/** Remove the value with this key, if there is one. */
+	void erase(const Key &key) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		remove(key);
+	}
+
+	/** Remove all values with keys matching the predicate. */
+	template<class Predicate>
+	void eraseIf(Predicate pred) {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		for (typename EntryList::iterator e = _entries.begin(); e != _entries.end(); ) {
+			if (!pred(e->key)) {
+				++e;
+				continue;
+			}
+
+			_size -= e->size;
+			_map.erase(e->key);
+			e = _entries.erase(e);
+		}
+	}
+
+	/** Remove all values. The statistics are kept. */
+	void clear() {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_entries.clear();
+		_map.clear();
+
+		_size = 0;
+	}
+
+	/** Return the current statistics. */
+	Stats getStats() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		Stats stats = _stats;
+
+		stats.count  = _map.size();
+		stats.size   = _size;
+		stats.budget = _budget;
+
+		return stats;
+	}
+
+	/** Reset the hit, miss and eviction counters. */
+	void resetStats() {
+		std::lock_guard<std::mutex> lock(_mutex);
+
+		_stats = Stats();
+	}
+
+private:
+	struct Entry {
+		Key key;
+		Value value;
+		size_t size;
+
+		Entry(const Key &k, const Value &v, size_t s) : key(k), value(v), size(s) {
+		}
+	};
+
+	/** All entries, the most recently used first. */
+	typedef std::list<Entry> EntryList;
+	typedef std::unordered_map<Key, typename EntryList::iterator, Hash> EntryMap;
+
+	EntryList _entries;
+	EntryMap  _map;
+
+	size_t _size;
+	size_t _budget;
+
+	Stats _stats;
+
+	mutable std::mutex _mutex;
+
+	void remove(const Key &key) {
+		typename EntryMap::iterator e = _map.find(key);
+		if (e == _map.end())
+			return;
+
+		_size -= e->second->size;
+		_entries.erase(e->second);
+		_map.erase(e);
+	}
+
+	/** Evict entries until there's room for this much more within the budget. */
+	void evict(size_t needed) {
+		while (!_entries.empty() && ((_size + needed) > _budget)) {
+			const Entry &entry = _entries.back();
+
+			_size -= entry.size;
+			_map.erase(entry.key);
+			_entries.pop_back();
+
+			_stats.evictions++;
+		}
+	}
+};
+
+} // End of namespace Common
+
+#endif // COMMON_LRUCACHE_H
@@ -0,0 +1,180 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Implementing the stream reading interfaces for memory-mapped files.
+ */
+
+#include "src/common/system.h"
+
+#if defined(WIN32)
+	#include <windows.h>
+#elif defined(UNIX)
+	#include <sys/types.h>
+	#include <sys/stat.h>
+	#include <sys/mman.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
+
+#include <cassert>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/make_shared.hpp>
+
+#include "src/common/mappedfile.h"
+#include "src/common/error.h"
+#include "src/common/ustring.h"
+
+namespace Common {
+
+MappedFile::MappedFile() : _data(0), _size(0) {
+}
+
+MappedFile::~MappedFile() {
+	close();
+}
+
+bool MappedFile::open(const UString &fileName) {
+	close();
+
+	const boost::filesystem::path path(fileName.c_str());
+
+#if defined(WIN32)
+	HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, 0, OPEN_EXISTING,
+	                          FILE_ATTRIBUTE_NORMAL, 0);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize) || (fileSize.QuadPart <= 0) ||
+	    ((uint64)fileSize.QuadPart > (uint64)0x7FFFFFFFULL)) {
+
+		CloseHandle(file);
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingW(file, 0, PAGE_READONLY, 0, 0, 0);
+	CloseHandle(file);
+
+	if (!mapping)
+		return false;
+
+	// The view keeps its own reference to the mapping object
+	const void *data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (!data)
+		return false;
+
+	_data = reinterpret_cast<const byte *>(data);
+	_size = (size_t)fileSize.QuadPart;
+
+	return true;
+
+#elif defined(UNIX)
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+
+	struct stat fileStat;
+	if ((fstat(fd, &fileStat) != 0) || (fileStat.st_size <= 0) ||
+	    ((uint64)fileStat.st_size > (uint64)0x7FFFFFFFULL)) {
+
+		::close(fd);
+		return false;
+	}
+
+	// The mapping stays valid after the file descriptor is closed
+	void *data = mmap(0, fileStat.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	::close(fd);
+
+	if (data == MAP_FAILED)
+		return false;
+
+	_data = reinterpret_cast<const byte *>(data);
+	_size = (size_t)fileStat.st_size;
+
+	return true;
+
+#else
+	return false;
+#endif
+}
+
+void MappedFile::close() {
+	if (_data) {
+#if defined(WIN32)
+		UnmapViewOfFile(_data);
+#elif defined(UNIX)
+		munmap(const_cast<byte *>(_data), _size);
+#endif
+	}
+
+	_data = 0;
+	_size = 0;
+}
+
+bool MappedFile::isOpen() const {
+	return _data != 0;
+}
+
+const byte *MappedFile::getData() const {
+	return _data;
+}
+
+size_t MappedFile::size() const {
+	return _size;
+}
+
+
+MappedFileReadStream::MappedFileReadStream(const boost::shared_ptr<MappedFile> &file) :
+	MemoryReadStream(file->getData(), file->size()), _file(file), _begin(0) {
+
+	assert(_file->isOpen());
+}
+
+MappedFileReadStream::MappedFileReadStream(const boost::shared_ptr<MappedFile> &file,
+                                           size_t begin, size_t end) :
+	MemoryReadStream(file->getData() + begin, end - begin), _file(file), _begin(begin) {
+
+	assert(_file->isOpen());
+	assert((begin <= end) && (end <= _file->size()));
+}
+
+MappedFileReadStream::~MappedFileReadStream() {
+}
+
+MemoryReadStream *MappedFileReadStream::readStreamAt(size_t offset, size_t dataSize) {
+	if ((offset > size()) || (dataSize > (size() - offset)))
+		throw Exception(kReadError);
+
+	return new MappedFileReadStream(_file, _begin + offset, _begin + offset + dataSize);
+}
+
+MappedFileReadStream *MappedFileReadStream::open(const UString &fileName) {
+	boost::shared_ptr<MappedFile> file = boost::make_shared<MappedFile>();
+	if (!file->open(fileName))
+		return 0;
+
+	return new MappedFileReadStream(file);
+}
+
+} // End of namespace Common
@@ -0,0 +1,103 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Implementing the stream reading interfaces for memory-mapped files.
+ */
+
+#ifndef COMMON_MAPPEDFILE_H
+#define COMMON_MAPPEDFILE_H
+
+#include <boost/noncopyable.hpp>
+#include <boost/shared_ptr.hpp>
+
+#include "src/common/types.h"
+#include "src/common/memreadstream.h"
+
+namespace Common {
+
+class UString;
+
+/** A read-only memory mapping of a whole file. */
+class MappedFile : boost::noncopyable {
+public:
+	MappedFile();
+	~MappedFile();
+
+	/** Try to map the file with the given fileName into memory.
+	 *
+	 *  This fails for empty files, and on platforms without support
+	 *  for memory-mapped files.
+	 *
+	 *  @param  fileName the name of the file to map
+	 *  @return true if file was mapped successfully, false otherwise
+	 */
+	bool open(const UString &fileName);
+
+	/** Unmap the file, if mapped. */
+	void close();
+
+	/** Checks if the object mapped a file successfully. */
+	bool isOpen() const;
+
+	/** Return the mapped data. */
+	const byte *getData() const;
+	/** Return the size of the mapped file. */
+	size_t size() const;
+
+private:
+	const byte *_data; ///< The mapped file data.
+	size_t      _size; ///< The file's size.
+};
+
+/** A read stream over (a part of) a memory-mapped file.
+ *
+ *  The stream holds a reference to the mapping, keeping it alive for as
+ *  long as the stream exists.
+ *
+ *  Data read with readStreamAt() is not copied. Instead, a new stream
+ *  viewing the same mapping is returned.
+ */
+class MappedFileReadStream : public MemoryReadStream {
+public:
+	/** Create a stream over the whole mapped file. */
+	MappedFileReadStream(const boost::shared_ptr<MappedFile> &file);
+	/** Create a stream over the range [begin, end) of the mapped file. */
+	MappedFileReadStream(const boost::shared_ptr<MappedFile> &file, size_t begin, size_t end);
+	~MappedFileReadStream();
+
+	/** Return a new stream viewing the specified data, without copying it. */
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
+	/** Try to map the file into memory and create a stream over it.
+	 *
+	 *  @return The stream over the whole file, or 0 if the file can't be mapped.
+	 */
+	static MappedFileReadStream *open(const UString &fileName);
+
+private:
+	boost::shared_ptr<MappedFile> _file;
+
+	size_t _begin;
+};
+
+} // End of namespace Common
+
+#endif // COMMON_MAPPEDFILE_H
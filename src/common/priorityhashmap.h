@@ -0,0 +1,360 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A flat hash map from 64-bit hashes to priority-ordered chains of values.
+ */
+
+#ifndef COMMON_PRIORITYHASHMAP_H
+#define COMMON_PRIORITYHASHMAP_H
+
+#include <cassert>
+#include <functional>
+#include <vector>
+#include <deque>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/types.h"
+
+namespace Common {
+
+/** A flat hash map from 64-bit hashes to chains of values, ordered by priority.
+ *
+ *  The keys live in a single open-addressing table with linear probing,
+ *  so finding a key touches one or two adjacent cache lines instead of
+ *  walking a tree. Every key maps to a chain of values, sorted so that
+ *  the value with the highest priority (according to Compare) comes first.
+ *  Values of equal priority are ordered newest first.
+ *
+ *  Values are referenced by handles. Both handles and the addresses of
+ *  the values stay valid until the value is erased or the map is cleared.
+ *
+ *  Const methods don't modify the map, so it is safe to call them
+ *  concurrently, as long as no non-const method is called at the same time.
+ */
+template<typename T, class Compare = std::less<T> >
+class PriorityHashMap : boost::noncopyable {
+public:
+	/** A handle referencing a value in the map. */
+	typedef uint32 Handle;
+
+	static const Handle kInvalidHandle = 0xFFFFFFFF;
+
+	PriorityHashMap() : _keyCount(0), _valueCount(0), _shift(64) {
+	}
+
+	~PriorityHashMap() {
+	}
+
+	/** Remove all values from the map. */
+	void clear() {
+		std::vector<Bucket>().swap(_buckets);
+		std::deque<Node>().swap(_nodes);
+		std::vector<Handle>().swap(_freeNodes);
+
+		_keyCount   = 0;
+		_valueCount = 0;
+		_shift      = 64;
+	}
+
+	/** Does the map contain no values? */
+	bool empty() const {
+		return _valueCount == 0;
+	}
+
+	/** Return the number of values in the map. */
+	size_t size() const {
+		return _valueCount;
+	}
+
+	/** Return the number of distinct hashes in the map. */
+	size_t getKeyCount() const {
+		return _keyCount;
+	}
+
+	/** Make room for this many distinct hashes without rehashing. */
+	void reserve(size_t keyCount) {
+		size_t bucketCount = 16;
+		while (!fitsLoad(keyCount, bucketCount))
+			bucketCount *= 2;
+
+		if (bucketCount > _buckets.size())
+			rehash(bucketCount);
+	}
+
+	/** Insert a value into the chain of that hash.
+	 *
+	 *  The value is placed in front of all values with a priority
+	 *  lower than or equal to its own.
+	 *
+	 *  @return The handle of the newly inserted value.
+	 */
+	Handle insert(uint64 hash, const T &value) {
+		if (!fitsLoad(_keyCount + 1, _buckets.size()))
+			rehash(_buckets.empty() ? 16 : (_buckets.size() * 2));
+
+		const Handle handle = allocateNode(hash, value);
+
+		Bucket &bucket = _buckets[findBucket(hash)];
+		if (bucket.head == kInvalidHandle) {
+			bucket.hash = hash;
+			bucket.head = handle;
+
+			_keyCount++;
+			_valueCount++;
+			return handle;
+		}
+
+		Handle prev = kInvalidHandle, cur = bucket.head;
+		while ((cur != kInvalidHandle) && _compare(value, _nodes[cur].value)) {
+			prev = cur;
+			cur  = _nodes[cur].next;
+		}
+
+		_nodes[handle].next = cur;
+		if (prev == kInvalidHandle)
+			bucket.head = handle;
+		else
+			_nodes[prev].next = handle;
+
+		_valueCount++;
+		return handle;
+	}
+
+	/** Remove the value with this handle from the map. */
+	void erase(Handle handle) {
+		assert(handle < _nodes.size());
+
+		const uint64 hash = _nodes[handle].hash;
+
+		const size_t index = findBucket(hash);
+		assert(_buckets[index].head != kInvalidHandle);
+
+		Handle prev = kInvalidHandle, cur = _buckets[index].head;
+		while (cur != handle) {
+			assert(cur != kInvalidHandle);
+
+			prev = cur;
+			cur  = _nodes[cur].next;
+		}
+
+		if (prev == kInvalidHandle)
+			_buckets[index].head = _nodes[handle].next;
+		else
+			_nodes[prev].next = _nodes[handle].next;
+
+		freeNode(handle);
+		_valueCount--;
+
+		if (_buckets[index].head == kInvalidHandle) {
+			removeBucket(index);
+			_keyCount--;
+		}
+	}
+
+	/** Find the value with the highest priority for this hash.
+	 *
+	 *  @return The value's handle, or kInvalidHandle if the hash is not in the map.
+	 */
+	Handle find(uint64 hash) const {
+		if (_buckets.empty())
+			return kInvalidHandle;
+
+		return _buckets[findBucket(hash)].head;
+	}
+
+	/** Return the value following this one in its chain, in order of decreasing priority. */
+	Handle getNext(Handle handle) const {
+		assert(handle < _nodes.size());
+
+		return _nodes[handle].next;
+	}
+
+	/** Return the value with the lowest priority in the chain starting at this handle. */
+	Handle getLast(Handle handle) const {
+		assert(handle < _nodes.size());
+
+		while (_nodes[handle].next != kInvalidHandle)
+			handle = _nodes[handle].next;
+
+		return handle;
+	}
+
+	/** Return the hash the value with this handle is stored under. */
+	uint64 getHash(Handle handle) const {
+		assert(handle < _nodes.size());
+
+		return _nodes[handle].hash;
+	}
+
+	T &get(Handle handle) {
+		assert(handle < _nodes.size());
+
+		return _nodes[handle].value;
+	}
+
+	const T &get(Handle handle) const {
+		assert(handle < _nodes.size());
+
+		return _nodes[handle].value;
+	}
+
+	/** Return the number of buckets in the hash table.
+	 *
+	 *  Together with getBucket(), this can be used to iterate over all
+	 *  hashes in the map, in an unspecified but deterministic order.
+	 */
+	size_t getBucketCount() const {
+		return _buckets.size();
+	}
+
+	/** Return the head of the chain in this bucket, or kInvalidHandle if it's empty. */
+	Handle getBucket(size_t index) const {
+		assert(index < _buckets.size());
+
+		return _buckets[index].head;
+	}
+
+private:
+	struct Bucket {
+		uint64 hash;
+		Handle head;
+
+		Bucket() : hash(0), head(kInvalidHandle) { }
+	};
+
+	struct Node {
+		T value;
+
+		uint64 hash;
+		Handle next;
+
+		Node(uint64 h, const T &v) : value(v), hash(h), next(kInvalidHandle) { }
+	};
+
+	/** The hash table. Its size is always 0 or a power of 2. */
+	std::vector<Bucket> _buckets;
+
+	/** The values. A deque never moves its elements when growing. */
+	std::deque<Node> _nodes;
+	/** Nodes of erased values, ready to be reused. */
+	std::vector<Handle> _freeNodes;
+
+	size_t _keyCount;
+	size_t _valueCount;
+
+	/** 64 - log2(bucket count), to map a hash onto the table. */
+	unsigned int _shift;
+
+	Compare _compare;
+
+
+	static bool fitsLoad(size_t keyCount, size_t bucketCount) {
+		// Keep the table at most 3/4 full
+		return (keyCount * 4) <= (bucketCount * 3);
+	}
+
+	size_t getIdealBucket(uint64 hash) const {
+		// Fibonacci hashing, so that weak hashes still spread over the whole table
+		return (size_t)((hash * 0x9E3779B97F4A7C15ULL) >> _shift);
+	}
+
+	/** Return the bucket containing the hash, or the empty bucket where it would go. */
+	size_t findBucket(uint64 hash) const {
+		const size_t mask = _buckets.size() - 1;
+
+		size_t index = getIdealBucket(hash);
+		while ((_buckets[index].head != kInvalidHandle) && (_buckets[index].hash != hash))
+			index = (index + 1) & mask;
+
+		return index;
+	}
+
+	void rehash(size_t bucketCount) {
+		std::vector<Bucket> oldBuckets(bucketCount);
+		oldBuckets.swap(_buckets);
+
+		_shift = 64;
+		for (size_t i = bucketCount; i > 1; i >>= 1)
+			_shift--;
+
+		for (typename std::vector<Bucket>::const_iterator b = oldBuckets.begin(); b != oldBuckets.end(); ++b)
+			if (b->head != kInvalidHandle)
+				_buckets[findBucket(b->hash)] = *b;
+	}
+
+	/** Empty this bucket, shifting back the entries probed past it. */
+	void removeBucket(size_t index) {
+		const size_t mask = _buckets.size() - 1;
+
+		_buckets[index].head = kInvalidHandle;
+
+		size_t next = index;
+		while (true) {
+			next = (next + 1) & mask;
+			if (_buckets[next].head == kInvalidHandle)
+				break;
+
+			// Leave the entry alone if its ideal bucket lies cyclically in (index, next]
+			const size_t ideal = getIdealBucket(_buckets[next].hash);
+			if ((index <= next) ? ((index < ideal) && (ideal <= next)) : ((index < ideal) || (ideal <= next)))
+				continue;
+
+			_buckets[index] = _buckets[next];
+			_buckets[next].head = kInvalidHandle;
+
+			index = next;
+		}
+	}
+
+	Handle allocateNode(uint64 hash, const T &value) {
+		if (!_freeNodes.empty()) {
+			const Handle handle = _freeNodes.back();
+			_freeNodes.pop_back();
+
+			_nodes[handle].value = value;
+			_nodes[handle].hash  = hash;
+			_nodes[handle].next  = kInvalidHandle;
+
+			return handle;
+		}
+
+		assert(_nodes.size() < kInvalidHandle);
+
+		_nodes.push_back(Node(hash, value));
+		return (Handle)(_nodes.size() - 1);
+	}
+
+	void freeNode(Handle handle) {
+		// Release whatever the value holds right away
+		_nodes[handle].value = T();
+		_nodes[handle].next  = kInvalidHandle;
+
+		_freeNodes.push_back(handle);
+	}
+};
+
+template<typename T, class Compare>
+const typename PriorityHashMap<T, Compare>::Handle PriorityHashMap<T, Compare>::kInvalidHandle;
+
+} // End of namespace Common
+
+#endif // COMMON_PRIORITYHASHMAP_H
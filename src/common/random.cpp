@@ -34,11 +34,15 @@ Random::Random() {
 }
 
 int Random::getNext(int min, int max) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	std::uniform_int_distribution<int> dist(min, max - 1);
 	return dist(_generator);
 }
 
 float Random::getNext(float min, float max) {
+	std::lock_guard<std::mutex> lock(_mutex);
+
 	std::uniform_real_distribution<float> dist(min, max);
 	return dist(_generator);
 }
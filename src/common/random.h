@@ -28,9 +28,11 @@
 #include <random>
 
 #include "src/common/singleton.h"
+#include "src/common/mutex.h"
 
 namespace Common {
 
+/** The global random number generator. It can be used from several threads at once. */
 class Random : public Singleton<Random> {
 public:
 	Random();
@@ -43,6 +45,8 @@ public:
 
 private:
 	std::mt19937 _generator;
+
+	std::mutex _mutex;
 };
 
 } // End of namespace Common
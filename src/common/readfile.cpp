@@ -22,6 +22,13 @@
  *  Implementing the stream reading interfaces for files.
  */
 
+#include "src/common/system.h"
+
+#if defined(UNIX)
+	#include <unistd.h>
+	#include <errno.h>
+#endif
+
 #include <cassert>
 
 #include "src/common/readfile.h"
@@ -97,6 +104,10 @@ bool ReadFile::eos() const {
 	if (!_handle)
 		return true;
 
+#if !defined(UNIX)
+	std::lock_guard<std::mutex> lock(_positionMutex);
+#endif
+
 	return std::feof(_handle) != 0;
 }
 
@@ -104,6 +115,10 @@ size_t ReadFile::pos() const {
 	if (!_handle)
 		return kPositionInvalid;
 
+#if !defined(UNIX)
+	std::lock_guard<std::mutex> lock(_positionMutex);
+#endif
+
 	return (size_t)std::ftell(_handle);
 }
 
@@ -119,7 +134,11 @@ size_t ReadFile::seek(ptrdiff_t offset, Origin whence) {
 	if (!_handle)
 		throw Exception(kSeekError);
 
-	size_t oldPos = pos();
+#if !defined(UNIX)
+	std::lock_guard<std::mutex> lock(_positionMutex);
+#endif
+
+	size_t oldPos = (size_t)std::ftell(_handle);
 
 	if (std::fseek(_handle, offset, kSeekToWhence[whence]) != 0)
 		throw Exception(kSeekError);
@@ -136,7 +155,61 @@ size_t ReadFile::read(void *dataPtr, size_t dataSize) {
 		return 0;
 
 	assert(dataPtr);
+
+#if !defined(UNIX)
+	std::lock_guard<std::mutex> lock(_positionMutex);
+#endif
+
 	return std::fread(dataPtr, 1, dataSize, _handle);
 }
 
+size_t ReadFile::readAt(size_t offset, void *dataPtr, size_t dataSize) {
+	if (!_handle || (offset >= _size))
+		return 0;
+
+	assert(dataPtr);
+
+	dataSize = MIN<size_t>(dataSize, _size - offset);
+
+#if defined(UNIX)
+	const int fd = fileno(_handle);
+
+	byte *data = reinterpret_cast<byte *>(dataPtr);
+
+	size_t readBytes = 0;
+	while (readBytes < dataSize) {
+		const ssize_t n = pread(fd, data + readBytes, dataSize - readBytes, offset + readBytes);
+		if (n < 0) {
+			if (errno == EINTR)
+				continue;
+
+			break;
+		}
+
+		if (n == 0)
+			break;
+
+		readBytes += n;
+	}
+
+	return readBytes;
+#else
+	/* No positional reads available, so we have to go through the
+	 * shared file position indicator, and restore it afterwards. Every
+	 * other user of the position indicator takes the same lock, so they
+	 * never see it moved. */
+
+	std::lock_guard<std::mutex> lock(_positionMutex);
+
+	const long oldPos = std::ftell(_handle);
+	if ((oldPos < 0) || (std::fseek(_handle, offset, SEEK_SET) != 0))
+		return 0;
+
+	const size_t readBytes = std::fread(dataPtr, 1, dataSize, _handle);
+
+	std::fseek(_handle, oldPos, SEEK_SET);
+	return readBytes;
+#endif
+}
+
 } // End of namespace Common
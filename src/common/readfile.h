@@ -31,6 +31,7 @@
 
 #include "src/common/types.h"
 #include "src/common/readstream.h"
+#include "src/common/mutex.h"
 
 namespace Common {
 
@@ -67,9 +68,23 @@ public:
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 	size_t read(void *dataPtr, size_t dataSize);
 
+	/** Read data from an absolute position within the file.
+	 *
+	 *  This is a positional read that does not use the file position
+	 *  indicator, so it can be called concurrently from several threads,
+	 *  and alongside seek() and read().
+	 *
+	 *  Where the platform has no positional reads, it falls back to seeking
+	 *  under a lock that all users of the file position indicator take.
+	 */
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
 protected:
 	std::FILE *_handle; ///< The actual file handle.
 	size_t _size;       ///< The file's size.
+
+	/** Guards the file position indicator where the platform has no positional reads. */
+	mutable std::mutex _positionMutex;
 };
 
 } // End of namespace Common
@@ -318,6 +318,35 @@ public:
 		return seek(offset, kOriginCurrent);
 	}
 
+	/** Read data from an absolute position within the stream, without
+	 *  touching the stream position indicator.
+	 *
+	 *  Streams that can do positional reads natively (files, memory blocks
+	 *  and substreams of those) allow any number of readAt() calls to run
+	 *  concurrently from several threads. The default implementation
+	 *  falls back to seek() and read(), and is not thread-safe.
+	 *
+	 *  Mixing readAt() with concurrent calls to seek() or read() on the
+	 *  same stream is never safe.
+	 *
+	 *  @param  offset the absolute position to read from.
+	 *  @param  dataPtr pointer to a buffer into which the data is read.
+	 *  @param  dataSize number of bytes to be read.
+	 *  @return the number of bytes which were actually read.
+	 */
+	virtual size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+
+	/** Read the specified amount of data from an absolute position into a
+	 *  new[]'ed buffer which then is wrapped into a MemoryReadStream.
+	 *
+	 *  This uses readAt(), and has the same thread-safety guarantees.
+	 *  When reading fails, a kReadError exception is thrown.
+	 *
+	 *  Streams over memory-mapped files override this to return a view
+	 *  into the mapping instead of a copy.
+	 */
+	virtual MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
 	/** Evaluate the seek offset relative to whence into a position from the beginning. */
 	static size_t evalSeek(ptrdiff_t offset, Origin whence, size_t pos, size_t begin, size_t size);
 };
@@ -367,6 +396,9 @@ public:
 
 	size_t seek(ptrdiff_t offset, Origin whence = kOriginBegin);
 
+	size_t readAt(size_t offset, void *dataPtr, size_t dataSize);
+	MemoryReadStream *readStreamAt(size_t offset, size_t dataSize);
+
 protected:
 	SeekableReadStream *_parentStream;
 
@@ -34,6 +34,8 @@ src_common_libcommon_la_SOURCES += \
     src/common/ptrlist.h \
     src/common/ptrvector.h \
     src/common/ptrmap.h \
+    src/common/priorityhashmap.h \
+    src/common/lrucache.h \
     src/common/singleton.h \
     src/common/maths.h \
     src/common/sinetables.h \
@@ -45,6 +47,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/mdct.h \
     src/common/threads.h \
     src/common/thread.h \
+    src/common/threadpool.h \
     src/common/ustring.h \
     src/common/hash.h \
     src/common/md5.h \
@@ -67,6 +70,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/stringmap.h \
     src/common/readline.h \
     src/common/readfile.h \
+    src/common/mappedfile.h \
     src/common/writefile.h \
     src/common/filepath.h \
     src/common/filelist.h \
@@ -75,6 +79,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/bitstreamwriter.h \
     src/common/huffman.h \
     src/common/boundingbox.h \
+    src/common/frustum.h \
     src/common/configfile.h \
     src/common/configman.h \
     src/common/foxpro.h \
@@ -87,6 +92,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/timestamp.h \
     src/common/geometry.h \
     src/common/aabbnode.h \
+    src/common/aabbtree.h \
     src/common/random.h \
     src/common/mutex.h \
     $(EMPTY)
@@ -102,6 +108,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/mdct.cpp \
     src/common/threads.cpp \
     src/common/thread.cpp \
+    src/common/threadpool.cpp \
     src/common/ustring.cpp \
     src/common/md5.cpp \
     src/common/blowfish.cpp \
@@ -123,11 +130,13 @@ src_common_libcommon_la_SOURCES += \
     src/common/stringmap.cpp \
     src/common/readline.cpp \
     src/common/readfile.cpp \
+    src/common/mappedfile.cpp \
     src/common/writefile.cpp \
     src/common/filepath.cpp \
     src/common/filelist.cpp \
     src/common/huffman.cpp \
     src/common/boundingbox.cpp \
+    src/common/frustum.cpp \
     src/common/configfile.cpp \
     src/common/configman.cpp \
     src/common/foxpro.cpp \
@@ -139,6 +148,7 @@ src_common_libcommon_la_SOURCES += \
     src/common/rational.cpp \
     src/common/timestamp.cpp \
     src/common/aabbnode.cpp \
+    src/common/aabbtree.cpp \
     src/common/random.cpp \
     $(EMPTY)
 
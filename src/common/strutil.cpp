@@ -212,13 +212,16 @@ static inline void parse(const char *nptr, char **endptr, double &value) {
 }
 
 
-template<typename T> void parseString(const UString &str, T &value, bool allowEmpty) {
-	if (str.empty()) {
-		if (allowEmpty)
-			return;
+enum ParseResult {
+	kParseOK,
+	kParseEmpty,
+	kParseInvalid,
+	kParseOutOfRange
+};
 
-		throw Exception("Trying to parse an empty string");
-	}
+template<typename T> static ParseResult parseValue(const UString &str, T &value) {
+	if (str.empty())
+		return kParseEmpty;
 
 	const char *nptr = str.c_str();
 	char *endptr = 0;
@@ -232,11 +235,35 @@ template<typename T> void parseString(const UString &str, T &value, bool allowEm
 		endptr++;
 
 	if (endptr && (*endptr != '\0'))
-		throw Exception("Can't convert \"%s\" to type of size %u", str.c_str(), (uint)sizeof(T));
+		return kParseInvalid;
 	if (errno == ERANGE)
-		throw Exception("\"%s\" out of range for type of size %u", str.c_str(), (uint)sizeof(T));
+		return kParseOutOfRange;
 
 	value = newValue;
+	return kParseOK;
+}
+
+template<typename T> void parseString(const UString &str, T &value, bool allowEmpty) {
+	switch (parseValue(str, value)) {
+		case kParseEmpty:
+			if (allowEmpty)
+				return;
+
+			throw Exception("Trying to parse an empty string");
+
+		case kParseInvalid:
+			throw Exception("Can't convert \"%s\" to type of size %u", str.c_str(), (uint)sizeof(T));
+
+		case kParseOutOfRange:
+			throw Exception("\"%s\" out of range for type of size %u", str.c_str(), (uint)sizeof(T));
+
+		default:
+			break;
+	}
+}
+
+template<typename T> bool tryParseString(const UString &str, T &value) {
+	return parseValue(str, value) == kParseOK;
 }
 
 template<> void parseString(const UString &str, bool &value, bool allowEmpty) {
@@ -272,6 +299,20 @@ template void parseString<unsigned long long>(const UString &str, unsigned long
 template void parseString<float             >(const UString &str, float              &value, bool allowEmpty);
 template void parseString<double            >(const UString &str, double             &value, bool allowEmpty);
 
+template bool tryParseString<  signed char     >(const UString &str,   signed char      &value);
+template bool tryParseString<unsigned char     >(const UString &str, unsigned char      &value);
+template bool tryParseString<  signed short    >(const UString &str,   signed short     &value);
+template bool tryParseString<unsigned short    >(const UString &str, unsigned short     &value);
+template bool tryParseString<  signed int      >(const UString &str,   signed int       &value);
+template bool tryParseString<unsigned int      >(const UString &str, unsigned int       &value);
+template bool tryParseString<  signed long     >(const UString &str,   signed long      &value);
+template bool tryParseString<unsigned long     >(const UString &str, unsigned long      &value);
+template bool tryParseString<  signed long long>(const UString &str,   signed long long &value);
+template bool tryParseString<unsigned long long>(const UString &str, unsigned long long &value);
+
+template bool tryParseString<float             >(const UString &str, float              &value);
+template bool tryParseString<double            >(const UString &str, double             &value);
+
 
 template<typename T> UString composeString(T value) {
 	/* Create a string representation of the value, in decimal notation.
@@ -54,6 +54,15 @@ UString debugTag(uint32 tag, bool trim = false);
  */
 template<typename T> void parseString(const UString &str, T &value, bool allowEmpty = false);
 
+/** Parse a string into any POD integer or float/double type, without throwing.
+ *
+ *  Unlike parseString(), this doesn't throw when the string can't be parsed,
+ *  which makes it a lot cheaper for strings that are often not numbers.
+ *
+ *  @return true if the string was parsed. Otherwise, value is left unmodified.
+ */
+template<typename T> bool tryParseString(const UString &str, T &value);
+
 /** Convert any POD integer, float/double or bool type into a string. */
 template<typename T> UString composeString(T value);
 
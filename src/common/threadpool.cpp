@@ -0,0 +1,158 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+
+#include "src/common/threadpool.h"
+
+namespace Common {
+
+ThreadPool::ThreadPool(size_t threadCount) : _quit(false) {
+	if (threadCount == 0)
+		threadCount = getHardwareThreadCount();
+
+	_threads.reserve(threadCount);
+	for (size_t i = 0; i < threadCount; i++)
+		_threads.push_back(std::thread(&ThreadPool::runWorker, this));
+}
+
+ThreadPool::~ThreadPool() {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_quit = true;
+	}
+
+	_condition.notify_all();
+
+	for (std::vector<std::thread>::iterator t = _threads.begin(); t != _threads.end(); ++t)
+		t->join();
+}
+
+size_t ThreadPool::getThreadCount() const {
+	return _threads.size();
+}
+
+size_t ThreadPool::getHardwareThreadCount() {
+	const size_t count = std::thread::hardware_concurrency();
+
+	return (count > 0) ? count : 1;
+}
+
+void ThreadPool::push(const std::function<void()> &job) {
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		_jobs.push_back(job);
+	}
+
+	_condition.notify_one();
+}
+
+void ThreadPool::runWorker() {
+	while (true) {
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(_mutex);
+			_condition.wait(lock, [this]() { return _quit || !_jobs.empty(); });
+
+			// Finish all queued jobs before quitting
+			if (_jobs.empty())
+				return;
+
+			job = _jobs.front();
+			_jobs.pop_front();
+		}
+
+		job();
+	}
+}
+
+namespace {
+
+/** The state shared between all threads working on one parallelFor(). */
+struct ParallelForState {
+	const std::function<void(size_t)> *func;
+
+	size_t count;
+
+	std::atomic<size_t> next;
+	std::atomic<size_t> done;
+
+	std::vector<std::exception_ptr> errors;
+
+	std::mutex mutex;
+	std::condition_variable finished;
+
+	ParallelForState(const std::function<void(size_t)> &f, size_t c) :
+		func(&f), count(c), next(0), done(0), errors(c) {
+	}
+
+	/** Work on indices until there are none left. */
+	void run() {
+		size_t i;
+		while ((i = next.fetch_add(1)) < count) {
+			try {
+				(*func)(i);
+			} catch (...) {
+				errors[i] = std::current_exception();
+			}
+
+			if (done.fetch_add(1) + 1 == count) {
+				std::lock_guard<std::mutex> lock(mutex);
+				finished.notify_all();
+			}
+		}
+	}
+};
+
+}
+
+void ThreadPool::parallelFor(size_t count, const std::function<void(size_t)> &func) {
+	if (count == 0)
+		return;
+
+	std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(func, count);
+
+	/* Wake up enough helpers. Helpers that only start once all the
+	 * indices are taken return right away, and the shared state
+	 * keeps them from touching anything that's gone by then. */
+	const size_t helpers = std::min(count - 1, _threads.size());
+	for (size_t i = 0; i < helpers; i++)
+		push([state]() { state->run(); });
+
+	state->run();
+
+	{
+		std::unique_lock<std::mutex> lock(state->mutex);
+		state->finished.wait(lock, [&state]() { return state->done.load() == state->count; });
+	}
+
+	for (std::vector<std::exception_ptr>::const_iterator e = state->errors.begin(); e != state->errors.end(); ++e)
+		if (*e)
+			std::rethrow_exception(*e);
+}
+
+} // End of namespace Common
@@ -0,0 +1,118 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  A pool of worker threads.
+ */
+
+#ifndef COMMON_THREADPOOL_H
+#define COMMON_THREADPOOL_H
+
+#if defined(__MINGW32__ ) && !defined(_GLIBCXX_HAS_GTHREADS)
+	#include "external/mingw-std-threads/mingw.thread.h"
+	#include "external/mingw-std-threads/mingw.future.h"
+#else
+	#include <thread>
+	#include <future>
+#endif
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <type_traits>
+
+#include <boost/noncopyable.hpp>
+
+#include "src/common/mutex.h"
+
+namespace Common {
+
+/** A fixed pool of worker threads, running jobs from a shared queue.
+ *
+ *  Jobs are started in the order they were queued. A job must not wait
+ *  for the result of another job queued after it, since all workers
+ *  might be busy with jobs waiting in the same way.
+ */
+class ThreadPool : boost::noncopyable {
+public:
+	/** Create a thread pool.
+	 *
+	 *  @param threadCount The number of worker threads. If 0, use
+	 *                     one thread per hardware thread.
+	 */
+	ThreadPool(size_t threadCount = 0);
+	/** Wait for all queued jobs to finish and stop the workers. */
+	~ThreadPool();
+
+	/** Return the number of worker threads. */
+	size_t getThreadCount() const;
+
+	/** Queue a job.
+	 *
+	 *  @return A future for the result of the job. If the job
+	 *          throws an exception, the future rethrows it.
+	 */
+	template<typename F>
+	std::future<typename std::result_of<F()>::type> enqueue(F func) {
+		typedef typename std::result_of<F()>::type Result;
+
+		std::shared_ptr< std::packaged_task<Result()> > task =
+			std::make_shared< std::packaged_task<Result()> >(func);
+
+		std::future<Result> future = task->get_future();
+
+		push([task]() { (*task)(); });
+
+		return future;
+	}
+
+	/** Call func(i) for every i in [0, count), spread over the workers.
+	 *
+	 *  The calling thread works on the indices as well, and this
+	 *  method returns only once func has been called for all of them.
+	 *  It is safe to call this from within a job of the same pool.
+	 *
+	 *  If func throws, the remaining indices are still processed.
+	 *  Afterwards, the exception thrown for the lowest index is rethrown.
+	 */
+	void parallelFor(size_t count, const std::function<void(size_t)> &func);
+
+	/** Return the number of hardware threads, but at least 1. */
+	static size_t getHardwareThreadCount();
+
+private:
+	std::vector<std::thread> _threads;
+
+	std::deque< std::function<void()> > _jobs;
+
+	std::mutex _mutex;
+	std::condition_variable _condition;
+
+	bool _quit;
+
+	void push(const std::function<void()> &job);
+
+	void runWorker();
+};
+
+} // End of namespace Common
+
+#endif // COMMON_THREADPOOL_H
@@ -34,31 +34,31 @@
 
 namespace Common {
 
-UString::UString() : _size(0) {
+UString::UString() : _size(0), _hashIgnoreCase(0) {
 }
 
-UString::UString(const UString &str) {
+UString::UString(const UString &str) : _size(0), _hashIgnoreCase(0) {
 	*this = str;
 }
 
-UString::UString(const std::string &str) {
+UString::UString(const std::string &str) : _size(0), _hashIgnoreCase(0) {
 	*this = str;
 }
 
-UString::UString(const char *str) {
+UString::UString(const char *str) : _size(0), _hashIgnoreCase(0) {
 	*this = str;
 }
 
-UString::UString(const char *str, size_t n) {
+UString::UString(const char *str, size_t n) : _size(0), _hashIgnoreCase(0) {
 	*this = std::string(str, n);
 }
 
-UString::UString(uint32 c, size_t n) : _size(0) {
+UString::UString(uint32 c, size_t n) : _size(0), _hashIgnoreCase(0) {
 	while (n-- > 0)
 		*this += c;
 }
 
-UString::UString(iterator sBegin, iterator sEnd) : _size(0) {
+UString::UString(iterator sBegin, iterator sEnd) : _size(0), _hashIgnoreCase(0) {
 	for (; (sBegin != sEnd) && *sBegin; ++sBegin)
 		*this += *sBegin;
 }
@@ -70,6 +70,8 @@ UString &UString::operator=(const UString &str) {
 	_string = str._string;
 	_size   = str._size;
 
+	_hashIgnoreCase.store(str._hashIgnoreCase.load(std::memory_order_relaxed), std::memory_order_relaxed);
+
 	return *this;
 }
 
@@ -139,6 +141,8 @@ UString &UString::operator+=(const UString &str) {
 	_string += str._string;
 	_size   += str._size;
 
+	_hashIgnoreCase.store(0, std::memory_order_relaxed);
+
 	return *this;
 }
 
@@ -164,16 +168,35 @@ UString &UString::operator+=(uint32 c) {
 
 	_size++;
 
+	_hashIgnoreCase.store(0, std::memory_order_relaxed);
+
 	return *this;
 }
 
+/** Lowercase a 7-bit ASCII character. */
+static inline byte toLowerASCII(byte c) {
+	return ((c >= 'A') && (c <= 'Z')) ? (c + ('a' - 'A')) : c;
+}
+
+/** Uppercase a 7-bit ASCII character. */
+static inline byte toUpperASCII(byte c) {
+	return ((c >= 'a') && (c <= 'z')) ? (c - ('a' - 'A')) : c;
+}
+
 int UString::strcmp(const UString &str) const {
-	try {
-		UString::iterator it1 = begin();
-		UString::iterator it2 = str.begin();
-		for (; (it1 != end()) && (it2 != str.end()); ++it1, ++it2) {
-			const uint32 c1 = *it1;
-			const uint32 c2 = *it2;
+	// Comparing UTF-8 byte-wise gives the same order as comparing the codepoints
+	const int result = _string.compare(str._string);
+
+	return (result < 0) ? -1 : ((result > 0) ? 1 : 0);
+}
+
+int UString::stricmp(const UString &str) const {
+	if (isASCII() && str.isASCII()) {
+		const size_t size = MIN(_string.size(), str._string.size());
+
+		for (size_t i = 0; i < size; i++) {
+			const byte c1 = toLowerASCII(_string[i]);
+			const byte c2 = toLowerASCII(str._string[i]);
 
 			if (c1 < c2)
 				return -1;
@@ -181,19 +204,12 @@ int UString::strcmp(const UString &str) const {
 				return  1;
 		}
 
-		if ((it1 == end()) && (it2 == str.end()))
+		if (_string.size() == str._string.size())
 			return 0;
 
-		if (it1 == end())
-			return -1;
-
-	} catch (...) {
+		return (_string.size() < str._string.size()) ? -1 : 1;
 	}
 
-	return 1;
-}
-
-int UString::stricmp(const UString &str) const {
 	try {
 		UString::iterator it1 = begin();
 		UString::iterator it2 = str.begin();
@@ -220,10 +236,20 @@ int UString::stricmp(const UString &str) const {
 }
 
 bool UString::equals(const UString &str) const {
-	return strcmp(str) == 0;
+	return (_size == str._size) && (_string == str._string);
 }
 
 bool UString::equalsIgnoreCase(const UString &str) const {
+	// Changing the case never changes the number of characters
+	if (_size != str._size)
+		return false;
+
+	// If we already know both hashes, we might not need to look at the strings
+	const size_t hash1 =     _hashIgnoreCase.load(std::memory_order_relaxed);
+	const size_t hash2 = str._hashIgnoreCase.load(std::memory_order_relaxed);
+	if ((hash1 != 0) && (hash2 != 0) && (hash1 != hash2))
+		return false;
+
 	return stricmp(str) == 0;
 }
 
@@ -239,17 +265,27 @@ void UString::swap(UString &str) {
 	_string.swap(str._string);
 
 	SWAP(_size, str._size);
+
+	_hashIgnoreCase.store(str._hashIgnoreCase.exchange(_hashIgnoreCase.load(std::memory_order_relaxed),
+	                      std::memory_order_relaxed), std::memory_order_relaxed);
 }
 
 void UString::clear() {
 	_string.clear();
 	_size = 0;
+
+	_hashIgnoreCase.store(0, std::memory_order_relaxed);
 }
 
 size_t UString::size() const {
 	return _size;
 }
 
+bool UString::isASCII() const {
+	// Every non-ASCII character takes up more than one byte
+	return _size == _string.size();
+}
+
 bool UString::empty() const {
 	return _string.empty() || (_string[0] == '\0');
 }
@@ -258,6 +294,23 @@ const char *UString::c_str() const {
 	return _string.c_str();
 }
 
+size_t UString::hashIgnoreCase() const {
+	size_t hash = _hashIgnoreCase.load(std::memory_order_relaxed);
+	if (hash != 0)
+		return hash;
+
+	if (isASCII()) {
+		for (std::string::const_iterator c = _string.begin(); c != _string.end(); ++c)
+			boost::hash_combine<uint32>(hash, toLowerASCII(*c));
+	} else {
+		for (iterator it = begin(); it != end(); ++it)
+			boost::hash_combine<uint32>(hash, toLower(*it));
+	}
+
+	_hashIgnoreCase.store(hash, std::memory_order_relaxed);
+	return hash;
+}
+
 UString::iterator UString::begin() const {
 	return iterator(_string.begin(), _string.begin(), _string.end());
 }
@@ -468,6 +521,8 @@ void UString::replaceAll(uint32 what, uint32 with) {
 		// And set the new string's contents
 		_string.swap(newString);
 
+		_hashIgnoreCase.store(0, std::memory_order_relaxed);
+
 	} catch (const std::exception &se) {
 		Exception e(se);
 		throw e;
@@ -476,6 +531,8 @@ void UString::replaceAll(uint32 what, uint32 with) {
 
 void UString::replaceAll(const UString &what, const UString &with) {
 	boost::replace_all(_string, what._string, with._string);
+
+	recalculateSize();
 }
 
 void UString::makeLower() {
@@ -489,6 +546,16 @@ void UString::makeUpper() {
 UString UString::toLower() const {
 	UString str;
 
+	if (isASCII()) {
+		str._string = _string;
+		str._size   = _size;
+
+		for (std::string::iterator c = str._string.begin(); c != str._string.end(); ++c)
+			*c = toLowerASCII(*c);
+
+		return str;
+	}
+
 	str._string.reserve(_string.size());
 	for (iterator it = begin(); it != end(); ++it)
 		str += toLower(*it);
@@ -499,6 +566,16 @@ UString UString::toLower() const {
 UString UString::toUpper() const {
 	UString str;
 
+	if (isASCII()) {
+		str._string = _string;
+		str._size   = _size;
+
+		for (std::string::iterator c = str._string.begin(); c != str._string.end(); ++c)
+			*c = toUpperASCII(*c);
+
+		return str;
+	}
+
 	str._string.reserve(_string.size());
 	for (iterator it = begin(); it != end(); ++it)
 		str += toUpper(*it);
@@ -762,6 +839,8 @@ size_t UString::split(const UString &text, uint32 delim, std::vector<UString> &t
 }
 
 void UString::recalculateSize() {
+	_hashIgnoreCase.store(0, std::memory_order_relaxed);
+
 	try {
 		// Calculate the "distance" in characters from the beginning and end
 		_size = utf8::distance(_string.begin(), _string.end());
@@ -779,7 +858,7 @@ uint32 UString::toLower(uint32 c) {
 		// We don't know how to lowercase that
 		return c;
 
-	return std::tolower(c);
+	return toLowerASCII(c);
 }
 
 uint32 UString::toUpper(uint32 c) {
@@ -787,7 +866,7 @@ uint32 UString::toUpper(uint32 c) {
 		// We don't know how to uppercase that
 		return c;
 
-	return std::toupper(c);
+	return toUpperASCII(c);
 }
 
 bool UString::isASCII(uint32 c) {
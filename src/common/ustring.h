@@ -28,6 +28,7 @@
 #include <string>
 #include <sstream>
 #include <vector>
+#include <atomic>
 
 #include <boost/functional/hash.hpp>
 
@@ -39,6 +40,11 @@
 namespace Common {
 
 /** A class holding an UTF-8 string.
+ *
+ *  Strings that are pure 7-bit ASCII, like all resource names, are compared
+ *  and lowercased byte-wise, without decoding them. The case-insensitive hash
+ *  is calculated only once and cached, which is safe even for strings shared
+ *  between threads.
  *
  *  WARNING:
  *  Copy constructors and assignment operators copying from std::string and
@@ -63,6 +69,13 @@ public:
 		}
 	};
 
+	// Case insensitive equality, to go with hashUStringCaseInsensitive
+	struct iequal : std::binary_function<UString, UString, bool> {
+		bool operator() (const UString &str1, const UString &str2) const {
+			return str1.equalsIgnoreCase(str2);
+		}
+	};
+
 	/** Construct an empty string. */
 	UString();
 	/** Copy constructor. */
@@ -116,12 +129,18 @@ public:
 	/** Return the size of the string, in characters. */
 	size_t size() const;
 
+	/** Is the whole string 7-bit ASCII? */
+	bool isASCII() const;
+
 	/** Is the string empty? */
 	bool empty() const;
 
 	/** Return the (utf8 encoded) string data. */
 	const char *c_str() const;
 
+	/** Return a hash of the lowercased string, as used by hashUStringCaseInsensitive. */
+	size_t hashIgnoreCase() const;
+
 	iterator begin() const;
 	iterator end() const;
 
@@ -204,6 +223,9 @@ private:
 
 	size_t _size;
 
+	/** The cached result of hashIgnoreCase(), or 0 if it needs to be calculated. */
+	mutable std::atomic<size_t> _hashIgnoreCase;
+
 	void recalculateSize();
 };
 
@@ -233,12 +255,7 @@ struct hashUStringCaseSensitive {
 
 struct hashUStringCaseInsensitive {
 	size_t operator()(const UString &str) const {
-		size_t seed = 0;
-
-		for (UString::iterator it = str.begin(); it != str.end(); ++it)
-			boost::hash_combine<uint32>(seed, UString::toLower(*it));
-
-		return seed;
+		return str.hashIgnoreCase();
 	}
 };
 
@@ -77,7 +77,11 @@ void ZipFile::load(SeekableReadStream &zip) {
 		 File  file;
 		IFile iFile;
 
-		zip.skip(20);
+		zip.skip(6);
+
+		iFile.method = zip.readUint16LE();
+
+		zip.skip(12);
 
 		iFile.size = zip.readUint32LE();
 
@@ -129,35 +133,48 @@ const ZipFile::IFile &ZipFile::getIFile(uint32 index) const {
 	return _iFiles[index];
 }
 
-void ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file,
+size_t ZipFile::getFileProperties(SeekableReadStream &zip, const IFile &file,
 		uint16 &compMethod, uint32 &compSize, uint32 &realSize) const {
 
-	zip.seek(file.offset);
+	static const size_t kLocalHeaderSize = 30;
 
-	uint32 tag = zip.readUint32LE();
+	/* Read the local header with a positional read, leaving the position
+	 * of the ZIP stream untouched. This way, several threads can access
+	 * files in the same ZIP at once. */
+
+	byte headerData[kLocalHeaderSize];
+	if (zip.readAt(file.offset, headerData, kLocalHeaderSize) != kLocalHeaderSize)
+		throw Exception(kReadError);
+
+	MemoryReadStream header(headerData);
+
+	uint32 tag = header.readUint32LE();
 	if (tag != 0x04034B50)
 		throw Exception("Unknown ZIP record %08X", tag);
 
-	zip.skip(4);
+	header.skip(4);
 
-	compMethod = zip.readUint16LE();
+	compMethod = header.readUint16LE();
 
-	zip.skip(8);
+	header.skip(8);
 
-	compSize = zip.readUint32LE();
-	realSize = zip.readUint32LE();
+	compSize = header.readUint32LE();
+	realSize = header.readUint32LE();
 
-	uint16 nameLength  = zip.readUint16LE();
-	uint16 extraLength = zip.readUint16LE();
+	uint16 nameLength  = header.readUint16LE();
+	uint16 extraLength = header.readUint16LE();
 
-	zip.skip(nameLength);
-	zip.skip(extraLength);
+	return file.offset + kLocalHeaderSize + nameLength + extraLength;
 }
 
 size_t ZipFile::getFileSize(uint32 index) const {
 	return getIFile(index).size;
 }
 
+bool ZipFile::isFileCompressed(uint32 index) const {
+	return getIFile(index).method != 0;
+}
+
 SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	const IFile &file = getIFile(index);
 
@@ -165,27 +182,30 @@ SeekableReadStream *ZipFile::getFile(uint32 index, bool tryNoCopy) const {
 	uint32 compSize;
 	uint32 realSize;
 
-	getFileProperties(*_zip, file, compMethod, compSize, realSize);
+	const size_t offset = getFileProperties(*_zip, file, compMethod, compSize, realSize);
 
 	if (tryNoCopy && (compMethod == 0))
-		return new SeekableSubReadStream(_zip.get(), _zip->pos(), _zip->pos() + compSize);
+		return new SeekableSubReadStream(_zip.get(), offset, offset + compSize);
 
-	return decompressFile(*_zip, compMethod, compSize, realSize);
+	return decompressFile(*_zip, offset, compMethod, compSize, realSize);
 }
 
-SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, uint32 method,
+SeekableReadStream *ZipFile::decompressFile(SeekableReadStream &zip, size_t offset, uint32 method,
 		uint32 compSize, uint32 realSize) {
 
+	if ((method != 0) && (method != 8))
+		throw Exception("Unhandled Zip compression %d", method);
+
+	MemoryReadStream *packed = zip.readStreamAt(offset, compSize);
 	if (method == 0) {
 		// Uncompressed
 
-		return zip.readStream(compSize);
+		return packed;
 	}
 
-	if (method != 8)
-		throw Exception("Unhandled Zip compression %d", method);
+	ScopedPtr<MemoryReadStream> packedStream(packed);
 
-	return decompressDeflate(zip, compSize, realSize, kWindowBitsMaxRaw);
+	return decompressDeflate(*packedStream, compSize, realSize, kWindowBitsMaxRaw);
 }
 
 } // End of namespace Common
@@ -58,6 +58,9 @@ public:
 	/** Return the size of a file. */
 	size_t getFileSize(uint32 index) const;
 
+	/** Is the file compressed? */
+	bool isFileCompressed(uint32 index) const;
+
 	/** Return a stream of the file's contents. */
 	SeekableReadStream *getFile(uint32 index, bool tryNoCopy = false) const;
 
@@ -66,6 +69,7 @@ private:
 	struct IFile {
 		uint32 offset; ///< The offset of the file within the ZIP.
 		uint32 size;   ///< The file's size.
+		uint16 method; ///< The file's compression method.
 	};
 
 	typedef std::vector<IFile> IFileList;
@@ -80,11 +84,13 @@ private:
 
 	void load(SeekableReadStream &zip);
 
-	static SeekableReadStream *decompressFile(SeekableReadStream &zip, uint32 method,
+	static SeekableReadStream *decompressFile(SeekableReadStream &zip, size_t offset, uint32 method,
 			uint32 compSize, uint32 realSize);
 
 	const IFile &getIFile(uint32 index) const;
-	void getFileProperties(SeekableReadStream &zip, const IFile &file,
+
+	/** Read the local file header of a file, returning the offset to the file data. */
+	size_t getFileProperties(SeekableReadStream &zip, const IFile &file,
 			uint16 &compMethod, uint32 &compSize, uint32 &realSize) const;
 };
 
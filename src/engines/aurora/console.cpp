@@ -38,6 +38,7 @@
 
 #include "src/aurora/resman.h"
 #include "src/aurora/talkman.h"
+#include "src/aurora/2dareg.h"
 
 #include "src/graphics/graphics.h"
 #include "src/graphics/font.h"
@@ -815,6 +816,16 @@ Console::Console(Engine &engine, const Common::UString &font, int fontHeight) :
 	registerCommand("setcamera"  , boost::bind(&Console::cmdSetCamera  , this, _1),
 			"Usage: setcamera <posX> <posY> <posZ> [<orientX> <orientY> <orientZ>]\n"
 			"Set the camera position (and orientation)");
+	registerCommand("rescache"   , boost::bind(&Console::cmdResCache   , this, _1),
+			"Usage: rescache\nPrint statistics about the cache of decompressed resources");
+	registerCommand("2dastats"   , boost::bind(&Console::cmd2DAStats   , this, _1),
+			"Usage: 2dastats\nPrint the parse time and memory use of all loaded 2DAs and GDAs");
+	registerCommand("animstats"  , boost::bind(&Console::cmdAnimStats  , this, _1),
+			"Usage: animstats\nPrint statistics about updating animations since the last animstats");
+	registerCommand("cull"       , boost::bind(&Console::cmdCull       , this, _1),
+			"Usage: cull [<true/false> [<distance>]]\n"
+			"Print statistics about culling world objects since the last cull,\n"
+			"or enable/disable culling and set the cull distance (0 for no limit)");
 
 	_console->print("Console ready...");
 }
@@ -1519,6 +1530,94 @@ void Console::cmdSetCamera(const CommandLine &cl) {
 	CameraMan.update();
 }
 
+void Console::cmdResCache(const CommandLine &UNUSED(cl)) {
+	const Aurora::ResourceManager::ResourceCacheStats stats = ResMan.getResourceCacheStats();
+
+	printf("%u resources, %.2f of %.2f MB", (uint) stats.count,
+	       stats.size / (1024.0 * 1024.0), stats.budget / (1024.0 * 1024.0));
+	printf("%" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions",
+	       stats.hits, stats.misses, stats.evictions);
+}
+
+void Console::cmd2DAStats(const CommandLine &UNUSED(cl)) {
+	const Aurora::TwoDARegistry::TableStatsList stats = TwoDAReg.getTableStats();
+
+	double time   = 0.0;
+	size_t memory = 0;
+
+	for (Aurora::TwoDARegistry::TableStatsList::const_iterator s = stats.begin(); s != stats.end(); ++s) {
+		printf("%s (%s): %.2fms, %.1f KB", s->name.c_str(), s->gda ? "GDA" : "2DA",
+		       s->time, s->memory / 1024.0);
+
+		time   += s->time;
+		memory += s->memory;
+	}
+
+	printf("%u tables: %.2fms, %.2f MB", (uint) stats.size(), time, memory / (1024.0 * 1024.0));
+}
+
+void Console::cmdAnimStats(const CommandLine &UNUSED(cl)) {
+	const Graphics::Aurora::AnimationThread::Stats stats = GfxMan.getAnimationStats();
+	GfxMan.resetAnimationStats();
+
+	printf("%u models, %u threads", (uint) stats.models, (uint) stats.threads);
+
+	if (stats.passes == 0)
+		return;
+
+	const double passTime    = stats.time / stats.passes;
+	const double utilization = (stats.time > 0.0) ? (stats.busyTime / (stats.time * stats.threads)) : 0.0;
+
+	printf("%" PRIu64 " passes: %.2fms and %.1f model updates per pass, %.0f%% worker utilization",
+	       stats.passes, passTime, ((double) stats.updates) / stats.passes, utilization * 100.0);
+}
+
+void Console::cmdCull(const CommandLine &cl) {
+	std::vector<Common::UString> args;
+	splitArguments(cl.args, args);
+
+	if (args.size() > 2) {
+		printCommandHelp(cl.cmd);
+		return;
+	}
+
+	if (!args.empty()) {
+		bool culling = true;
+		float distance = GfxMan.getCullDistance();
+
+		try {
+			Common::parseString(args[0], culling);
+			if (args.size() > 1)
+				Common::parseString(args[1], distance);
+		} catch (...) {
+			printCommandHelp(cl.cmd);
+			return;
+		}
+
+		GfxMan.setCulling(culling);
+		GfxMan.setCullDistance(distance);
+		GfxMan.resetCullStats();
+	}
+
+	const Graphics::GraphicsManager::CullStats stats = GfxMan.getCullStats(true);
+
+	if (!GfxMan.isCullingEnabled())
+		printf("Culling disabled");
+	else if (GfxMan.getCullDistance() > 0.0f)
+		printf("Culling enabled, up to a distance of %.2f", GfxMan.getCullDistance());
+	else
+		printf("Culling enabled, without a distance limit");
+
+	if (stats.frames == 0)
+		return;
+
+	const double objects = ((double) stats.objects) / stats.frames;
+	const double culled  = ((double) stats.culled ) / stats.frames;
+
+	printf("%" PRIu64 " frames: %.1f world objects, %.1f drawn and %.1f culled per frame",
+	       stats.frames, objects, objects - culled, culled);
+}
+
 void Console::printFullHelp() {
 	print("Available commands (help <command> for further help on each command):");
 
@@ -313,6 +313,10 @@ private:
 	void cmdGetString  (const CommandLine &cl);
 	void cmdGetCamera  (const CommandLine &cl);
 	void cmdSetCamera  (const CommandLine &cl);
+	void cmdResCache   (const CommandLine &cl);
+	void cmd2DAStats   (const CommandLine &cl);
+	void cmdAnimStats  (const CommandLine &cl);
+	void cmdCull       (const CommandLine &cl);
 
 	void updateHelpArguments();
 
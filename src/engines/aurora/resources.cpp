@@ -22,6 +22,9 @@
  *  Generic Aurora engines resource utility functions.
  */
 
+#include <boost/scope_exit.hpp>
+#include <boost/bind.hpp>
+
 #include "src/common/error.h"
 #include "src/common/ustring.h"
 
@@ -109,6 +112,67 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, ChangeLi
 	return indexOptionalArchive(file, priority, password, changes);
 }
 
+static void indexArchives(const std::vector<ArchiveFile> &files, bool optional, ChangeList *changes) {
+	if (EventMan.quitRequested())
+		return;
+
+	std::vector<Aurora::ResourceManager::ArchiveIndexRequest> archives;
+	archives.reserve(files.size());
+
+	ChangeList::iterator firstChange;
+	if (changes)
+		firstChange = changes->end();
+
+	for (std::vector<ArchiveFile>::const_iterator f = files.begin(); f != files.end(); ++f) {
+		Common::ChangeID *changeID = 0;
+
+		if (changes) {
+			changes->push_back(Common::ChangeID());
+			changeID = &changes->back();
+
+			if (firstChange == changes->end())
+				firstChange = --changes->end();
+		}
+
+		archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest(f->file, f->priority, optional, changeID));
+	}
+
+	BOOST_SCOPE_EXIT( (&changes) (&firstChange) ) {
+		// Drop the changes of archives that weren't indexed
+		if (changes) {
+			for (ChangeList::iterator c = firstChange; c != changes->end(); ) {
+				if (!c->getContent())
+					c = changes->erase(c);
+				else
+					++c;
+			}
+		}
+	} BOOST_SCOPE_EXIT_END
+
+	try {
+		ResMan.indexArchives(archives, boost::bind(&Events::EventsManager::quitRequested, &EventMan));
+	} catch (Common::Exception &e) {
+		e.add(optional ? "Failed to index optional archives" : "Failed to index mandatory archives");
+		throw;
+	}
+}
+
+void indexMandatoryArchives(const std::vector<ArchiveFile> &files) {
+	indexArchives(files, false, 0);
+}
+
+void indexMandatoryArchives(const std::vector<ArchiveFile> &files, ChangeList &changes) {
+	indexArchives(files, false, &changes);
+}
+
+void indexOptionalArchives(const std::vector<ArchiveFile> &files) {
+	indexArchives(files, true, 0);
+}
+
+void indexOptionalArchives(const std::vector<ArchiveFile> &files, ChangeList &changes) {
+	indexArchives(files, true, &changes);
+}
+
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
                              uint32 priority, Common::ChangeID *changeID) {
 
@@ -40,6 +40,12 @@ namespace Engines {
 
 typedef std::list<Common::ChangeID> ChangeList;
 
+/** An archive file to add to the resource manager, with its priority. */
+struct ArchiveFile {
+	const char *file;
+	uint32 priority;
+};
+
 /** Add an archive file to the resource manager, erroring out if it does not exist. */
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, Common::ChangeID *changeID = 0);
 void indexMandatoryArchive(const Common::UString &file, uint32 priority, ChangeList &changes);
@@ -56,6 +62,22 @@ bool indexOptionalArchive(const Common::UString &file, uint32 priority, const st
 bool indexOptionalArchive(const Common::UString &file, uint32 priority, const std::vector<byte> &password,
                           ChangeList &changes);
 
+/** Add several archive files to the resource manager, erroring out if one does not exist.
+ *
+ *  The archives are read in parallel, but added in the order given, with the
+ *  same result as adding them one by one.
+ */
+void indexMandatoryArchives(const std::vector<ArchiveFile> &files);
+void indexMandatoryArchives(const std::vector<ArchiveFile> &files, ChangeList &changes);
+
+/** Add several archive files to the resource manager, skipping those that do not exist.
+ *
+ *  The archives are read in parallel, but added in the order given, with the
+ *  same result as adding them one by one.
+ */
+void indexOptionalArchives(const std::vector<ArchiveFile> &files);
+void indexOptionalArchives(const std::vector<ArchiveFile> &files, ChangeList &changes);
+
 /** Add a directory to the resource manager, erroring out if it does not exist. */
 void indexMandatoryDirectory(const Common::UString &dir, const char *glob, int depth,
                              uint32 priority, Common::ChangeID *changeID = 0);
@@ -88,6 +88,10 @@ void Trigger::calculateDistance() {
 
 }
 
+const Common::BoundingBox *Trigger::getWorldBound() const {
+	return &_boundingbox;
+}
+
 void Trigger::render(Graphics::RenderPass pass) {
 	if (!_visible || pass != Graphics::kRenderPassTransparent)
 		return;
@@ -120,6 +124,9 @@ void Trigger::prepare() {
 	// Add vertices to the bounding box
 	for (it = _geometry.begin(); it != _geometry.end(); ++it)
 		_boundingbox.add(it->x, it->y, it->z);
+
+	notifyWorldBoundChanged();
+
 	//
 	// Initialization
 	std::vector<glm::vec3>::iterator it1, it2;
@@ -45,6 +45,7 @@ public:
 	// .--- Renderable
 	void calculateDistance();
 	void render(Graphics::RenderPass pass);
+	const Common::BoundingBox *getWorldBound() const;
 	// '---
 protected:
 	std::vector<glm::vec3> _geometry;
@@ -221,20 +221,22 @@ void DragonAgeEngine::initResources(LoadProgress &progress) {
 	Game::loadTalkTables("/packages/core", 0, _languageTLK, _language);
 
 	progress.step("Indexing extra core resources files");
-	indexMandatoryArchive("/packages/core/data/designerscripts.rim",        450, _resources);
-	indexMandatoryArchive("/packages/core/data/globalvfx.rim",              451, _resources);
-	indexMandatoryArchive("/packages/core/data/chargen.rim",                452, _resources);
-	indexMandatoryArchive("/packages/core/data/chargen.gpu.rim",            453, _resources);
-	indexMandatoryArchive("/packages/core/data/global.rim",                 454, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/spiritform.rim",   455, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/summonwolf.rim",   456, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/mouseform.rim",    457, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/summonspider.rim", 458, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/summonbear.rim",   459, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/spiderform.rim",   460, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/golemform.rim",    461, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/bearform.rim",     462, _resources);
-	indexMandatoryArchive("/packages/core/data/abilities/burningform.rim",  463, _resources);
+	indexMandatoryArchives({
+		{ "/packages/core/data/designerscripts.rim"       , 450 },
+		{ "/packages/core/data/globalvfx.rim"             , 451 },
+		{ "/packages/core/data/chargen.rim"               , 452 },
+		{ "/packages/core/data/chargen.gpu.rim"           , 453 },
+		{ "/packages/core/data/global.rim"                , 454 },
+		{ "/packages/core/data/abilities/spiritform.rim"  , 455 },
+		{ "/packages/core/data/abilities/summonwolf.rim"  , 456 },
+		{ "/packages/core/data/abilities/mouseform.rim"   , 457 },
+		{ "/packages/core/data/abilities/summonspider.rim", 458 },
+		{ "/packages/core/data/abilities/summonbear.rim"  , 459 },
+		{ "/packages/core/data/abilities/spiderform.rim"  , 460 },
+		{ "/packages/core/data/abilities/golemform.rim"   , 461 },
+		{ "/packages/core/data/abilities/bearform.rim"    , 462 },
+		{ "/packages/core/data/abilities/burningform.rim" , 463 }
+	}, _resources);
 
 	progress.step("Indexing single-player campaign resources files");
 	Game::loadResources ("/modules/single player", 500, _resources);
@@ -221,24 +221,26 @@ void DragonAge2Engine::initResources(LoadProgress &progress) {
 	Game::loadTalkTables("/packages/core", 0, _languageTLK, _language);
 
 	progress.step("Indexing extra core resources files");
-	indexMandatoryArchive("/packages/core/data/2da.rim",                       450, _resources);
-	indexMandatoryArchive("/packages/core/data/chargen.gpu.rim",               451, _resources);
-	indexMandatoryArchive("/packages/core/data/chargen.rim",                   452, _resources);
-	indexMandatoryArchive("/packages/core/data/designerresources.rim",         453, _resources);
-	indexMandatoryArchive("/packages/core/data/designerscripts.rim",           454, _resources);
-	indexMandatoryArchive("/packages/core/data/global-uncompressed.rim",       455, _resources);
-	indexMandatoryArchive("/packages/core/data/global.rim",                    456, _resources);
-	indexMandatoryArchive("/packages/core/data/globalani-core.rim",            457, _resources);
-	indexMandatoryArchive("/packages/core/data/globalchargen-core.rim",        458, _resources);
-	indexMandatoryArchive("/packages/core/data/globalchargendds-core.gpu.rim", 459, _resources);
-	indexMandatoryArchive("/packages/core/data/globaldds-core.gpu.rim",        460, _resources);
-	indexMandatoryArchive("/packages/core/data/globalmao-core.rim",            461, _resources);
-	indexMandatoryArchive("/packages/core/data/globalvfx-core.rim",            462, _resources);
-	indexMandatoryArchive("/packages/core/data/materialobjects.rim",           463, _resources);
-	indexMandatoryArchive("/packages/core/data/pathfindingpatches.rim",        464, _resources);
-	indexMandatoryArchive("/packages/core/data/summonwardog.gpu.rim",          465, _resources);
-	indexMandatoryArchive("/packages/core/data/summonwardog.rim",              466, _resources);
-	indexMandatoryArchive("/packages/core/data/tints.rim",                     467, _resources);
+	indexMandatoryArchives({
+		{ "/packages/core/data/2da.rim"                      , 450 },
+		{ "/packages/core/data/chargen.gpu.rim"              , 451 },
+		{ "/packages/core/data/chargen.rim"                  , 452 },
+		{ "/packages/core/data/designerresources.rim"        , 453 },
+		{ "/packages/core/data/designerscripts.rim"          , 454 },
+		{ "/packages/core/data/global-uncompressed.rim"      , 455 },
+		{ "/packages/core/data/global.rim"                   , 456 },
+		{ "/packages/core/data/globalani-core.rim"           , 457 },
+		{ "/packages/core/data/globalchargen-core.rim"       , 458 },
+		{ "/packages/core/data/globalchargendds-core.gpu.rim", 459 },
+		{ "/packages/core/data/globaldds-core.gpu.rim"       , 460 },
+		{ "/packages/core/data/globalmao-core.rim"           , 461 },
+		{ "/packages/core/data/globalvfx-core.rim"           , 462 },
+		{ "/packages/core/data/materialobjects.rim"          , 463 },
+		{ "/packages/core/data/pathfindingpatches.rim"       , 464 },
+		{ "/packages/core/data/summonwardog.gpu.rim"         , 465 },
+		{ "/packages/core/data/summonwardog.rim"             , 466 },
+		{ "/packages/core/data/tints.rim"                    , 467 }
+	}, _resources);
 
 	progress.step("Indexing single-player campaign resources files");
 	Game::loadResources ("/modules/campaign_base", 500, _resources, _language);
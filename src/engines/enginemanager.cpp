@@ -31,6 +31,7 @@
 #include "src/common/readfile.h"
 #include "src/common/filelist.h"
 #include "src/common/filepath.h"
+#include "src/common/hash.h"
 #include "src/common/debugman.h"
 #include "src/common/configman.h"
 
@@ -219,9 +220,28 @@ void GameInstanceEngine::listLanguages() {
 	destroyEngine();
 }
 
+/** Return the file the resource index cache for this game is stored in. */
+static Common::UString getIndexCacheFile(const Common::UString &target) {
+	const uint64 hash = Common::hashString(Common::FilePath::canonicalize(target), Common::kHashFNV64);
+
+	return Common::FilePath::getConfigDirectory() +
+	       Common::UString::format("/indexcache/%08X%08X.cache", (uint) (hash >> 32), (uint) (hash & 0xFFFFFFFF));
+}
+
 void GameInstanceEngine::run() {
 	createEngine();
 
+	if (ConfigMan.getBool("indexcache", true))
+		ResMan.openIndexCache(getIndexCacheFile(_target));
+
+	// Size of the cache for decompressed resources, in MB
+	const int resCache = ConfigMan.getInt("rescache", 64);
+	ResMan.setResourceCacheSize(((size_t) MAX(resCache, 0)) * 1024 * 1024);
+
+	// Size of the cache for decoded strings of each talk table, in KB
+	const int talkCache = ConfigMan.getInt("talkcache", 1024);
+	TalkMan.setCacheSize(((size_t) MAX(talkCache, 0)) * 1024);
+
 	_engine->start(_probe->getGameID(), _target, _probe->getPlatform());
 
 	destroyEngine();
@@ -277,6 +297,17 @@ void EngineManager::cleanup() const {
 		LangMan.clear();
 		TalkMan.clear();
 		TwoDAReg.clear();
+
+		if (ConfigMan.getBool("indextime", false)) {
+			const Aurora::ResourceManager::IndexStats &stats = ResMan.getIndexStats();
+
+			info("Indexed %u archives and directories from the cache in %.3fms",
+			     stats.fromCache, stats.cacheTime);
+			info("Indexed %u archives and directories from the disk in %.3fms",
+			     stats.fromDisk, stats.diskTime);
+		}
+
+		ResMan.closeIndexCache();
 		ResMan.clear();
 
 		ConfigMan.setGame();
@@ -268,14 +268,16 @@ void JadeEngine::initResources(LoadProgress &progress) {
 	indexMandatoryArchive("chitin.key", 10);
 
 	progress.step("Loading global auxiliary resources");
-	indexMandatoryArchive("loadscreens.mod"   , 50);
-	indexMandatoryArchive("players.mod"       , 51);
-	indexMandatoryArchive("global-a.rim"      , 52);
-	indexMandatoryArchive("ingamemenu-a.rim"  , 53);
-	indexMandatoryArchive("globalunload-a.rim", 54);
-	indexMandatoryArchive("minigame-a.rim"    , 55);
-	indexMandatoryArchive("miniglobal-a.rim"  , 56);
-	indexMandatoryArchive("mmenu-a.rim"       , 57);
+	indexMandatoryArchives({
+		{ "loadscreens.mod"   , 50 },
+		{ "players.mod"       , 51 },
+		{ "global-a.rim"      , 52 },
+		{ "ingamemenu-a.rim"  , 53 },
+		{ "globalunload-a.rim", 54 },
+		{ "minigame-a.rim"    , 55 },
+		{ "miniglobal-a.rim"  , 56 },
+		{ "mmenu-a.rim"       , 57 }
+	});
 
 	progress.step("Indexing extra font resources");
 	indexMandatoryDirectory("fonts"   , 0, -1, 100);
@@ -228,16 +228,18 @@ void KotOREngine::initResources(LoadProgress &progress) {
 		_hasLiveKey = true;
 
 	progress.step("Loading global auxiliary resources");
-	indexMandatoryArchive("mainmenu.rim"    , 50);
-	indexMandatoryArchive("mainmenudx.rim"  , 51);
-	indexMandatoryArchive("legal.rim"       , 52);
-	indexMandatoryArchive("legaldx.rim"     , 53);
-	indexMandatoryArchive("global.rim"      , 54);
-	indexMandatoryArchive("subglobaldx.rim" , 55);
-	indexMandatoryArchive("miniglobaldx.rim", 56);
-	indexMandatoryArchive("globaldx.rim"    , 57);
-	indexMandatoryArchive("chargen.rim"     , 58);
-	indexMandatoryArchive("chargendx.rim"   , 59);
+	indexMandatoryArchives({
+		{ "mainmenu.rim"    , 50 },
+		{ "mainmenudx.rim"  , 51 },
+		{ "legal.rim"       , 52 },
+		{ "legaldx.rim"     , 53 },
+		{ "global.rim"      , 54 },
+		{ "subglobaldx.rim" , 55 },
+		{ "miniglobaldx.rim", 56 },
+		{ "globaldx.rim"    , 57 },
+		{ "chargen.rim"     , 58 },
+		{ "chargendx.rim"   , 59 }
+	});
 
 	if (_platform == Aurora::kPlatformXbox) {
 		// The Xbox version has most of its textures in "textures.bif"
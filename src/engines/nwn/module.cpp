@@ -345,6 +345,7 @@ void Module::enter() {
 
 		loadTLK();
 		loadHAKs();
+		load2DAs();
 		loadAreas();
 
 	} catch (Common::Exception &e) {
@@ -606,6 +607,22 @@ void Module::unloadHAKs() {
 	deindexResources(_resHAKs);
 }
 
+void Module::load2DAs() {
+	status("Loading 2DAs...");
+
+	// The HAKs might override any of these, so they're loaded afterwards
+	static const char * const k2DAs[] = {
+		"ambientmusic", "ambientsound", "appearance", "classes", "doortypes", "feat", "gender",
+		"genericdoors", "phenotype", "placeableobjsnds", "placeables", "portraits", "racialtypes",
+		"skills", "soundset", "spells", "surfacemat"
+	};
+
+	Aurora::TwoDARegistry::Manifest manifest;
+	manifest.twodas.assign(k2DAs, k2DAs + ARRAYSIZE(k2DAs));
+
+	TwoDAReg.preload(manifest);
+}
+
 static const char * const texturePacks[4][4] = {
 	{ "textures_tpc.erf", "tiles_tpc.erf", "xp1_tex_tpc.erf", "xp2_tex_tpc.erf" }, // Worst
 	{ "textures_tpa.erf", "tiles_tpc.erf", "xp1_tex_tpc.erf", "xp2_tex_tpc.erf" }, // Bad
@@ -244,6 +244,7 @@ private:
 
 	void loadTLK();          ///< Load the TLK used by the module.
 	void loadHAKs();         ///< Load the HAKs required by the module.
+	void load2DAs();         ///< Load the 2DAs needed by the module's objects.
 	void loadTexturePack();  ///< Load the texture pack.
 	void loadAreas();        ///< Load the areas.
 	void loadSurfaceTypes(); ///< Load the surface types.
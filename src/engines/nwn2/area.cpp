@@ -26,6 +26,7 @@
 #include "src/common/error.h"
 #include "src/common/configman.h"
 
+#include "src/aurora/resman.h"
 #include "src/aurora/gff3file.h"
 #include "src/aurora/2dafile.h"
 #include "src/aurora/2dareg.h"
@@ -480,6 +481,16 @@ void Area::unloadModels() {
 }
 
 void Area::loadTileModels() {
+	// Decompress the tile models in the background, while we're already loading the first ones
+	std::vector<Common::UString> modelNames;
+	modelNames.reserve(_tiles.size());
+
+	for (std::vector<Tile>::const_iterator t = _tiles.begin(); t != _tiles.end(); ++t)
+		if (!t->modelName.empty())
+			modelNames.push_back(t->modelName);
+
+	ResMan.prefetch(modelNames, { Aurora::kFileTypeMDB });
+
 	for (std::vector<Tile>::iterator t = _tiles.begin(); t != _tiles.end(); ++t) {
 		if (t->modelName.empty())
 			continue;
@@ -221,103 +221,111 @@ void NWN2Engine::initResources(LoadProgress &progress) {
 
 	progress.step("Loading main resource files");
 
-	indexMandatoryArchive("2da.zip"           , 10);
-	indexMandatoryArchive("actors.zip"        , 11);
-	indexMandatoryArchive("animtags.zip"      , 12);
-	indexMandatoryArchive("convo.zip"         , 13);
-	indexMandatoryArchive("ini.zip"           , 14);
-	indexMandatoryArchive("lod-merged.zip"    , 15);
-	indexMandatoryArchive("music.zip"         , 16);
-	indexMandatoryArchive("nwn2_materials.zip", 17);
-	indexMandatoryArchive("nwn2_models.zip"   , 18);
-	indexMandatoryArchive("nwn2_vfx.zip"      , 19);
-	indexMandatoryArchive("prefabs.zip"       , 20);
-	indexMandatoryArchive("scripts.zip"       , 21);
-	indexMandatoryArchive("sounds.zip"        , 22);
-	indexMandatoryArchive("soundsets.zip"     , 23);
-	indexMandatoryArchive("speedtree.zip"     , 24);
-	indexMandatoryArchive("templates.zip"     , 25);
-	indexMandatoryArchive("vo.zip"            , 26);
-	indexMandatoryArchive("walkmesh.zip"      , 27);
+	indexMandatoryArchives({
+		{ "2da.zip"           , 10 },
+		{ "actors.zip"        , 11 },
+		{ "animtags.zip"      , 12 },
+		{ "convo.zip"         , 13 },
+		{ "ini.zip"           , 14 },
+		{ "lod-merged.zip"    , 15 },
+		{ "music.zip"         , 16 },
+		{ "nwn2_materials.zip", 17 },
+		{ "nwn2_models.zip"   , 18 },
+		{ "nwn2_vfx.zip"      , 19 },
+		{ "prefabs.zip"       , 20 },
+		{ "scripts.zip"       , 21 },
+		{ "sounds.zip"        , 22 },
+		{ "soundsets.zip"     , 23 },
+		{ "speedtree.zip"     , 24 },
+		{ "templates.zip"     , 25 },
+		{ "vo.zip"            , 26 },
+		{ "walkmesh.zip"      , 27 }
+	});
 
 	progress.step("Loading expansion 1 resource files");
 
 	// Expansion 1: Mask of the Betrayer (MotB)
 	_hasXP1 = ResMan.hasArchive("2da_x1.zip");
-	indexOptionalArchive("2da_x1.zip"           , 50);
-	indexOptionalArchive("actors_x1.zip"        , 51);
-	indexOptionalArchive("animtags_x1.zip"      , 52);
-	indexOptionalArchive("convo_x1.zip"         , 53);
-	indexOptionalArchive("ini_x1.zip"           , 54);
-	indexOptionalArchive("lod-merged_x1.zip"    , 55);
-	indexOptionalArchive("music_x1.zip"         , 56);
-	indexOptionalArchive("nwn2_materials_x1.zip", 57);
-	indexOptionalArchive("nwn2_models_x1.zip"   , 58);
-	indexOptionalArchive("nwn2_vfx_x1.zip"      , 59);
-	indexOptionalArchive("prefabs_x1.zip"       , 60);
-	indexOptionalArchive("scripts_x1.zip"       , 61);
-	indexOptionalArchive("soundsets_x1.zip"     , 62);
-	indexOptionalArchive("sounds_x1.zip"        , 63);
-	indexOptionalArchive("speedtree_x1.zip"     , 64);
-	indexOptionalArchive("templates_x1.zip"     , 65);
-	indexOptionalArchive("vo_x1.zip"            , 66);
-	indexOptionalArchive("walkmesh_x1.zip"      , 67);
+	indexOptionalArchives({
+		{ "2da_x1.zip"           , 50 },
+		{ "actors_x1.zip"        , 51 },
+		{ "animtags_x1.zip"      , 52 },
+		{ "convo_x1.zip"         , 53 },
+		{ "ini_x1.zip"           , 54 },
+		{ "lod-merged_x1.zip"    , 55 },
+		{ "music_x1.zip"         , 56 },
+		{ "nwn2_materials_x1.zip", 57 },
+		{ "nwn2_models_x1.zip"   , 58 },
+		{ "nwn2_vfx_x1.zip"      , 59 },
+		{ "prefabs_x1.zip"       , 60 },
+		{ "scripts_x1.zip"       , 61 },
+		{ "soundsets_x1.zip"     , 62 },
+		{ "sounds_x1.zip"        , 63 },
+		{ "speedtree_x1.zip"     , 64 },
+		{ "templates_x1.zip"     , 65 },
+		{ "vo_x1.zip"            , 66 },
+		{ "walkmesh_x1.zip"      , 67 }
+	});
 
 	progress.step("Loading expansion 2 resource files");
 
 	// Expansion 2: Storm of Zehir (SoZ)
 	_hasXP2 = ResMan.hasArchive("2da_x2.zip");
-	indexOptionalArchive("2da_x2.zip"           , 100);
-	indexOptionalArchive("actors_x2.zip"        , 101);
-	indexOptionalArchive("animtags_x2.zip"      , 102);
-	indexOptionalArchive("lod-merged_x2.zip"    , 103);
-	indexOptionalArchive("music_x2.zip"         , 104);
-	indexOptionalArchive("nwn2_materials_x2.zip", 105);
-	indexOptionalArchive("nwn2_models_x2.zip"   , 106);
-	indexOptionalArchive("nwn2_vfx_x2.zip"      , 107);
-	indexOptionalArchive("prefabs_x2.zip"       , 108);
-	indexOptionalArchive("scripts_x2.zip"       , 109);
-	indexOptionalArchive("soundsets_x2.zip"     , 110);
-	indexOptionalArchive("sounds_x2.zip"        , 111);
-	indexOptionalArchive("speedtree_x2.zip"     , 112);
-	indexOptionalArchive("templates_x2.zip"     , 113);
-	indexOptionalArchive("vo_x2.zip"            , 114);
+	indexOptionalArchives({
+		{ "2da_x2.zip"           , 100 },
+		{ "actors_x2.zip"        , 101 },
+		{ "animtags_x2.zip"      , 102 },
+		{ "lod-merged_x2.zip"    , 103 },
+		{ "music_x2.zip"         , 104 },
+		{ "nwn2_materials_x2.zip", 105 },
+		{ "nwn2_models_x2.zip"   , 106 },
+		{ "nwn2_vfx_x2.zip"      , 107 },
+		{ "prefabs_x2.zip"       , 108 },
+		{ "scripts_x2.zip"       , 109 },
+		{ "soundsets_x2.zip"     , 110 },
+		{ "sounds_x2.zip"        , 111 },
+		{ "speedtree_x2.zip"     , 112 },
+		{ "templates_x2.zip"     , 113 },
+		{ "vo_x2.zip"            , 114 }
+	});
 
 	// Expansion 3: Mysteries of Westgate
 	_hasXP3 = ResMan.hasArchive("westgate.hak");
 
 	progress.step("Loading patch resource files");
 
-	indexOptionalArchive("actors_v103x1.zip"         , 150);
-	indexOptionalArchive("actors_v106.zip"           , 151);
-	indexOptionalArchive("lod-merged_v101.zip"       , 152);
-	indexOptionalArchive("lod-merged_v107.zip"       , 153);
-	indexOptionalArchive("lod-merged_v121.zip"       , 154);
-	indexOptionalArchive("lod-merged_x1_v121.zip"    , 155);
-	indexOptionalArchive("lod-merged_x2_v121.zip"    , 156);
-	indexOptionalArchive("nwn2_materials_v103x1.zip" , 157);
-	indexOptionalArchive("nwn2_materials_v104.zip"   , 158);
-	indexOptionalArchive("nwn2_materials_v106.zip"   , 159);
-	indexOptionalArchive("nwn2_materials_v107.zip"   , 160);
-	indexOptionalArchive("nwn2_materials_v110.zip"   , 161);
-	indexOptionalArchive("nwn2_materials_v112.zip"   , 162);
-	indexOptionalArchive("nwn2_materials_v121.zip"   , 163);
-	indexOptionalArchive("nwn2_materials_x1_v113.zip", 164);
-	indexOptionalArchive("nwn2_materials_x1_v121.zip", 165);
-	indexOptionalArchive("nwn2_models_v103x1.zip"    , 166);
-	indexOptionalArchive("nwn2_models_v104.zip"      , 167);
-	indexOptionalArchive("nwn2_models_v105.zip"      , 168);
-	indexOptionalArchive("nwn2_models_v106.zip"      , 169);
-	indexOptionalArchive("nwn2_models_v107.zip"      , 160);
-	indexOptionalArchive("nwn2_models_v112.zip"      , 171);
-	indexOptionalArchive("nwn2_models_v121.zip"      , 172);
-	indexOptionalArchive("nwn2_models_x1_v121.zip"   , 173);
-	indexOptionalArchive("nwn2_models_x2_v121.zip"   , 174);
-	indexOptionalArchive("templates_v112.zip"        , 175);
-	indexOptionalArchive("templates_v122.zip"        , 176);
-	indexOptionalArchive("templates_x1_v122.zip"     , 177);
-	indexOptionalArchive("vo_103x1.zip"              , 178);
-	indexOptionalArchive("vo_106.zip"                , 179);
+	indexOptionalArchives({
+		{ "actors_v103x1.zip"         , 150 },
+		{ "actors_v106.zip"           , 151 },
+		{ "lod-merged_v101.zip"       , 152 },
+		{ "lod-merged_v107.zip"       , 153 },
+		{ "lod-merged_v121.zip"       , 154 },
+		{ "lod-merged_x1_v121.zip"    , 155 },
+		{ "lod-merged_x2_v121.zip"    , 156 },
+		{ "nwn2_materials_v103x1.zip" , 157 },
+		{ "nwn2_materials_v104.zip"   , 158 },
+		{ "nwn2_materials_v106.zip"   , 159 },
+		{ "nwn2_materials_v107.zip"   , 160 },
+		{ "nwn2_materials_v110.zip"   , 161 },
+		{ "nwn2_materials_v112.zip"   , 162 },
+		{ "nwn2_materials_v121.zip"   , 163 },
+		{ "nwn2_materials_x1_v113.zip", 164 },
+		{ "nwn2_materials_x1_v121.zip", 165 },
+		{ "nwn2_models_v103x1.zip"    , 166 },
+		{ "nwn2_models_v104.zip"      , 167 },
+		{ "nwn2_models_v105.zip"      , 168 },
+		{ "nwn2_models_v106.zip"      , 169 },
+		{ "nwn2_models_v107.zip"      , 160 },
+		{ "nwn2_models_v112.zip"      , 171 },
+		{ "nwn2_models_v121.zip"      , 172 },
+		{ "nwn2_models_x1_v121.zip"   , 173 },
+		{ "nwn2_models_x2_v121.zip"   , 174 },
+		{ "templates_v112.zip"        , 175 },
+		{ "templates_v122.zip"        , 176 },
+		{ "templates_x1_v122.zip"     , 177 },
+		{ "vo_103x1.zip"              , 178 },
+		{ "vo_106.zip"                , 179 }
+	});
 
 	progress.step("Indexing extra sound resources");
 	indexMandatoryDirectory("ambient"   , 0,  0, 200);
@@ -19,11 +19,17 @@
  */
 
 /** @file
- *  Dedicated animation thread.
+ *  Dedicated animation thread, updating animations on a pool of workers.
  */
 
+#include <chrono>
+
 #include "external/glm/gtc/type_ptr.hpp"
 
+#include "src/common/threadpool.h"
+
+#include "src/aurora/resman.h"
+
 #include "src/events/events.h"
 
 #include "src/graphics/camera.h"
@@ -38,6 +44,13 @@ namespace Aurora {
 const int kPauseDuration = 10;
 const int kYieldDuration = 10;
 
+static double getMilliseconds(const std::chrono::steady_clock::time_point &start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+AnimationThread::Stats::Stats() : threads(0), models(0), passes(0), updates(0), time(0.0), busyTime(0.0) {
+}
+
 AnimationThread::PoolModel::PoolModel(Model *m) : model(m) {
 }
 
@@ -73,24 +86,61 @@ void AnimationThread::unregisterModel(Model *model) {
 }
 
 void AnimationThread::flush() {
-	FlushStatus expected = kFlushReady;
-	if (!_flush.compare_exchange_strong(expected, kFlushRequested, std::memory_order_seq_cst))
+	bool expected = false;
+	if (!_flushing.compare_exchange_strong(expected, true, std::memory_order_seq_cst))
 		return;
 
-	bool inProgress = false;
-	while (!inProgress && (_pause.load(std::memory_order_seq_cst) != kPausePaused)) {
-		expected = kFlushGranted;
-		inProgress = _flush.compare_exchange_strong(expected, kFlushInProgress, std::memory_order_seq_cst);
-	}
+	// Wait for the running model updates. No new ones start until we're done
+	while (_updating.load(std::memory_order_seq_cst) > 0)
+		std::this_thread::yield();
 
 	for (auto &m : _models) {
 		m.second.model->flushNodeBuffers();
 	}
 
-	_flush.store(kFlushReady, std::memory_order_seq_cst);
+	_flushing.store(false, std::memory_order_seq_cst);
+}
+
+AnimationThread::Stats AnimationThread::getStats() const {
+	std::lock_guard<std::mutex> lock(_statsMutex);
+
+	Stats stats = _stats;
+
+	stats.threads = _threadCount.load(std::memory_order_relaxed);
+
+	return stats;
+}
+
+void AnimationThread::resetStats() {
+	std::lock_guard<std::mutex> lock(_statsMutex);
+
+	const size_t models = _stats.models;
+
+	_stats = Stats();
+	_stats.models = models;
+}
+
+void AnimationThread::beginUpdate() {
+	while (true) {
+		_updating.fetch_add(1, std::memory_order_seq_cst);
+		if (!_flushing.load(std::memory_order_seq_cst))
+			return;
+
+		// A flush is waiting for us. Step back and wait until it's done
+		_updating.fetch_sub(1, std::memory_order_seq_cst);
+
+		while (_flushing.load(std::memory_order_seq_cst))
+			std::this_thread::yield();
+	}
+}
+
+void AnimationThread::endUpdate() {
+	_updating.fetch_sub(1, std::memory_order_seq_cst);
 }
 
 void AnimationThread::threadMethod() {
+	_threadCount.store(ResMan.getThreadPool().getThreadCount() + 1, std::memory_order_relaxed);
+
 	while (!_killThread.load(std::memory_order_relaxed)) {
 		if (EventMan.quitRequested())
 			break;
@@ -102,36 +152,79 @@ void AnimationThread::threadMethod() {
 
 		std::lock_guard<std::recursive_mutex> lock(_modelsMutex);
 
+		// Registering changes the model map, which a flush looks at
+		beginUpdate();
 		registerQueuedModels();
+		endUpdate();
 
 		if (_models.empty()) {
 			EventMan.delay(100);
 			continue;
 		}
 
-		for (auto &m : _models) {
-			if (EventMan.quitRequested() || (_pause.load(std::memory_order_seq_cst) == kPausePaused))
-				break;
+		runPass();
+	}
+}
+
+void AnimationThread::runPass() {
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	_dueModels.clear();
+	for (auto &m : _models) {
+		if (m.second.skippedCount < getNumIterationsToSkip(m.second.model)) {
+			++m.second.skippedCount;
+			continue;
+		}
+
+		m.second.skippedCount = 0;
+		_dueModels.push_back(&m.second);
+	}
 
-			if (m.second.skippedCount < getNumIterationsToSkip(m.second.model)) {
-				++m.second.skippedCount;
-				continue;
-			} else {
-				m.second.skippedCount = 0;
-			}
+	_dueTimes.assign(_dueModels.size(), 0.0);
 
-			handleFlush();
+	ResMan.getThreadPool().parallelFor(_dueModels.size(), [this](size_t i) {
+		// Cut the pass short when quitting or pausing, leaving the remaining models for later
+		if (EventMan.quitRequested() || (_pause.load(std::memory_order_seq_cst) != kPauseResumed))
+			return;
 
-			uint32 now = EventMan.getTimestamp();
-			float dt = 0;
-			if (m.second.lastChanged > 0) {
-				dt = (now - m.second.lastChanged) / 1000.0f;
-			}
-			m.second.lastChanged = now;
+		updateModel(*_dueModels[i], _dueTimes[i]);
+	});
 
-			m.second.model->manageAnimations(dt);
-		}
+	double busyTime = 0.0;
+	for (std::vector<double>::const_iterator t = _dueTimes.begin(); t != _dueTimes.end(); ++t)
+		busyTime += *t;
+
+	std::lock_guard<std::mutex> lock(_statsMutex);
+
+	_stats.models    = _models.size();
+	_stats.passes   += 1;
+	_stats.updates  += _dueModels.size();
+	_stats.time     += getMilliseconds(start);
+	_stats.busyTime += busyTime;
+}
+
+void AnimationThread::updateModel(PoolModel &model, double &time) {
+	beginUpdate();
+
+	const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	uint32 now = EventMan.getTimestamp();
+	float dt = 0;
+	if (model.lastChanged > 0) {
+		dt = (now - model.lastChanged) / 1000.0f;
+	}
+	model.lastChanged = now;
+
+	try {
+		model.model->manageAnimations(dt);
+	} catch (...) {
+		endUpdate();
+		throw;
 	}
+
+	time = getMilliseconds(start);
+
+	endUpdate();
 }
 
 void AnimationThread::registerQueuedModels() {
@@ -188,14 +281,6 @@ void AnimationThread::handleYield() {
 		EventMan.delay(kYieldDuration);
 }
 
-void AnimationThread::handleFlush() {
-	FlushStatus expected = kFlushRequested;
-	if (_flush.compare_exchange_strong(expected, kFlushGranted, std::memory_order_seq_cst)) {
-		while (_flush.load(std::memory_order_seq_cst) != kFlushReady)
-			; // Spin until flushing is finished
-	}
-}
-
 } // End of namespace Aurora
 
 } // End of namespace Engines
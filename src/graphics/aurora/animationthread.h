@@ -25,6 +25,7 @@
 #ifndef GRAPHICS_AURORA_ANIMATIONTHREAD_H
 #define GRAPHICS_AURORA_ANIMATIONTHREAD_H
 
+#include <vector>
 #include <map>
 #include <queue>
 #include <atomic>
@@ -32,6 +33,7 @@
 #include "external/glm/vec3.hpp"
 #include "external/glm/vec4.hpp"
 
+#include "src/common/types.h"
 #include "src/common/thread.h"
 #include "src/common/mutex.h"
 
@@ -41,8 +43,33 @@ namespace Aurora {
 
 class Model;
 
+/** The thread updating the animations of all visible models.
+ *
+ *  In each pass over the models, the models due for an update are spread
+ *  over the resource manager's shared thread pool, each model updated as a
+ *  task of its own. Workers take the next model as soon as they're done
+ *  with one, so a few expensive models don't hold up the others. A pass is
+ *  cut short when a quit or a pause is requested.
+ *
+ *  flush() acts as a barrier: while it applies the buffered changes to the
+ *  models, no model updates are running, and none are started.
+ */
 class AnimationThread : public Common::Thread {
 public:
+	/** Statistics about updating the animations. */
+	struct Stats {
+		size_t threads; ///< Number of threads updating models, including the animation thread.
+		size_t models;  ///< Number of models in the processing pool.
+
+		uint64 passes;  ///< Number of passes over all models.
+		uint64 updates; ///< Number of model updates.
+
+		double time;     ///< Time spent in passes, in milliseconds.
+		double busyTime; ///< Time spent updating models, summed over all threads, in milliseconds.
+
+		Stats();
+	};
+
 	void pause();
 	void resume();
 
@@ -55,6 +82,11 @@ public:
 	/** Apply buffered changes to all models in the processing pool. */
 	void flush();
 
+	/** Return the statistics collected since the last reset. */
+	Stats getStats() const;
+	/** Reset the collected statistics. */
+	void resetStats();
+
 private:
 	enum PauseStatus {
 		kPauseResumed,
@@ -62,13 +94,6 @@ private:
 		kPausePaused
 	};
 
-	enum FlushStatus {
-		kFlushReady,
-		kFlushRequested,
-		kFlushGranted,
-		kFlushInProgress
-	};
-
 	struct PoolModel {
 		Model *model;
 		uint32 lastChanged { 0 };
@@ -83,12 +108,24 @@ private:
 	ModelMap _models;
 	ModelQueue _registerQueue;
 
+	/** The models to update in the current pass. */
+	std::vector<PoolModel *> _dueModels;
+	/** The time spent updating each model in the current pass, in milliseconds. */
+	std::vector<double> _dueTimes;
+
 	std::atomic_bool         _yield { false };
 	std::atomic<PauseStatus> _pause { kPauseResumed };
-	std::atomic<FlushStatus> _flush { kFlushReady };
+
+	std::atomic_bool    _flushing { false }; ///< Is a flush waiting or in progress?
+	std::atomic<size_t> _updating { 0 };     ///< Number of model updates currently running.
+
+	std::atomic<size_t> _threadCount { 1 };
+
+	Stats _stats;
 
 	std::recursive_mutex _modelsMutex;   ///< Mutex protecting access to the model map.
 	std::recursive_mutex _registerMutex; ///< Mutex protecting access to the registration queue.
+	mutable std::mutex   _statsMutex;    ///< Mutex protecting access to the statistics.
 
 	// Model registration
 
@@ -96,12 +133,20 @@ private:
 	void registerModelInternal(Model *model);
 	void unregisterModelInternal(Model *model);
 
+	// Flush barrier
+
+	/** Wait until no flush is running, and mark a model update as running. */
+	void beginUpdate();
+	/** Mark a model update as finished. */
+	void endUpdate();
+
 
 	void threadMethod();
+	void runPass();
+	void updateModel(PoolModel &model, double &time);
 	uint8 getNumIterationsToSkip(Model *model) const;
 	bool handlePause();
 	void handleYield();
-	void handleFlush();
 };
 
 } // End of namespace Aurora
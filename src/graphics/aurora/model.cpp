@@ -159,6 +159,13 @@ bool Model::isIn(float x1, float y1, float z1, float x2, float y2, float z2) con
 	return _absoluteBoundBox.isIn(x1, y1, z1, x2, y2, z2);
 }
 
+const Common::BoundingBox *Model::getWorldBound() const {
+	if (_type == kModelTypeGUIFront)
+		return 0;
+
+	return &_absoluteBoundBox;
+}
+
 float Model::getWidth() const {
 	return _boundBox.getWidth() * _scale[0];
 }
@@ -315,6 +322,8 @@ void Model::createAbsolutePosition() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	notifyWorldBoundChanged();
 }
 
 const std::list<Common::UString> &Model::getStates() const {
@@ -894,6 +903,8 @@ void Model::createBound() {
 	_absoluteBoundBox = _boundBox;
 	_absoluteBoundBox.transform(_absolutePosition);
 	_absoluteBoundBox.absolutize();
+
+	notifyWorldBoundChanged();
 }
 
 void Model::readValue(Common::SeekableReadStream &stream, uint32 &value) {
@@ -312,7 +312,7 @@ bool Model_KotOR::readAnim(ParserContext &ctx, uint32 offset) {
 	ctx.mdl->seek(ctx.offModelData + nodeHeadPointer);
 	rootNode->load(ctx);
 
-	Animation *anim = new SkeletalAnimation(4);
+	Animation *anim = new SkeletalAnimation();
 
 	anim->setName(ctx.state->name);
 	anim->setLength(animLength);
@@ -959,14 +959,23 @@ void ModelNode_KotOR::readSkin(Model_KotOR::ParserContext &ctx) {
 
 	ctx.mdl->seek(pos);
 
-	std::vector<float> &boneWeights = _mesh->skin->boneWeights;
-	std::vector<float> &boneMappingId = _mesh->skin->boneMappingId;
+	std::vector<float> normals;
+	std::vector<float> boneWeights;
+	std::vector<float> boneMappingId;
+
+	normals.reserve(3 * ctx.vertexCount);
+	boneWeights.reserve(4 * ctx.vertexCount);
+	boneMappingId.reserve(4 * ctx.vertexCount);
 
 	VertexBuffer *vertexBuffer = _mesh->data->rawMesh->getVertexBuffer();
 	float *vertexData = static_cast<float *>(vertexBuffer->getData());
 
 	for (int i = 0; i < ctx.vertexCount; i++) {
-		// Skip position and normal attributes
+		// Skip position, but remember the normal of the bind pose
+		normals.push_back(vertexData[3]);
+		normals.push_back(vertexData[4]);
+		normals.push_back(vertexData[5]);
+
 		vertexData += 6;
 
 		// Bone weights
@@ -1000,6 +1009,9 @@ void ModelNode_KotOR::readSkin(Model_KotOR::ParserContext &ctx) {
 		// Skip textures coordinates
 		vertexData += 2 * _mesh->data->textures.size();
 	}
+
+	_mesh->skin->vertices.set(ctx.vertexCount, 4, _mesh->data->initialVertexCoords.data(), normals.data(),
+	                          boneMappingId.data(), boneWeights.data());
 }
 
 void ModelNode_KotOR::readSaber(Model_KotOR::ParserContext &ctx) {
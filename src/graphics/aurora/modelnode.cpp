@@ -457,6 +457,9 @@ void ModelNode::loadTextures(const std::vector<Common::UString> &textures) {
 
 	Common::UString envMap;
 
+	// Read all the texture images at once, so that they're decompressed in parallel
+	TextureMan.preload(textures);
+
 	for (size_t t = 0; t != textures.size(); t++) {
 
 		try {
@@ -1026,14 +1029,6 @@ const std::vector<float> &ModelNode::getInitialVertexCoords() const {
 	return _mesh->data->initialVertexCoords;
 }
 
-const std::vector<float> &ModelNode::getBoneIndices() const {
-	return _mesh->skin->boneMappingId;
-}
-
-const std::vector<float> &ModelNode::getBoneWeights() const {
-	return _mesh->skin->boneWeights;
-}
-
 bool ModelNode::hasSkinNode() const {
 	return _mesh && _mesh->skin;
 }
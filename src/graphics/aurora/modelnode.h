@@ -37,6 +37,7 @@
 
 #include "src/graphics/aurora/types.h"
 #include "src/graphics/aurora/texturehandle.h"
+#include "src/graphics/aurora/skinning.h"
 
 #include "src/graphics/mesh/meshman.h"
 #include "src/graphics/shader/shaderrenderable.h"
@@ -123,8 +124,6 @@ public:
 	int getBoneIndexByNodeNumber(int nodeNumber) const;
 	ModelNode *getBoneNode(int index);
 	const std::vector<float> &getInitialVertexCoords() const;
-	const std::vector<float> &getBoneIndices() const;
-	const std::vector<float> &getBoneWeights() const;
 
 	bool hasSkinNode() const;
 	void notifyVertexCoordsBuffered();
@@ -184,10 +183,11 @@ public:
 	struct Skin {
 		std::vector<float>       boneMapping;
 		uint32                   boneMappingCount;
-		std::vector<float>       boneWeights;
-		std::vector<float>       boneMappingId;
 		std::vector<ModelNode *> boneNodeMap;
 
+		SkinningData           vertices;       ///< The vertices to skin on the CPU.
+		std::vector<glm::mat4> boneTransforms; ///< Combined bone transformations, for skinning on the CPU.
+
 		Skin();
 	};
 
@@ -61,6 +61,7 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/aurora/animationchannel.h \
     src/graphics/aurora/line.h \
     src/graphics/aurora/skeletalanimation.h \
+    src/graphics/aurora/skinning.h \
     $(EMPTY)
 
 src_graphics_libgraphics_la_SOURCES += \
@@ -104,4 +105,5 @@ src_graphics_libgraphics_la_SOURCES += \
     src/graphics/aurora/animationchannel.cpp \
     src/graphics/aurora/line.cpp \
     src/graphics/aurora/skeletalanimation.cpp \
+    src/graphics/aurora/skinning.cpp \
     $(EMPTY)
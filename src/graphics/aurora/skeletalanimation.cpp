@@ -23,7 +23,6 @@
  */
 
 #include "external/glm/gtc/type_ptr.hpp"
-#include "external/glm/gtc/matrix_transform.hpp"
 
 #include "src/graphics/aurora/skeletalanimation.h"
 #include "src/graphics/aurora/model.h"
@@ -33,9 +32,7 @@ namespace Graphics {
 
 namespace Aurora {
 
-SkeletalAnimation::SkeletalAnimation(int bonesPerVertex) :
-		Animation(),
-		_bonesPerVertex(bonesPerVertex) {
+SkeletalAnimation::SkeletalAnimation() : Animation() {
 }
 
 void SkeletalAnimation::update(Model *model,
@@ -51,23 +48,23 @@ void SkeletalAnimation::updateModel(Model *model, float time) {
 	if (!model->hasSkinNodes())
 		return;
 
+	bool computedTransforms = false;
+
 	for (const auto &n : model->getNodes()) {
 		if (!n->hasSkinNode())
 			continue;
 
-		model->computeNodeTransforms();
+		if (!computedTransforms) {
+			model->computeNodeTransforms();
+			computedTransforms = true;
+		}
 
 		if (GfxMan.isRendererExperimental()) {
 			fillBoneTransforms(n);
 			continue;
 		}
 
-		const std::vector<float> &vertsIn = n->getInitialVertexCoords();
-		const std::vector<float> &boneIndices = n->getBoneIndices();
-		const std::vector<float> &boneWeights = n->getBoneWeights();
-		VertexBuffer *vertexBuffer = n->getMesh()->data->rawMesh->getVertexBuffer();
-
-		transform(n, vertsIn, boneIndices, boneWeights, vertexBuffer);
+		transform(n);
 
 		n->notifyVertexCoordsBuffered();
 	}
@@ -93,61 +90,48 @@ void SkeletalAnimation::fillBoneTransforms(ModelNode *node) {
 	}
 }
 
-void SkeletalAnimation::transform(ModelNode *node,
-                                  const std::vector<float> &vertsIn,
-                                  const std::vector<float> &boneIndices,
-                                  const std::vector<float> &boneWeights,
-                                  VertexBuffer *vertexBuffer) {
-
-	const int vertexCount = static_cast<int>(vertsIn.size()) / 3;
-	const float *vertsInData = vertsIn.data();
+void SkeletalAnimation::transform(ModelNode *node) {
+	ModelNode::Mesh *mesh = node->getMesh();
+	ModelNode::Skin *skin = mesh->skin;
 
-	const float *boneIndicesData = boneIndices.data();
-	const float *boneWeightsData = boneWeights.data();
-	const int boneStride = _bonesPerVertex;
+	const SkinningData &vertices = skin->vertices;
+	if (vertices.empty())
+		return;
 
-	float *bufferData = static_cast<float *>(vertexBuffer->getData());
-	const int bufferStride = static_cast<int>(vertexBuffer->getVertexDecl()[0].stride) / sizeof(float);
+	/* Move the vertices into the space of the bones, apply the bone's
+	 * transformation and move them back. Bones without a node don't move. */
+	const glm::mat4 &base        = node->getAbsoluteBaseTransform();
+	const glm::mat4 &baseInverse = node->getAbsoluteBaseTransformInverse();
 
-	for (int i = 0; i < vertexCount; ++i) {
-		bufferData[0] = 0.0f;
-		bufferData[1] = 0.0f;
-		bufferData[2] = 0.0f;
+	skin->boneTransforms.resize(vertices.getBoneCount());
+	for (size_t i = 0; i < skin->boneTransforms.size(); i++) {
+		ModelNode *boneNode = (i < skin->boneNodeMap.size()) ? skin->boneNodeMap[i] : 0;
 
-		for (int j = 0; j < _bonesPerVertex; ++j) {
-			const int boneIndex = static_cast<int>(boneIndicesData[j]);
-			if (boneIndex == -1)
-				continue;
+		if (boneNode)
+			skin->boneTransforms[i] = baseInverse * boneNode->getBoneTransform() * base;
+		else
+			skin->boneTransforms[i] = glm::mat4();
+	}
 
-			const glm::mat4 &boneTransform = node->getBoneNode(boneIndex)->getBoneTransform();
-			const float boneWeight = boneWeightsData[j];
-			float v0[3], v1[3];
+	VertexBuffer *vertexBuffer = mesh->data->rawMesh->getVertexBuffer();
+	const VertexDecl &vertexDecl = vertexBuffer->getVertexDecl();
 
-			multiply(vertsInData, node->getAbsoluteBaseTransform(), v0);
-			multiply(v0, boneTransform, v1);
-			multiply(v1, node->getAbsoluteBaseTransformInverse(), v0);
+	float *data = static_cast<float *>(vertexBuffer->getData());
 
-			bufferData[0] += v0[0] * boneWeight;
-			bufferData[1] += v0[1] * boneWeight;
-			bufferData[2] += v0[2] * boneWeight;
-		}
+	float *positions = 0, *normals = 0;
+	for (VertexDecl::const_iterator a = vertexDecl.begin(); a != vertexDecl.end(); ++a) {
+		const size_t offset = static_cast<const float *>(a->pointer) - data;
 
-		vertsInData += 3;
-		boneIndicesData += boneStride;
-		boneWeightsData += boneStride;
-		bufferData += bufferStride;
+		if (a->index == VPOSITION)
+			positions = data + offset;
+		else if (a->index == VNORMAL)
+			normals = data + offset;
 	}
-}
 
-void SkeletalAnimation::multiply(const float *v, const glm::mat4 &m, float *vOut) {
-	float x = v[0] * m[0][0] + v[1] * m[1][0] + v[2] * m[2][0] + m[3][0];
-	float y = v[0] * m[0][1] + v[1] * m[1][1] + v[2] * m[2][1] + m[3][1];
-	float z = v[0] * m[0][2] + v[1] * m[1][2] + v[2] * m[2][2] + m[3][2];
-	float w = v[0] * m[0][3] + v[1] * m[1][3] + v[2] * m[2][3] + m[3][3];
+	if (!positions || !normals)
+		return;
 
-	vOut[0] = x / w;
-	vOut[1] = y / w;
-	vOut[2] = z / w;
+	vertices.skin(skin->boneTransforms.data(), positions, normals, vertexDecl[0].stride / sizeof(float));
 }
 
 } // End of namespace Aurora
@@ -27,22 +27,17 @@
 
 #include <vector>
 
-#include "external/glm/vec3.hpp"
-#include "external/glm/mat4x4.hpp"
-
 #include "src/common/types.h"
 
 #include "src/graphics/aurora/animation.h"
 
 namespace Graphics {
 
-class VertexBuffer;
-
 namespace Aurora {
 
 class SkeletalAnimation : public Animation {
 public:
-	SkeletalAnimation(int bonesPerVertex);
+	SkeletalAnimation();
 
 	void update(Model *model,
 	            float lastFrame,
@@ -50,27 +45,15 @@ public:
 	            const std::vector<ModelNode *> &modelNodeMap);
 
 private:
-	int _bonesPerVertex;
-
 	void updateModel(Model *model, float time);
 	void fillBoneTransforms(ModelNode *node);
 
-	/** Transform vertex coordinates.
+	/** Transform the vertex coordinates and normals of a skinned node into its vertex buffer.
 	 *
-	 *  @param node         Model node whose vertices are being transformed.
-	 *  @param vertsIn      Input array of vertex coordinates.
-	 *  @param boneIndices  Array of bone indices.
-	 *  @param boneWeights  Array of bone weights.
-	 *  @param vertexBuffer Vertex buffer to receive transformed vertex coordinates.
+	 *  Each bone's transformation is combined with the node's base transformation
+	 *  once, and the vertices are then skinned with these combined transformations.
 	 */
-	void transform(ModelNode *node,
-	               const std::vector<float> &vertsIn,
-	               const std::vector<float> &boneIndices,
-	               const std::vector<float> &boneWeights,
-	               VertexBuffer *vertexBuffer);
-
-	/** Multiply a specified vector by a specified matrix. */
-	static void multiply(const float *v, const glm::mat4 &m, float *vOut);
+	static void transform(ModelNode *node);
 };
 
 } // End of namespace Aurora
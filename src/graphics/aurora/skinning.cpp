@@ -0,0 +1,236 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Vertex skinning on the CPU.
+ */
+
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 2))
+	#define XOREOS_SKINNING_SSE2 1
+	#include <emmintrin.h>
+#endif
+
+#include "external/glm/gtc/type_ptr.hpp"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+
+#include "src/graphics/aurora/skinning.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+static const float kWeightScale = 1.0f / 65535.0f;
+
+SkinningData::SkinningData() : _vertexCount(0), _boneCount(0) {
+}
+
+void SkinningData::set(size_t vertexCount, size_t bonesPerVertex, const float *positions, const float *normals,
+                       const float *boneIndices, const float *boneWeights) {
+
+	if (bonesPerVertex > kMaxBonesPerVertex)
+		throw Common::Exception("Too many bones per vertex (%u)", (uint) bonesPerVertex);
+
+	clear();
+
+	_positions.assign(positions, positions + 3 * vertexCount);
+	_normals.assign(normals, normals + 3 * vertexCount);
+
+	_influences.resize(vertexCount);
+
+	for (size_t i = 0; i < vertexCount; i++) {
+		Influences &influences = _influences[i];
+
+		for (size_t j = 0; j < kMaxBonesPerVertex; j++) {
+			influences.indices[j] = 0;
+			influences.weights[j] = 0;
+
+			if (j >= bonesPerVertex)
+				continue;
+
+			const int index = static_cast<int>(boneIndices[j]);
+			if (index < 0)
+				continue;
+
+			if (index > 0xFFFF)
+				throw Common::Exception("Invalid bone index %d", index);
+
+			influences.indices[j] = index;
+			influences.weights[j] = static_cast<uint16>(std::lround(CLIP(boneWeights[j], 0.0f, 1.0f) * 65535.0f));
+
+			_boneCount = MAX<size_t>(_boneCount, index + 1);
+		}
+
+		boneIndices += bonesPerVertex;
+		boneWeights += bonesPerVertex;
+	}
+
+	_vertexCount = vertexCount;
+}
+
+void SkinningData::clear() {
+	_vertexCount = 0;
+	_boneCount   = 0;
+
+	_positions.clear();
+	_normals.clear();
+	_influences.clear();
+}
+
+bool SkinningData::empty() const {
+	return _vertexCount == 0;
+}
+
+size_t SkinningData::getVertexCount() const {
+	return _vertexCount;
+}
+
+size_t SkinningData::getBoneCount() const {
+	return _boneCount;
+}
+
+void SkinningData::skinScalar(const glm::mat4 *bones, float *positions, float *normals, size_t stride) const {
+	const float *positionsIn = _positions.data();
+	const float *normalsIn   = _normals.data();
+
+	for (size_t i = 0; i < _vertexCount; i++) {
+		const Influences &influences = _influences[i];
+
+		// Blend the bone matrices, ignoring the projective row
+		float m[12] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f };
+
+		for (size_t j = 0; j < kMaxBonesPerVertex; j++) {
+			if (influences.weights[j] == 0)
+				continue;
+
+			const glm::mat4 &bone = bones[influences.indices[j]];
+			const float weight = influences.weights[j] * kWeightScale;
+
+			for (int c = 0; c < 4; c++)
+				for (int r = 0; r < 3; r++)
+					m[c * 3 + r] += bone[c][r] * weight;
+		}
+
+		const float *p = positionsIn + 3 * i;
+		const float *n = normalsIn   + 3 * i;
+
+		for (int r = 0; r < 3; r++)
+			positions[r] = m[r] * p[0] + m[3 + r] * p[1] + m[6 + r] * p[2] + m[9 + r];
+
+		float normal[3];
+		for (int r = 0; r < 3; r++)
+			normal[r] = m[r] * n[0] + m[3 + r] * n[1] + m[6 + r] * n[2];
+
+		const float length = std::sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		if (length > 0.0f) {
+			normals[0] = normal[0] / length;
+			normals[1] = normal[1] / length;
+			normals[2] = normal[2] / length;
+		} else {
+			normals[0] = n[0];
+			normals[1] = n[1];
+			normals[2] = n[2];
+		}
+
+		positions += stride;
+		normals   += stride;
+	}
+}
+
+#ifdef XOREOS_SKINNING_SSE2
+
+/** Write the first three components of an SSE register. */
+static inline void store3(float *data, __m128 v) {
+	_mm_storel_pi(reinterpret_cast<__m64 *>(data), v);
+	_mm_store_ss(data + 2, _mm_movehl_ps(v, v));
+}
+
+void SkinningData::skin(const glm::mat4 *bones, float *positions, float *normals, size_t stride) const {
+	const float *positionsIn = _positions.data();
+	const float *normalsIn   = _normals.data();
+
+	const __m128 zero = _mm_setzero_ps();
+
+	for (size_t i = 0; i < _vertexCount; i++) {
+		const Influences &influences = _influences[i];
+
+		// Blend the columns of the bone matrices
+		__m128 c0 = zero, c1 = zero, c2 = zero, c3 = zero;
+
+		for (size_t j = 0; j < kMaxBonesPerVertex; j++) {
+			if (influences.weights[j] == 0)
+				continue;
+
+			const float *bone = glm::value_ptr(bones[influences.indices[j]]);
+			const __m128 weight = _mm_set1_ps(influences.weights[j] * kWeightScale);
+
+			c0 = _mm_add_ps(c0, _mm_mul_ps(_mm_loadu_ps(bone +  0), weight));
+			c1 = _mm_add_ps(c1, _mm_mul_ps(_mm_loadu_ps(bone +  4), weight));
+			c2 = _mm_add_ps(c2, _mm_mul_ps(_mm_loadu_ps(bone +  8), weight));
+			c3 = _mm_add_ps(c3, _mm_mul_ps(_mm_loadu_ps(bone + 12), weight));
+		}
+
+		const float *p = positionsIn + 3 * i;
+		const float *n = normalsIn   + 3 * i;
+
+		__m128 position = c3;
+		position = _mm_add_ps(position, _mm_mul_ps(c0, _mm_set1_ps(p[0])));
+		position = _mm_add_ps(position, _mm_mul_ps(c1, _mm_set1_ps(p[1])));
+		position = _mm_add_ps(position, _mm_mul_ps(c2, _mm_set1_ps(p[2])));
+
+		__m128 normal = _mm_mul_ps(c0, _mm_set1_ps(n[0]));
+		normal = _mm_add_ps(normal, _mm_mul_ps(c1, _mm_set1_ps(n[1])));
+		normal = _mm_add_ps(normal, _mm_mul_ps(c2, _mm_set1_ps(n[2])));
+
+		// Sum up the squares of x, y and z
+		const __m128 squares = _mm_mul_ps(normal, normal);
+		const __m128 length2 = _mm_add_ss(_mm_add_ss(squares, _mm_shuffle_ps(squares, squares, 0x55)),
+		                                  _mm_movehl_ps(squares, squares));
+
+		store3(positions, position);
+
+		const float length = std::sqrt(_mm_cvtss_f32(length2));
+		if (length > 0.0f) {
+			store3(normals, _mm_div_ps(normal, _mm_set1_ps(length)));
+		} else {
+			normals[0] = n[0];
+			normals[1] = n[1];
+			normals[2] = n[2];
+		}
+
+		positions += stride;
+		normals   += stride;
+	}
+}
+
+#else
+
+void SkinningData::skin(const glm::mat4 *bones, float *positions, float *normals, size_t stride) const {
+	skinScalar(bones, positions, normals, stride);
+}
+
+#endif
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
@@ -0,0 +1,109 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Vertex skinning on the CPU.
+ */
+
+#ifndef GRAPHICS_AURORA_SKINNING_H
+#define GRAPHICS_AURORA_SKINNING_H
+
+#include <vector>
+
+#include "external/glm/mat4x4.hpp"
+
+#include "src/common/types.h"
+
+namespace Graphics {
+
+namespace Aurora {
+
+/** The vertices of a skinned mesh, in a compact layout for skinning them on the CPU.
+ *
+ *  Every vertex is influenced by up to four bones. The bone indices are
+ *  stored as 16-bit integers and the weights quantized to 16 bits, packed
+ *  together with the other influences of the same vertex.
+ *
+ *  Skinning a vertex first blends the matrices of its bones by their weights,
+ *  and then transforms the vertex' position and normal by the blended matrix.
+ *  The matrices are expected to be the complete, combined transformation of
+ *  each bone from the bind pose, calculated once per frame, and to be affine.
+ */
+class SkinningData {
+public:
+	static const size_t kMaxBonesPerVertex = 4;
+
+	SkinningData();
+
+	/** Set the vertices.
+	 *
+	 *  @param vertexCount    The number of vertices.
+	 *  @param bonesPerVertex The number of bone influences per vertex, at most kMaxBonesPerVertex.
+	 *  @param positions      3 floats per vertex, the positions in the bind pose.
+	 *  @param normals        3 floats per vertex, the normals in the bind pose.
+	 *  @param boneIndices    bonesPerVertex floats per vertex, the indices into the bone
+	 *                        matrices. -1 for no bone.
+	 *  @param boneWeights    bonesPerVertex floats per vertex, the weights of the bones.
+	 */
+	void set(size_t vertexCount, size_t bonesPerVertex, const float *positions, const float *normals,
+	         const float *boneIndices, const float *boneWeights);
+
+	void clear();
+
+	bool empty() const;
+
+	/** Return the number of vertices. */
+	size_t getVertexCount() const;
+	/** Return the number of bone matrices needed to skin the vertices. */
+	size_t getBoneCount() const;
+
+	/** Skin all vertices, using SIMD instructions if available.
+	 *
+	 *  @param bones     The combined transformations of the bones, getBoneCount() matrices.
+	 *  @param positions Where to write the position of the first vertex.
+	 *  @param normals   Where to write the normal of the first vertex.
+	 *  @param stride    The distance between the data of two consecutive vertices, in floats.
+	 */
+	void skin(const glm::mat4 *bones, float *positions, float *normals, size_t stride) const;
+
+	/** Skin all vertices, without SIMD instructions. The same as skin() otherwise. */
+	void skinScalar(const glm::mat4 *bones, float *positions, float *normals, size_t stride) const;
+
+private:
+	/** The bones influencing one vertex. Unused influences have a weight of 0. */
+	struct Influences {
+		uint16 indices[kMaxBonesPerVertex];
+		uint16 weights[kMaxBonesPerVertex];
+	};
+
+	size_t _vertexCount;
+	size_t _boneCount;
+
+	std::vector<float> _positions; ///< Positions in the bind pose, 3 floats per vertex.
+	std::vector<float> _normals;   ///< Normals in the bind pose, 3 floats per vertex.
+
+	std::vector<Influences> _influences;
+};
+
+} // End of namespace Aurora
+
+} // End of namespace Graphics
+
+#endif // GRAPHICS_AURORA_SKINNING_H
@@ -321,7 +321,12 @@ Texture *Texture::createPLT(const Common::UString &name, Common::SeekableReadStr
 }
 
 Texture *Texture::create(const Common::UString &name, bool deswizzle) {
-	::Aurora::FileType type = ::Aurora::kFileTypeNone;
+	return create(name, 0, ::Aurora::kFileTypeNone, deswizzle);
+}
+
+Texture *Texture::create(const Common::UString &name, Common::SeekableReadStream *imageStream,
+                         ::Aurora::FileType type, bool deswizzle) {
+
 	ImageDecoder *image = 0;
 	ImageDecoder *layers[6] = { 0, 0, 0, 0, 0, 0 };
 	TXI *txi = 0;
@@ -333,33 +338,42 @@ Texture *Texture::create(const Common::UString &name, bool deswizzle) {
 		if (isFileCubeMap) {
 			// A cube map with each side a separate image file
 
+			delete imageStream;
+			imageStream = 0;
+
 			for (size_t i = 0; i < 6; i++) {
 				const Common::UString side = name + Common::composeString(i);
-				Common::SeekableReadStream *imageStream = ResMan.getResource(::Aurora::kResourceImage, side, &type);
-				if (!imageStream)
+				Common::SeekableReadStream *sideStream = ResMan.getResource(::Aurora::kResourceImage, side, &type);
+				if (!sideStream)
 					throw Common::Exception("No such cube side image resource \"%s\"", side.c_str());
 
-				layers[i] = loadImage(imageStream, type, txi, deswizzle);
+				layers[i] = loadImage(sideStream, type, txi, deswizzle);
 			}
 
 			image = new CubeMapCombiner(layers);
 
 		} else {
-			Common::SeekableReadStream *imageStream = ResMan.getResource(::Aurora::kResourceImage, name, &type);
+			if (!imageStream)
+				imageStream = ResMan.getResource(::Aurora::kResourceImage, name, &type);
 			if (!imageStream)
 				throw Common::Exception("No such image resource \"%s\"", name.c_str());
 
+			// The image loaders take over the stream
+			Common::SeekableReadStream *stream = imageStream;
+			imageStream = 0;
+
 			// PLT needs extra handling, since they're their own Texture class
 			if (type == ::Aurora::kFileTypePLT) {
 				delete txi;
 
-				return createPLT(name, imageStream);
+				return createPLT(name, stream);
 			}
 
-			image = loadImage(imageStream, type, txi, deswizzle);
+			image = loadImage(stream, type, txi, deswizzle);
 		}
 
 	} catch (Common::Exception &e) {
+		delete imageStream;
 		delete txi;
 		delete image;
 
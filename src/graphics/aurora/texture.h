@@ -77,6 +77,12 @@ public:
 
 	/** Create a texture from this image resource. */
 	static Texture *create(const Common::UString &name, bool deswizzle = false);
+	/** Create a texture from this image resource, which was already read.
+	 *
+	 *  Takes over the image stream. If it is 0, the image resource is read here.
+	 */
+	static Texture *create(const Common::UString &name, Common::SeekableReadStream *imageStream,
+	                       ::Aurora::FileType type, bool deswizzle = false);
 	/** Take over the image and create a texture from it. */
 	static Texture *create(ImageDecoder *image, ::Aurora::FileType type = ::Aurora::kFileTypeNone,
 	                       TXI *txi = 0, bool deswizzle = false);
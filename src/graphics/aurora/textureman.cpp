@@ -22,10 +22,16 @@
  *  The Aurora texture manager.
  */
 
+#include <algorithm>
+
 #include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/uuid.h"
+#include "src/common/readstream.h"
+
+#include "src/aurora/resman.h"
 
 #include "src/graphics/aurora/textureman.h"
 #include "src/graphics/aurora/texture.h"
@@ -188,6 +194,55 @@ TextureHandle TextureManager::getIfExist(const Common::UString &name) {
 	return TextureHandle();
 }
 
+void TextureManager::preload(const std::vector<Common::UString> &names) {
+	std::lock_guard<std::recursive_mutex> lock(_mutex);
+
+	std::vector<Common::UString> newNames;
+	for (std::vector<Common::UString>::const_iterator n = names.begin(); n != names.end(); ++n) {
+		if (n->empty() || (_bogusTextures.find(*n) != _bogusTextures.end()))
+			continue;
+
+		if (_textures.find(*n) != _textures.end())
+			continue;
+		if (std::find(newNames.begin(), newNames.end(), *n) != newNames.end())
+			continue;
+
+		newNames.push_back(*n);
+	}
+
+	// Reading a single image in parallel doesn't gain us anything
+	if (newNames.size() < 2)
+		return;
+
+	Common::PtrVector<Common::SeekableReadStream> streams;
+	std::vector< ::Aurora::FileType> types;
+
+	try {
+		ResMan.getResources(::Aurora::kResourceImage, newNames, streams, &types);
+	} catch (...) {
+		// Ignored, get() will complain once the texture is needed
+		return;
+	}
+
+	for (size_t i = 0; i < newNames.size(); i++) {
+		// Leave missing images and PLTs, which are their own dynamic textures, to get()
+		if (!streams[i] || (types[i] == ::Aurora::kFileTypePLT))
+			continue;
+
+		Common::SeekableReadStream *stream = streams[i];
+		streams[i] = 0;
+
+		Texture *texture = 0;
+		try {
+			texture = Texture::create(newNames[i], stream, types[i], _deswizzleSBM);
+		} catch (...) {
+			continue;
+		}
+
+		_textures.insert(std::make_pair(newNames[i], new ManagedTexture(texture)));
+	}
+}
+
 void TextureManager::startRecordNewTextures() {
 	std::lock_guard<std::recursive_mutex> lock(_mutex);
 
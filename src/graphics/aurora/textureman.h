@@ -27,6 +27,7 @@
 
 #include <set>
 #include <list>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
@@ -81,6 +82,14 @@ public:
 	/** Retrieve this named texture, returning an empty handle if it's not managed. */
 	TextureHandle getIfExist(const Common::UString &name);
 
+	/** Load these named textures that aren't yet managed, reading their images in parallel.
+	 *
+	 *  This pays off for compressed images that are needed together, like all
+	 *  the textures of a model. Textures that fail to load are silently skipped.
+	 *  They will fail again, with an error, when they are requested with get().
+	 */
+	void preload(const std::vector<Common::UString> &names);
+
 	/** Start recording all names of newly created textures. */
 	void startRecordNewTextures();
 	/** Stop the recording of texture names, and return a list of previously recorded names. */
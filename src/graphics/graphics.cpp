@@ -38,6 +38,8 @@
 #include "src/common/configman.h"
 #include "src/common/debugman.h"
 #include "src/common/threads.h"
+#include "src/common/boundingbox.h"
+#include "src/common/aabbtree.h"
 
 #include "src/events/requests.h"
 #include "src/events/events.h"
@@ -70,7 +72,42 @@ namespace Graphics {
 
 PFNGLCOMPRESSEDTEXIMAGE2DPROC glCompressedTexImage2D;
 
-GraphicsManager::GraphicsManager() : Events::Notifyable() {
+/** How much to enlarge the bounding boxes of pickable world objects in the pick tree.
+ *  Objects moving less than that don't need to be moved within the tree. */
+static const float kPickMargin = 0.5f;
+
+/** Does a segment hit a pickable world object, and where? */
+struct PickTest {
+	const float *start;
+	const float *end;
+
+	PickTest(const float *s, const float *e) : start(s), end(e) {
+	}
+
+	bool operator()(void *data, float &t) const {
+		const Renderable &object = *static_cast<const Renderable *>(data);
+
+		if (!object.isClickable())
+			return false;
+
+		if (!object.isIn(start[0], start[1], start[2], end[0], end[1], end[2]))
+			return false;
+
+		const Common::BoundingBox *bound = object.getWorldBound();
+		if (bound) {
+			float min[3], max[3];
+			bound->getMin(min[0], min[1], min[2]);
+			bound->getMax(max[0], max[1], max[2]);
+
+			// Where the segment enters the object's bounding box
+			Common::AABBTree::intersect(min, max, start, end, t);
+		}
+
+		return true;
+	}
+};
+
+GraphicsManager::GraphicsManager() : Events::Notifyable(), _pickTree(kPickMargin) {
 	_ready = false;
 
 	_debugGL = false;
@@ -108,6 +145,9 @@ GraphicsManager::GraphicsManager() : Events::Notifyable() {
 
 	_renderableID = 0;
 
+	_culling      = true;
+	_cullDistance = 0.0f;
+
 	_hasAbandoned = false;
 
 	_lastSampled = 0;
@@ -131,6 +171,9 @@ void GraphicsManager::init() {
 
 	_rendererExperimental = ConfigMan.getBool("rendernew", false);
 
+	_culling      = ConfigMan.getBool("culling", true);
+	_cullDistance = MAX(ConfigMan.getDouble("culldistance", 0.0), 0.0);
+
 	if (!setupSDLGL())
 		throw Common::Exception("Failed initializing the OpenGL renderer");
 
@@ -169,6 +212,13 @@ void GraphicsManager::deinit() {
 
 	QueueMan.clearAllQueues();
 
+	{
+		std::lock_guard<std::mutex> lock(_pickMutex);
+
+		_pickTree.clear();
+		_pickables.clear();
+	}
+
 	_animationThread.pause();
 	_animationThread.destroyThread();
 
@@ -779,34 +829,28 @@ void GraphicsManager::unlockFrame() {
 
 void GraphicsManager::recalculateObjectDistances() {
 	// World objects
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
+	const std::vector<Queueable *> &objects = QueueMan.lockSnapshot(kQueueVisibleWorldObject);
+	for (std::vector<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o)
 		static_cast<Renderable *>(*o)->calculateDistance();
 
+	QueueMan.unlockSnapshot(kQueueVisibleWorldObject);
 	QueueMan.sortQueue(kQueueVisibleWorldObject);
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
 
 	// GUI front objects
-	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-
-	const std::list<Queueable *> &guiFront = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
-	for (std::list<Queueable *>::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
+	const std::vector<Queueable *> &guiFront = QueueMan.lockSnapshot(kQueueVisibleGUIFrontObject);
+	for (std::vector<Queueable *>::const_iterator g = guiFront.begin(); g != guiFront.end(); ++g)
 		static_cast<Renderable *>(*g)->calculateDistance();
 
+	QueueMan.unlockSnapshot(kQueueVisibleGUIFrontObject);
 	QueueMan.sortQueue(kQueueVisibleGUIFrontObject);
-	QueueMan.unlockQueue(kQueueVisibleGUIFrontObject);
 
 	// GUI back objects
-	QueueMan.lockQueue(kQueueVisibleGUIBackObject);
-
-	const std::list<Queueable *> &guiBack = QueueMan.getQueue(kQueueVisibleGUIBackObject);
-	for (std::list<Queueable *>::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
+	const std::vector<Queueable *> &guiBack = QueueMan.lockSnapshot(kQueueVisibleGUIBackObject);
+	for (std::vector<Queueable *>::const_iterator g = guiBack.begin(); g != guiBack.end(); ++g)
 		static_cast<Renderable *>(*g)->calculateDistance();
 
+	QueueMan.unlockSnapshot(kQueueVisibleGUIBackObject);
 	QueueMan.sortQueue(kQueueVisibleGUIBackObject);
-	QueueMan.unlockQueue(kQueueVisibleGUIBackObject);
 }
 
 uint32 GraphicsManager::createRenderableID() {
@@ -871,11 +915,10 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 
 	Renderable *object = 0;
 
-	QueueMan.lockQueue(kQueueVisibleGUIFrontObject);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(kQueueVisibleGUIFrontObject);
+	const std::vector<Queueable *> &gui = QueueMan.lockSnapshot(kQueueVisibleGUIFrontObject);
 
 	// Go through the GUI elements, from nearest to furthest
-	for (std::list<Queueable *>::const_iterator g = gui.begin(); g != gui.end(); ++g) {
+	for (std::vector<Queueable *>::const_iterator g = gui.begin(); g != gui.end(); ++g) {
 		Renderable &r = static_cast<Renderable &>(**g);
 
 		if (!r.isClickable())
@@ -889,39 +932,22 @@ Renderable *GraphicsManager::getGUIObjectAt(float x, float y) const {
 		}
 	}
 
-	QueueMan.unlockQueue(kQueueVisibleGUIFrontObject);
+	QueueMan.unlockSnapshot(kQueueVisibleGUIFrontObject);
 	return object;
 }
 
 Renderable *GraphicsManager::getWorldObjectAt(float x, float y) const {
-	if (QueueMan.isQueueEmpty(kQueueVisibleWorldObject))
-		return 0;
-
 	float x1, y1, z1, x2, y2, z2;
 	if (!unproject(x, y, x1, y1, z1, x2, y2, z2))
 		return 0;
 
-	Renderable *object = 0;
-
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const float start[3] = { x1, y1, z1 };
+	const float end  [3] = { x2, y2, z2 };
 
-	for (std::list<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
-		Renderable &r = static_cast<Renderable &>(**o);
+	// Find the nearest clickable object the line intersects with
+	std::lock_guard<std::mutex> lock(_pickMutex);
 
-		if (!r.isClickable())
-			// Object isn't clickable, don't check
-			continue;
-
-		// If the line intersects with the object, return it
-		if (r.isIn(x1, y1, z1, x2, y2, z2)) {
-			object = &r;
-			break;
-		}
-	}
-
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
-	return object;
+	return static_cast<Renderable *>(_pickTree.raycast(start, end, PickTest(start, end)));
 }
 
 Renderable *GraphicsManager::getObjectAt(float x, float y) {
@@ -937,30 +963,28 @@ Renderable *GraphicsManager::getObjectAt(float x, float y) {
 }
 
 void GraphicsManager::buildNewTextures() {
-	QueueMan.lockQueue(kQueueNewShader);
-	const std::list<Queueable *> &shadq = QueueMan.getQueue(kQueueNewShader);
-	if (shadq.empty()) {
-		QueueMan.unlockQueue(kQueueNewShader);
-	} else {
-		for (std::list<Queueable *>::const_iterator t = shadq.begin(); t != shadq.end(); ++t)
+	/* Only kick out the objects we've rebuilt. Objects added in the meantime stay
+	 * in the queue, for the next frame. Like lockSnapshot(), this locks the queue
+	 * while holding its snapshot, never the other way round. */
+
+	if (!QueueMan.isQueueEmpty(kQueueNewShader)) {
+		const std::vector<Queueable *> &shadq = QueueMan.lockSnapshot(kQueueNewShader);
+		for (std::vector<Queueable *>::const_iterator t = shadq.begin(); t != shadq.end(); ++t)
 			static_cast<GLContainer *>(*t)->rebuild();
 
-		QueueMan.clearQueue(kQueueNewShader);
-		QueueMan.unlockQueue(kQueueNewShader);
+		QueueMan.clearQueue(kQueueNewShader, shadq);
+		QueueMan.unlockSnapshot(kQueueNewShader);
 	}
 
-	QueueMan.lockQueue(kQueueNewTexture);
-	const std::list<Queueable *> &text = QueueMan.getQueue(kQueueNewTexture);
-	if (text.empty()) {
-		QueueMan.unlockQueue(kQueueNewTexture);
+	if (QueueMan.isQueueEmpty(kQueueNewTexture))
 		return;
-	}
 
-	for (std::list<Queueable *>::const_iterator t = text.begin(); t != text.end(); ++t)
+	const std::vector<Queueable *> &text = QueueMan.lockSnapshot(kQueueNewTexture);
+	for (std::vector<Queueable *>::const_iterator t = text.begin(); t != text.end(); ++t)
 		static_cast<GLContainer *>(*t)->rebuild();
 
-	QueueMan.clearQueue(kQueueNewTexture);
-	QueueMan.unlockQueue(kQueueNewTexture);
+	QueueMan.clearQueue(kQueueNewTexture, text);
+	QueueMan.unlockSnapshot(kQueueNewTexture);
 }
 
 void GraphicsManager::beginScene() {
@@ -986,16 +1010,15 @@ bool GraphicsManager::playVideo() {
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
-	QueueMan.lockQueue(kQueueVisibleVideo);
-	const std::list<Queueable *> &videos = QueueMan.getQueue(kQueueVisibleVideo);
+	const std::vector<Queueable *> &videos = QueueMan.lockSnapshot(kQueueVisibleVideo);
 
-	for (std::list<Queueable *>::const_iterator v = videos.begin(); v != videos.end(); ++v) {
+	for (std::vector<Queueable *>::const_iterator v = videos.begin(); v != videos.end(); ++v) {
 		glPushMatrix();
 		static_cast<Renderable *>(*v)->render(kRenderPassAll);
 		glPopMatrix();
 	}
 
-	QueueMan.unlockQueue(kQueueVisibleVideo);
+	QueueMan.unlockSnapshot(kQueueVisibleVideo);
 	return true;
 }
 
@@ -1033,35 +1056,71 @@ bool GraphicsManager::renderWorld() {
 	_modelview = glm::rotate(_modelview, Common::deg2rad(-cOrient[2]), glm::vec3(0.0f, 0.0f, 1.0f));
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const std::vector<Queueable *> &objects = QueueMan.lockSnapshot(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
+	cullWorldObjects(objects);
+
 	// Draw opaque objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_iterator o = _visibleWorldObjects.begin();
+	     o != _visibleWorldObjects.end(); ++o) {
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassOpaque);
+		(*o)->render(kRenderPassOpaque);
 		glPopMatrix();
 	}
 
 	// Draw transparent objects
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
+	for (std::vector<Renderable *>::const_iterator o = _visibleWorldObjects.begin();
+	     o != _visibleWorldObjects.end(); ++o) {
 
 		glPushMatrix();
-		static_cast<Renderable *>(*o)->render(kRenderPassTransparent);
+		(*o)->render(kRenderPassTransparent);
 		glPopMatrix();
 	}
 
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
+	QueueMan.unlockSnapshot(kQueueVisibleWorldObject);
 	return true;
 }
 
+void GraphicsManager::cullWorldObjects(const std::vector<Queueable *> &objects) {
+	_visibleWorldObjects.clear();
+
+	bool culling;
+	float cullDistance;
+	{
+		std::lock_guard<std::mutex> lock(_cullMutex);
+
+		culling      = _culling;
+		cullDistance = _cullDistance;
+	}
+
+	if (culling) {
+		_frustum.set(_projection, _modelview);
+		_frustum.setMaxDistance(cullDistance);
+	} else
+		_frustum.clear();
+
+	for (std::vector<Queueable *>::const_reverse_iterator o = objects.rbegin();
+	     o != objects.rend(); ++o) {
+
+		Renderable *object = static_cast<Renderable *>(*o);
+
+		const Common::BoundingBox *bound = object->getWorldBound();
+		if (!bound || _frustum.isIn(*bound))
+			_visibleWorldObjects.push_back(object);
+	}
+
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	_cullStats.frames++;
+	_cullStats.objects += objects.size();
+	_cullStats.culled  += objects.size() - _visibleWorldObjects.size();
+}
+
 bool GraphicsManager::renderGUIFront() {
 	return renderGUI(_scalingType, kQueueVisibleGUIFrontObject, false);
 }
@@ -1097,12 +1156,11 @@ bool GraphicsManager::renderGUI(ScalingType scalingType, QueueType guiQueue, boo
 	glMatrixMode(GL_MODELVIEW);
 	glLoadIdentity();
 
-	QueueMan.lockQueue(guiQueue);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(guiQueue);
+	const std::vector<Queueable *> &gui = QueueMan.lockSnapshot(guiQueue);
 
 	buildNewTextures();
 
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
+	for (std::vector<Queueable *>::const_reverse_iterator g = gui.rbegin();
 	     g != gui.rend(); ++g) {
 
 		glPushMatrix();
@@ -1110,7 +1168,7 @@ bool GraphicsManager::renderGUI(ScalingType scalingType, QueueType guiQueue, boo
 		glPopMatrix();
 	}
 
-	QueueMan.unlockQueue(guiQueue);
+	QueueMan.unlockSnapshot(guiQueue);
 
 	if (disableDepthMask)
 		glDepthMask(GL_TRUE);
@@ -1160,23 +1218,24 @@ bool GraphicsManager::renderWorldShader() {
 	_modelview = glm::rotate(_modelview, Common::deg2rad(-cOrient[2]), glm::vec3(0.0f, 0.0f, 1.0f));
 	_modelview = glm::translate(_modelview, glm::vec3(-cPos[0], -cPos[1], -cPos[2]));
 
-	QueueMan.lockQueue(kQueueVisibleWorldObject);
-	const std::list<Queueable *> &objects = QueueMan.getQueue(kQueueVisibleWorldObject);
+	const std::vector<Queueable *> &objects = QueueMan.lockSnapshot(kQueueVisibleWorldObject);
 
 	buildNewTextures();
 
 	_animationThread.flush();
 
+	cullWorldObjects(objects);
+
 	glm::mat4 ident;
 	RenderMan.clear();
-	for (std::list<Queueable *>::const_reverse_iterator o = objects.rbegin();
-	     o != objects.rend(); ++o) {
-		static_cast<Renderable *>(*o)->queueRender(ident);
+	for (std::vector<Renderable *>::const_iterator o = _visibleWorldObjects.begin();
+	     o != _visibleWorldObjects.end(); ++o) {
+		(*o)->queueRender(ident);
 	}
 	RenderMan.sort();
 	RenderMan.render();
 
-	QueueMan.unlockQueue(kQueueVisibleWorldObject);
+	QueueMan.unlockSnapshot(kQueueVisibleWorldObject);
 	return true;
 }
 
@@ -1203,19 +1262,18 @@ bool GraphicsManager::renderGUIShader(ScalingType UNUSED(scalingType), QueueType
 	_projection = _ortho;
 	_projectionInv = _orthoInv;
 
-	QueueMan.lockQueue(guiQueue);
-	const std::list<Queueable *> &gui = QueueMan.getQueue(guiQueue);
+	const std::vector<Queueable *> &gui = QueueMan.lockSnapshot(guiQueue);
 	_modelview = glm::mat4();
 
 	buildNewTextures();
 
 	glm::mat4 ident;
-	for (std::list<Queueable *>::const_reverse_iterator g = gui.rbegin();
+	for (std::vector<Queueable *>::const_reverse_iterator g = gui.rbegin();
 	     g != gui.rend(); ++g) {
 		static_cast<Renderable *>(*g)->renderImmediate(ident);
 	}
 
-	QueueMan.unlockQueue(guiQueue);
+	QueueMan.unlockSnapshot(guiQueue);
 
 	if (disableDepthMask)
 		glDepthMask(GL_TRUE);
@@ -1337,28 +1395,127 @@ void GraphicsManager::unregisterAnimatedModel(Aurora::Model *model) {
 	_animationThread.unregisterModel(model);
 }
 
+Aurora::AnimationThread::Stats GraphicsManager::getAnimationStats() const {
+	return _animationThread.getStats();
+}
+
+void GraphicsManager::resetAnimationStats() {
+	_animationThread.resetStats();
+}
+
+bool GraphicsManager::isCullingEnabled() const {
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	return _culling;
+}
+
+void GraphicsManager::setCulling(bool enabled) {
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	_culling = enabled;
+}
+
+float GraphicsManager::getCullDistance() const {
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	return _cullDistance;
+}
+
+void GraphicsManager::setCullDistance(float distance) {
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	_cullDistance = MAX(distance, 0.0f);
+}
+
+void GraphicsManager::addPickable(Renderable *object) {
+	std::lock_guard<std::mutex> lock(_pickMutex);
+
+	if (_pickables.find(object) != _pickables.end())
+		return;
+
+	_pickables.insert(std::make_pair(object, Common::AABBTree::kEntryNone));
+
+	updatePickableEntry(object, _pickables.find(object)->second);
+}
+
+void GraphicsManager::removePickable(Renderable *object) {
+	std::lock_guard<std::mutex> lock(_pickMutex);
+
+	PickableMap::iterator p = _pickables.find(object);
+	if (p == _pickables.end())
+		return;
+
+	if (p->second != Common::AABBTree::kEntryNone)
+		_pickTree.remove(p->second);
+
+	_pickables.erase(p);
+}
+
+void GraphicsManager::updatePickable(Renderable *object) {
+	std::lock_guard<std::mutex> lock(_pickMutex);
+
+	PickableMap::iterator p = _pickables.find(object);
+	if (p == _pickables.end())
+		return;
+
+	updatePickableEntry(object, p->second);
+}
+
+void GraphicsManager::updatePickableEntry(Renderable *object, Common::AABBTree::EntryID &entry) {
+	const Common::BoundingBox *bound = object->getWorldBound();
+
+	if (!bound || bound->empty()) {
+		if (entry != Common::AABBTree::kEntryNone)
+			_pickTree.remove(entry);
+
+		entry = Common::AABBTree::kEntryNone;
+		return;
+	}
+
+	float min[3], max[3];
+	bound->getMin(min[0], min[1], min[2]);
+	bound->getMax(max[0], max[1], max[2]);
+
+	if (entry == Common::AABBTree::kEntryNone)
+		entry = _pickTree.add(min, max, object);
+	else
+		_pickTree.update(entry, min, max);
+}
+
+GraphicsManager::CullStats GraphicsManager::getCullStats(bool reset) {
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	const CullStats stats = _cullStats;
+	if (reset)
+		_cullStats = CullStats();
+
+	return stats;
+}
+
+void GraphicsManager::resetCullStats() {
+	std::lock_guard<std::mutex> lock(_cullMutex);
+
+	_cullStats = CullStats();
+}
+
 bool GraphicsManager::isGL3() const {
 	return _renderType == WindowManager::kOpenGL32Compat;
 }
 
 void GraphicsManager::rebuildGLContainers() {
-	QueueMan.lockQueue(kQueueGLContainer);
-
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
+	const std::vector<Queueable *> &cont = QueueMan.lockSnapshot(kQueueGLContainer);
+	for (std::vector<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
 		static_cast<GLContainer *>(*c)->rebuild();
 
-	QueueMan.unlockQueue(kQueueGLContainer);
+	QueueMan.unlockSnapshot(kQueueGLContainer);
 }
 
 void GraphicsManager::destroyGLContainers() {
-	QueueMan.lockQueue(kQueueGLContainer);
-
-	const std::list<Queueable *> &cont = QueueMan.getQueue(kQueueGLContainer);
-	for (std::list<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
+	const std::vector<Queueable *> &cont = QueueMan.lockSnapshot(kQueueGLContainer);
+	for (std::vector<Queueable *>::const_iterator c = cont.begin(); c != cont.end(); ++c)
 		static_cast<GLContainer *>(*c)->destroy();
 
-	QueueMan.unlockQueue(kQueueGLContainer);
+	QueueMan.unlockSnapshot(kQueueGLContainer);
 }
 
 void GraphicsManager::destroyContext() {
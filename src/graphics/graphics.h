@@ -28,6 +28,7 @@
 #include <vector>
 #include <list>
 #include <atomic>
+#include <unordered_map>
 
 #include "external/glm/mat4x4.hpp"
 
@@ -36,6 +37,8 @@
 #include "src/common/singleton.h"
 #include "src/common/ustring.h"
 #include "src/common/mutex.h"
+#include "src/common/frustum.h"
+#include "src/common/aabbtree.h"
 
 #include "src/graphics/types.h"
 #include "src/graphics/windowman.h"
@@ -53,6 +56,7 @@ namespace Aurora {
 class FPSCounter;
 class Cursor;
 class Renderable;
+class Queueable;
 
 /** The graphics manager. */
 class GraphicsManager : public Common::Singleton<GraphicsManager>, public Events::Notifyable {
@@ -182,6 +186,47 @@ public:
 	/** Unregister a model from the animation thread. */
 	void unregisterAnimatedModel(Aurora::Model *model);
 
+	/** Return statistics about updating the animations, since the last reset. */
+	Aurora::AnimationThread::Stats getAnimationStats() const;
+	/** Reset the statistics about updating the animations. */
+	void resetAnimationStats();
+
+	/** Statistics about culling world objects. */
+	struct CullStats {
+		uint64 frames;  ///< Number of frames with world objects.
+		uint64 objects; ///< Number of world objects considered.
+		uint64 culled;  ///< Number of world objects culled.
+
+		CullStats() : frames(0), objects(0), culled(0) {
+		}
+	};
+
+	/** Is culling world objects outside the camera's view enabled? */
+	bool isCullingEnabled() const;
+	/** Enable or disable culling world objects outside the camera's view. */
+	void setCulling(bool enabled);
+
+	/** Return the distance beyond which world objects are culled, 0.0f for no limit. */
+	float getCullDistance() const;
+	/** Set the distance beyond which world objects are culled, 0.0f for no limit. */
+	void setCullDistance(float distance);
+
+	/** Return statistics about culling world objects, since the last reset.
+	 *
+	 *  If reset is true, the statistics are reset in the same step, so that
+	 *  no frames rendered in between go uncounted.
+	 */
+	CullStats getCullStats(bool reset = false);
+	/** Reset the statistics about culling world objects. */
+	void resetCullStats();
+
+	/** Add a visible world object to the objects that can be picked. */
+	void addPickable(Renderable *object);
+	/** Remove a world object from the objects that can be picked. */
+	void removePickable(Renderable *object);
+	/** Update a pickable world object after its bounding box changed. */
+	void updatePickable(Renderable *object);
+
 private:
 	enum ProjectType {
 		kProjectTypePerspective,
@@ -248,6 +293,30 @@ private:
 
 	Aurora::AnimationThread _animationThread;
 
+	bool  _culling;      ///< Cull world objects outside the camera's view?
+	float _cullDistance; ///< Cull world objects further away than this, if > 0.
+
+	Common::Frustum _frustum;  ///< The camera's view frustum, for culling.
+	CullStats       _cullStats;
+
+	/** A mutex protecting the culling settings and statistics.
+	 *
+	 *  They are used by the render thread, but changed and read through
+	 *  the console from the engine thread.
+	 */
+	mutable std::mutex _cullMutex;
+
+	/** The world objects to render in the current frame. */
+	std::vector<Renderable *> _visibleWorldObjects;
+
+	/** The entries of the pickable world objects in the pick tree, kEntryNone without a bounding box. */
+	typedef std::unordered_map<Renderable *, Common::AABBTree::EntryID> PickableMap;
+
+	Common::AABBTree _pickTree;  ///< The pickable world objects, by their bounding boxes.
+	PickableMap      _pickables;
+
+	mutable std::mutex _pickMutex; ///< A mutex protecting the pickable world objects.
+
 	void setupScene();
 
 	bool setupSDLGL();
@@ -271,10 +340,16 @@ private:
 	Renderable *getGUIObjectAt(float x, float y) const;
 	Renderable *getWorldObjectAt(float x, float y) const;
 
+	/** Add, update or remove the entry of a pickable world object in the pick tree. */
+	void updatePickableEntry(Renderable *object, Common::AABBTree::EntryID &entry);
+
 	void buildNewTextures();
 
 	void beginScene();
 	bool playVideo();
+	/** Collect the world objects within the camera's view into _visibleWorldObjects. */
+	void cullWorldObjects(const std::vector<Queueable *> &objects);
+
 	bool renderWorld();
 	bool renderGUIFront();
 	bool renderGUIBack();
@@ -22,46 +22,32 @@
  *  An object that can be stored in a queue.
  */
 
-#include "src/common/system.h"
-
 #include "src/graphics/queueman.h"
 #include "src/graphics/queueable.h"
 
 namespace Graphics {
 
 Queueable::Queueable() {
-	for (int i = 0; i < kQueueMAX; i++)
+	for (int i = 0; i < kQueueMAX; i++) {
 		_isInQueue[i] = false;
+		_queueSlot[i] = 0;
+	}
 }
 
 Queueable::~Queueable() {
 	removeFromAll();
 }
 
-bool Queueable::operator<(const Queueable &UNUSED(q)) const {
-	return false;
+float Queueable::getSortKey() const {
+	return 0.0f;
 }
 
 void Queueable::addToQueue(QueueType queue) {
-	QueueMan.lockQueue(queue);
-
-	if (!_isInQueue[queue]) {
-		_queueRef[queue] = QueueMan.addToQueue(queue, *this);
-		_isInQueue[queue] = true;
-	}
-
-	QueueMan.unlockQueue(queue);
+	QueueMan.addToQueue(queue, *this);
 }
 
 void Queueable::removeFromQueue(QueueType queue) {
-	QueueMan.lockQueue(queue);
-
-	if (_isInQueue[queue]) {
-		QueueMan.removeFromQueue(queue, _queueRef[queue]);
-		_isInQueue[queue] = false;
-	}
-
-	QueueMan.unlockQueue(queue);
+	QueueMan.removeFromQueue(queue, *this);
 }
 
 void Queueable::lockQueue(QueueType queue) {
@@ -73,9 +59,7 @@ void Queueable::unlockQueue(QueueType queue) {
 }
 
 void Queueable::sortQueue(QueueType queue) {
-	QueueMan.lockQueue(queue);
 	QueueMan.sortQueue(queue);
-	QueueMan.unlockQueue(queue);
 }
 
 void Queueable::removeFromAll() {
@@ -84,11 +68,7 @@ void Queueable::removeFromAll() {
 }
 
 void Queueable::kickedOut(QueueType queue) {
-	QueueMan.lockQueue(queue);
-
 	_isInQueue[queue] = false;
-
-	QueueMan.unlockQueue(queue);
 }
 
 } // End of namespace Graphics
@@ -25,8 +25,6 @@
 #ifndef GRAPHICS_QUEUEABLE_H
 #define GRAPHICS_QUEUEABLE_H
 
-#include <list>
-
 #include "src/graphics/types.h"
 
 namespace Graphics {
@@ -36,7 +34,8 @@ public:
 	Queueable();
 	virtual ~Queueable();
 
-	virtual bool operator<(const Queueable &q) const;
+	/** Return the key this object is sorted by in its queues. Lower keys come first. */
+	virtual float getSortKey() const;
 
 protected:
 	bool isInQueue(QueueType queue) const {
@@ -52,7 +51,7 @@ protected:
 
 private:
 	bool _isInQueue[kQueueMAX];
-	std::list<Queueable *>::iterator _queueRef[kQueueMAX];
+	size_t _queueSlot[kQueueMAX]; ///< The slot in each queue's entries.
 
 	void removeFromAll();
 	void kickedOut(QueueType queue);
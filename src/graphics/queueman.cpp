@@ -22,6 +22,9 @@
  *  The graphics queue manager.
  */
 
+#include <cassert>
+#include <cstring>
+
 #include "src/graphics/queueman.h"
 #include "src/graphics/queueable.h"
 
@@ -29,8 +32,24 @@ DECLARE_SINGLETON(Graphics::QueueManager)
 
 namespace Graphics {
 
-static bool queueComp(Queueable *a, Queueable *b) {
-	return *a < *b;
+/** Below this many objects, an insertion sort is faster than the radix sort. */
+static const size_t kRadixSortMin = 64;
+
+static const uint   kRadixBits    = 11;
+static const uint   kRadixPasses  = 3;
+static const size_t kRadixBuckets = 1 << kRadixBits;
+
+/** Map a float onto an unsigned integer with the same ordering. */
+static uint32 getRadixKey(float value) {
+	uint32 bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	// Negative numbers have all their bits flipped, positive ones only the sign
+	return (bits & 0x80000000) ? ~bits : (bits | 0x80000000);
+}
+
+
+QueueManager::Queue::Queue() : removed(0), needSort(false), snapshotLocks(0) {
 }
 
 
@@ -42,62 +61,127 @@ QueueManager::~QueueManager() {
 }
 
 void QueueManager::lockQueue(QueueType queue) {
-	_queueMutex[queue].lock();
+	_queues[queue].mutex.lock();
 }
 
 void QueueManager::unlockQueue(QueueType queue) {
-	_queueMutex[queue].unlock();
+	_queues[queue].mutex.unlock();
 }
 
 bool QueueManager::isQueueEmpty(QueueType queue) {
-	std::lock_guard<std::recursive_mutex> lock(_queueMutex[queue]);
+	std::lock_guard<std::recursive_mutex> lock(_queues[queue].mutex);
 
-	return _queue[queue].empty();
+	return _queues[queue].entries.size() == _queues[queue].removed;
 }
 
-const std::list<Queueable *> &QueueManager::getQueue(QueueType queue) const {
-	return _queue[queue];
+const std::vector<Queueable *> &QueueManager::lockSnapshot(QueueType queue) {
+	Queue &q = _queues[queue];
+
+	// Taking this lock first makes every removal after the copy wait for unlockSnapshot()
+	q.snapshotMutex.lock();
+	if (q.snapshotLocks++ > 0)
+		return q.snapshot;
+
+	std::lock_guard<std::recursive_mutex> lock(q.mutex);
+
+	if (q.needSort)
+		sort(q, queue);
+	else if (q.removed > 0)
+		compact(q, queue);
+
+	q.snapshot.resize(q.entries.size());
+	for (size_t i = 0; i < q.entries.size(); i++)
+		q.snapshot[i] = q.entries[i].object;
+
+	return q.snapshot;
 }
 
-void QueueManager::sortQueue(QueueType queue) {
-	lockQueue(queue);
+void QueueManager::unlockSnapshot(QueueType queue) {
+	Queue &q = _queues[queue];
 
-	_queue[queue].sort(queueComp);
+	assert(q.snapshotLocks > 0);
 
-	unlockQueue(queue);
+	q.snapshotLocks--;
+	q.snapshotMutex.unlock();
 }
 
-std::list<Queueable *>::iterator QueueManager::addToQueue(QueueType queue, Queueable &q) {
-	lockQueue(queue);
+void QueueManager::sortQueue(QueueType queue) {
+	std::lock_guard<std::recursive_mutex> lock(_queues[queue].mutex);
+
+	_queues[queue].needSort = true;
+}
+
+void QueueManager::addToQueue(QueueType queue, Queueable &object) {
+	Queue &q = _queues[queue];
 
-	_queue[queue].push_back(&q);
-	std::list<Queueable *>::iterator ref = --_queue[queue].end();
+	std::lock_guard<std::recursive_mutex> lock(q.mutex);
 
-	unlockQueue(queue);
+	if (object._isInQueue[queue])
+		return;
 
-	return ref;
+	Entry entry;
+	entry.key    = 0;
+	entry.object = &object;
+
+	object._queueSlot[queue] = q.entries.size();
+	object._isInQueue[queue] = true;
+
+	q.entries.push_back(entry);
 }
 
-void QueueManager::removeFromQueue(QueueType queue,
-		const std::list<Queueable *>::iterator &ref) {
+void QueueManager::removeFromQueue(QueueType queue, Queueable &object) {
+	Queue &q = _queues[queue];
+
+	{
+		std::lock_guard<std::recursive_mutex> lock(q.mutex);
 
-	lockQueue(queue);
+		if (!object._isInQueue[queue])
+			return;
 
-	_queue[queue].erase(ref);
+		q.entries[object._queueSlot[queue]].object = 0;
+		object._isInQueue[queue] = false;
 
-	unlockQueue(queue);
+		// Don't let queues that are never snapshotted fill up with empty slots
+		if (++q.removed > (q.entries.size() / 2))
+			compact(q, queue);
+	}
+
+	// The object might be part of a snapshot that's currently in use. Wait until it isn't
+	std::lock_guard<std::recursive_mutex> lock(q.snapshotMutex);
 }
 
 void QueueManager::clearQueue(QueueType queue) {
-	lockQueue(queue);
+	Queue &q = _queues[queue];
+
+	std::lock_guard<std::recursive_mutex> lock(q.mutex);
+
+	for (std::vector<Entry>::iterator e = q.entries.begin(); e != q.entries.end(); ++e)
+		if (e->object)
+			e->object->kickedOut(queue);
+
+	q.entries.clear();
+
+	q.removed  = 0;
+	q.needSort = false;
+}
 
-	for (std::list<Queueable *>::iterator q = _queue[queue].begin();
-	     q != _queue[queue].end(); ++q)
-		(*q)->kickedOut(queue);
+void QueueManager::clearQueue(QueueType queue, const std::vector<Queueable *> &objects) {
+	Queue &q = _queues[queue];
 
-	_queue[queue].clear();
+	std::lock_guard<std::recursive_mutex> lock(q.mutex);
 
-	unlockQueue(queue);
+	for (std::vector<Queueable *>::const_iterator o = objects.begin(); o != objects.end(); ++o) {
+		if (!(*o)->_isInQueue[queue])
+			continue;
+
+		q.entries[(*o)->_queueSlot[queue]].object = 0;
+		(*o)->kickedOut(queue);
+
+		q.removed++;
+	}
+
+	if (q.removed > (q.entries.size() / 2))
+		compact(q, queue);
 }
 
 void QueueManager::clearAllQueues() {
@@ -105,4 +189,80 @@ void QueueManager::clearAllQueues() {
 		clearQueue((QueueType) i);
 }
 
+void QueueManager::compact(Queue &queue, QueueType type) {
+	size_t count = 0;
+
+	for (size_t i = 0; i < queue.entries.size(); i++) {
+		if (!queue.entries[i].object)
+			continue;
+
+		queue.entries[i].object->_queueSlot[type] = count;
+		queue.entries[count++] = queue.entries[i];
+	}
+
+	queue.entries.resize(count);
+	queue.removed = 0;
+}
+
+void QueueManager::sort(Queue &queue, QueueType type) {
+	compact(queue, type);
+
+	queue.needSort = false;
+
+	std::vector<Entry> &entries = queue.entries;
+	const size_t count = entries.size();
+
+	for (size_t i = 0; i < count; i++)
+		entries[i].key = getRadixKey(entries[i].object->getSortKey());
+
+	if (count < kRadixSortMin) {
+		// Stable insertion sort
+		for (size_t i = 1; i < count; i++) {
+			const Entry entry = entries[i];
+
+			size_t j = i;
+			for (; (j > 0) && (entries[j - 1].key > entry.key); j--)
+				entries[j] = entries[j - 1];
+
+			entries[j] = entry;
+		}
+
+	} else {
+		// LSD radix sort, with the histograms of all passes counted up front
+		uint32 histograms[kRadixPasses][kRadixBuckets];
+		std::memset(histograms, 0, sizeof(histograms));
+
+		for (size_t i = 0; i < count; i++)
+			for (uint pass = 0; pass < kRadixPasses; pass++)
+				histograms[pass][(entries[i].key >> (pass * kRadixBits)) & (kRadixBuckets - 1)]++;
+
+		queue.sorted.resize(count);
+
+		for (uint pass = 0; pass < kRadixPasses; pass++) {
+			uint32 *histogram = histograms[pass];
+			const uint shift  = pass * kRadixBits;
+
+			// All keys have the same digit, so this pass wouldn't change anything
+			if (histogram[(entries[0].key >> shift) & (kRadixBuckets - 1)] == count)
+				continue;
+
+			uint32 offset = 0;
+			for (size_t i = 0; i < kRadixBuckets; i++) {
+				const uint32 bucketSize = histogram[i];
+
+				histogram[i] = offset;
+				offset += bucketSize;
+			}
+
+			for (size_t i = 0; i < count; i++)
+				queue.sorted[histogram[(entries[i].key >> shift) & (kRadixBuckets - 1)]++] = entries[i];
+
+			entries.swap(queue.sorted);
+		}
+	}
+
+	for (size_t i = 0; i < count; i++)
+		entries[i].object->_queueSlot[type] = i;
+}
+
 } // End of namespace Graphics
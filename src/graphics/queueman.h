@@ -25,7 +25,7 @@
 #ifndef GRAPHICS_QUEUEMAN_H
 #define GRAPHICS_QUEUEMAN_H
 
-#include <list>
+#include <vector>
 
 #include "src/common/types.h"
 #include "src/common/singleton.h"
@@ -37,7 +37,23 @@ namespace Graphics {
 
 class Queueable;
 
-/** The graphics queue manager. */
+/** The graphics queue manager.
+ *
+ *  Every queue is a contiguous array of (sort key, object) entries. An object
+ *  remembers the slot it occupies in each of its queues, so removing it only
+ *  clears that slot. The holes are squeezed out, keeping the order of the
+ *  remaining objects, the next time the queue is sorted or snapshotted, or
+ *  once they make up half of the queue.
+ *
+ *  Sorting a queue only marks it as unsorted. The actual sort, a radix sort
+ *  on the objects' sort keys, is done when the next snapshot is taken.
+ *
+ *  To iterate over a queue, take a snapshot of it with lockSnapshot(). This
+ *  copies the objects into a separate array, so the queue lock is only held
+ *  for that copy, and objects can be added to the queue while the snapshot
+ *  is in use. Removing an object from the queue, however, waits until the
+ *  snapshot is unlocked again, so that objects in the snapshot stay alive.
+ */
 class QueueManager : public Common::Singleton<QueueManager> {
 public:
 	QueueManager();
@@ -48,19 +64,56 @@ public:
 	void lockQueue(QueueType queue);
 	void unlockQueue(QueueType queue);
 
-	const std::list<Queueable *> &getQueue(QueueType queue) const;
-
+	/** Lock the snapshot of a queue, and fill it with the objects currently in the queue.
+	 *
+	 *  The snapshot is valid until unlockSnapshot() is called. Only one thread
+	 *  at a time can hold the snapshot of a queue. Locking it again from the
+	 *  same thread returns the same snapshot, unchanged. Don't call this while
+	 *  holding a lock on a different queue that another thread might want to
+	 *  remove objects from.
+	 */
+	const std::vector<Queueable *> &lockSnapshot(QueueType queue);
+	void unlockSnapshot(QueueType queue);
+
+	/** Sort the queue by the objects' sort keys, once the next snapshot is taken. */
 	void sortQueue(QueueType queue);
 	void clearQueue(QueueType queue);
+	/** Kick these objects, like those of a snapshot, out of the queue, leaving any others in it. */
+	void clearQueue(QueueType queue, const std::vector<Queueable *> &objects);
 
 	void clearAllQueues();
 
 private:
-	std::recursive_mutex _queueMutex[kQueueMAX];
-	std::list<Queueable *> _queue[kQueueMAX];
+	struct Entry {
+		uint32 key;         ///< The radix sort key. Only valid while sorting.
+		Queueable *object;  ///< The object in this slot, or 0 if it was removed.
+	};
+
+	struct Queue {
+		std::vector<Entry> entries; ///< All slots, including removed ones.
+		std::vector<Entry> sorted;  ///< Scratch space for sorting.
+
+		size_t removed;  ///< Number of slots whose objects have been removed.
+		bool needSort;   ///< Does the queue need to be sorted before the next snapshot?
+
+		std::vector<Queueable *> snapshot; ///< The objects in the queue, as of the last snapshot.
+		size_t snapshotLocks;              ///< How often the snapshot is locked.
+
+		std::recursive_mutex mutex;         ///< Protects the entries.
+		std::recursive_mutex snapshotMutex; ///< Held while the snapshot is in use.
+
+		Queue();
+	};
+
+	Queue _queues[kQueueMAX];
+
+	void addToQueue(QueueType queue, Queueable &object);
+	void removeFromQueue(QueueType queue, Queueable &object);
 
-	std::list<Queueable *>::iterator addToQueue(QueueType queue, Queueable &q);
-	void removeFromQueue(QueueType queue, const std::list<Queueable *>::iterator &ref);
+	/** Remove the empty slots from a queue, keeping the order of the objects. */
+	void compact(Queue &queue, QueueType type);
+	/** Radix sort the objects in the queue by their sort keys. */
+	void sort(Queue &queue, QueueType type);
 
 	friend class Queueable;
 };
@@ -68,6 +121,6 @@ private:
 } // End of namespace Graphics
 
 /** Shortcut for accessing the graphics queue manager. */
-#define QueueMan QueueManager::instance()
+#define QueueMan Graphics::QueueManager::instance()
 
 #endif // GRAPHICS_QUEUEMAN_H
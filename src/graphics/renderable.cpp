@@ -72,8 +72,8 @@ Renderable::~Renderable() {
 	removeFromQueue(_queueExists);
 }
 
-bool Renderable::operator<(const Queueable &q) const {
-	return _distance < static_cast<const Renderable &>(q)._distance;
+float Renderable::getSortKey() const {
+	return _distance;
 }
 
 void Renderable::advanceTime(float UNUSED(dt)) {
@@ -111,6 +111,11 @@ void Renderable::resort() {
 	sortQueue(_queueVisible);
 }
 
+void Renderable::notifyWorldBoundChanged() {
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.updatePickable(this);
+}
+
 void Renderable::show() {
 	lockQueue(_queueVisible);
 
@@ -118,9 +123,15 @@ void Renderable::show() {
 	sortQueue(_queueVisible);
 
 	unlockQueue(_queueVisible);
+
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.addPickable(this);
 }
 
 void Renderable::hide() {
+	if (_queueVisible == kQueueVisibleWorldObject)
+		GfxMan.removePickable(this);
+
 	removeFromQueue(_queueVisible);
 }
 
@@ -138,6 +149,10 @@ bool Renderable::isIn(float UNUSED(x1), float UNUSED(y1), float UNUSED(z1),
 	return false;
 }
 
+const Common::BoundingBox *Renderable::getWorldBound() const {
+	return 0;
+}
+
 void Renderable::lockFrame() {
 	GfxMan.lockFrame();
 }
@@ -36,6 +36,10 @@
 #include "src/graphics/types.h"
 #include "src/graphics/queueable.h"
 
+namespace Common {
+	class BoundingBox;
+}
+
 namespace Graphics {
 
 /** An object that can be displayed by the graphics manager. */
@@ -44,7 +48,8 @@ public:
 	Renderable(RenderableType type);
 	~Renderable();
 
-	bool operator<(const Queueable &q) const;
+	/** Renderables are sorted by their distance. */
+	float getSortKey() const;
 
 	/** Calculate the object's distance. */
 	virtual void calculateDistance() = 0;
@@ -89,6 +94,13 @@ public:
 	/** Does the line from x1.y1.z1 to x2.y2.z2 intersect with the object? */
 	virtual bool isIn(float x1, float y1, float z1, float x2, float y2, float z2) const;
 
+	/** Return the object's bounding box in world coordinates, or 0 if it doesn't have one.
+	 *
+	 *  Used to cull world objects that are out of view. Objects without a
+	 *  bounding box, or with an empty one, are never culled.
+	 */
+	virtual const Common::BoundingBox *getWorldBound() const;
+
 protected:
 	QueueType _queueExists;
 	QueueType _queueVisible;
@@ -102,6 +114,9 @@ protected:
 
 	void resort();
 
+	/** Tell the graphics manager that the world bounding box of the object changed. */
+	void notifyWorldBoundChanged();
+
 	void lockFrame();
 	void unlockFrame();
 
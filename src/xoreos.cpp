@@ -46,6 +46,7 @@
 #endif
 
 #include "src/aurora/resman.h"
+#include "src/aurora/resref.h"
 #include "src/aurora/2dareg.h"
 #include "src/aurora/language.h"
 #include "src/aurora/talkman.h"
@@ -343,6 +344,7 @@ static void deinit() {
 	Aurora::TalkManager::destroy();
 	Aurora::TwoDARegistry::destroy();
 	Aurora::ResourceManager::destroy();
+	Aurora::ResRefManager::destroy();
 	Aurora::FileTypeManager::destroy();
 
 	Aurora::NWScript::ObjectManager::destroy();
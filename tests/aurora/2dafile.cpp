@@ -155,6 +155,79 @@ GTEST_TEST(TwoDAFileASCII, getRow) {
 	EXPECT_EQ(&twoda.getRow("ID"  , "Nope"), &twoda.getRow(Aurora::kFieldIDInvalid));
 }
 
+GTEST_TEST(TwoDAFileASCII, getRowIgnoreCase) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	EXPECT_EQ(&twoda.getRow("StringValue", "FOOBAR"), &twoda.getRow(0));
+	EXPECT_EQ(&twoda.getRow("StringValue", "barfoo"), &twoda.getRow(1));
+	EXPECT_EQ(&twoda.getRow("StringValue", "tEsT5" ), &twoda.getRow(10));
+}
+
+GTEST_TEST(TwoDAFileASCII, getRowFirstMatch) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	// Rows 2 and 5 both have an empty ID, and row 3 to 10 all have an empty FloatValue
+	EXPECT_EQ(&twoda.getRow("ID"        , ""), &twoda.getRow(2));
+	EXPECT_EQ(&twoda.getRow("FloatValue", ""), &twoda.getRow(3));
+}
+
+GTEST_TEST(TwoDAFileASCII, getIntColumn) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	for (size_t i = 0; i < ARRAYSIZE(kDataInt); i++) {
+		const std::vector<int32> &column = twoda.getIntColumn(i);
+		ASSERT_EQ(column.size(), ARRAYSIZE(kDataInt[i]));
+
+		for (size_t j = 0; j < ARRAYSIZE(kDataInt[i]); j++)
+			EXPECT_EQ(column[j], kDataInt[i][j]) << "At index " << j << "." << i;
+	}
+
+	EXPECT_TRUE(twoda.getIntColumn(Aurora::kFieldIDInvalid).empty());
+}
+
+GTEST_TEST(TwoDAFileASCII, getFloatColumn) {
+	Common::MemoryReadStream stream(k2DAASCII);
+	const Aurora::TwoDAFile twoda(stream);
+
+	for (size_t i = 0; i < ARRAYSIZE(kDataFloat); i++) {
+		const std::vector<float> &column = twoda.getFloatColumn(i);
+		ASSERT_EQ(column.size(), ARRAYSIZE(kDataFloat[i]));
+
+		for (size_t j = 0; j < ARRAYSIZE(kDataFloat[i]); j++)
+			EXPECT_FLOAT_EQ(column[j], kDataFloat[i][j]) << "At index " << j << "." << i;
+	}
+
+	EXPECT_TRUE(twoda.getFloatColumn(Aurora::kFieldIDInvalid).empty());
+}
+
+GTEST_TEST(TwoDAFileASCII, defaultValue) {
+	static const char *k2DADefault =
+		"2DA V2.0\n"
+		"DEFAULT: 5\n"
+		"   ID   Name\n"
+		" 0 23   Foo\n"
+		" 1 **** Bar\n";
+
+	Common::MemoryReadStream stream(k2DADefault);
+	const Aurora::TwoDAFile twoda(stream);
+
+	EXPECT_TRUE(twoda.getRow(1).empty(0));
+
+	EXPECT_STREQ(twoda.getRow(1).getString(0).c_str(), "5");
+	EXPECT_EQ(twoda.getRow(1).getInt(0), 5);
+	EXPECT_FLOAT_EQ(twoda.getRow(1).getFloat(0), 5.0f);
+
+	EXPECT_EQ(twoda.getIntColumn(0)[0], 23);
+	EXPECT_EQ(twoda.getIntColumn(0)[1],  5);
+
+	// Cells that don't exist get the default as well
+	EXPECT_EQ(twoda.getRow(0).getInt(Aurora::kFieldIDInvalid), 5);
+	EXPECT_EQ(twoda.getRow(Aurora::kFieldIDInvalid).getInt(0), 5);
+}
+
 GTEST_TEST(TwoDAFileASCII, writeBinary) {
 	Common::MemoryReadStream stream(k2DAASCII);
 	const Aurora::TwoDAFile twoda(stream);
@@ -170,6 +243,32 @@ GTEST_TEST(TwoDAFileASCII, writeBinary) {
 
 // --- 2DA Binary ---
 
+GTEST_TEST(TwoDAFileBinary, getIntColumn) {
+	Common::MemoryReadStream stream(k2DABinary);
+	const Aurora::TwoDAFile twoda(stream);
+
+	for (size_t i = 0; i < ARRAYSIZE(kDataInt); i++) {
+		const std::vector<int32> &column = twoda.getIntColumn(i);
+		ASSERT_EQ(column.size(), ARRAYSIZE(kDataInt[i]));
+
+		for (size_t j = 0; j < ARRAYSIZE(kDataInt[i]); j++)
+			EXPECT_EQ(column[j], kDataInt[i][j]) << "At index " << j << "." << i;
+	}
+}
+
+GTEST_TEST(TwoDAFileBinary, getFloatColumn) {
+	Common::MemoryReadStream stream(k2DABinary);
+	const Aurora::TwoDAFile twoda(stream);
+
+	for (size_t i = 0; i < ARRAYSIZE(kDataFloat); i++) {
+		const std::vector<float> &column = twoda.getFloatColumn(i);
+		ASSERT_EQ(column.size(), ARRAYSIZE(kDataFloat[i]));
+
+		for (size_t j = 0; j < ARRAYSIZE(kDataFloat[i]); j++)
+			EXPECT_FLOAT_EQ(column[j], kDataFloat[i][j]) << "At index " << j << "." << i;
+	}
+}
+
 GTEST_TEST(TwoDAFileBinary, getRowCount) {
 	Common::MemoryReadStream stream(k2DABinary);
 	const Aurora::TwoDAFile twoda(stream);
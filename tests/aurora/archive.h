@@ -0,0 +1,87 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Common utility functions used by the archive-related unit tests.
+ */
+
+#ifndef TESTS_AURORA_ARCHIVE_H
+#define TESTS_AURORA_ARCHIVE_H
+
+#include <cstring>
+#include <vector>
+#include <atomic>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "src/common/types.h"
+#include "src/common/scopedptr.h"
+#include "src/common/readstream.h"
+#include "src/common/thread.h"
+
+#include "src/aurora/archive.h"
+
+/** Write the data into a temporary file, so that we can test real file I/O. */
+template<size_t N>
+static boost::filesystem::path writeTempFile(const byte (&data)[N]) {
+	const boost::filesystem::path path = boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+	boost::filesystem::ofstream file(path, std::ofstream::binary);
+	file.write(reinterpret_cast<const char *>(data), N);
+	file.close();
+
+	return path;
+}
+
+/** Hammer an archive resource from several threads at once, counting every mismatch. */
+static size_t readConcurrently(const Aurora::Archive &archive, uint32 index, const char *expected) {
+	static const size_t kThreadCount = 8;
+	static const size_t kIterations  = 200;
+
+	std::atomic<size_t> errors(0);
+
+	std::vector<std::thread> threads;
+	for (size_t t = 0; t < kThreadCount; t++) {
+		threads.push_back(std::thread([&archive, index, expected, &errors]() {
+			for (size_t i = 0; i < kIterations; i++) {
+				Common::ScopedPtr<Common::SeekableReadStream> file(archive.getResource(index));
+
+				const size_t size = strlen(expected);
+				if (file->size() != size) {
+					errors++;
+					continue;
+				}
+
+				std::vector<char> data(size);
+				if ((file->read(&data[0], size) != size) || (std::memcmp(&data[0], expected, size) != 0))
+					errors++;
+			}
+		}));
+	}
+
+	for (std::vector<std::thread>::iterator t = threads.begin(); t != threads.end(); ++t)
+		t->join();
+
+	return errors.load();
+}
+
+#endif // TESTS_AURORA_ARCHIVE_H
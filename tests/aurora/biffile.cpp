@@ -22,14 +22,23 @@
  *  Unit tests for our BIF file archive class.
  */
 
+#include <cstring>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
 #include "gtest/gtest.h"
 
 #include "src/common/error.h"
+#include "src/common/scopedptr.h"
 #include "src/common/memreadstream.h"
+#include "src/common/readfile.h"
 
 #include "src/aurora/biffile.h"
 #include "src/aurora/keyfile.h"
 
+#include "tests/aurora/archive.h"
+
 // Percy Bysshe Shelley's "Ozymandias"
 static const char *kFileData =
 	"I met a traveller from an antique land\n"
@@ -183,6 +192,26 @@ GTEST_TEST(BIFFile10, mergeKEY) {
 	EXPECT_EQ(resource.index, 0);
 }
 
+GTEST_TEST(BIFFile10, getResourceConcurrent) {
+	const boost::filesystem::path path = writeTempFile(kBIF10File);
+
+	{
+		Aurora::BIFFile bif(new Common::ReadFile(path.generic_string()));
+
+		Common::MemoryReadStream keyStream(kKEYFile);
+		Aurora::KEYFile key(keyStream);
+
+		bif.mergeKEY(key, 0);
+
+		const uint32 index = bif.findResource("ozymandias", Aurora::kFileTypeTXT);
+		ASSERT_EQ(index, 0);
+
+		EXPECT_EQ(readConcurrently(bif, index, kFileData), 0);
+	}
+
+	boost::filesystem::remove(path);
+}
+
 // --- BIF V1.1 ---
 
 // Percy Bysshe Shelley's "Ozymandias", within a BIF V1.1 file
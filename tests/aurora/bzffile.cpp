@@ -22,10 +22,15 @@
  *  Unit tests for our BZF file archive class.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/ptrvector.h"
+#include "src/common/threadpool.h"
 
 #include "src/aurora/bzffile.h"
 #include "src/aurora/keyfile.h"
@@ -91,6 +96,34 @@ static const byte kBZFFile[] = {
 	0xCE,0x54,0xDA,0x78,0xFF,0xF8,0x6E,0xCB,0x5F
 };
 
+/** Create a BZF file containing count copies of the compressed "Ozymandias". */
+static Common::MemoryReadStream *createBZF(uint32 count) {
+	static const uint32 kHeaderSize = 0x14;
+	static const uint32 kEntrySize  = 0x10;
+	static const uint32 kDataOffset = 0x24;
+
+	const uint32 dataSize = sizeof(kBZFFile) - kDataOffset;
+
+	Common::MemoryWriteStreamDynamic bzf(false);
+
+	bzf.write(kBZFFile, 8);
+	bzf.writeUint32LE(count);
+	bzf.writeUint32LE(0);
+	bzf.writeUint32LE(kHeaderSize);
+
+	for (uint32 i = 0; i < count; i++) {
+		bzf.writeUint32LE(i);
+		bzf.writeUint32LE(kHeaderSize + count * kEntrySize + i * dataSize);
+		bzf.writeUint32LE(strlen(kFileData));
+		bzf.writeUint32LE(0x0A);
+	}
+
+	for (uint32 i = 0; i < count; i++)
+		bzf.write(kBZFFile + kDataOffset, dataSize);
+
+	return new Common::MemoryReadStream(bzf.getData(), bzf.size(), true);
+}
+
 GTEST_TEST(BZFFile, getNameHashAlgo) {
 	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kBZFFile);
 	const Aurora::BZFFile bzf(stream);
@@ -168,3 +201,24 @@ GTEST_TEST(BZFFile, mergeKEY) {
 	EXPECT_EQ(resource.hash, 0);
 	EXPECT_EQ(resource.index, 0);
 }
+
+GTEST_TEST(BZFFile, getResourceConcurrent) {
+	const Aurora::BZFFile bzf(createBZF(16));
+
+	Common::ThreadPool pool(2);
+
+	Common::PtrVector<Common::SeekableReadStream> streams;
+	streams.resize(16, 0);
+
+	pool.parallelFor(streams.size(), [&bzf, &streams](size_t i) {
+		streams[i] = bzf.getResource(15 - i);
+	});
+
+	for (size_t i = 0; i < streams.size(); i++) {
+		ASSERT_TRUE(streams[i]) << "At stream " << i;
+		ASSERT_EQ(streams[i]->size(), strlen(kFileData)) << "At stream " << i;
+
+		for (size_t j = 0; j < strlen(kFileData); j++)
+			ASSERT_EQ(streams[i]->readByte(), kFileData[j]) << "At stream " << i << ", index " << j;
+	}
+}
@@ -22,16 +22,26 @@
  *  Unit tests for our ERF file archive class.
  */
 
+#include <cstring>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
 #include "gtest/gtest.h"
 
 #include "src/common/error.h"
 #include "src/common/hash.h"
+#include "src/common/scopedptr.h"
 #include "src/common/memreadstream.h"
+#include "src/common/readfile.h"
+#include "src/common/mappedfile.h"
 
 #include "src/aurora/locstring.h"
 #include "src/aurora/language.h"
 #include "src/aurora/erffile.h"
 
+#include "tests/aurora/archive.h"
+
 /** Utility class to hold an ERF password by copying from a static array. */
 class PasswordStore : public std::vector<byte> {
 public:
@@ -212,6 +222,48 @@ GTEST_TEST(ERFFile10, getResource) {
 	delete file;
 }
 
+GTEST_TEST(ERFFile10, getResourceConcurrent) {
+	const boost::filesystem::path path = writeTempFile(kERFFile10);
+
+	{
+		const Aurora::ERFFile erf(new Common::ReadFile(path.generic_string()));
+
+		EXPECT_EQ(readConcurrently(erf, 0, kFileData), 0);
+	}
+
+	boost::filesystem::remove(path);
+}
+
+GTEST_TEST(ERFFile10, getResourceMapped) {
+	const boost::filesystem::path path = writeTempFile(kERFFile10);
+
+	{
+		Common::MappedFileReadStream *stream = Common::MappedFileReadStream::open(path.generic_string());
+		ASSERT_NE(stream, static_cast<Common::MappedFileReadStream *>(0));
+
+		const byte *mapping = stream->getData();
+
+		const Aurora::ERFFile erf(stream);
+
+		// The resource is a view into the mapped file, not a copy
+		Common::ScopedPtr<Common::SeekableReadStream> file(erf.getResource(0));
+
+		Common::MemoryReadStream *memFile = dynamic_cast<Common::MemoryReadStream *>(file.get());
+		ASSERT_NE(memFile, static_cast<Common::MemoryReadStream *>(0));
+
+		EXPECT_EQ(memFile->getData(), mapping + 0xD8);
+
+		ASSERT_EQ(file->size(), strlen(kFileData));
+
+		for (size_t i = 0; i < strlen(kFileData); i++)
+			EXPECT_EQ(file->readByte(), kFileData[i]) << "At index " << i;
+
+		EXPECT_EQ(readConcurrently(erf, 0, kFileData), 0);
+	}
+
+	boost::filesystem::remove(path);
+}
+
 GTEST_TEST(ERFFile10, typeMOD) {
 	static const byte kERF[] = {
 		0x4D,0x4F,0x44,0x20,0x56,0x31,0x2E,0x30,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
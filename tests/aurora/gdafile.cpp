@@ -137,6 +137,9 @@ GTEST_TEST(GDAFile, findColumnName) {
 	for (size_t i = 0; i < kColumnCount; i++)
 		EXPECT_EQ(gda.findColumn(kHeaders[i]), kFields[i]);
 
+	for (size_t i = 0; i < kColumnCount; i++)
+		EXPECT_EQ(gda.findColumn(kHeadersLow[i]), kFields[i]);
+
 	EXPECT_EQ(gda.findColumn("NOPE"), Aurora::GDAFile::kInvalidColumn);
 }
 
@@ -356,6 +359,9 @@ GTEST_TEST(GDAFile, add) {
 
 	Aurora::GDAFile gda(new Common::MemoryReadStream(kMGDA1));
 
+	EXPECT_EQ(gda.findRow(kIDs[0]), 0);
+	EXPECT_EQ(gda.findRow(kIDs[3]), Aurora::GDAFile::kInvalidRow);
+
 	gda.add(new Common::MemoryReadStream(kMGDA3));
 	gda.add(new Common::MemoryReadStream(kMGDA2));
 
@@ -29,10 +29,12 @@
 #include "src/common/util.h"
 #include "src/common/error.h"
 #include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
 
 #include "src/aurora/locstring.h"
 #include "src/aurora/language.h"
 #include "src/aurora/gff3file.h"
+#include "src/aurora/gff3writer.h"
 
 // --- GFF3, single struct ---
 
@@ -157,6 +159,23 @@ GTEST_TEST(GFF3Struct, getFieldNames) {
 		EXPECT_STREQ(fieldNames[i].c_str(), kFieldNamesSingle[i]) << "At index " << i;
 }
 
+GTEST_TEST(GFF3Struct, getFieldLabel) {
+	Aurora::GFF3File gff3(new Common::MemoryReadStream(kGFF3SingleStruct));
+	const Aurora::GFF3Struct &strct = gff3.getTopLevel();
+
+	const Aurora::GFF3Label kFieldUint32("FieldUint32");
+	const Aurora::GFF3Label kNope("Nope");
+
+	EXPECT_EQ(kFieldUint32.getHash(), Aurora::GFF3Label("FieldUint32").getHash());
+	EXPECT_NE(kFieldUint32.getHash(), kNope.getHash());
+
+	EXPECT_TRUE (strct.hasField(kFieldUint32));
+	EXPECT_FALSE(strct.hasField(kNope));
+
+	EXPECT_EQ(strct.getUint(kFieldUint32), 25);
+	EXPECT_EQ(strct.getUint(kNope, 99), 99);
+}
+
 GTEST_TEST(GFF3Struct, getFieldType) {
 	Aurora::GFF3File gff3(new Common::MemoryReadStream(kGFF3SingleStruct));
 	const Aurora::GFF3Struct &strct = gff3.getTopLevel();
@@ -654,3 +673,41 @@ GTEST_TEST(GFF3File, GFF3V33) {
 	EXPECT_EQ(strct.getID(), 23);
 	EXPECT_EQ(strct.getUint("FieldUint32"), 32);
 }
+
+// --- GFF3, lazy loading ---
+
+GTEST_TEST(GFF3File, getLoadedStructCount) {
+	Aurora::GFF3Writer writer(MKTAG('G', 'F', 'F', ' '));
+
+	writer.getTopLevel()->addStruct("Struct")->addUint32("FieldUint32", 23);
+
+	Aurora::GFF3WriterListPtr list = writer.getTopLevel()->addList("List");
+	for (uint32 i = 0; i < 3; i++)
+		list->addStruct("ListStruct")->addUint32("FieldUint32", i);
+
+	Common::MemoryWriteStreamDynamic stream(true);
+	writer.write(stream);
+
+	Aurora::GFF3File gff3(new Common::MemoryReadStream(stream.getData(), stream.size()));
+
+	EXPECT_EQ(gff3.getStructCount(), 5);
+	EXPECT_EQ(gff3.getLoadedStructCount(), 0);
+
+	const Aurora::GFF3Struct &top = gff3.getTopLevel();
+	EXPECT_EQ(gff3.getLoadedStructCount(), 1);
+
+	EXPECT_EQ(top.getStruct("Struct").getUint("FieldUint32"), 23);
+	EXPECT_EQ(gff3.getLoadedStructCount(), 2);
+
+	const Aurora::GFF3List &structs = top.getList("List");
+	EXPECT_EQ(gff3.getLoadedStructCount(), 5);
+
+	ASSERT_EQ(structs.size(), 3);
+	for (uint32 i = 0; i < 3; i++)
+		EXPECT_EQ(structs[i]->getUint("FieldUint32"), i);
+
+	// Accessing them again doesn't create new structs
+	EXPECT_EQ(&top.getStruct("Struct"), &top.getStruct("Struct"));
+	EXPECT_EQ(&top.getList("List"), &top.getList("List"));
+	EXPECT_EQ(gff3.getLoadedStructCount(), 5);
+}
@@ -1079,6 +1079,78 @@ GTEST_TEST(GFF4StructSingle, getData) {
 	ASSERT_EQ(data2, static_cast<Common::SeekableReadStream *>(0));
 }
 
+GTEST_TEST(GFF4StructSingle, getValueCount) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	EXPECT_EQ(strct.getValueCount( 256),  1);
+	EXPECT_EQ(strct.getValueCount( 512),  1);
+	EXPECT_EQ(strct.getValueCount( 768),  3);
+	EXPECT_EQ(strct.getValueCount( 769),  4);
+	EXPECT_EQ(strct.getValueCount( 772), 16);
+	EXPECT_EQ(strct.getValueCount(9999),  0);
+}
+
+GTEST_TEST(GFF4StructSingle, getFloatArray) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	float v[16];
+
+	ASSERT_EQ(strct.getFloat(512, v, 16), 1);
+	EXPECT_FLOAT_EQ(v[0], 27.1f);
+
+	ASSERT_EQ(strct.getFloat(513, v, 16), 1);
+	EXPECT_FLOAT_EQ(v[0], 27.2f);
+
+	// Nintendo fixed point
+	ASSERT_EQ(strct.getFloat(514, v, 16), 1);
+	EXPECT_NEAR(v[0], 5.23f, 0.00005);
+
+	ASSERT_EQ(strct.getFloat(768, v, 16), 3);
+	EXPECT_FLOAT_EQ(v[0], 28.1f);
+	EXPECT_FLOAT_EQ(v[1], 28.2f);
+	EXPECT_FLOAT_EQ(v[2], 28.3f);
+
+	ASSERT_EQ(strct.getFloat(772, v, 16), 16);
+	for (size_t i = 0; i < 16; i++)
+		EXPECT_FLOAT_EQ(v[i], 40.0f + (i / 4) + (i % 4) * 0.1f) << "At index " << i;
+
+	// Only read as much as fits
+	v[2] = 0.0f;
+	ASSERT_EQ(strct.getFloat(769, v, 2), 2);
+	EXPECT_FLOAT_EQ(v[0], 29.1f);
+	EXPECT_FLOAT_EQ(v[1], 29.2f);
+	EXPECT_FLOAT_EQ(v[2],  0.0f);
+
+	EXPECT_EQ(strct.getFloat(9999, v, 16), 0);
+
+	EXPECT_THROW(strct.getFloat( 256, v, 16), Common::Exception);
+	EXPECT_THROW(strct.getFloat(1024, v, 16), Common::Exception);
+}
+
+GTEST_TEST(GFF4StructSingle, getUintArray) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4SingleValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	uint32 v[4];
+
+	ASSERT_EQ(strct.getUint(256, v, 4), 1);
+	EXPECT_EQ(v[0], 23);
+
+	ASSERT_EQ(strct.getUint(260, v, 4), 1);
+	EXPECT_EQ(v[0], 25);
+
+	ASSERT_EQ(strct.getUint(261, v, 4), 1);
+	EXPECT_EQ(v[0], (uint32) -25);
+
+	EXPECT_EQ(strct.getUint(9999, v, 4), 0);
+
+	EXPECT_THROW(strct.getUint(262, v, 4), Common::Exception);
+	EXPECT_THROW(strct.getUint(263, v, 4), Common::Exception);
+	EXPECT_THROW(strct.getUint(512, v, 4), Common::Exception);
+}
+
 // --- GFF4, list values ---
 
 static const byte kGFF4ListValues[] = {
@@ -1889,6 +1961,81 @@ GTEST_TEST(GFF4StructList, getData) {
 	ASSERT_EQ(data2, static_cast<Common::SeekableReadStream *>(0));
 }
 
+GTEST_TEST(GFF4StructList, getValueCount) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4ListValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	EXPECT_EQ(strct.getValueCount(256),  3);
+	EXPECT_EQ(strct.getValueCount(512),  3);
+	EXPECT_EQ(strct.getValueCount(768),  9);
+	EXPECT_EQ(strct.getValueCount(769), 12);
+	EXPECT_EQ(strct.getValueCount(772), 48);
+}
+
+GTEST_TEST(GFF4StructList, getFloatArray) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4ListValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	std::vector<float> v(strct.getValueCount(768));
+
+	ASSERT_EQ(strct.getFloat(768, &v[0], v.size()), 9);
+	EXPECT_FLOAT_EQ(v[0], 81.1f);
+	EXPECT_FLOAT_EQ(v[1], 81.2f);
+	EXPECT_FLOAT_EQ(v[2], 81.3f);
+	EXPECT_FLOAT_EQ(v[3], 82.1f);
+	EXPECT_FLOAT_EQ(v[4], 82.2f);
+	EXPECT_FLOAT_EQ(v[5], 82.3f);
+	EXPECT_FLOAT_EQ(v[6], 83.1f);
+	EXPECT_FLOAT_EQ(v[7], 83.2f);
+	EXPECT_FLOAT_EQ(v[8], 83.3f);
+
+	// The bulk read has to match reading element by element
+	static const uint32 kFields[] = { 512, 513, 514, 768, 769, 770, 771, 772 };
+	for (size_t i = 0; i < ARRAYSIZE(kFields); i++) {
+		std::vector< std::vector<float> > elements;
+		if (kFields[i] < 768) {
+			std::vector<float> list;
+			ASSERT_TRUE(strct.getFloat(kFields[i], list));
+
+			for (size_t j = 0; j < list.size(); j++)
+				elements.push_back(std::vector<float>(1, list[j]));
+		} else
+			ASSERT_TRUE(strct.getVectorMatrix(kFields[i], elements));
+
+		v.resize(strct.getValueCount(kFields[i]));
+		ASSERT_EQ(strct.getFloat(kFields[i], &v[0], v.size()), v.size());
+
+		size_t n = 0;
+		for (size_t j = 0; j < elements.size(); j++)
+			for (size_t k = 0; k < elements[j].size(); k++, n++)
+				EXPECT_FLOAT_EQ(v[n], elements[j][k]) << "At field " << kFields[i] << ", index " << n;
+
+		EXPECT_EQ(n, v.size());
+	}
+}
+
+GTEST_TEST(GFF4StructList, getUintArray) {
+	Aurora::GFF4File gff4(new Common::MemoryReadStream(kGFF4ListValues));
+	const Aurora::GFF4Struct &strct = gff4.getTopLevel();
+
+	uint32 v[3];
+
+	ASSERT_EQ(strct.getUint(256, v, 3), 3);
+	EXPECT_EQ(v[0], 23);
+	EXPECT_EQ(v[1], 24);
+	EXPECT_EQ(v[2], 25);
+
+	ASSERT_EQ(strct.getUint(260, v, 3), 3);
+	EXPECT_EQ(v[0], 43);
+	EXPECT_EQ(v[1], 44);
+	EXPECT_EQ(v[2], 45);
+
+	ASSERT_EQ(strct.getUint(259, v, 3), 3);
+	EXPECT_EQ(v[0], (uint32) -33);
+	EXPECT_EQ(v[1], (uint32) -34);
+	EXPECT_EQ(v[2], (uint32) -35);
+}
+
 // --- GFF4, reference values ---
 
 static const byte kGFF4RefValues[] = {
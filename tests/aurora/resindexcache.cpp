@@ -0,0 +1,232 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the persistent resource index cache.
+ */
+
+#include <cstring>
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/scopedptr.h"
+#include "src/common/memreadstream.h"
+#include "src/common/memwritestream.h"
+#include "src/common/writefile.h"
+
+#include "src/aurora/resindexcache.h"
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/resman.h"
+
+static const byte kData[] = { 0x01, 0x02, 0x03, 0x04, 0x05 };
+
+static boost::filesystem::path getTempPath() {
+	return boost::filesystem::temp_directory_path() /
+		boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+}
+
+static void writeFile(const boost::filesystem::path &path, const char *contents) {
+	boost::filesystem::ofstream file(path, std::ofstream::binary);
+	file << contents;
+	file.close();
+}
+
+class ResourceIndexCache : public ::testing::Test {
+protected:
+	boost::filesystem::path _cacheFile;
+	boost::filesystem::path _dependFile;
+
+	void SetUp() {
+		_cacheFile  = getTempPath();
+		_dependFile = getTempPath();
+
+		writeFile(_dependFile, "foobar");
+	}
+
+	void TearDown() {
+		boost::filesystem::remove(_cacheFile);
+		boost::filesystem::remove(_dependFile);
+	}
+
+	Aurora::ResourceIndexCache::Dependencies getDependencies() {
+		Aurora::ResourceIndexCache::Dependencies dependencies(1);
+		EXPECT_TRUE(Aurora::ResourceIndexCache::getDependency(_dependFile.generic_string(), dependencies[0]));
+
+		return dependencies;
+	}
+};
+
+GTEST_TEST_F(ResourceIndexCache, getDependency) {
+	Aurora::ResourceIndexCache::Dependency dependency;
+
+	ASSERT_TRUE(Aurora::ResourceIndexCache::getDependency(_dependFile.generic_string(), dependency));
+	EXPECT_EQ(dependency.path, _dependFile.generic_string());
+	EXPECT_EQ(dependency.size, 6);
+
+	ASSERT_TRUE(Aurora::ResourceIndexCache::getDependency(_dependFile.parent_path().generic_string(), dependency));
+	EXPECT_EQ(dependency.size, 0);
+
+	EXPECT_FALSE(Aurora::ResourceIndexCache::getDependency(_cacheFile.generic_string() + ".nonexistent", dependency));
+}
+
+GTEST_TEST_F(ResourceIndexCache, saveLoad) {
+	{
+		Aurora::ResourceIndexCache cache;
+
+		cache.add("foo", getDependencies(), kData, sizeof(kData));
+		cache.save(_cacheFile.generic_string());
+	}
+
+	Aurora::ResourceIndexCache cache;
+	ASSERT_TRUE(cache.load(_cacheFile.generic_string()));
+
+	Common::ScopedPtr<Common::MemoryReadStream> data(cache.find("foo"));
+	ASSERT_TRUE(data);
+
+	ASSERT_EQ(data->size(), sizeof(kData));
+	for (size_t i = 0; i < sizeof(kData); i++)
+		EXPECT_EQ(data->readByte(), kData[i]) << "At index " << i;
+
+	EXPECT_FALSE(cache.find("bar"));
+}
+
+GTEST_TEST_F(ResourceIndexCache, invalidateChanged) {
+	Aurora::ResourceIndexCache cache;
+
+	cache.add("foo", getDependencies(), kData, sizeof(kData));
+
+	writeFile(_dependFile, "foobarquux");
+
+	Common::ScopedPtr<Common::MemoryReadStream> data(cache.find("foo"));
+	EXPECT_FALSE(data);
+}
+
+GTEST_TEST_F(ResourceIndexCache, invalidateRemoved) {
+	Aurora::ResourceIndexCache cache;
+
+	cache.add("foo", getDependencies(), kData, sizeof(kData));
+
+	boost::filesystem::remove(_dependFile);
+
+	Common::ScopedPtr<Common::MemoryReadStream> data(cache.find("foo"));
+	EXPECT_FALSE(data);
+}
+
+GTEST_TEST_F(ResourceIndexCache, dropUnused) {
+	{
+		Aurora::ResourceIndexCache cache;
+
+		cache.add("foo", getDependencies(), kData, sizeof(kData));
+		cache.add("bar", getDependencies(), kData, sizeof(kData));
+		cache.save(_cacheFile.generic_string());
+	}
+
+	{
+		// Only use "bar", so "foo" will be dropped
+		Aurora::ResourceIndexCache cache;
+		ASSERT_TRUE(cache.load(_cacheFile.generic_string()));
+
+		Common::ScopedPtr<Common::MemoryReadStream> data(cache.find("bar"));
+		ASSERT_TRUE(data);
+
+		cache.save(_cacheFile.generic_string());
+	}
+
+	Aurora::ResourceIndexCache cache;
+	ASSERT_TRUE(cache.load(_cacheFile.generic_string()));
+
+	Common::ScopedPtr<Common::MemoryReadStream> foo(cache.find("foo"));
+	Common::ScopedPtr<Common::MemoryReadStream> bar(cache.find("bar"));
+
+	EXPECT_FALSE(foo);
+	EXPECT_TRUE(bar);
+}
+
+GTEST_TEST_F(ResourceIndexCache, loadFail) {
+	Aurora::ResourceIndexCache cache;
+
+	EXPECT_FALSE(cache.load(_cacheFile.generic_string()));
+
+	writeFile(_cacheFile, "Not a cache file");
+	EXPECT_FALSE(cache.load(_cacheFile.generic_string()));
+}
+
+GTEST_TEST_F(ResourceIndexCache, resourceManager) {
+	const boost::filesystem::path dataDir = getTempPath();
+	boost::filesystem::create_directories(dataDir);
+
+	{
+		Common::WriteFile file((dataDir / "test.erf").generic_string());
+		Aurora::ERFWriter erf(MKTAG('E', 'R', 'F', ' '), 1, file);
+
+		static const byte kResource[] = { 'f', 'o', 'o', 'b', 'a', 'r' };
+		Common::MemoryReadStream resource(kResource);
+
+		erf.add("foo", Aurora::kFileTypeTXT, resource);
+	}
+
+	// First run: everything is read from disk. Second run: everything comes from the cache
+	for (int run = 0; run < 2; run++) {
+		ResMan.openIndexCache(_cacheFile.generic_string());
+
+		ResMan.registerDataBase(dataDir.generic_string());
+		ResMan.indexArchive("test.erf", 100);
+
+		const Aurora::ResourceManager::IndexStats &stats = ResMan.getIndexStats();
+		if (run == 0) {
+			EXPECT_EQ(stats.fromCache, 0);
+			EXPECT_GT(stats.fromDisk , 0);
+		} else {
+			EXPECT_GT(stats.fromCache, 0);
+			EXPECT_EQ(stats.fromDisk , 0);
+		}
+
+		Common::ScopedPtr<Common::SeekableReadStream> resource(ResMan.getResource("foo", Aurora::kFileTypeTXT));
+		ASSERT_TRUE(resource) << "In run " << run;
+		ASSERT_EQ(resource->size(), 6);
+
+		char data[6];
+		ASSERT_EQ(resource->read(data, sizeof(data)), sizeof(data));
+		EXPECT_EQ(std::memcmp(data, "foobar", sizeof(data)), 0);
+
+		ResMan.closeIndexCache();
+		ResMan.clear();
+	}
+
+	boost::filesystem::remove_all(dataDir);
+}
+
+GTEST_TEST(ResourceIndexCacheString, readWrite) {
+	Common::MemoryWriteStreamDynamic stream(true);
+
+	Aurora::ResourceIndexCache::writeString(stream, "");
+	Aurora::ResourceIndexCache::writeString(stream, "foobar");
+
+	Common::MemoryReadStream read(stream.getData(), stream.size());
+
+	EXPECT_STREQ(Aurora::ResourceIndexCache::readString(read).c_str(), "");
+	EXPECT_STREQ(Aurora::ResourceIndexCache::readString(read).c_str(), "foobar");
+
+	EXPECT_THROW(Aurora::ResourceIndexCache::readString(read), Common::Exception);
+}
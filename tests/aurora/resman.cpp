@@ -0,0 +1,340 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the resource manager.
+ */
+
+#include <cstring>
+
+#include <map>
+#include <list>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/ptrvector.h"
+#include "src/common/memreadstream.h"
+#include "src/common/writefile.h"
+#include "src/common/changeid.h"
+
+#include "src/aurora/erfwriter.h"
+#include "src/aurora/resman.h"
+
+static const size_t kArchiveCount  = 8;
+static const size_t kResourceCount = 16;
+
+// A ZIP file with "foo.txt" ("foobar" 8 times, compressed) and "bar.txt" ("barfoo", stored)
+static const byte kZIPFile[] = {
+	0x50,0x4B,0x03,0x04,0x14,0x00,0x00,0x00,0x08,0x00,0x00,0x00,0x21,0x00,0xC9,0x72,
+	0x7E,0xF8,0x0B,0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x07,0x00,0x00,0x00,0x66,0x6F,
+	0x6F,0x2E,0x74,0x78,0x74,0x4B,0xCB,0xCF,0x4F,0x4A,0x2C,0x4A,0x23,0x9A,0x04,0x00,
+	0x50,0x4B,0x03,0x04,0x14,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x21,0x00,0x2B,0x85,
+	0xA8,0xE2,0x06,0x00,0x00,0x00,0x06,0x00,0x00,0x00,0x07,0x00,0x00,0x00,0x62,0x61,
+	0x72,0x2E,0x74,0x78,0x74,0x62,0x61,0x72,0x66,0x6F,0x6F,0x50,0x4B,0x01,0x02,0x14,
+	0x03,0x14,0x00,0x00,0x00,0x08,0x00,0x00,0x00,0x21,0x00,0xC9,0x72,0x7E,0xF8,0x0B,
+	0x00,0x00,0x00,0x30,0x00,0x00,0x00,0x07,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x80,0x01,0x00,0x00,0x00,0x00,0x66,0x6F,0x6F,0x2E,0x74,0x78,0x74,
+	0x50,0x4B,0x01,0x02,0x14,0x03,0x14,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x21,0x00,
+	0x2B,0x85,0xA8,0xE2,0x06,0x00,0x00,0x00,0x06,0x00,0x00,0x00,0x07,0x00,0x00,0x00,
+	0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x00,0x80,0x01,0x30,0x00,0x00,0x00,0x62,0x61,
+	0x72,0x2E,0x74,0x78,0x74,0x50,0x4B,0x05,0x06,0x00,0x00,0x00,0x00,0x02,0x00,0x02,
+	0x00,0x6A,0x00,0x00,0x00,0x5B,0x00,0x00,0x00,0x00,0x00
+};
+
+typedef std::map<Common::UString, byte> ResourceContents;
+
+class ResourceManager : public ::testing::Test {
+protected:
+	boost::filesystem::path _dataDir;
+
+	void SetUp() {
+		_dataDir = boost::filesystem::temp_directory_path() /
+			boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		boost::filesystem::create_directories(_dataDir);
+
+		/* Every archive contains every second resource, starting at its own index,
+		 * so that archives override each others' resources in various ways.
+		 * Every resource is a single byte identifying the archive. */
+		for (size_t i = 0; i < kArchiveCount; i++) {
+			Common::WriteFile file((_dataDir / getArchiveName(i).c_str()).generic_string());
+			Aurora::ERFWriter erf(MKTAG('E', 'R', 'F', ' '), kResourceCount / 2, file);
+
+			for (size_t j = i % 2; j < kResourceCount; j += 2) {
+				const byte data[] = { (byte) i };
+				Common::MemoryReadStream resource(data);
+
+				erf.add(getResourceName(j), Aurora::kFileTypeTXT, resource);
+			}
+		}
+
+		ResMan.registerDataBase(_dataDir.generic_string());
+	}
+
+	void TearDown() {
+		ResMan.clear();
+
+		boost::filesystem::remove_all(_dataDir);
+	}
+
+	static Common::UString getArchiveName(size_t i) {
+		return Common::UString::format("archive%u.erf", (uint) i);
+	}
+
+	static Common::UString getResourceName(size_t i) {
+		return Common::UString::format("resource%u", (uint) i);
+	}
+
+	/** Return the contents of all resources, as currently indexed. */
+	static ResourceContents getContents() {
+		ResourceContents contents;
+
+		for (size_t i = 0; i < kResourceCount; i++) {
+			Common::ScopedPtr<Common::SeekableReadStream> resource(ResMan.getResource(getResourceName(i), Aurora::kFileTypeTXT));
+			if (resource)
+				contents[getResourceName(i)] = resource->readByte();
+		}
+
+		return contents;
+	}
+
+	/** Index all archives one by one, with shuffled priorities, and return the result. */
+	ResourceContents indexSerially() {
+		for (size_t i = 0; i < kArchiveCount; i++)
+			ResMan.indexArchive(getArchiveName(i), getPriority(i));
+
+		return getContents();
+	}
+
+	/** Add a ZIP file with compressed resources, and index it with the resource cache enabled. */
+	void indexZIP() {
+		{
+			Common::WriteFile file((_dataDir / "cache.zip").generic_string());
+			file.write(kZIPFile, sizeof(kZIPFile));
+		}
+
+		ResMan.registerDataBase(_dataDir.generic_string());
+
+		ResMan.setResourceCacheSize(1024);
+		ResMan.indexArchive("cache.zip", 100);
+	}
+
+	static uint32 getPriority(size_t i) {
+		// Some archives share a priority, so the order of indexing matters too
+		return 10 + ((i * 5) % kArchiveCount) / 2;
+	}
+};
+
+GTEST_TEST_F(ResourceManager, indexArchives) {
+	const ResourceContents serial = indexSerially();
+	ASSERT_EQ(serial.size(), kResourceCount);
+
+	ResMan.clear();
+	ResMan.registerDataBase(_dataDir.generic_string());
+
+	std::vector<Aurora::ResourceManager::ArchiveIndexRequest> archives;
+	for (size_t i = 0; i < kArchiveCount; i++)
+		archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest(getArchiveName(i), getPriority(i)));
+
+	ResMan.indexArchives(archives);
+
+	const ResourceContents parallel = getContents();
+	ASSERT_EQ(parallel.size(), kResourceCount);
+
+	for (ResourceContents::const_iterator s = serial.begin(), p = parallel.begin(); s != serial.end(); ++s, ++p) {
+		EXPECT_STREQ(p->first.c_str(), s->first.c_str());
+		EXPECT_EQ(p->second, s->second) << "For resource " << s->first.c_str();
+	}
+}
+
+GTEST_TEST_F(ResourceManager, getResources) {
+	const ResourceContents contents = indexSerially();
+
+	std::vector<Common::UString> names;
+	for (size_t i = 0; i < kResourceCount; i++)
+		names.push_back(getResourceName(i));
+
+	names.push_back("nonexistent");
+
+	Common::PtrVector<Common::SeekableReadStream> streams;
+	std::vector<Aurora::FileType> types;
+	ResMan.getResources(names, std::vector<Aurora::FileType>(1, Aurora::kFileTypeTXT), streams, &types);
+
+	ASSERT_EQ(streams.size(), names.size());
+	ASSERT_EQ(types.size(), names.size());
+
+	for (size_t i = 0; i < kResourceCount; i++) {
+		ASSERT_TRUE(streams[i]) << "For resource " << names[i].c_str();
+
+		ResourceContents::const_iterator c = contents.find(names[i]);
+		ASSERT_NE(c, contents.end());
+
+		EXPECT_EQ(streams[i]->readByte(), c->second) << "For resource " << names[i].c_str();
+		EXPECT_EQ(types[i], Aurora::kFileTypeTXT) << "For resource " << names[i].c_str();
+	}
+
+	EXPECT_FALSE(streams.back());
+	EXPECT_EQ(types.back(), Aurora::kFileTypeNone);
+}
+
+GTEST_TEST_F(ResourceManager, getResourceResRefID) {
+	const ResourceContents contents = indexSerially();
+
+	for (size_t i = 0; i < kResourceCount; i++) {
+		const Aurora::ResRefID id = ResRefMan.intern(getResourceName(i).toUpper());
+
+		EXPECT_TRUE(ResMan.hasResource(id, Aurora::kFileTypeTXT));
+
+		Common::ScopedPtr<Common::SeekableReadStream> resource(ResMan.getResource(id, Aurora::kFileTypeTXT));
+		ASSERT_TRUE(resource) << "For resource " << i;
+
+		EXPECT_EQ(resource->readByte(), contents.find(getResourceName(i))->second) << "For resource " << i;
+	}
+
+	const Aurora::ResRefID id = ResRefMan.intern("nonexistent");
+
+	EXPECT_FALSE(ResMan.hasResource(id, Aurora::kFileTypeTXT));
+	EXPECT_FALSE(ResMan.getResource(id, std::vector<Aurora::FileType>(1, Aurora::kFileTypeTXT)));
+}
+
+GTEST_TEST_F(ResourceManager, indexArchivesChanges) {
+	std::list<Common::ChangeID> changes(kArchiveCount + 1);
+
+	std::vector<Aurora::ResourceManager::ArchiveIndexRequest> archives;
+
+	std::list<Common::ChangeID>::iterator change = changes.begin();
+	for (size_t i = 0; i < kArchiveCount; i++, ++change)
+		archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest(getArchiveName(i), 10 + i, false, &*change));
+
+	archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest("nonexistent.erf", 100, true, &*change));
+
+	ResMan.indexArchives(archives);
+
+	// The missing optional archive was skipped, without creating a change
+	EXPECT_FALSE(changes.back().getContent());
+	changes.pop_back();
+
+	// Undoing the changes in reverse removes the resources again
+	EXPECT_EQ(getContents()[getResourceName(0)], kArchiveCount - 2);
+
+	for (std::list<Common::ChangeID>::reverse_iterator c = changes.rbegin(); c != changes.rend(); ++c) {
+		EXPECT_TRUE(c->getContent());
+		ResMan.undo(*c);
+	}
+
+	EXPECT_TRUE(getContents().empty());
+}
+
+GTEST_TEST_F(ResourceManager, indexArchivesMissing) {
+	std::vector<Aurora::ResourceManager::ArchiveIndexRequest> archives;
+
+	archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest(getArchiveName(0), 10));
+	archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest("nonexistent.erf", 11));
+	archives.push_back(Aurora::ResourceManager::ArchiveIndexRequest(getArchiveName(1), 12));
+
+	EXPECT_THROW(ResMan.indexArchives(archives), Common::Exception);
+
+	// The archive before the missing one was indexed, the one after it wasn't
+	const ResourceContents contents = getContents();
+	ASSERT_EQ(contents.size(), kResourceCount / 2);
+
+	for (ResourceContents::const_iterator c = contents.begin(); c != contents.end(); ++c)
+		EXPECT_EQ(c->second, 0) << "For resource " << c->first.c_str();
+}
+
+/* Benchmark of indexing 64 archives with 5000 resources each,
+ * one after the other and with indexArchives().
+ *
+ * Run with --gtest_also_run_disabled_tests. */
+/** Read a resource and check that it's this string repeated count times. */
+static void checkResource(Common::SeekableReadStream *resource, const char *str, size_t count) {
+	ASSERT_TRUE(resource);
+
+	const size_t length = std::strlen(str);
+	ASSERT_EQ(resource->size(), length * count);
+
+	for (size_t i = 0; i < count; i++) {
+		char data[16];
+		ASSERT_EQ(resource->read(data, length), length);
+		EXPECT_EQ(std::memcmp(data, str, length), 0) << "At repetition " << i;
+	}
+}
+
+GTEST_TEST_F(ResourceManager, resourceCache) {
+	indexZIP();
+
+	const Aurora::ResourceManager::ResourceCacheStats before = ResMan.getResourceCacheStats();
+
+	// Only the compressed resource is cached, and only decompressed once
+	for (int i = 0; i < 3; i++) {
+		Common::ScopedPtr<Common::SeekableReadStream> foo(ResMan.getResource("foo", Aurora::kFileTypeTXT));
+		Common::ScopedPtr<Common::SeekableReadStream> bar(ResMan.getResource("bar", Aurora::kFileTypeTXT));
+
+		checkResource(foo.get(), "foobar", 8);
+		checkResource(bar.get(), "barfoo", 1);
+	}
+
+	Aurora::ResourceManager::ResourceCacheStats stats = ResMan.getResourceCacheStats();
+	EXPECT_EQ(stats.misses - before.misses, 1);
+	EXPECT_EQ(stats.hits   - before.hits  , 2);
+	EXPECT_EQ(stats.count, 1);
+	EXPECT_EQ(stats.size , 48);
+
+	// Streams of cached resources stay valid after they were evicted
+	Common::ScopedPtr<Common::SeekableReadStream> foo(ResMan.getResource("foo", Aurora::kFileTypeTXT));
+
+	ResMan.setResourceCacheSize(0);
+
+	stats = ResMan.getResourceCacheStats();
+	EXPECT_EQ(stats.evictions - before.evictions, 1);
+	EXPECT_EQ(stats.count, 0);
+
+	checkResource(foo.get(), "foobar", 8);
+}
+
+GTEST_TEST_F(ResourceManager, prefetch) {
+	indexZIP();
+
+	const std::vector<Common::UString> names = { "foo", "bar", "nonexistent" };
+	const std::vector<Aurora::FileType> types = { Aurora::kFileTypeTXT };
+
+	// Only the compressed resource is cached
+	std::shared_future<size_t> prefetch = ResMan.prefetch(names, types);
+	EXPECT_EQ(prefetch.get(), 1);
+
+	const Aurora::ResourceManager::ResourceCacheStats before = ResMan.getResourceCacheStats();
+
+	Common::ScopedPtr<Common::SeekableReadStream> foo(ResMan.getResource("foo", Aurora::kFileTypeTXT));
+	checkResource(foo.get(), "foobar", 8);
+
+	const Aurora::ResourceManager::ResourceCacheStats after = ResMan.getResourceCacheStats();
+	EXPECT_EQ(after.hits   - before.hits  , 1);
+	EXPECT_EQ(after.misses - before.misses, 0);
+
+	// Nothing is prefetched without a cache
+	ResMan.setResourceCacheSize(0);
+	EXPECT_EQ(ResMan.prefetch(names, types).get(), 0);
+}
@@ -0,0 +1,97 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the ResRef manager.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/error.h"
+#include "src/common/threadpool.h"
+
+#include "src/aurora/resref.h"
+
+GTEST_TEST(ResRefManager, empty) {
+	EXPECT_EQ(ResRefMan.intern(""), Aurora::kResRefIDNone);
+	EXPECT_EQ(ResRefMan.find(""), Aurora::kResRefIDNone);
+
+	EXPECT_STREQ(ResRefMan.getName(Aurora::kResRefIDNone).c_str(), "");
+}
+
+GTEST_TEST(ResRefManager, intern) {
+	const Aurora::ResRefID id1 = ResRefMan.intern("nw_test_foo");
+	const Aurora::ResRefID id2 = ResRefMan.intern("NW_Test_Foo");
+	const Aurora::ResRefID id3 = ResRefMan.intern("nw_test_bar");
+
+	EXPECT_NE(id1, Aurora::kResRefIDNone);
+	EXPECT_EQ(id1, id2);
+	EXPECT_NE(id1, id3);
+
+	EXPECT_EQ(ResRefMan.find("NW_TEST_FOO"), id1);
+	EXPECT_EQ(ResRefMan.find("nw_test_quux"), Aurora::kResRefIDNone);
+
+	EXPECT_STREQ(ResRefMan.getName(id1).c_str(), "nw_test_foo");
+	EXPECT_STREQ(ResRefMan.getName(id3).c_str(), "nw_test_bar");
+
+	Common::hashUStringCaseInsensitive hash;
+	EXPECT_EQ(ResRefMan.getHash(id1), hash("NW_TEST_FOO"));
+	EXPECT_EQ(ResRefMan.getHash(id3), hash("nw_test_bar"));
+
+	EXPECT_THROW(ResRefMan.getName(ResRefMan.getCount()), Common::Exception);
+}
+
+GTEST_TEST(ResRefManager, manyChunks) {
+	static const size_t kCount = 10000;
+
+	std::vector<Aurora::ResRefID> ids;
+	for (size_t i = 0; i < kCount; i++)
+		ids.push_back(ResRefMan.intern(Common::UString::format("nw_many_%u", (uint) i)));
+
+	for (size_t i = 0; i < kCount; i++) {
+		EXPECT_STREQ(ResRefMan.getName(ids[i]).c_str(), Common::UString::format("nw_many_%u", (uint) i).c_str());
+
+		// Still found after the lookup table grew
+		EXPECT_EQ(ResRefMan.find(Common::UString::format("NW_MANY_%u", (uint) i)), ids[i]);
+	}
+}
+
+GTEST_TEST(ResRefManager, threads) {
+	static const size_t kCount = 1000;
+
+	std::vector<Aurora::ResRefID> ids1(kCount), ids2(kCount);
+
+	Common::ThreadPool pool(4);
+
+	// Interning the same names concurrently results in the same IDs
+	pool.parallelFor(kCount * 2, [&ids1, &ids2](size_t i) {
+		const Common::UString name = Common::UString::format("nw_thread_%u", (uint) (i / 2));
+
+		const Aurora::ResRefID id = ResRefMan.intern((i % 2) ? name : name.toUpper());
+
+		((i % 2) ? ids1 : ids2)[i / 2] = id;
+		EXPECT_STREQ(ResRefMan.getName(id).c_str(), name.c_str());
+	});
+
+	for (size_t i = 0; i < kCount; i++)
+		EXPECT_EQ(ids1[i], ids2[i]) << "At index " << i;
+}
@@ -86,6 +86,8 @@ tests_aurora_test_keyfile_SOURCES  = tests/aurora/keyfile.cpp
 tests_aurora_test_keyfile_LDADD    = $(aurora_LIBS)
 tests_aurora_test_keyfile_CXXFLAGS = $(test_CXXFLAGS)
 
+noinst_HEADERS += tests/aurora/archive.h
+
 check_PROGRAMS                    += tests/aurora/test_biffile
 tests_aurora_test_biffile_SOURCES  = tests/aurora/biffile.cpp
 tests_aurora_test_biffile_LDADD    = $(aurora_LIBS)
@@ -103,6 +105,21 @@ tests_aurora_test_erffile_SOURCES  = tests/aurora/erffile.cpp
 tests_aurora_test_erffile_LDADD    = $(aurora_LIBS)
 tests_aurora_test_erffile_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                  += tests/aurora/test_resref
+tests_aurora_test_resref_SOURCES  = tests/aurora/resref.cpp
+tests_aurora_test_resref_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resref_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                          += tests/aurora/test_resindexcache
+tests_aurora_test_resindexcache_SOURCES  = tests/aurora/resindexcache.cpp
+tests_aurora_test_resindexcache_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resindexcache_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                  += tests/aurora/test_resman
+tests_aurora_test_resman_SOURCES  = tests/aurora/resman.cpp
+tests_aurora_test_resman_LDADD    = $(aurora_LIBS)
+tests_aurora_test_resman_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                     += tests/aurora/test_gff3file
 tests_aurora_test_gff3file_SOURCES  = tests/aurora/gff3file.cpp
 tests_aurora_test_gff3file_LDADD    = $(aurora_LIBS)
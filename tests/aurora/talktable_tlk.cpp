@@ -194,3 +194,56 @@ GTEST_TEST(TalkTable_TLK40, fromGeneric) {
 
 	delete tlk;
 }
+
+// --- String cache ---
+
+// A V4.0 TLK with a Latin-9 string "Café" and a plain ASCII string "Foo"
+static const byte kTLKLatin9[] = {
+	0x54,0x4C,0x4B,0x20,0x56,0x34,0x2E,0x30,0x00,0x00,0x00,0x00,0x02,0x00,0x00,0x00,
+	0x18,0x00,0x00,0x00,0x2C,0x00,0x00,0x00,0xFF,0xFF,0xFF,0xFF,0x2C,0x00,0x00,0x00,
+	0x04,0x00,0xFF,0xFF,0xFF,0xFF,0x30,0x00,0x00,0x00,0x03,0x00,0x43,0x61,0x66,0xE9,
+	0x46,0x6F,0x6F
+};
+
+GTEST_TEST(TalkTable_TLKCache, decodedStrings) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKLatin9);
+	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingLatin9);
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Caf\xC3\xA9");
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Caf\xC3\xA9");
+
+	const Aurora::TalkTable::CacheStats stats = tlk.getCacheStats();
+	EXPECT_EQ(stats.hits  , 1);
+	EXPECT_EQ(stats.misses, 1);
+	EXPECT_EQ(stats.count , 1);
+	EXPECT_EQ(stats.budget, Aurora::TalkTable::kDefaultCacheSize);
+}
+
+GTEST_TEST(TalkTable_TLKCache, plainASCII) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKLatin9);
+	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingLatin9);
+
+	// Plain ASCII strings don't need decoding, so they bypass the cache
+	EXPECT_STREQ(tlk.getString(1).c_str(), "Foo");
+	EXPECT_STREQ(tlk.getString(1).c_str(), "Foo");
+
+	const Aurora::TalkTable::CacheStats stats = tlk.getCacheStats();
+	EXPECT_EQ(stats.hits  , 0);
+	EXPECT_EQ(stats.misses, 0);
+	EXPECT_EQ(stats.count , 0);
+}
+
+GTEST_TEST(TalkTable_TLKCache, disabled) {
+	Common::MemoryReadStream *stream = new Common::MemoryReadStream(kTLKLatin9);
+	Aurora::TalkTable_TLK tlk(stream, Common::kEncodingLatin9);
+
+	tlk.setCacheSize(0);
+
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Caf\xC3\xA9");
+	EXPECT_STREQ(tlk.getString(0).c_str(), "Caf\xC3\xA9");
+
+	const Aurora::TalkTable::CacheStats stats = tlk.getCacheStats();
+	EXPECT_EQ(stats.hits  , 0);
+	EXPECT_EQ(stats.misses, 2);
+	EXPECT_EQ(stats.count , 0);
+}
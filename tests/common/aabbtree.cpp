@@ -0,0 +1,302 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the AABBTree class.
+ */
+
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/aabbtree.h"
+
+/** A box in the tree, for testing. */
+struct Box {
+	float min[3];
+	float max[3];
+
+	bool clickable;
+
+	Box(float x1, float y1, float z1, float x2, float y2, float z2) : clickable(true) {
+		min[0] = x1; min[1] = y1; min[2] = z1;
+		max[0] = x2; max[1] = y2; max[2] = z2;
+	}
+};
+
+/** Hit a box if it's clickable, at the point where the segment enters it. */
+struct HitTest {
+	const float *start;
+	const float *end;
+
+	HitTest(const float *s, const float *e) : start(s), end(e) {
+	}
+
+	bool operator()(void *data, float &t) const {
+		const Box &box = *static_cast<const Box *>(data);
+
+		return box.clickable && Common::AABBTree::intersect(box.min, box.max, start, end, t);
+	}
+};
+
+static Box *raycast(const Common::AABBTree &tree, const float *start, const float *end) {
+	return static_cast<Box *>(tree.raycast(start, end, HitTest(start, end)));
+}
+
+/** Find the nearest box hit by the segment, the slow way. */
+static Box *raycastLinear(std::vector<Box> &boxes, const float *start, const float *end) {
+	const HitTest hitTest(start, end);
+
+	Box *hit = 0;
+	float hitT = 1.0f;
+
+	for (std::vector<Box>::iterator b = boxes.begin(); b != boxes.end(); ++b) {
+		float t;
+		if (hitTest(&*b, t) && (t <= hitT)) {
+			hit  = &*b;
+			hitT = t;
+		}
+	}
+
+	return hit;
+}
+
+/** A simple, deterministic pseudo-random number generator. */
+static float random(uint32 &seed, float min, float max) {
+	seed = seed * 1664525 + 1013904223;
+	return min + ((seed >> 8) / 16777216.0f) * (max - min);
+}
+
+/** Create boxes scattered over an area, like objects placed in a game world. */
+static void createBoxes(std::vector<Box> &boxes, size_t count, float size, uint32 seed) {
+	boxes.reserve(count);
+
+	for (size_t i = 0; i < count; i++) {
+		const float x = random(seed, 0.0f, size);
+		const float y = random(seed, 0.0f, size);
+		const float z = random(seed, 0.0f, 5.0f);
+
+		const float width  = random(seed, 0.5f, 3.0f);
+		const float height = random(seed, 0.5f, 3.0f);
+		const float depth  = random(seed, 0.5f, 3.0f);
+
+		boxes.push_back(Box(x, y, z, x + width, y + height, z + depth));
+	}
+}
+
+/** Create a segment looking down at the area from above, at an angle. */
+static void createSegment(float *start, float *end, float size, uint32 &seed) {
+	start[0] = random(seed, 0.0f, size);
+	start[1] = random(seed, 0.0f, size);
+	start[2] = 50.0f;
+
+	end[0] = start[0] + random(seed, -20.0f, 20.0f);
+	end[1] = start[1] + random(seed, -20.0f, 20.0f);
+	end[2] = -50.0f;
+}
+
+GTEST_TEST(AABBTree, empty) {
+	const Common::AABBTree tree;
+
+	EXPECT_EQ(tree.getCount(), 0);
+	EXPECT_EQ(tree.getHeight(), 0);
+
+	const float start[3] = { 0.0f, 0.0f,  10.0f };
+	const float end  [3] = { 0.0f, 0.0f, -10.0f };
+
+	EXPECT_EQ(raycast(tree, start, end), static_cast<Box *>(0));
+}
+
+GTEST_TEST(AABBTree, add) {
+	Box box1(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+	Box box2(5.0f, 0.0f, 0.0f, 6.0f, 1.0f, 1.0f);
+
+	Common::AABBTree tree;
+
+	const Common::AABBTree::EntryID id1 = tree.add(box1.min, box1.max, &box1);
+	const Common::AABBTree::EntryID id2 = tree.add(box2.min, box2.max, &box2);
+
+	EXPECT_NE(id1, id2);
+
+	EXPECT_EQ(tree.getCount(), 2);
+	EXPECT_EQ(tree.getHeight(), 1);
+
+	EXPECT_EQ(tree.getData(id1), &box1);
+	EXPECT_EQ(tree.getData(id2), &box2);
+}
+
+GTEST_TEST(AABBTree, remove) {
+	Box box1(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+	Box box2(5.0f, 0.0f, 0.0f, 6.0f, 1.0f, 1.0f);
+
+	Common::AABBTree tree;
+
+	const Common::AABBTree::EntryID id1 = tree.add(box1.min, box1.max, &box1);
+	const Common::AABBTree::EntryID id2 = tree.add(box2.min, box2.max, &box2);
+
+	const float start[3] = { 0.5f, 0.5f,  10.0f };
+	const float end  [3] = { 0.5f, 0.5f, -10.0f };
+
+	EXPECT_EQ(raycast(tree, start, end), &box1);
+
+	tree.remove(id1);
+
+	EXPECT_EQ(tree.getCount(), 1);
+	EXPECT_EQ(tree.getData(id2), &box2);
+	EXPECT_EQ(raycast(tree, start, end), static_cast<Box *>(0));
+
+	// Freed entries are reused
+	EXPECT_EQ(tree.add(box1.min, box1.max, &box1), id1);
+	EXPECT_EQ(raycast(tree, start, end), &box1);
+}
+
+GTEST_TEST(AABBTree, raycastNearest) {
+	// Three boxes stacked on top of each other, added in a jumbled order
+	Box box1(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+	Box box2(0.0f, 0.0f, 2.0f, 1.0f, 1.0f, 3.0f);
+	Box box3(0.0f, 0.0f, 4.0f, 1.0f, 1.0f, 5.0f);
+
+	Common::AABBTree tree;
+
+	tree.add(box2.min, box2.max, &box2);
+	tree.add(box1.min, box1.max, &box1);
+	tree.add(box3.min, box3.max, &box3);
+
+	const float top   [3] = { 0.5f, 0.5f,  10.0f };
+	const float bottom[3] = { 0.5f, 0.5f, -10.0f };
+
+	EXPECT_EQ(raycast(tree, top, bottom), &box3);
+	EXPECT_EQ(raycast(tree, bottom, top), &box1);
+
+	// Boxes the hit test rejects are skipped
+	box3.clickable = false;
+	EXPECT_EQ(raycast(tree, top, bottom), &box2);
+
+	// The segment ends before reaching any box
+	const float middle[3] = { 0.5f, 0.5f, 3.5f };
+	EXPECT_EQ(raycast(tree, top, middle), static_cast<Box *>(0));
+
+	// A segment missing all boxes
+	const float start[3] = { 2.0f, 2.0f,  10.0f };
+	const float end  [3] = { 2.0f, 2.0f, -10.0f };
+	EXPECT_EQ(raycast(tree, start, end), static_cast<Box *>(0));
+}
+
+GTEST_TEST(AABBTree, update) {
+	Box box1(0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f);
+	Box box2(5.0f, 0.0f, 0.0f, 6.0f, 1.0f, 1.0f);
+
+	Common::AABBTree tree(0.5f);
+
+	const Common::AABBTree::EntryID id1 = tree.add(box1.min, box1.max, &box1);
+	tree.add(box2.min, box2.max, &box2);
+
+	const float start[3] = { 10.5f, 0.5f,  10.0f };
+	const float end  [3] = { 10.5f, 0.5f, -10.0f };
+
+	EXPECT_EQ(raycast(tree, start, end), static_cast<Box *>(0));
+
+	// Moving within the margin doesn't change the tree
+	box1 = Box(0.25f, 0.0f, 0.0f, 1.25f, 1.0f, 1.0f);
+	EXPECT_FALSE(tree.update(id1, box1.min, box1.max));
+
+	// Moving further does
+	box1 = Box(10.0f, 0.0f, 0.0f, 11.0f, 1.0f, 1.0f);
+	EXPECT_TRUE(tree.update(id1, box1.min, box1.max));
+
+	EXPECT_EQ(tree.getCount(), 2);
+	EXPECT_EQ(raycast(tree, start, end), &box1);
+}
+
+GTEST_TEST(AABBTree, intersect) {
+	const float min[3] = { 0.0f, 0.0f, 0.0f };
+	const float max[3] = { 1.0f, 1.0f, 1.0f };
+
+	float t = -1.0f;
+
+	const float start1[3] = { 0.5f, 0.5f,  2.0f };
+	const float end1  [3] = { 0.5f, 0.5f, -2.0f };
+	EXPECT_TRUE(Common::AABBTree::intersect(min, max, start1, end1, t));
+	EXPECT_FLOAT_EQ(t, 0.25f);
+
+	// Starting inside the box
+	const float start2[3] = { 0.5f, 0.5f, 0.5f };
+	EXPECT_TRUE(Common::AABBTree::intersect(min, max, start2, end1, t));
+	EXPECT_FLOAT_EQ(t, 0.0f);
+
+	// Diagonal
+	const float start3[3] = { -1.0f, -1.0f, -1.0f };
+	const float end3  [3] = {  3.0f,  3.0f,  3.0f };
+	EXPECT_TRUE(Common::AABBTree::intersect(min, max, start3, end3, t));
+	EXPECT_FLOAT_EQ(t, 0.25f);
+
+	// Missing the box
+	const float start4[3] = { 1.5f, 0.5f,  2.0f };
+	const float end4  [3] = { 1.5f, 0.5f, -2.0f };
+	EXPECT_FALSE(Common::AABBTree::intersect(min, max, start4, end4, t));
+
+	// Ending before the box
+	const float end5[3] = { 0.5f, 0.5f, 1.5f };
+	EXPECT_FALSE(Common::AABBTree::intersect(min, max, start1, end5, t));
+}
+
+GTEST_TEST(AABBTree, raycastRandom) {
+	static const size_t kCount = 1000;
+	static const float  kSize  = 200.0f;
+
+	std::vector<Box> boxes;
+	createBoxes(boxes, kCount, kSize, 0x12345678);
+
+	Common::AABBTree tree(0.25f);
+
+	std::vector<Common::AABBTree::EntryID> ids;
+	for (std::vector<Box>::iterator b = boxes.begin(); b != boxes.end(); ++b)
+		ids.push_back(tree.add(b->min, b->max, &*b));
+
+	// The tree should stay balanced
+	EXPECT_LE(tree.getHeight(), 20);
+
+	uint32 seed = 0x87654321;
+
+	// Move some boxes around, by a bit or by a lot
+	for (size_t i = 0; i < kCount; i += 3) {
+		const float dX = (i % 2) ? random(seed, -0.2f, 0.2f) : random(seed, -50.0f, 50.0f);
+		const float dY = (i % 2) ? random(seed, -0.2f, 0.2f) : random(seed, -50.0f, 50.0f);
+
+		boxes[i].min[0] += dX; boxes[i].max[0] += dX;
+		boxes[i].min[1] += dY; boxes[i].max[1] += dY;
+
+		tree.update(ids[i], boxes[i].min, boxes[i].max);
+	}
+
+	// And make some not clickable
+	for (size_t i = 0; i < kCount; i += 7)
+		boxes[i].clickable = false;
+
+	EXPECT_LE(tree.getHeight(), 20);
+
+	for (size_t i = 0; i < 1000; i++) {
+		float start[3], end[3];
+		createSegment(start, end, kSize, seed);
+
+		EXPECT_EQ(raycast(tree, start, end), raycastLinear(boxes, start, end)) << "At segment " << i;
+	}
+}
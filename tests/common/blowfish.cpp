@@ -22,13 +22,16 @@
  *  Unit tests for our Blowfish implementation.
  */
 
+#include <cstring>
 #include <vector>
 
 #include "gtest/gtest.h"
 
 #include "src/common/util.h"
 #include "src/common/error.h"
+#include "src/common/scopedptr.h"
 #include "src/common/memreadstream.h"
+#include "src/common/threadpool.h"
 #include "src/common/blowfish.h"
 
 static const byte kClearText[]  = { 'F', 'o', 'o', 'b', 'a', 'r', ' ', 'B', 'a', 'r', 'f', 'o', 'o' };
@@ -81,3 +84,78 @@ GTEST_TEST(Blowfish, misalign) {
 
 	EXPECT_THROW(Common::decryptBlowfishEBC(cipherText, key), Common::Exception);
 }
+
+GTEST_TEST(Blowfish, decryptInPlace) {
+	std::vector<byte> key;
+	createKey(key);
+
+	byte data[ARRAYSIZE(kCypherText)];
+	std::memcpy(data, kCypherText, sizeof(data));
+
+	Common::decryptBlowfishEBC(data, sizeof(data), key);
+
+	for (size_t i = 0; i < ARRAYSIZE(kClearText); i++)
+		EXPECT_EQ(data[i], kClearText[i]) << "At index " << i;
+
+	EXPECT_THROW(Common::decryptBlowfishEBC(data, 7, key), Common::Exception);
+}
+
+/** Fill a buffer with data that isn't the same in every block. */
+static void createData(std::vector<byte> &data, size_t size) {
+	data.resize(size);
+
+	for (size_t i = 0; i < size; i++)
+		data[i] = (byte) ((i * 7) ^ (i >> 8));
+}
+
+GTEST_TEST(Blowfish, inPlaceBlocks) {
+	std::vector<byte> key;
+	createKey(key);
+
+	// 4 interleaved blocks at a time, plus 3 single ones
+	std::vector<byte> clearText;
+	createData(clearText, 7 * 8);
+
+	Common::MemoryReadStream clearStream(&clearText[0], clearText.size());
+	Common::ScopedPtr<Common::MemoryReadStream> cipherStream(Common::encryptBlowfishEBC(clearStream, key));
+
+	std::vector<byte> data = clearText;
+	Common::encryptBlowfishEBC(&data[0], data.size(), key);
+
+	ASSERT_EQ(cipherStream->size(), data.size());
+	for (size_t i = 0; i < data.size(); i++)
+		EXPECT_EQ(data[i], cipherStream->readByte()) << "At index " << i;
+
+	// Each block on its own has to encrypt to the same
+	for (size_t i = 0; i < data.size(); i += 8) {
+		byte block[8];
+		std::memcpy(block, &clearText[i], 8);
+
+		Common::encryptBlowfishEBC(block, 8, key);
+		EXPECT_EQ(std::memcmp(block, &data[i], 8), 0) << "At block " << (i / 8);
+	}
+
+	Common::decryptBlowfishEBC(&data[0], data.size(), key);
+	EXPECT_TRUE(data == clearText);
+}
+
+GTEST_TEST(Blowfish, inPlaceThreadPool) {
+	std::vector<byte> key;
+	createKey(key);
+
+	// Several chunks, the last one not full
+	std::vector<byte> clearText;
+	createData(clearText, 300 * 1024 + 8);
+
+	Common::ThreadPool pool(2);
+
+	std::vector<byte> serial = clearText, parallel = clearText;
+	Common::encryptBlowfishEBC(&serial  [0], serial  .size(), key);
+	Common::encryptBlowfishEBC(&parallel[0], parallel.size(), key, &pool);
+
+	EXPECT_TRUE(serial == parallel);
+	EXPECT_FALSE(serial == clearText);
+
+	Common::decryptBlowfishEBC(&parallel[0], parallel.size(), key, &pool);
+	EXPECT_TRUE(parallel == clearText);
+}
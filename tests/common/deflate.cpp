@@ -24,6 +24,7 @@
 
 #include "gtest/gtest.h"
 
+#include "src/common/util.h"
 #include "src/common/deflate.h"
 #include "src/common/memreadstream.h"
 #include "src/common/error.h"
@@ -282,3 +283,76 @@ GTEST_TEST(DEFLATE, decompressChunked) {
 
 	delete[] output;
 }
+
+GTEST_TEST(DEFLATE, inflateStream) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	Common::InflateReadStream stream(new Common::MemoryReadStream(kDataCompressed),
+	                                 kSizeDecompressed, Common::kWindowBitsMaxRaw);
+
+	ASSERT_EQ(stream.size(), kSizeDecompressed);
+
+	for (size_t i = 0; i < kSizeDecompressed; i++)
+		EXPECT_EQ(stream.readByte(), kDataUncompressed[i]) << "At index " << i;
+
+	EXPECT_FALSE(stream.eos());
+
+	byte data;
+	EXPECT_EQ(stream.read(&data, 1), 0);
+	EXPECT_TRUE(stream.eos());
+}
+
+GTEST_TEST(DEFLATE, inflateStreamSeek) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+	static const size_t kRestartInterval  = 64;
+
+	Common::InflateReadStream stream(new Common::MemoryReadStream(kDataCompressed),
+	                                 kSizeDecompressed, Common::kWindowBitsMaxRaw, true, kRestartInterval);
+
+	// Seeking forward decompresses up to there, and saves all restart points on the way
+	stream.seek(300);
+	EXPECT_EQ(stream.readByte(), kDataUncompressed[300]);
+	EXPECT_EQ(stream.getRestartPointCount(), 300 / kRestartInterval);
+
+	// Going back, before, onto and after restart points
+	static const size_t kPositions[] = { 10, 63, 64, 65, 200, 0, 128, 301, 500, 100 };
+	for (size_t i = 0; i < ARRAYSIZE(kPositions); i++) {
+		stream.seek(kPositions[i]);
+
+		char data[16];
+		ASSERT_EQ(stream.read(data, sizeof(data)), sizeof(data));
+
+		for (size_t j = 0; j < sizeof(data); j++)
+			EXPECT_EQ(data[j], kDataUncompressed[kPositions[i] + j]) << "At index " << kPositions[i] + j;
+	}
+
+	EXPECT_EQ(stream.getRestartPointCount(), 516 / kRestartInterval);
+
+	stream.seek(-1, Common::SeekableReadStream::kOriginEnd);
+	EXPECT_EQ(stream.readByte(), kDataUncompressed[kSizeDecompressed - 1]);
+
+	EXPECT_THROW(stream.seek(kSizeDecompressed + 1), Common::Exception);
+}
+
+GTEST_TEST(DEFLATE, inflateStreamFailInputCut) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	Common::InflateReadStream stream(new Common::MemoryReadStream(kDataCompressed, sizeof(kDataCompressed) / 2),
+	                                 kSizeDecompressed, Common::kWindowBitsMaxRaw);
+
+	// The beginning is still fine
+	EXPECT_EQ(stream.readByte(), kDataUncompressed[0]);
+
+	stream.seek(-1, Common::SeekableReadStream::kOriginEnd);
+	EXPECT_THROW(stream.readByte(), Common::Exception);
+}
+
+GTEST_TEST(DEFLATE, inflateStreamFailOutputBig) {
+	static const size_t kSizeDecompressed = strlen(kDataUncompressed);
+
+	Common::InflateReadStream stream(new Common::MemoryReadStream(kDataCompressed),
+	                                 kSizeDecompressed + 1, Common::kWindowBitsMaxRaw);
+
+	stream.seek(-1, Common::SeekableReadStream::kOriginEnd);
+	EXPECT_THROW(stream.readByte(), Common::Exception);
+}
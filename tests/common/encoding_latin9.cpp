@@ -25,6 +25,7 @@
 #include "gtest/gtest.h"
 
 #include "src/common/error.h"
+#include "src/common/scopedptr.h"
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
 #include "src/common/memwritestream.h"
@@ -50,6 +51,23 @@ GTEST_TEST(XOREOS_ENCODINGNAME, isValidCodePoint) {
 	EXPECT_FALSE(Common::isValidCodepoint(kEncoding, 0x80));
 }
 
+GTEST_TEST(XOREOS_ENCODINGNAME, notLatin1) {
+	testSupport(kEncoding);
+
+	// Latin-9 replaced a few Latin-1 characters, like the currency sign with the euro sign
+	static const byte data[] = { '5', ' ', 0xA4, ' ', 0xBD };
+	static const char *utf8 = "5 ""\xe2""\x82""\xac"" ""\xc5""\x93";
+
+	const Common::UString string = Common::readString(data, sizeof(data), kEncoding);
+	EXPECT_STREQ(string.c_str(), utf8);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(Common::convertString(utf8, kEncoding, false));
+	ASSERT_EQ(stream->size(), sizeof(data));
+
+	for (size_t i = 0; i < sizeof(data); i++)
+		EXPECT_EQ(stream->readByte(), data[i]) << "At index " << i;
+}
+
 // -- Generalized encoding function tests --
 
 // Example string with terminating 0
@@ -25,6 +25,10 @@
 #ifndef TESTS_COMMON_ENCODING_TESTS_H
 #define TESTS_COMMON_ENCODING_TESTS_H
 
+#include <vector>
+
+#include "src/common/scopedptr.h"
+
 GTEST_TEST(XOREOS_ENCODINGNAME, readString) {
 	testSupport(kEncoding);
 
@@ -22,9 +22,12 @@
  *  Unit tests for little-endian UTF-16 encoding functions.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/error.h"
+#include "src/common/scopedptr.h"
 #include "src/common/encoding.h"
 #include "src/common/memreadstream.h"
 #include "src/common/memwritestream.h"
@@ -49,6 +52,43 @@ GTEST_TEST(XOREOS_ENCODINGNAME, isValidCodePoint) {
 	EXPECT_TRUE(Common::isValidCodepoint(kEncoding, 0x20));
 }
 
+GTEST_TEST(XOREOS_ENCODINGNAME, surrogatePairs) {
+	testSupport(kEncoding);
+
+	// U+1F600, grinning face
+	static const byte data[] = { 'a', 0x00, 0x3D, 0xD8, 0x00, 0xDE, 'b', 0x00 };
+	static const char *utf8 = "a""\xf0""\x9f""\x98""\x80""b";
+
+	const Common::UString string = Common::readString(data, sizeof(data), kEncoding);
+	EXPECT_EQ(string.size(), 3);
+	EXPECT_STREQ(string.c_str(), utf8);
+
+	Common::ScopedPtr<Common::MemoryReadStream> stream(Common::convertString(utf8, kEncoding, false));
+	ASSERT_EQ(stream->size(), sizeof(data));
+
+	for (size_t i = 0; i < sizeof(data); i++)
+		EXPECT_EQ(stream->readByte(), data[i]) << "At index " << i;
+}
+
+GTEST_TEST(XOREOS_ENCODINGNAME, longASCII) {
+	testSupport(kEncoding);
+
+	// Long enough for several blocks of 8 characters, with a non-ASCII character and an end in between
+	static const char *ascii = "The quick brown fox jumps over the lazy dog";
+
+	std::vector<byte> data;
+	for (const char *c = ascii; *c; c++) {
+		data.push_back(*c);
+		data.push_back(0x00);
+	}
+
+	data[2 * 20] = 0xF6;
+	data[2 * 34] = 0x00;
+
+	const Common::UString string = Common::readString(&data[0], data.size(), kEncoding);
+	EXPECT_STREQ(string.c_str(), "The quick brown fox ""\xc3""\xb6""umps over the");
+}
+
 // -- Generalized encoding function tests --
 
 // Example string with terminating 0
@@ -0,0 +1,190 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the Frustum class.
+ */
+
+#include "external/glm/gtc/matrix_transform.hpp"
+
+#include "gtest/gtest.h"
+
+#include "src/common/frustum.h"
+#include "src/common/boundingbox.h"
+#include "src/common/maths.h"
+
+/** Create the perspective projection the GraphicsManager uses by default. */
+static glm::mat4 createProjection() {
+	return glm::perspective(Common::deg2rad(60.0f), 4.0f / 3.0f, 1.0f, 1000.0f);
+}
+
+/** Create a camera view the same way the GraphicsManager does. */
+static glm::mat4 createModelview(float x, float y, float z, float pitch, float roll, float yaw) {
+	glm::mat4 modelview;
+
+	modelview = glm::rotate(modelview, Common::deg2rad(-pitch), glm::vec3(1.0f, 0.0f, 0.0f));
+	modelview = glm::rotate(modelview, Common::deg2rad(-roll ), glm::vec3(0.0f, 1.0f, 0.0f));
+	modelview = glm::rotate(modelview, Common::deg2rad(-yaw  ), glm::vec3(0.0f, 0.0f, 1.0f));
+	modelview = glm::translate(modelview, glm::vec3(-x, -y, -z));
+
+	return modelview;
+}
+
+static Common::BoundingBox createBox(float x1, float y1, float z1, float x2, float y2, float z2) {
+	Common::BoundingBox box;
+
+	box.add(x1, y1, z1);
+	box.add(x2, y2, z2);
+
+	return box;
+}
+
+GTEST_TEST(Frustum, empty) {
+	const Common::Frustum frustum;
+
+	EXPECT_TRUE(frustum.isIn(0.0f, 0.0f, 0.0f));
+	EXPECT_TRUE(frustum.isIn(1000.0f, -1000.0f, 1000.0f));
+	EXPECT_TRUE(frustum.isIn(createBox(-5.0f, -5.0f, -5.0f, 5.0f, 5.0f, 5.0f)));
+
+	EXPECT_FLOAT_EQ(frustum.getMaxDistance(), 0.0f);
+}
+
+GTEST_TEST(Frustum, emptyBox) {
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+
+	EXPECT_TRUE(frustum.isIn(Common::BoundingBox()));
+}
+
+GTEST_TEST(Frustum, pointsForward) {
+	// Camera at the origin, looking down the negative z axis
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+
+	EXPECT_TRUE(frustum.isIn(0.0f, 0.0f, -10.0f));
+	EXPECT_TRUE(frustum.isIn(3.0f, 2.0f, -10.0f));
+	EXPECT_TRUE(frustum.isIn(0.0f, 0.0f, -999.0f));
+
+	EXPECT_FALSE(frustum.isIn(0.0f, 0.0f, 10.0f));     // Behind
+	EXPECT_FALSE(frustum.isIn(0.0f, 0.0f, -0.5f));     // Before the near plane
+	EXPECT_FALSE(frustum.isIn(0.0f, 0.0f, -1001.0f));  // Behind the far plane
+	EXPECT_FALSE(frustum.isIn(-100.0f, 0.0f, -10.0f)); // Left
+	EXPECT_FALSE(frustum.isIn( 100.0f, 0.0f, -10.0f)); // Right
+	EXPECT_FALSE(frustum.isIn(0.0f, -100.0f, -10.0f)); // Below
+	EXPECT_FALSE(frustum.isIn(0.0f,  100.0f, -10.0f)); // Above
+
+	// The vertical field of view is 60°, the horizontal one wider
+	EXPECT_TRUE (frustum.isIn(0.0f, 5.5f, -10.0f));
+	EXPECT_FALSE(frustum.isIn(0.0f, 6.0f, -10.0f));
+	EXPECT_TRUE (frustum.isIn(7.5f, 0.0f, -10.0f));
+	EXPECT_FALSE(frustum.isIn(8.0f, 0.0f, -10.0f));
+}
+
+GTEST_TEST(Frustum, pointsLookingNorth) {
+	// Camera looking along the positive y axis, like an upright game camera
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(10.0f, 20.0f, 5.0f, 90.0f, 0.0f, 0.0f));
+
+	EXPECT_TRUE (frustum.isIn(10.0f, 30.0f, 5.0f));
+	EXPECT_FALSE(frustum.isIn(10.0f, 10.0f, 5.0f));
+	EXPECT_FALSE(frustum.isIn(10.0f, 20.0f, 15.0f));
+	EXPECT_FALSE(frustum.isIn(60.0f, 30.0f, 5.0f));
+}
+
+GTEST_TEST(Frustum, pointsLookingWest) {
+	// Camera looking along the negative x axis
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(10.0f, 20.0f, 5.0f, 90.0f, 0.0f, 90.0f));
+
+	EXPECT_TRUE (frustum.isIn( 0.0f, 20.0f, 5.0f));
+	EXPECT_FALSE(frustum.isIn(20.0f, 20.0f, 5.0f));
+	EXPECT_FALSE(frustum.isIn(10.0f, 30.0f, 5.0f));
+}
+
+GTEST_TEST(Frustum, boxes) {
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+
+	// Completely inside
+	EXPECT_TRUE(frustum.isIn(createBox(-1.0f, -1.0f, -12.0f, 1.0f, 1.0f, -10.0f)));
+	// Containing the camera
+	EXPECT_TRUE(frustum.isIn(createBox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f)));
+	// Partly inside, partly behind the camera
+	EXPECT_TRUE(frustum.isIn(createBox(-1.0f, -1.0f, -10.0f, 1.0f, 1.0f, 10.0f)));
+	// Partly inside, partly to the right
+	EXPECT_TRUE(frustum.isIn(createBox(5.0f, -1.0f, -12.0f, 50.0f, 1.0f, -10.0f)));
+	// All corners outside, but spanning the whole view
+	EXPECT_TRUE(frustum.isIn(createBox(-100.0f, -1.0f, -20.0f, 100.0f, 1.0f, -10.0f)));
+
+	// Completely behind the camera
+	EXPECT_FALSE(frustum.isIn(createBox(-1.0f, -1.0f, 10.0f, 1.0f, 1.0f, 12.0f)));
+	// Completely to the left
+	EXPECT_FALSE(frustum.isIn(createBox(-50.0f, -1.0f, -12.0f, -20.0f, 1.0f, -10.0f)));
+	// Completely above
+	EXPECT_FALSE(frustum.isIn(createBox(-1.0f, 20.0f, -12.0f, 1.0f, 30.0f, -10.0f)));
+	// Completely behind the far plane
+	EXPECT_FALSE(frustum.isIn(createBox(-1.0f, -1.0f, -1200.0f, 1.0f, 1.0f, -1100.0f)));
+}
+
+GTEST_TEST(Frustum, boxesTransformed) {
+	// A box that's only in view after moving it with its origin
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(10.0f, 20.0f, 5.0f, 90.0f, 0.0f, 0.0f));
+
+	Common::BoundingBox box = createBox(-1.0f, -1.0f, -1.0f, 1.0f, 1.0f, 1.0f);
+	EXPECT_FALSE(frustum.isIn(box));
+
+	box.translate(10.0f, 30.0f, 5.0f);
+	box.absolutize();
+	EXPECT_TRUE(frustum.isIn(box));
+}
+
+GTEST_TEST(Frustum, maxDistance) {
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(10.0f, 20.0f, 5.0f, 90.0f, 0.0f, 0.0f));
+	frustum.setMaxDistance(40.0f);
+
+	EXPECT_FLOAT_EQ(frustum.getMaxDistance(), 40.0f);
+
+	EXPECT_TRUE (frustum.isIn(10.0f, 50.0f, 5.0f));
+	EXPECT_FALSE(frustum.isIn(10.0f, 70.0f, 5.0f));
+
+	// The closest point of the box counts, not its center
+	EXPECT_TRUE (frustum.isIn(createBox(5.0f, 55.0f, 0.0f, 15.0f, 65.0f, 10.0f)));
+	EXPECT_FALSE(frustum.isIn(createBox(5.0f, 65.0f, 0.0f, 15.0f, 75.0f, 10.0f)));
+
+	frustum.setMaxDistance(0.0f);
+
+	EXPECT_TRUE(frustum.isIn(10.0f, 70.0f, 5.0f));
+	EXPECT_TRUE(frustum.isIn(createBox(5.0f, 65.0f, 0.0f, 15.0f, 75.0f, 10.0f)));
+}
+
+GTEST_TEST(Frustum, clear) {
+	Common::Frustum frustum;
+	frustum.set(createProjection(), createModelview(0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f));
+	frustum.setMaxDistance(10.0f);
+
+	EXPECT_FALSE(frustum.isIn(0.0f, 0.0f, 10.0f));
+
+	frustum.clear();
+
+	EXPECT_TRUE(frustum.isIn(0.0f, 0.0f, 10.0f));
+	EXPECT_TRUE(frustum.isIn(0.0f, 0.0f, -100.0f));
+}
@@ -0,0 +1,156 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our LRUCache template.
+ */
+
+#include "gtest/gtest.h"
+
+#include "src/common/lrucache.h"
+
+typedef Common::LRUCache<int, int> Cache;
+
+GTEST_TEST(LRUCache, getPut) {
+	Cache cache(100);
+
+	int value = 0;
+	EXPECT_FALSE(cache.get(1, value));
+
+	EXPECT_TRUE(cache.put(1, 23, 10));
+	EXPECT_TRUE(cache.put(2, 42, 10));
+
+	ASSERT_TRUE(cache.get(1, value));
+	EXPECT_EQ(value, 23);
+	ASSERT_TRUE(cache.get(2, value));
+	EXPECT_EQ(value, 42);
+
+	EXPECT_TRUE (cache.contains(1));
+	EXPECT_FALSE(cache.contains(3));
+
+	// Replacing a value
+	EXPECT_TRUE(cache.put(1, 5, 20));
+	ASSERT_TRUE(cache.get(1, value));
+	EXPECT_EQ(value, 5);
+
+	const Cache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.hits     , 3);
+	EXPECT_EQ(stats.misses   , 1);
+	EXPECT_EQ(stats.evictions, 0);
+	EXPECT_EQ(stats.count    , 2);
+	EXPECT_EQ(stats.size     , 30);
+	EXPECT_EQ(stats.budget   , 100);
+}
+
+GTEST_TEST(LRUCache, evict) {
+	Cache cache(30);
+
+	cache.put(1, 1, 10);
+	cache.put(2, 2, 10);
+	cache.put(3, 3, 10);
+
+	// Using 1 makes 2 the least recently used value
+	int value = 0;
+	EXPECT_TRUE(cache.get(1, value));
+
+	cache.put(4, 4, 10);
+
+	EXPECT_TRUE (cache.get(1, value));
+	EXPECT_FALSE(cache.get(2, value));
+	EXPECT_TRUE (cache.get(3, value));
+	EXPECT_TRUE (cache.get(4, value));
+
+	// Needs room for two values, evicting 1 and 3
+	cache.put(5, 5, 20);
+
+	EXPECT_FALSE(cache.get(1, value));
+	EXPECT_FALSE(cache.get(3, value));
+	EXPECT_TRUE (cache.get(4, value));
+	EXPECT_TRUE (cache.get(5, value));
+
+	const Cache::Stats stats = cache.getStats();
+	EXPECT_EQ(stats.evictions, 3);
+	EXPECT_EQ(stats.count    , 2);
+	EXPECT_EQ(stats.size     , 30);
+}
+
+GTEST_TEST(LRUCache, tooLarge) {
+	Cache cache(30);
+
+	cache.put(1, 1, 10);
+
+	EXPECT_FALSE(cache.put(2, 2, 31));
+
+	int value = 0;
+	EXPECT_TRUE (cache.get(1, value));
+	EXPECT_FALSE(cache.get(2, value));
+
+	EXPECT_EQ(cache.getStats().evictions, 0);
+}
+
+GTEST_TEST(LRUCache, setBudget) {
+	Cache cache(30);
+
+	cache.put(1, 1, 10);
+	cache.put(2, 2, 10);
+	cache.put(3, 3, 10);
+
+	cache.setBudget(15);
+
+	int value = 0;
+	EXPECT_FALSE(cache.get(1, value));
+	EXPECT_FALSE(cache.get(2, value));
+	EXPECT_TRUE (cache.get(3, value));
+
+	// A budget of 0 disables the cache
+	cache.setBudget(0);
+	EXPECT_FALSE(cache.get(3, value));
+	EXPECT_FALSE(cache.put(4, 4, 1));
+
+	EXPECT_EQ(cache.getStats().evictions, 3);
+	EXPECT_EQ(cache.getStats().size     , 0);
+}
+
+GTEST_TEST(LRUCache, erase) {
+	Cache cache(100);
+
+	for (int i = 0; i < 10; i++)
+		cache.put(i, i, 1);
+
+	cache.erase(0);
+	cache.eraseIf([](int key) { return (key % 2) == 1; });
+
+	int value = 0;
+	for (int i = 0; i < 10; i++)
+		EXPECT_EQ(cache.get(i, value), (i != 0) && ((i % 2) == 0)) << "At key " << i;
+
+	EXPECT_EQ(cache.getStats().size, 4);
+
+	cache.clear();
+	EXPECT_EQ(cache.getStats().size , 0);
+	EXPECT_EQ(cache.getStats().count, 0);
+
+	// Erasing isn't evicting
+	EXPECT_EQ(cache.getStats().evictions, 0);
+
+	cache.resetStats();
+	EXPECT_EQ(cache.getStats().hits  , 0);
+	EXPECT_EQ(cache.getStats().misses, 0);
+}
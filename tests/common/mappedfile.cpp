@@ -0,0 +1,121 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our memory-mapped file read stream.
+ */
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+
+#include "gtest/gtest.h"
+
+#include "src/common/util.h"
+#include "src/common/error.h"
+#include "src/common/scopedptr.h"
+#include "src/common/platform.h"
+#include "src/common/readstream.h"
+#include "src/common/mappedfile.h"
+
+static boost::filesystem::path kFilePath;
+
+static const byte kData[8] = { 0x12, 0x34, 0x56, 0x78, 0x90, 0xAB, 0xCD, 0xEF };
+
+class MappedFile : public ::testing::Test {
+protected:
+	static void SetUpTestCase() {
+		Common::Platform::init();
+
+		boost::filesystem::path tmpPath    = boost::filesystem::temp_directory_path();
+		boost::filesystem::path uniquePath = boost::filesystem::unique_path("%%%%_%%%%_%%%%_%%%%.xoreos");
+
+		kFilePath = tmpPath / uniquePath;
+
+		boost::filesystem::ofstream testFile(kFilePath, std::ofstream::binary);
+		testFile.write(reinterpret_cast<const char *>(kData), ARRAYSIZE(kData));
+		testFile.close();
+	}
+
+	static void TearDownTestCase() {
+		if (!kFilePath.empty())
+			boost::filesystem::remove(kFilePath);
+	}
+};
+
+GTEST_TEST_F(MappedFile, read) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::ScopedPtr<Common::MappedFileReadStream> file(Common::MappedFileReadStream::open(kFilePath.generic_string()));
+	ASSERT_TRUE(file);
+
+	EXPECT_EQ(file->size(), ARRAYSIZE(kData));
+
+	for (size_t i = 0; i < ARRAYSIZE(kData); i++)
+		EXPECT_EQ(file->readByte(), kData[i]) << "At index " << i;
+
+	EXPECT_THROW(file->readByte(), Common::Exception);
+}
+
+GTEST_TEST_F(MappedFile, readStreamAt) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::ScopedPtr<Common::MappedFileReadStream> file(Common::MappedFileReadStream::open(kFilePath.generic_string()));
+	ASSERT_TRUE(file);
+
+	Common::ScopedPtr<Common::MemoryReadStream> view(file->readStreamAt(2, 4));
+
+	// The view points directly into the mapping
+	EXPECT_EQ(view->getData(), file->getData() + 2);
+	EXPECT_EQ(view->size(), 4);
+
+	// A view of a view still points into the same mapping
+	Common::ScopedPtr<Common::MemoryReadStream> subView(view->readStreamAt(1, 2));
+	EXPECT_EQ(subView->getData(), file->getData() + 3);
+
+	EXPECT_THROW(view->readStreamAt(3, 2), Common::Exception);
+
+	// The views keep the mapping alive
+	file.reset();
+
+	for (size_t i = 0; i < 4; i++)
+		EXPECT_EQ(view->readByte(), kData[2 + i]) << "At index " << i;
+
+	EXPECT_EQ(subView->readByte(), kData[3]);
+	EXPECT_EQ(subView->readByte(), kData[4]);
+}
+
+GTEST_TEST_F(MappedFile, readStreamAtSubStream) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	Common::ScopedPtr<Common::MappedFileReadStream> file(Common::MappedFileReadStream::open(kFilePath.generic_string()));
+	ASSERT_TRUE(file);
+
+	Common::SeekableSubReadStream subStream(file.get(), 4, 8);
+
+	Common::ScopedPtr<Common::MemoryReadStream> view(subStream.readStreamAt(1, 3));
+	EXPECT_EQ(view->getData(), file->getData() + 5);
+}
+
+GTEST_TEST_F(MappedFile, openFail) {
+	const boost::filesystem::path path = kFilePath.generic_string() + ".nonexistent";
+
+	Common::ScopedPtr<Common::MappedFileReadStream> file(Common::MappedFileReadStream::open(path.generic_string()));
+	EXPECT_FALSE(file);
+}
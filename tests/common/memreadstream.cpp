@@ -105,6 +105,42 @@ GTEST_TEST(MemoryReadStream, readStream) {
 	EXPECT_THROW(stream.readStream(ARRAYSIZE(data) + 1), Common::Exception);
 }
 
+GTEST_TEST(MemoryReadStream, readAt) {
+	static const byte data[5] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+	Common::MemoryReadStream stream(data);
+
+	stream.seek(1);
+
+	byte readData[3] = { 0 };
+	EXPECT_EQ(stream.readAt(2, readData, 3), 3);
+
+	EXPECT_EQ(readData[0], 0x56);
+	EXPECT_EQ(readData[1], 0x78);
+	EXPECT_EQ(readData[2], 0x90);
+
+	EXPECT_EQ(stream.pos(), 1);
+
+	EXPECT_EQ(stream.readAt(4, readData, 3), 1);
+	EXPECT_EQ(stream.readAt(5, readData, 3), 0);
+}
+
+GTEST_TEST(MemoryReadStream, readStreamAt) {
+	static const byte data[3] = { 0x12, 0x34, 0x56 };
+	Common::MemoryReadStream stream(data);
+
+	Common::MemoryReadStream *streamRead = stream.readStreamAt(1, 2);
+
+	EXPECT_EQ(streamRead->size(), 2);
+	EXPECT_EQ(streamRead->readByte(), 0x34);
+	EXPECT_EQ(streamRead->readByte(), 0x56);
+
+	delete streamRead;
+
+	EXPECT_EQ(stream.pos(), 0);
+
+	EXPECT_THROW(stream.readStreamAt(1, 3), Common::Exception);
+}
+
 GTEST_TEST(MemoryReadStream, readChar) {
 	static const byte data[3] = { 0x12, 0x34, 0x56 };
 	Common::MemoryReadStream stream(data);
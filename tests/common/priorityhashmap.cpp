@@ -0,0 +1,268 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our PriorityHashMap template.
+ */
+
+
+#include <map>
+#include <list>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/system.h"
+#include "src/common/priorityhashmap.h"
+
+struct TestValue {
+	uint32 priority;
+	uint32 id;
+
+	TestValue(uint32 p = 0, uint32 i = 0) : priority(p), id(i) { }
+
+	bool operator<(const TestValue &right) const {
+		return priority < right.priority;
+	}
+};
+
+typedef Common::PriorityHashMap<TestValue> TestMap;
+
+/** Simple deterministic pseudo-random number generator. */
+static uint64 nextRandom(uint64 &state) {
+	state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+
+	return state >> 16;
+}
+
+/** Return the IDs of the chain for this hash, from highest to lowest priority. */
+static std::vector<uint32> getChain(const TestMap &map, uint64 hash) {
+	std::vector<uint32> ids;
+
+	for (TestMap::Handle h = map.find(hash); h != TestMap::kInvalidHandle; h = map.getNext(h))
+		ids.push_back(map.get(h).id);
+
+	return ids;
+}
+
+GTEST_TEST(PriorityHashMap, empty) {
+	TestMap map;
+
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.size(), 0);
+	EXPECT_EQ(map.getKeyCount(), 0);
+
+	EXPECT_EQ(map.find(23), TestMap::kInvalidHandle);
+}
+
+GTEST_TEST(PriorityHashMap, insertFind) {
+	TestMap map;
+
+	const TestMap::Handle h1 = map.insert(1, TestValue(1, 1));
+	const TestMap::Handle h2 = map.insert(2, TestValue(1, 2));
+
+	EXPECT_FALSE(map.empty());
+	EXPECT_EQ(map.size(), 2);
+	EXPECT_EQ(map.getKeyCount(), 2);
+
+	EXPECT_EQ(map.find(1), h1);
+	EXPECT_EQ(map.find(2), h2);
+	EXPECT_EQ(map.find(3), TestMap::kInvalidHandle);
+
+	EXPECT_EQ(map.get(h1).id, 1);
+	EXPECT_EQ(map.get(h2).id, 2);
+
+	EXPECT_EQ(map.getHash(h1), 1);
+	EXPECT_EQ(map.getHash(h2), 2);
+}
+
+GTEST_TEST(PriorityHashMap, priorityOrder) {
+	TestMap map;
+
+	map.insert(5, TestValue(10, 1));
+	map.insert(5, TestValue(30, 2));
+	map.insert(5, TestValue(20, 3));
+	map.insert(5, TestValue(30, 4));
+	map.insert(5, TestValue( 5, 5));
+
+	EXPECT_EQ(map.size(), 5);
+	EXPECT_EQ(map.getKeyCount(), 1);
+
+	// Highest priority first, newest first among equal priorities
+	const std::vector<uint32> chain = getChain(map, 5);
+	ASSERT_EQ(chain.size(), 5);
+
+	EXPECT_EQ(chain[0], 4);
+	EXPECT_EQ(chain[1], 2);
+	EXPECT_EQ(chain[2], 3);
+	EXPECT_EQ(chain[3], 1);
+	EXPECT_EQ(chain[4], 5);
+
+	EXPECT_EQ(map.get(map.getLast(map.find(5))).id, 5);
+}
+
+GTEST_TEST(PriorityHashMap, erase) {
+	TestMap map;
+
+	const TestMap::Handle h1 = map.insert(7, TestValue(1, 1));
+	const TestMap::Handle h2 = map.insert(7, TestValue(2, 2));
+	const TestMap::Handle h3 = map.insert(7, TestValue(3, 3));
+
+	map.erase(h2);
+
+	std::vector<uint32> chain = getChain(map, 7);
+	ASSERT_EQ(chain.size(), 2);
+	EXPECT_EQ(chain[0], 3);
+	EXPECT_EQ(chain[1], 1);
+
+	map.erase(h3);
+
+	chain = getChain(map, 7);
+	ASSERT_EQ(chain.size(), 1);
+	EXPECT_EQ(chain[0], 1);
+
+	map.erase(h1);
+
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.getKeyCount(), 0);
+	EXPECT_EQ(map.find(7), TestMap::kInvalidHandle);
+}
+
+GTEST_TEST(PriorityHashMap, stableAddresses) {
+	TestMap map;
+
+	const TestMap::Handle handle = map.insert(0, TestValue(1, 1));
+	const TestValue *value = &map.get(handle);
+
+	// Force a few rehashes
+	for (uint32 i = 1; i < 10000; i++)
+		map.insert(i, TestValue(1, i));
+
+	EXPECT_EQ(&map.get(handle), value);
+	EXPECT_EQ(map.find(0), handle);
+}
+
+GTEST_TEST(PriorityHashMap, clear) {
+	TestMap map;
+
+	for (uint32 i = 0; i < 100; i++)
+		map.insert(i, TestValue(1, i));
+
+	map.clear();
+
+	EXPECT_TRUE(map.empty());
+	EXPECT_EQ(map.getKeyCount(), 0);
+	EXPECT_EQ(map.find(5), TestMap::kInvalidHandle);
+
+	map.insert(5, TestValue(1, 5));
+	EXPECT_EQ(map.get(map.find(5)).id, 5);
+}
+
+GTEST_TEST(PriorityHashMap, iterate) {
+	TestMap map;
+
+	for (uint32 i = 0; i < 100; i++) {
+		map.insert(i, TestValue(1, i));
+		map.insert(i, TestValue(2, i + 100));
+	}
+
+	std::vector<bool> seen(100, false);
+
+	size_t count = 0;
+	for (size_t i = 0; i < map.getBucketCount(); i++) {
+		const TestMap::Handle h = map.getBucket(i);
+		if (h == TestMap::kInvalidHandle)
+			continue;
+
+		const uint64 hash = map.getHash(h);
+		ASSERT_LT(hash, 100);
+
+		EXPECT_FALSE(seen[hash]);
+		seen[hash] = true;
+
+		EXPECT_EQ(map.get(h).id, hash + 100);
+		count++;
+	}
+
+	EXPECT_EQ(count, 100);
+}
+
+GTEST_TEST(PriorityHashMap, randomized) {
+	/* Compare against a std::map of std::lists, sorted the same way,
+	 * with interleaved inserts and erases over a small hash space. */
+
+	typedef std::map<uint64, std::list<std::pair<TestValue, TestMap::Handle> > > ReferenceMap;
+
+	TestMap map;
+	ReferenceMap reference;
+
+	uint64 state = 23;
+
+	for (uint32 i = 0; i < 20000; i++) {
+		const uint64 hash = nextRandom(state) % 2000;
+
+		if (((nextRandom(state) % 3) == 0) && (reference.find(hash) != reference.end())) {
+			std::list<std::pair<TestValue, TestMap::Handle> > &list = reference[hash];
+
+			std::list<std::pair<TestValue, TestMap::Handle> >::iterator it = list.begin();
+			std::advance(it, nextRandom(state) % list.size());
+
+			map.erase(it->second);
+
+			list.erase(it);
+			if (list.empty())
+				reference.erase(hash);
+
+			continue;
+		}
+
+		const TestValue value((uint32)(nextRandom(state) % 4), i);
+
+		std::list<std::pair<TestValue, TestMap::Handle> > &list = reference[hash];
+
+		std::list<std::pair<TestValue, TestMap::Handle> >::iterator it = list.begin();
+		while ((it != list.end()) && (value < it->first))
+			++it;
+
+		list.insert(it, std::make_pair(value, map.insert(hash, value)));
+	}
+
+	size_t valueCount = 0;
+	for (ReferenceMap::const_iterator r = reference.begin(); r != reference.end(); ++r) {
+		const std::vector<uint32> chain = getChain(map, r->first);
+		ASSERT_EQ(chain.size(), r->second.size());
+
+		size_t n = 0;
+		for (std::list<std::pair<TestValue, TestMap::Handle> >::const_iterator v = r->second.begin();
+		     v != r->second.end(); ++v, ++n)
+			EXPECT_EQ(chain[n], v->first.id);
+
+		valueCount += chain.size();
+	}
+
+	EXPECT_EQ(map.size(), valueCount);
+	EXPECT_EQ(map.getKeyCount(), reference.size());
+
+	for (uint64 hash = 0; hash < 2000; hash++) {
+		if (reference.find(hash) == reference.end()) {
+			EXPECT_EQ(map.find(hash), TestMap::kInvalidHandle);
+		}
+	}
+}
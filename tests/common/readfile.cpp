@@ -87,3 +87,39 @@ GTEST_TEST_F(ReadFile, write) {
 	for (size_t i = 0; i < ARRAYSIZE(data); i++)
 		EXPECT_EQ(readData[i], data[i]) << "At index " << i;
 }
+
+GTEST_TEST_F(ReadFile, readAt) {
+	ASSERT_FALSE(kFilePath.empty());
+
+	static const byte data[5] = { 0x12, 0x34, 0x56, 0x78, 0x90 };
+
+	// Create the input file
+
+	boost::filesystem::ofstream testFile(kFilePath, std::ofstream::binary);
+
+	testFile.write(reinterpret_cast<const char *>(data), ARRAYSIZE(data));
+	testFile.flush();
+	ASSERT_FALSE(testFile.fail());
+
+	testFile.close();
+
+	// Read from the middle of the file, without moving the file position
+
+	Common::ReadFile file(kFilePath.generic_string());
+	ASSERT_TRUE(file.isOpen());
+
+	file.seek(1);
+
+	byte readData[3] = { 0 };
+	EXPECT_EQ(file.readAt(2, readData, 3), 3);
+
+	EXPECT_EQ(readData[0], 0x56);
+	EXPECT_EQ(readData[1], 0x78);
+	EXPECT_EQ(readData[2], 0x90);
+
+	EXPECT_EQ(file.pos(), 1);
+	EXPECT_EQ(file.readByte(), 0x34);
+
+	EXPECT_EQ(file.readAt(4, readData, 3), 1);
+	EXPECT_EQ(file.readAt(5, readData, 3), 0);
+}
@@ -55,6 +55,16 @@ tests_common_test_ptrmap_SOURCES  = tests/common/ptrmap.cpp
 tests_common_test_ptrmap_LDADD    = $(common_LIBS)
 tests_common_test_ptrmap_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                            += tests/common/test_priorityhashmap
+tests_common_test_priorityhashmap_SOURCES  = tests/common/priorityhashmap.cpp
+tests_common_test_priorityhashmap_LDADD    = $(common_LIBS)
+tests_common_test_priorityhashmap_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                     += tests/common/test_lrucache
+tests_common_test_lrucache_SOURCES  = tests/common/lrucache.cpp
+tests_common_test_lrucache_LDADD    = $(common_LIBS)
+tests_common_test_lrucache_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                    += tests/common/test_ustring
 tests_common_test_ustring_SOURCES  = tests/common/ustring.cpp
 tests_common_test_ustring_LDADD    = $(common_LIBS)
@@ -90,6 +100,11 @@ tests_common_test_readfile_SOURCES  = tests/common/readfile.cpp
 tests_common_test_readfile_LDADD    = $(common_LIBS)
 tests_common_test_readfile_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                       += tests/common/test_mappedfile
+tests_common_test_mappedfile_SOURCES  = tests/common/mappedfile.cpp
+tests_common_test_mappedfile_LDADD    = $(common_LIBS)
+tests_common_test_mappedfile_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                      += tests/common/test_writefile
 tests_common_test_writefile_SOURCES  = tests/common/writefile.cpp
 tests_common_test_writefile_LDADD    = $(common_LIBS)
@@ -246,6 +261,11 @@ tests_common_test_boundingbox_SOURCES  = tests/common/boundingbox.cpp
 tests_common_test_boundingbox_LDADD    = $(common_LIBS)
 tests_common_test_boundingbox_CXXFLAGS = $(test_CXXFLAGS)
 
+check_PROGRAMS                     += tests/common/test_frustum
+tests_common_test_frustum_SOURCES  = tests/common/frustum.cpp
+tests_common_test_frustum_LDADD    = $(common_LIBS)
+tests_common_test_frustum_CXXFLAGS = $(test_CXXFLAGS)
+
 check_PROGRAMS                 += tests/common/test_rect
 tests_common_test_rect_SOURCES  = tests/common/rect.cpp
 tests_common_test_rect_LDADD    = $(common_LIBS)
@@ -260,3 +280,13 @@ check_PROGRAMS                     += tests/common/test_aabbnode
 tests_common_test_aabbnode_SOURCES  = tests/common/aabbnode.cpp
 tests_common_test_aabbnode_LDADD    = $(common_LIBS)
 tests_common_test_aabbnode_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                     += tests/common/test_aabbtree
+tests_common_test_aabbtree_SOURCES  = tests/common/aabbtree.cpp
+tests_common_test_aabbtree_LDADD    = $(common_LIBS)
+tests_common_test_aabbtree_CXXFLAGS = $(test_CXXFLAGS)
+
+check_PROGRAMS                       += tests/common/test_threadpool
+tests_common_test_threadpool_SOURCES  = tests/common/threadpool.cpp
+tests_common_test_threadpool_LDADD    = $(common_LIBS)
+tests_common_test_threadpool_CXXFLAGS = $(test_CXXFLAGS)
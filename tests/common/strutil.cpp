@@ -349,6 +349,35 @@ GTEST_TEST(StrUtil, parseDouble) {
 	EXPECT_DOUBLE_EQ(x, 0.0);
 }
 
+GTEST_TEST(StrUtil, tryParseInt32) {
+	int32 x = 5;
+
+	EXPECT_TRUE(Common::tryParseString("-23", x));
+	EXPECT_EQ(x, -23);
+	EXPECT_TRUE(Common::tryParseString( "23 ", x));
+	EXPECT_EQ(x,  23);
+
+	// Failures leave the value alone
+	EXPECT_FALSE(Common::tryParseString("", x));
+	EXPECT_EQ(x, 23);
+	EXPECT_FALSE(Common::tryParseString("Foobar", x));
+	EXPECT_EQ(x, 23);
+	EXPECT_FALSE(Common::tryParseString("1.5", x));
+	EXPECT_EQ(x, 23);
+	EXPECT_FALSE(Common::tryParseString("2147483648", x));
+	EXPECT_EQ(x, 23);
+}
+
+GTEST_TEST(StrUtil, tryParseFloat) {
+	float x = 5.0f;
+
+	EXPECT_TRUE(Common::tryParseString("-1.5", x));
+	EXPECT_FLOAT_EQ(x, -1.5f);
+
+	EXPECT_FALSE(Common::tryParseString("****", x));
+	EXPECT_FLOAT_EQ(x, -1.5f);
+}
+
 GTEST_TEST(StrUtil, searchBackwards) {
 	static const byte kHaystack[] = { 'a','x',' ','a','b','c',' ','a','x','y',' ','a','z','x' };
 	Common::MemoryReadStream haystack(kHaystack, sizeof(kHaystack));
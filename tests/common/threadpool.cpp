@@ -0,0 +1,112 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for our thread pool.
+ */
+
+#include <atomic>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "src/common/error.h"
+#include "src/common/threadpool.h"
+
+GTEST_TEST(ThreadPool, threadCount) {
+	Common::ThreadPool pool(3);
+	EXPECT_EQ(pool.getThreadCount(), 3);
+
+	Common::ThreadPool defaultPool;
+	EXPECT_EQ(defaultPool.getThreadCount(), Common::ThreadPool::getHardwareThreadCount());
+}
+
+GTEST_TEST(ThreadPool, enqueue) {
+	Common::ThreadPool pool(4);
+
+	std::vector< std::future<int> > results;
+	for (int i = 0; i < 100; i++)
+		results.push_back(pool.enqueue([i]() { return i * i; }));
+
+	for (int i = 0; i < 100; i++)
+		EXPECT_EQ(results[i].get(), i * i) << "At index " << i;
+}
+
+GTEST_TEST(ThreadPool, enqueueException) {
+	Common::ThreadPool pool(2);
+
+	std::future<int> result = pool.enqueue([]() -> int { throw Common::Exception("Foobar"); });
+
+	EXPECT_THROW(result.get(), Common::Exception);
+}
+
+GTEST_TEST(ThreadPool, parallelFor) {
+	Common::ThreadPool pool(4);
+
+	std::vector<int> values(1000, 0);
+	pool.parallelFor(values.size(), [&values](size_t i) { values[i] = (int) i + 1; });
+
+	for (size_t i = 0; i < values.size(); i++)
+		EXPECT_EQ(values[i], (int) i + 1) << "At index " << i;
+}
+
+GTEST_TEST(ThreadPool, parallelForSingleThread) {
+	Common::ThreadPool pool(1);
+
+	std::atomic<int> sum(0);
+	pool.parallelFor(10, [&sum](size_t i) { sum += (int) i; });
+
+	EXPECT_EQ(sum.load(), 45);
+}
+
+GTEST_TEST(ThreadPool, parallelForException) {
+	Common::ThreadPool pool(4);
+
+	std::atomic<int> calls(0);
+
+	try {
+		pool.parallelFor(100, [&calls](size_t i) {
+			calls++;
+
+			if ((i == 23) || (i == 42))
+				throw Common::Exception("%u", (uint) i);
+		});
+
+		GTEST_FAIL() << "No exception thrown";
+
+	} catch (Common::Exception &e) {
+		// The exception of the lowest index wins
+		EXPECT_STREQ(e.what(), "23");
+	}
+
+	// All indices are still processed
+	EXPECT_EQ(calls.load(), 100);
+}
+
+GTEST_TEST(ThreadPool, parallelForNested) {
+	Common::ThreadPool pool(2);
+
+	std::atomic<int> sum(0);
+	pool.parallelFor(8, [&pool, &sum](size_t) {
+		pool.parallelFor(8, [&sum](size_t j) { sum += (int) j; });
+	});
+
+	EXPECT_EQ(sum.load(), 8 * 28);
+}
@@ -22,6 +22,8 @@
  *  Unit tests for our UString class.
  */
 
+#include <vector>
+
 #include "gtest/gtest.h"
 
 #include "src/common/util.h"
@@ -562,3 +564,100 @@ GTEST_TEST(UString, append) {
 
 	EXPECT_STREQ(str.c_str(), "Foobar Barfoo Quux");
 }
+
+GTEST_TEST(UString, isASCII) {
+	EXPECT_TRUE (Common::UString().isASCII());
+	EXPECT_TRUE (Common::UString("Foobar").isASCII());
+	EXPECT_FALSE(Common::UString((const char *) kTestStringUTF8).isASCII());
+
+	Common::UString str("Foobar");
+	str += (uint32) 0xF6;
+	EXPECT_FALSE(str.isASCII());
+
+	str.replaceAll(Common::UString((uint32) 0xF6), Common::UString("o"));
+	EXPECT_TRUE(str.isASCII());
+	EXPECT_EQ(str.size(), 7);
+}
+
+GTEST_TEST(UString, compareASCII) {
+	const Common::UString str1("nw_res_a");
+	const Common::UString str2("NW_RES_A");
+	const Common::UString str3("nw_res_ab");
+
+	EXPECT_TRUE (str1.equalsIgnoreCase(str2));
+	EXPECT_FALSE(str1.equalsIgnoreCase(str3));
+	EXPECT_FALSE(str1.equals(str2));
+
+	EXPECT_EQ(str1.stricmp(str2), 0);
+	EXPECT_EQ(str1.stricmp(str3), -1);
+	EXPECT_EQ(str3.stricmp(str2), 1);
+
+	EXPECT_EQ(str2.strcmp(str1), -1);
+	EXPECT_EQ(str1.strcmp(str2), 1);
+	EXPECT_EQ(str1.strcmp(str3), -1);
+	EXPECT_EQ(str1.strcmp(Common::UString("nw_res_a")), 0);
+
+	// Non-ASCII strings, and mixing them with ASCII strings
+	static const byte kTestStringMixedUTF8[10] = { 'f', 0xC3, 0xB6, 0xC3, 0xB6, 'B', 0xC3, 0xA4, 'R', 0 };
+
+	const Common::UString str4((const char *) kTestStringUTF8);
+	const Common::UString str5((const char *) kTestStringMixedUTF8);
+	const Common::UString str6("fOObAR");
+
+	EXPECT_EQ(str4.stricmp(str5), 0);
+	EXPECT_TRUE(str4.equalsIgnoreCase(str5));
+	EXPECT_FALSE(str4.equalsIgnoreCase(str6));
+	EXPECT_EQ(str6.stricmp(str4), -1);
+	EXPECT_EQ(str4.strcmp(str6), -1);
+}
+
+GTEST_TEST(UString, hashIgnoreCase) {
+	const Common::UString str1("nw_res_a");
+	const Common::UString str2("NW_RES_A");
+	const Common::UString str3("nw_res_b");
+
+	Common::hashUStringCaseInsensitive hash;
+
+	EXPECT_EQ(hash(str1), hash(str2));
+	EXPECT_NE(hash(str1), hash(str3));
+
+	// The ASCII and non-ASCII paths have to agree
+	size_t expected = 0;
+	for (Common::UString::iterator c = str1.begin(); c != str1.end(); ++c)
+		boost::hash_combine<uint32>(expected, *c);
+
+	EXPECT_EQ(hash(str2), expected);
+
+	Common::UString str5((const char *) kTestStringUTF8);
+
+	expected = 0;
+	for (const uint32 *c = kTestStringUTF32; *c; c++)
+		boost::hash_combine<uint32>(expected, Common::UString::toLower(*c));
+
+	EXPECT_EQ(hash(str5), expected);
+
+	str5.replaceAll(Common::UString((uint32) 0xF6), Common::UString("O"));
+	str5.replaceAll(Common::UString((uint32) 0xE4), Common::UString("A"));
+	EXPECT_TRUE(str5.isASCII());
+	EXPECT_EQ(hash(str5), hash(Common::UString("fOObAR")));
+
+	// Both hashes are known now, but they still have to be compared correctly
+	EXPECT_TRUE (str1.equalsIgnoreCase(str2));
+	EXPECT_FALSE(str1.equalsIgnoreCase(str3));
+
+	// Changing the string has to change the hash
+	Common::UString str4(str1);
+	EXPECT_EQ(hash(str4), hash(str1));
+
+	str4.replaceAll('a', 'b');
+	EXPECT_EQ(hash(str4), hash(str3));
+
+	str4 += "c";
+	EXPECT_EQ(hash(str4), hash(Common::UString("NW_RES_BC")));
+
+	str4.swap(str4 = str2);
+	EXPECT_EQ(hash(str4), hash(str2));
+
+	str4.clear();
+	EXPECT_EQ(hash(str4), hash(Common::UString()));
+}
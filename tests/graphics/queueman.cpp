@@ -0,0 +1,314 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for the graphics queue manager.
+ */
+
+#include <vector>
+#include <atomic>
+#include <thread>
+#include <chrono>
+
+#include "gtest/gtest.h"
+
+#include "src/common/types.h"
+#include "src/common/util.h"
+
+#include "src/graphics/queueman.h"
+#include "src/graphics/queueable.h"
+
+static const Graphics::QueueType kQueue = Graphics::kQueueVisibleWorldObject;
+
+class TestQueueable : public Graphics::Queueable {
+public:
+	float key;
+	uint id;
+
+	TestQueueable(float k = 0.0f, uint i = 0) : key(k), id(i) {
+	}
+
+	float getSortKey() const {
+		return key;
+	}
+
+	bool isIn() const {
+		return isInQueue(kQueue);
+	}
+
+	void add() {
+		addToQueue(kQueue);
+	}
+
+	void remove() {
+		removeFromQueue(kQueue);
+	}
+};
+
+static std::vector<TestQueueable *> getSnapshot() {
+	const std::vector<Graphics::Queueable *> &snapshot = QueueMan.lockSnapshot(kQueue);
+
+	std::vector<TestQueueable *> objects;
+	for (std::vector<Graphics::Queueable *>::const_iterator q = snapshot.begin(); q != snapshot.end(); ++q)
+		objects.push_back(static_cast<TestQueueable *>(*q));
+
+	QueueMan.unlockSnapshot(kQueue);
+
+	return objects;
+}
+
+static uint32 random(uint32 &seed) {
+	seed = seed * 1664525 + 1013904223;
+	return seed >> 8;
+}
+
+GTEST_TEST(QueueManager, add) {
+	TestQueueable a, b, c;
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(kQueue));
+
+	a.add();
+	b.add();
+	c.add();
+	b.add();
+
+	EXPECT_FALSE(QueueMan.isQueueEmpty(kQueue));
+	EXPECT_TRUE(a.isIn());
+
+	const std::vector<TestQueueable *> objects = getSnapshot();
+	ASSERT_EQ(objects.size(), 3);
+
+	EXPECT_EQ(objects[0], &a);
+	EXPECT_EQ(objects[1], &b);
+	EXPECT_EQ(objects[2], &c);
+
+	QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, remove) {
+	std::vector<TestQueueable> objects(10);
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i].add();
+
+	objects[0].remove();
+	objects[4].remove();
+	objects[5].remove();
+	objects[9].remove();
+	objects[9].remove();
+
+	EXPECT_FALSE(objects[4].isIn());
+	EXPECT_TRUE(objects[3].isIn());
+
+	std::vector<TestQueueable *> snapshot = getSnapshot();
+	ASSERT_EQ(snapshot.size(), 6);
+
+	static const size_t kRemaining[] = { 1, 2, 3, 6, 7, 8 };
+	for (size_t i = 0; i < ARRAYSIZE(kRemaining); i++)
+		EXPECT_EQ(snapshot[i], &objects[kRemaining[i]]) << "At index " << i;
+
+	// Removing after the queue was compacted
+	objects[2].remove();
+	objects[4].add();
+
+	snapshot = getSnapshot();
+	ASSERT_EQ(snapshot.size(), 6);
+
+	EXPECT_EQ(snapshot[1], &objects[3]);
+	EXPECT_EQ(snapshot[5], &objects[4]);
+
+	for (size_t i = 0; i < objects.size(); i++)
+		objects[i].remove();
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(kQueue));
+	EXPECT_TRUE(getSnapshot().empty());
+}
+
+GTEST_TEST(QueueManager, clear) {
+	TestQueueable a, b;
+
+	a.add();
+	b.add();
+
+	QueueMan.clearQueue(kQueue);
+
+	EXPECT_TRUE(QueueMan.isQueueEmpty(kQueue));
+	EXPECT_FALSE(a.isIn());
+	EXPECT_FALSE(b.isIn());
+
+	a.remove();
+	b.add();
+
+	const std::vector<TestQueueable *> objects = getSnapshot();
+	ASSERT_EQ(objects.size(), 1);
+	EXPECT_EQ(objects[0], &b);
+
+	QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, clearObjects) {
+	TestQueueable a, b, c;
+
+	a.add();
+	b.add();
+
+	const std::vector<Graphics::Queueable *> &snapshot = QueueMan.lockSnapshot(kQueue);
+
+	// Added after the snapshot was taken
+	c.add();
+
+	QueueMan.clearQueue(kQueue, snapshot);
+	QueueMan.unlockSnapshot(kQueue);
+
+	EXPECT_FALSE(a.isIn());
+	EXPECT_FALSE(b.isIn());
+	EXPECT_TRUE(c.isIn());
+
+	const std::vector<TestQueueable *> objects = getSnapshot();
+	ASSERT_EQ(objects.size(), 1);
+	EXPECT_EQ(objects[0], &c);
+
+	QueueMan.clearQueue(kQueue);
+}
+
+static void testSort(size_t count) {
+	uint32 seed = 0x12345678;
+
+	std::vector<TestQueueable> objects(count);
+	for (size_t i = 0; i < count; i++) {
+		// Negative and positive keys, with lots of duplicates
+		objects[i].key = (static_cast<int>(random(seed) % 512) - 256) * 0.25f;
+		objects[i].id  = i;
+
+		objects[i].add();
+	}
+
+	for (size_t i = 0; i < count; i += 7)
+		objects[i].remove();
+
+	QueueMan.sortQueue(kQueue);
+
+	const std::vector<TestQueueable *> snapshot = getSnapshot();
+	ASSERT_EQ(snapshot.size(), count - (count + 6) / 7);
+
+	for (size_t i = 1; i < snapshot.size(); i++) {
+		// Sorted by key, and equal keys keep their order
+		ASSERT_LE(snapshot[i - 1]->key, snapshot[i]->key) << "At index " << i;
+
+		if (snapshot[i - 1]->key == snapshot[i]->key) {
+			ASSERT_LT(snapshot[i - 1]->id, snapshot[i]->id) << "At index " << i;
+		}
+	}
+
+	// Removing objects from a sorted queue keeps it sorted
+	for (size_t i = 1; i < count; i += 3)
+		objects[i].remove();
+
+	const std::vector<TestQueueable *> removed = getSnapshot();
+	for (size_t i = 1; i < removed.size(); i++)
+		ASSERT_LE(removed[i - 1]->key, removed[i]->key) << "At index " << i;
+
+	QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, sortSmall) {
+	testSort(50);
+}
+
+GTEST_TEST(QueueManager, sortLarge) {
+	testSort(5000);
+}
+
+GTEST_TEST(QueueManager, sortLargeKeys) {
+	static const float kKeys[] = { 1.0e30f, -1.0e30f, 0.0f, -0.5f, 0.5f, 1.0e-30f, -1.0e-30f, 65536.0f, -65536.0f };
+
+	std::vector<TestQueueable> objects(100);
+	for (size_t i = 0; i < objects.size(); i++) {
+		objects[i].key = kKeys[i % ARRAYSIZE(kKeys)];
+		objects[i].add();
+	}
+
+	QueueMan.sortQueue(kQueue);
+
+	const std::vector<TestQueueable *> snapshot = getSnapshot();
+	ASSERT_EQ(snapshot.size(), objects.size());
+
+	EXPECT_EQ(snapshot.front()->key, -1.0e30f);
+	EXPECT_EQ(snapshot.back()->key, 1.0e30f);
+
+	for (size_t i = 1; i < snapshot.size(); i++)
+		EXPECT_LE(snapshot[i - 1]->key, snapshot[i]->key) << "At index " << i;
+
+	QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, snapshotAdd) {
+	TestQueueable a, b;
+
+	a.add();
+
+	const std::vector<Graphics::Queueable *> &snapshot = QueueMan.lockSnapshot(kQueue);
+
+	// Adding doesn't wait for the snapshot
+	std::thread thread(&TestQueueable::add, &b);
+	thread.join();
+
+	EXPECT_TRUE(b.isIn());
+
+	// Locking the snapshot again doesn't change it
+	EXPECT_EQ(&QueueMan.lockSnapshot(kQueue), &snapshot);
+	QueueMan.unlockSnapshot(kQueue);
+
+	ASSERT_EQ(snapshot.size(), 1);
+	EXPECT_EQ(snapshot[0], &a);
+
+	QueueMan.unlockSnapshot(kQueue);
+
+	EXPECT_EQ(getSnapshot().size(), 2);
+
+	QueueMan.clearQueue(kQueue);
+}
+
+GTEST_TEST(QueueManager, snapshotRemove) {
+	TestQueueable a, b;
+
+	a.add();
+	b.add();
+
+	QueueMan.lockSnapshot(kQueue);
+
+	// Removing from the same thread doesn't wait
+	b.remove();
+
+	std::atomic<bool> removed(false);
+	std::thread thread([&]() {
+		a.remove();
+		removed.store(true);
+	});
+
+	// Removing from a different thread waits until the snapshot is unlocked
+	std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	EXPECT_FALSE(removed.load());
+
+	QueueMan.unlockSnapshot(kQueue);
+	thread.join();
+
+	EXPECT_TRUE(removed.load());
+	EXPECT_TRUE(QueueMan.isQueueEmpty(kQueue));
+}
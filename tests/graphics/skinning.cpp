@@ -0,0 +1,239 @@
+/* xoreos - A reimplementation of BioWare's Aurora engine
+ *
+ * xoreos is the legal property of its developers, whose names
+ * can be found in the AUTHORS file distributed with this source
+ * distribution.
+ *
+ * xoreos is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 3
+ * of the License, or (at your option) any later version.
+ *
+ * xoreos is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with xoreos. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/** @file
+ *  Unit tests for skinning vertices on the CPU.
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+#include "external/glm/gtc/matrix_transform.hpp"
+
+#include "src/common/types.h"
+#include "src/common/error.h"
+
+#include "src/graphics/aurora/skinning.h"
+
+static const size_t kBoneCount      = 32;
+static const size_t kBonesPerVertex = 4;
+
+/** A synthetic skinned mesh, with the bone transformations of one frame. */
+struct Mesh {
+	size_t vertexCount;
+
+	std::vector<float> positions;
+	std::vector<float> normals;
+	std::vector<float> boneIndices;
+	std::vector<float> boneWeights;
+
+	glm::mat4 base;
+	glm::mat4 baseInverse;
+
+	std::vector<glm::mat4> bones;    ///< The transformations of the bones themselves.
+	std::vector<glm::mat4> combined; ///< The bone transformations combined with the base.
+
+	Mesh(size_t count) : vertexCount(count) {
+		uint32 seed = 0x12345678;
+
+		positions.resize(3 * vertexCount);
+		normals.resize(3 * vertexCount);
+		boneIndices.resize(kBonesPerVertex * vertexCount);
+		boneWeights.resize(kBonesPerVertex * vertexCount);
+
+		for (size_t i = 0; i < vertexCount; i++) {
+			float normal[3], length = 0.0f;
+			for (size_t j = 0; j < 3; j++) {
+				positions[3 * i + j] = random(seed) * 20.0f - 10.0f;
+
+				normal[j] = random(seed) * 2.0f - 1.0f + 0.01f;
+				length += normal[j] * normal[j];
+			}
+
+			for (size_t j = 0; j < 3; j++)
+				normals[3 * i + j] = normal[j] / std::sqrt(length);
+
+			// A varying number of bones per vertex, with the unused ones marked by -1
+			const size_t used = 1 + (i % kBonesPerVertex);
+
+			float weightSum = 0.0f;
+			for (size_t j = 0; j < kBonesPerVertex; j++) {
+				boneIndices[kBonesPerVertex * i + j] = (j < used) ? static_cast<int>(random(seed) * kBoneCount) : -1;
+				boneWeights[kBonesPerVertex * i + j] = (j < used) ? (random(seed) + 0.1f) : 0.0f;
+
+				weightSum += boneWeights[kBonesPerVertex * i + j];
+			}
+
+			for (size_t j = 0; j < kBonesPerVertex; j++)
+				boneWeights[kBonesPerVertex * i + j] /= weightSum;
+		}
+
+		base = glm::translate(glm::mat4(), glm::vec3(1.0f, -2.0f, 0.5f));
+		base = glm::rotate(base, 0.3f, glm::vec3(0.0f, 0.0f, 1.0f));
+		baseInverse = glm::inverse(base);
+
+		for (size_t i = 0; i < kBoneCount; i++) {
+			glm::mat4 bone = glm::translate(glm::mat4(), glm::vec3(random(seed), random(seed), random(seed)));
+			bone = glm::rotate(bone, random(seed) * 3.0f, glm::normalize(glm::vec3(random(seed), 1.0f, random(seed))));
+
+			bones.push_back(bone);
+			combined.push_back(baseInverse * bone * base);
+		}
+	}
+
+	static float random(uint32 &seed) {
+		seed = seed * 1664525 + 1013904223;
+		return (seed >> 8) / 16777216.0f;
+	}
+};
+
+static void multiply(const float *v, const glm::mat4 &m, float *vOut) {
+	const float x = v[0] * m[0][0] + v[1] * m[1][0] + v[2] * m[2][0] + m[3][0];
+	const float y = v[0] * m[0][1] + v[1] * m[1][1] + v[2] * m[2][1] + m[3][1];
+	const float z = v[0] * m[0][2] + v[1] * m[1][2] + v[2] * m[2][2] + m[3][2];
+	const float w = v[0] * m[0][3] + v[1] * m[1][3] + v[2] * m[2][3] + m[3][3];
+
+	vOut[0] = x / w;
+	vOut[1] = y / w;
+	vOut[2] = z / w;
+}
+
+/** Skin the positions the way SkeletalAnimation used to, with three matrix multiplications per bone. */
+static void skinReference(const Mesh &mesh, float *positions, size_t stride) {
+	const float *vertsIn     = mesh.positions.data();
+	const float *boneIndices = mesh.boneIndices.data();
+	const float *boneWeights = mesh.boneWeights.data();
+
+	for (size_t i = 0; i < mesh.vertexCount; i++) {
+		positions[0] = 0.0f;
+		positions[1] = 0.0f;
+		positions[2] = 0.0f;
+
+		for (size_t j = 0; j < kBonesPerVertex; j++) {
+			const int boneIndex = static_cast<int>(boneIndices[j]);
+			if (boneIndex == -1)
+				continue;
+
+			float v0[3], v1[3];
+
+			multiply(vertsIn, mesh.base, v0);
+			multiply(v0, mesh.bones[boneIndex], v1);
+			multiply(v1, mesh.baseInverse, v0);
+
+			positions[0] += v0[0] * boneWeights[j];
+			positions[1] += v0[1] * boneWeights[j];
+			positions[2] += v0[2] * boneWeights[j];
+		}
+
+		vertsIn     += 3;
+		boneIndices += kBonesPerVertex;
+		boneWeights += kBonesPerVertex;
+		positions   += stride;
+	}
+}
+
+static void setData(Graphics::Aurora::SkinningData &data, const Mesh &mesh) {
+	data.set(mesh.vertexCount, kBonesPerVertex, mesh.positions.data(), mesh.normals.data(),
+	         mesh.boneIndices.data(), mesh.boneWeights.data());
+}
+
+GTEST_TEST(SkinningData, set) {
+	const Mesh mesh(100);
+
+	Graphics::Aurora::SkinningData data;
+	EXPECT_TRUE(data.empty());
+
+	setData(data, mesh);
+
+	EXPECT_FALSE(data.empty());
+	EXPECT_EQ(data.getVertexCount(), 100);
+	EXPECT_LE(data.getBoneCount(), kBoneCount);
+	EXPECT_GT(data.getBoneCount(), 0);
+
+	data.clear();
+
+	EXPECT_TRUE(data.empty());
+	EXPECT_EQ(data.getVertexCount(), 0);
+	EXPECT_EQ(data.getBoneCount(), 0);
+}
+
+GTEST_TEST(SkinningData, setInvalid) {
+	const Mesh mesh(1);
+
+	Graphics::Aurora::SkinningData data;
+	EXPECT_THROW(data.set(1, 5, mesh.positions.data(), mesh.normals.data(),
+	                      mesh.boneIndices.data(), mesh.boneWeights.data()), Common::Exception);
+
+	const float boneIndices[kBonesPerVertex] = { 65536.0f, -1.0f, -1.0f, -1.0f };
+	EXPECT_THROW(data.set(1, kBonesPerVertex, mesh.positions.data(), mesh.normals.data(),
+	                      boneIndices, mesh.boneWeights.data()), Common::Exception);
+}
+
+GTEST_TEST(SkinningData, identity) {
+	const Mesh mesh(100);
+
+	Graphics::Aurora::SkinningData data;
+	setData(data, mesh);
+
+	const std::vector<glm::mat4> bones(data.getBoneCount());
+	std::vector<float> vertices(6 * mesh.vertexCount);
+
+	data.skin(bones.data(), vertices.data(), vertices.data() + 3, 6);
+
+	for (size_t i = 0; i < mesh.vertexCount; i++) {
+		for (size_t j = 0; j < 3; j++) {
+			EXPECT_NEAR(vertices[6 * i + j    ], mesh.positions[3 * i + j], 1e-3) << "At index " << i << "." << j;
+			EXPECT_NEAR(vertices[6 * i + j + 3], mesh.normals  [3 * i + j], 1e-3) << "At index " << i << "." << j;
+		}
+	}
+}
+
+GTEST_TEST(SkinningData, skin) {
+	const Mesh mesh(1000);
+
+	Graphics::Aurora::SkinningData data;
+	setData(data, mesh);
+
+	std::vector<float> reference(6 * mesh.vertexCount);
+	std::vector<float> scalar   (6 * mesh.vertexCount);
+	std::vector<float> simd     (6 * mesh.vertexCount);
+
+	skinReference(mesh, reference.data(), 6);
+	data.skinScalar(mesh.combined.data(), scalar.data(), scalar.data() + 3, 6);
+	data.skin      (mesh.combined.data(), simd.data()  , simd.data()   + 3, 6);
+
+	for (size_t i = 0; i < mesh.vertexCount; i++) {
+		float length = 0.0f;
+
+		for (size_t j = 0; j < 3; j++) {
+			// Positions match the old algorithm, up to the quantization of the weights
+			EXPECT_NEAR(scalar[6 * i + j], reference[6 * i + j], 1e-3) << "At index " << i << "." << j;
+			EXPECT_NEAR(simd  [6 * i + j], reference[6 * i + j], 1e-3) << "At index " << i << "." << j;
+
+			EXPECT_NEAR(simd[6 * i + j + 3], scalar[6 * i + j + 3], 1e-5) << "At index " << i << "." << j;
+
+			length += simd[6 * i + j + 3] * simd[6 * i + j + 3];
+		}
+
+		EXPECT_NEAR(length, 1.0f, 1e-4) << "At index " << i;
+	}
+}
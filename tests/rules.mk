@@ -40,6 +40,7 @@ include tests/version/rules.mk
 include tests/common/rules.mk
 include tests/aurora/rules.mk
 include tests/images/rules.mk
+include tests/graphics/rules.mk
 include tests/engines/nwn2/rules.mk
 
 TESTS += $(check_PROGRAMS)